@@ -34,6 +34,7 @@ usage(char *s)
   fprintf(stderr,"   -N N		use N-gram (available max)\n");
   fprintf(stderr,"   -v                 verbose output\n");
   fprintf(stderr,"   -debug             debug output\n");
+  fprintf(stderr,"   -bench             measure N-gram lookup speed (fixed seed)\n");
   exit(1);
 }
 
@@ -62,6 +63,9 @@ main(int argc, char *argv[])
   boolean debug = FALSE;
   boolean quiet = FALSE;
   boolean reverse = FALSE;
+  boolean bench = FALSE;
+  clock_t bench_clock = 0, c;
+  double bench_count = 0.0;
 
   /* set random seed */
   srandom(getpid());
@@ -70,7 +74,11 @@ main(int argc, char *argv[])
    binfile = NULL;
   for(i=1;i<argc;i++) {
     if (argv[i][0] == '-') {
-      if (argv[i][1] == 'd') {
+      if (strmatch(argv[i], "-bench")) {
+	bench = TRUE;
+	/* use the same sentences for comparison */
+	srandom(0);
+      } else if (argv[i][1] == 'd') {
 	debug = TRUE;
       } else if (argv[i][1] == 'n') {
 	if (++i >= argc) usage(argv[0]);
@@ -173,6 +181,7 @@ main(int argc, char *argv[])
       /* loop to predict next words */
       while (1) {
 	/* create word index and store ngram prob */
+	if (bench) c = clock();
 	for(i=0;i<ngram->max_word_num;i++) {
 	  windex[i] = i;
 	  wlist[len] = i;
@@ -183,6 +192,10 @@ main(int argc, char *argv[])
 	  }
 	  findex[i] = ngram_prob(ngram, ntmp, &(wlist[len-ntmp+1]));
 	}
+	if (bench) {
+	  bench_clock += clock() - c;
+	  bench_count += ngram->max_word_num;
+	}
 	if (debug) {
 	  if (ntmp > 1) {
 	    printf("context=");
@@ -275,6 +288,11 @@ main(int argc, char *argv[])
     free(windex);
   }  
 
+  if (bench) {
+    printf("--- N-gram lookup speed ---\n");
+    printf("%.0f lookups in %.3f sec, %.0f lookups/sec\n", bench_count, (double)bench_clock / CLOCKS_PER_SEC, bench_clock > 0 ? bench_count / ((double)bench_clock / CLOCKS_PER_SEC) : 0.0);
+  }
+
   
   return 0;
 }
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 1991-2013 Kawahara Lab., Kyoto University
+ * Copyright (c) 2000-2005 Shikano Lab., Nara Institute of Science and Technology
+ * Copyright (c) 2005-2013 Julius project team, Nagoya Institute of Technology
+ * All rights reserved
+ */
+
+/*
+ * jalign --- batch forced alignment of transcribed speech files
+ *
+ * Reads a list of input files and the transcription of each, and
+ * performs forced alignment against the given acoustic model and
+ * dictionary without doing recognition.  Files are processed in
+ * parallel, and the results are output in tab-separated form:
+ *
+ *   file  unit  begin_frame  end_frame  avgscore  label
+ *
+ */
+
+#include <julius/juliuslib.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+static int thread_num = 1;	/* number of alignment threads */
+static LOGPROB beam = 0.0;	/* beam width of alignment, 0.0 for full */
+static char *transext = "txt";	/* extension of transcription files */
+
+/* input file list */
+static char **flist = NULL;
+static int fnum = 0;
+
+/* shared status among threads */
+static Recog *recog;
+static RecogProcess *r;
+static int fnext = 0;		/* next file to process */
+static int fprinted = 0;	/* next file to output */
+static int failnum = 0;		/* number of failed files */
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t mutex;	/* lock for reading inputs and output */
+static pthread_cond_t cond;	/* signaled at each output */
+#endif
+
+static boolean
+opt_help(Jconf *jconf, char *arg[], int argnum)
+{
+  fprintf(stderr, "jalign --- batch forced alignment of transcribed speech files\n");
+  fprintf(stderr, "Usage: jalign [options..] -filelist listfile\n");
+  fprintf(stderr, "    [-h hmmdefs]         acoustic model\n");
+  fprintf(stderr, "    [-v dictfile]        word dictionary (with -d, -nlr or -dfa)\n");
+  fprintf(stderr, "    [-input rawfile|htkparam] input type\n");
+  fprintf(stderr, "    [-walign]            output word alignment (default)\n");
+  fprintf(stderr, "    [-palign]            output phoneme alignment\n");
+  fprintf(stderr, "    [-salign]            output state alignment\n");
+  fprintf(stderr, "    [-thread num]        number of threads     (%d)\n", thread_num);
+  fprintf(stderr, "    [-beam width]        beam width, 0 for full (%.1f)\n", beam);
+  fprintf(stderr, "    [-transext ext]      transcription suffix  (%s)\n", transext);
+  fprintf(stderr, "    (other Julius options for AM and front-end are also valid)\n");
+  fprintf(stderr, "Library configuration: ");
+  confout_version(stderr);
+  confout_audio(stderr);
+  confout_process(stderr);
+  fprintf(stderr, "\n");
+  exit(1);			/* exit here */
+  return TRUE;
+}
+
+static boolean
+opt_thread(Jconf *jconf, char *arg[], int argnum)
+{
+  thread_num = atoi(arg[0]);
+  if (thread_num < 1) thread_num = 1;
+#ifndef HAVE_PTHREAD
+  if (thread_num > 1) {
+    fprintf(stderr, "Warning: \"-thread\" needs pthread support, ignored\n");
+    thread_num = 1;
+  }
+#endif
+  return TRUE;
+}
+static boolean
+opt_beam(Jconf *jconf, char *arg[], int argnum)
+{
+  beam = atof(arg[0]);
+  return TRUE;
+}
+static boolean
+opt_transext(Jconf *jconf, char *arg[], int argnum)
+{
+  transext = strcpy((char *)mymalloc(strlen(arg[0]) + 1), arg[0]);
+  return TRUE;
+}
+
+/* read input file list */
+static boolean
+read_filelist(char *listfile)
+{
+  FILE *fp;
+  char buf[MAXPATHLEN];
+  int maxnum = 0;
+
+  if ((fp = fopen(listfile, "r")) == NULL) {
+    fprintf(stderr, "Error: failed to open %s\n", listfile);
+    return FALSE;
+  }
+  while (getl_fp(buf, MAXPATHLEN, fp) != NULL) {
+    if (buf[0] == '\0' || buf[0] == '#') continue;
+    if (fnum >= maxnum) {
+      maxnum += 100;
+      flist = (char **)myrealloc(flist, sizeof(char *) * maxnum);
+    }
+    flist[fnum++] = strcpy((char *)mymalloc(strlen(buf) + 1), buf);
+  }
+  fclose(fp);
+  return TRUE;
+}
+
+/* read transcription of the input file and convert to word sequence */
+static WORD_ID *
+read_transcription(char *fname, int *len_ret)
+{
+  FILE *fp;
+  char tname[MAXPATHLEN];
+  char buf[MAXLINELEN];
+  char *s, *p;
+  int len;
+  WORD_ID *wseq;
+
+  /* replace extension */
+  strncpy(tname, fname, MAXPATHLEN - strlen(transext) - 2);
+  tname[MAXPATHLEN - strlen(transext) - 2] = '\0';
+  p = strrchr(tname, '.');
+  if (p != NULL && strchr(p, '/') == NULL) *p = '\0';
+  strcat(tname, ".");
+  strcat(tname, transext);
+
+  if ((fp = fopen(tname, "r")) == NULL) {
+    fprintf(stderr, "Error: %s: failed to open transcription %s\n", fname, tname);
+    return NULL;
+  }
+  /* concatenate all lines */
+  len = 0;
+  s = (char *)mymalloc(1);
+  s[0] = '\0';
+  while (fgets(buf, MAXLINELEN, fp) != NULL) {
+    for (p = buf; *p != '\0'; p++) {
+      if (*p == '\t' || *p == '\r' || *p == '\n') *p = ' ';
+    }
+    len += strlen(buf);
+    s = (char *)myrealloc(s, len + 1);
+    strcat(s, buf);
+  }
+  fclose(fp);
+
+  wseq = new_str2wordseq(r->lm->winfo, s, len_ret);
+  free(s);
+  if (wseq != NULL && *len_ret == 0) {
+    fprintf(stderr, "Error: %s: empty transcription %s\n", fname, tname);
+    free(wseq);
+    wseq = NULL;
+  }
+  if (wseq == NULL) {
+    fprintf(stderr, "Error: %s: failed to read transcription %s\n", fname, tname);
+  }
+  return wseq;
+}
+
+/* read input file and compute feature parameter */
+static HTK_Param *
+read_input(char *fname)
+{
+  HTK_Param *param;
+  SP16 *speech;
+  int speechlen, alloclen, cnt;
+
+  if (recog->jconf->input.type == INPUT_VECTOR) {
+    /* read parameter file */
+    param = new_param();
+    if (rdparam(fname, param) == FALSE) {
+      fprintf(stderr, "Error: %s: failed to read parameter file\n", fname);
+      free_param(param);
+      return NULL;
+    }
+    if (recog->jconf->preprocess.strip_zero_sample) {
+      param_strip_zero(param);
+    }
+    if (param_check_and_adjust(r->am->hmminfo, param, FALSE) == -1) {
+      fprintf(stderr, "Error: %s: parameter type mismatch\n", fname);
+      free_param(param);
+      return NULL;
+    }
+    return param;
+  }
+
+  /* read whole waveform */
+  if (adin_file_begin(fname) == FALSE) return NULL;
+  alloclen = MAXSPEECHLEN;
+  speech = (SP16 *)mymalloc(sizeof(SP16) * alloclen);
+  speechlen = 0;
+  for(;;) {
+    if (speechlen == alloclen) {
+      alloclen *= 2;
+      speech = (SP16 *)myrealloc(speech, sizeof(SP16) * alloclen);
+    }
+    cnt = adin_file_read(&(speech[speechlen]), alloclen - speechlen);
+    if (cnt < 0) break;
+    speechlen += cnt;
+  }
+  adin_file_end();
+  if (cnt == -2) {
+    free(speech);
+    return NULL;
+  }
+  /* compute feature parameter with sentence CMN */
+  if (wav2mfcc(speech, speechlen, recog) == FALSE) {
+    fprintf(stderr, "Error: %s: failed to compute feature parameter\n", fname);
+    free(speech);
+    return NULL;
+  }
+  free(speech);
+  /* take the parameter from the engine */
+  param = r->am->mfcc->param;
+  r->am->mfcc->param = new_param();
+  return param;
+}
+
+/* output alignment result in tab-separated form */
+static void
+output_align(char *fname, SentenceAlign *align)
+{
+  WORD_INFO *winfo;
+  HMM_Logical *p;
+  int i;
+  static char *unitname[] = {"word", "phoneme", "state"};
+
+  winfo = r->lm->winfo;
+  for(i=0;i<align->num;i++) {
+    printf("%s\t%s\t%d\t%d\t%f\t", fname, unitname[align->unittype], align->begin_frame[i], align->end_frame[i], align->avgscore[i]);
+    switch(align->unittype) {
+    case PER_WORD:
+      /* output string, or word name if it is empty */
+      if (winfo->woutput[align->w[i]][0] != '\0') {
+	printf("%s\n", winfo->woutput[align->w[i]]);
+      } else {
+	printf("%s\n", winfo->wname[align->w[i]]);
+      }
+      break;
+    case PER_PHONEME:
+      printf("%s\n", align->ph[i]->name);
+      break;
+    case PER_STATE:
+      p = align->ph[i];
+      if (r->am->hmminfo->multipath && align->is_iwsp[i]) {
+	printf("%s#%d(sp)\n", p->name, align->loc[i]);
+      } else {
+	printf("%s#%d\n", p->name, align->loc[i]);
+      }
+      break;
+    }
+  }
+}
+
+/* align one file */
+static void
+align_file(int n, HMMWork *wrk, BMALLOC_ARENA *arena, SentenceAlign *align)
+{
+  HTK_Param *param;
+  WORD_ID *wseq;
+  int wnum;
+  int u, i;
+  boolean unit[3];
+  boolean ok;
+
+  unit[PER_WORD] = r->config->annotate.align_result_word_flag;
+  unit[PER_PHONEME] = r->config->annotate.align_result_phoneme_flag;
+  unit[PER_STATE] = r->config->annotate.align_result_state_flag;
+  if (!unit[PER_WORD] && !unit[PER_PHONEME] && !unit[PER_STATE]) {
+    unit[PER_WORD] = TRUE;
+  }
+
+  /* read inputs (front-end and dictionary lookup are not thread-safe) */
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock(&mutex);
+#endif
+  param = read_input(flist[n]);
+  wseq = (param != NULL) ? read_transcription(flist[n], &wnum) : NULL;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_unlock(&mutex);
+#endif
+
+  ok = FALSE;
+  if (param != NULL && wseq != NULL) {
+    ok = TRUE;
+    outprob_prepare(wrk, param->samplenum);
+    i = 0;
+    for(u=PER_WORD;u<=PER_STATE;u++) {
+      if (!unit[u]) continue;
+      if (align_word_sequence(wseq, wnum, param, u, beam, &(align[i]), wrk, arena, r) == FALSE) ok = FALSE;
+      i++;
+    }
+  }
+
+  /* output in the order of input list */
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock(&mutex);
+  while (fprinted != n) pthread_cond_wait(&cond, &mutex);
+#endif
+  if (ok) {
+    i = 0;
+    for(u=PER_WORD;u<=PER_STATE;u++) {
+      if (!unit[u]) continue;
+      output_align(flist[n], &(align[i]));
+      i++;
+    }
+  } else {
+    if (param != NULL && wseq != NULL) {
+      fprintf(stderr, "Error: %s: alignment failed\n", flist[n]);
+    }
+    failnum++;
+  }
+  fflush(stdout);
+  fprinted++;
+#ifdef HAVE_PTHREAD
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+#endif
+
+  mybarena_reset(arena);
+  if (wseq) free(wseq);
+  if (param) free_param(param);
+}
+
+/* alignment thread */
+static void *
+align_thread(void *arg)
+{
+  HMMWork wrk;
+  BMALLOC_ARENA arena;
+  SentenceAlign align[3];
+  PROCESS_AM *am;
+  int n;
+
+  am = r->am;
+  if (outprob_init(&wrk, am->hmminfo, am->hmm_gs, am->config->gs_statenum, am->config->gprune_method, am->config->mixnum_thres) == FALSE) {
+    fprintf(stderr, "Error: failed to initialize work area\n");
+    exit(1);
+  }
+  mybarena_init(&arena);
+
+  for(;;) {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&mutex);
+#endif
+    n = fnext++;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&mutex);
+#endif
+    if (n >= fnum) break;
+    align_file(n, &wrk, &arena, align);
+  }
+
+  mybarena_free(&arena);
+  outprob_free(&wrk);
+  return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+  Jconf *jconf;
+#ifdef HAVE_PTHREAD
+  pthread_t *threads;
+  int i;
+#endif
+
+  /* set application-specific additional options */
+  j_add_option("-thread", 1, 1, "number of threads", opt_thread);
+  j_add_option("-beam", 1, 1, "beam width of alignment", opt_beam);
+  j_add_option("-transext", 1, 1, "suffix of transcription files", opt_transext);
+  j_add_option("-help", 0, 0, "display this help", opt_help);
+  j_add_option("--help", 0, 0, "display this help", opt_help);
+
+  /* when no argument, output help and exit */
+  if (argc <= 1) {
+    opt_help(NULL, NULL, 0);
+    return 0;
+  }
+
+  /* output log to stderr, keep stdout for the result */
+  jlog_set_output(stderr);
+
+  /* process config and load models */
+  jconf = j_jconf_new();
+  if (j_config_load_args(jconf, argc, argv) == -1) {
+    fprintf(stderr, "Error reading arguments\n");
+    return -1;
+  }
+  if (jconf->input.type == INPUT_WAVEFORM && jconf->input.speech_input != SP_RAWFILE) {
+    fprintf(stderr, "Error: only \"-input rawfile\" or \"-input htkparam\" is supported\n");
+    return -1;
+  }
+  if (jconf->input.inputlist_filename == NULL) {
+    fprintf(stderr, "Error: input file list should be given by \"-filelist\"\n");
+    return -1;
+  }
+  if (j_jconf_finalize(jconf) == FALSE) {
+    fprintf(stderr, "Error in configuration\n");
+    return -1;
+  }
+  /* compute features with sentence CMN */
+  jconf->decodeopt.realtime_flag = FALSE;
+  recog = j_recog_new();
+  recog->jconf = jconf;
+  if (j_load_all(recog, jconf) == FALSE) {
+    fprintf(stderr, "Error in loading models\n");
+    return -1;
+  }
+  if (j_final_fusion(recog) == FALSE) {
+    fprintf(stderr, "Error while setup work area\n");
+    j_recog_free(recog);
+    return -1;
+  }
+  r = recog->process_list;
+  if (r->next != NULL) {
+    fprintf(stderr, "Warning: only the first recognition process \"%s\" is used\n", r->config->name);
+  }
+  if (jconf->input.type == INPUT_WAVEFORM) {
+    if (adin_file_standby(jconf->input.sfreq, NULL) == FALSE) {
+      j_recog_free(recog);
+      return -1;
+    }
+  }
+  if (read_filelist(jconf->input.inputlist_filename) == FALSE) {
+    j_recog_free(recog);
+    return -1;
+  }
+
+  /* run alignment */
+#ifdef HAVE_PTHREAD
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+  if (thread_num > fnum) thread_num = fnum;
+  if (thread_num > 1) {
+    threads = (pthread_t *)mymalloc(sizeof(pthread_t) * thread_num);
+    for(i=0;i<thread_num;i++) {
+      if (pthread_create(&(threads[i]), NULL, align_thread, NULL) != 0) {
+	fprintf(stderr, "Error: failed to create thread\n");
+	return -1;
+      }
+    }
+    for(i=0;i<thread_num;i++) pthread_join(threads[i], NULL);
+    free(threads);
+  } else {
+    align_thread(NULL);
+  }
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+#else
+  align_thread(NULL);
+#endif
+
+  fprintf(stderr, "%d files aligned, %d failed\n", fnum - failnum, failnum);
+
+  j_recog_free(recog);
+  return(failnum > 0 ? 1 : 0);
+}
@@ -433,10 +433,22 @@ result_pass2(Recog *recog, void *dummy)
     num = r->result.sentnum;
 
     if (multi) {
-      module_send(module_sd, "<RECOGOUT ID=\"SR%02d\" NAME=\"%s\">\n", r->config->id, r->config->name);
+      module_send(module_sd, "<RECOGOUT ID=\"SR%02d\" NAME=\"%s\"", r->config->id, r->config->name);
     } else {
-      module_send(module_sd, "<RECOGOUT>\n");
+      module_send(module_sd, "<RECOGOUT");
+    }
+    if (r->result.status == J_RESULT_STATUS_TRUNCATED) {
+      module_send(module_sd, " STATUS=\"TRUNCATED\"");
+    }
+    if (r->config->pass2.adapt_by_confidence && r->lmvar != LM_DFA_WORD) {
+      int *c = r->pass2.adapt_num;
+      int total = c[PASS2_ADAPT_FULL] + c[PASS2_ADAPT_REDUCED] + c[PASS2_ADAPT_SKIPPED];
+      module_send(module_sd, " PASS2=\"%s\" SKIPRATE=\"%f\"",
+		  r->result.pass2_adapt == PASS2_ADAPT_SKIPPED ? "SKIPPED" :
+		  (r->result.pass2_adapt == PASS2_ADAPT_REDUCED ? "REDUCED" : "FULL"),
+		  total > 0 ? (float)c[PASS2_ADAPT_SKIPPED] / (float)total : 0.0);
     }
+    module_send(module_sd, ">\n");
     for(n=0;n<num;n++) {
       s = &(r->result.sent[n]);
       seq = s->word;
@@ -840,6 +840,23 @@ result_pass2(Recog *recog, void *dummy)
     winfo = r->lm->winfo;
     num = r->result.sentnum;
 
+    if (r->result.status == J_RESULT_STATUS_TRUNCATED) {
+      if (! r->config->successive.enabled || ! r->config->output.progout_flag) {
+	printf("<search truncated by deadline>\n");
+      }
+    }
+    if (r->config->pass2.adapt_by_confidence && r->lmvar != LM_DFA_WORD) {
+      int *c = r->pass2.adapt_num;
+      int total = c[PASS2_ADAPT_FULL] + c[PASS2_ADAPT_REDUCED] + c[PASS2_ADAPT_SKIPPED];
+      printf("pass2_mode: %s (margin=%f, skipped %d/%d = %.1f%%, reduced %d)\n",
+	     r->result.pass2_adapt == PASS2_ADAPT_SKIPPED ? "skipped" :
+	     (r->result.pass2_adapt == PASS2_ADAPT_REDUCED ? "reduced" : "full"),
+	     r->result.pass1_margin,
+	     c[PASS2_ADAPT_SKIPPED], total,
+	     total > 0 ? (float)c[PASS2_ADAPT_SKIPPED] * 100.0 / (float)total : 0.0,
+	     c[PASS2_ADAPT_REDUCED]);
+    }
+
     for(n=0;n<num;n++) {
       s = &(r->result.sent[n]);
       seq = s->word;
@@ -35,6 +35,7 @@ typedef int TOKENID;
 typedef struct {
   TRELLIS_ATOM *last_tre;	///< Previous word candidate in word trellis
   WORD_ID last_cword;		///< Previous context-aware (not transparent) word for N-gram
+  WORD_ID last_cword2;		///< Context-aware word before @a last_cword, for trigram on the 1st pass
   LOGPROB last_lscore;		///< Currently assigned word-internal LM score for factoring for N-gram
   LOGPROB score;		///< Current accumulated score (AM+LM)
   int node;			///< Lexicon node ID to which this token is assigned
@@ -45,4 +46,33 @@ typedef struct {
 
 #define FILLWIDTH 70		///< Word-wrap character length for progressive output
 
+/// Transition arc other than self-loop and next-state on flat word HMM
+typedef struct {
+  int from;			///< Source state index
+  int to;			///< Destination state index
+  LOGPROB a;			///< Transition probability
+} FLATWORD_ARC;
+
+/**
+ * Flat per-word HMM state sequences for fast isolated word recognition.
+ * All states of all words are stored sequencially, and the states of
+ * the k-th word are [wbegin[k]..wbegin[k+1]-1].
+ * 
+ */
+typedef struct {
+  int wnum;			///< Number of words
+  WORD_ID *wid;			///< Word ID of each word [0..wnum-1]
+  int *wbegin;			///< First state index of each word [0..wnum]
+  int maxwnum;			///< Allocated length of @a wid and @a wbegin
+  int statenum;			///< Total number of states
+  int maxstatenum;		///< Allocated number of states
+  int *node;			///< Corresponding node on tree lexicon [state]
+  LOGPROB *a_self;		///< Self-loop transition probability [state]
+  LOGPROB *a_next;		///< Transition to the next state in word, or LOG_ZERO [state]
+  LOGPROB *score[2];		///< Viterbi score, swapped at each frame [state]
+  FLATWORD_ARC *arc;		///< Other transition arcs within word
+  int arcnum;			///< Number of @a arc
+  int maxarcnum;		///< Allocated number of @a arc
+} FLATWORD;
+
 #endif /* __J_BEAM_H__ */
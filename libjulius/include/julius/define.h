@@ -66,6 +66,7 @@
 #define J_RESULT_STATUS_REJECT_SHORT -2 ///< Input rejected by short input
 #define J_RESULT_STATUS_FAIL -1	///< Recognition ended with no candidate
 #define J_RESULT_STATUS_SUCCESS 0 ///< Recognition output some result
+#define J_RESULT_STATUS_TRUNCATED 1 ///< Recognition output some result, but 2nd pass was cut by deadline
 
 /* delete incoherent option */
 /* CATEGORY_TREE: DFA=always on, NGRAM=always off */
@@ -290,5 +291,50 @@
  */
 #define SCORE_PRUNING
 
+/**
+ * Maximum rate of beam widening per frame on adaptive beam control
+ * ("-badapt" and "-badaptmsec").  Narrowing is applied at once when
+ * the budget is exceeded, while widening is limited by this rate.
+ * 
+ */
+#define ADAPTIVE_BEAM_GROW_RATE 0.05
+
+/**
+ * Number of entries of 3-gram cache on the 1st pass ("-trigram1").
+ * Will be rounded up to power of 2.
+ * 
+ */
+#define TRIGRAM1_CACHE_SIZE 65536
+
+/**
+ * Minimum number of expanded words to compute in parallel at the
+ * 2nd pass ("-nwthread").  Smaller expansions are done by the main
+ * thread alone.
+ * 
+ */
+#define NW_PARALLEL_MIN_NUM 16
+
+/* 2nd pass mode decided by confidence of 1st pass result ("-pass2skip") */
+#define PASS2_ADAPT_FULL 0	///< Full 2nd pass
+#define PASS2_ADAPT_REDUCED 1	///< 2nd pass with reduced stack
+#define PASS2_ADAPT_SKIPPED 2	///< 2nd pass skipped, 1st pass result is output
+
+/**
+ * Divisor of the stack size and the hypothesis overflow threshold
+ * for the reduced 2nd pass ("-pass2skip").
+ * 
+ */
+#define PASS2_REDUCE_RATE 4
+
+/**
+ * Enable parallel model loading ("-parallelload").  Requires pthread,
+ * and also zlib since the built-in gzip reader can open only one file
+ * at a time.
+ * 
+ */
+#if defined(HAVE_PTHREAD) && defined(HAVE_ZLIB)
+#define PARALLEL_LOAD
+#endif
+
 #endif /* __J_DEFINE_H__ */
 
@@ -34,6 +34,7 @@ void bt_prepare(BACKTRELLIS *bt);
 void bt_free(BACKTRELLIS *bt);
 TRELLIS_ATOM *bt_new(BACKTRELLIS *bt);
 void bt_store(BACKTRELLIS *bt, TRELLIS_ATOM *aotm);
+int bt_sweep(BACKTRELLIS *bt, int keeptime);
 void bt_relocate_rw(BACKTRELLIS *bt);
 void set_terminal_words(RecogProcess *r);
 void bt_discount_pescore(WCHMM_INFO *wchmm, BACKTRELLIS *bt, HTK_Param *param);
@@ -46,10 +47,14 @@ void make_iwcache_index(WCHMM_INFO *wchmm);
 void adjust_sc_index(WCHMM_INFO *wchmm);
 void make_successor_list(WCHMM_INFO *wchmm);
 void make_successor_list_unigram_factoring(WCHMM_INFO *wchmm);
-void max_successor_cache_init(WCHMM_INFO *wchmm);
+void max_successor_cache_init(WCHMM_INFO *wchmm, int cachesize);
 void max_successor_cache_free(WCHMM_INFO *wchmm);
 LOGPROB max_successor_prob(WCHMM_INFO *wchmm, WORD_ID lastword, int node);
+boolean max_successor_trigram_init(WCHMM_INFO *wchmm, int cachesize);
+LOGPROB max_successor_prob_trigram(WCHMM_INFO *wchmm, WORD_ID lastword2, WORD_ID lastword, int node);
+#ifdef UNIGRAM_FACTORING
 LOGPROB *max_successor_prob_iw(WCHMM_INFO *wchmm, WORD_ID lastword);
+#endif
 void  calc_all_unigram_factoring_values(WCHMM_INFO *wchmm);
 boolean can_succeed(WCHMM_INFO *wchmm, WORD_ID lastword, int node);
 
@@ -60,6 +65,12 @@ void get_back_trellis_end(HTK_Param *param, RecogProcess *r);
 void fsbeam_free(FSBeam *d);
 void finalize_1st_pass(RecogProcess *r, int len);
 
+/* flatword.c */
+boolean flatword_init(HTK_Param *param, RecogProcess *r);
+boolean flatword_proceed(int t, HTK_Param *param, RecogProcess *r);
+void flatword_end(HTK_Param *param, RecogProcess *r);
+void flatword_free(FLATWORD *fw);
+
 /* pass1.c */
 #ifdef POWER_REJECT
 boolean power_reject(Recog *recog);
@@ -97,6 +108,12 @@ void error_missing_left_triphone(HMM_Logical *base, char *lc_name);
 int ngram_firstwords(NEXTWORD **nw, int peseqlen, int maxnw, RecogProcess *r);
 int ngram_nextwords(NODE *hypo, NEXTWORD **nw, int maxnw, RecogProcess *r);
 boolean ngram_acceptable(NODE *hypo, RecogProcess *r);
+void nwcache_init(RecogProcess *r);
+void nwcache_clear(RecogProcess *r);
+void nwcache_free(RecogProcess *r);
+void lmcache_init(RecogProcess *r);
+void lmcache_clear(RecogProcess *r);
+void lmcache_free(RecogProcess *r);
 int dfa_firstwords(NEXTWORD **nw, int peseqlen, int maxnw, RecogProcess *r);
 int dfa_nextwords(NODE *hypo, NEXTWORD **nw, int maxnw, RecogProcess *r);
 boolean dfa_acceptable(NODE *hypo, RecogProcess *r);
@@ -105,6 +122,8 @@ boolean dfa_look_around(NEXTWORD *nword, NODE *hypo, RecogProcess *r);
 /* search_bestfirst_main.c */
 void segment_set_last_nword(NODE *hypo, RecogProcess *r);
 void pass2_finalize_on_no_result(RecogProcess *r, boolean use_1pass_as_final);
+double pass2_clock_msec();
+boolean pass2_adapt_by_confidence(RecogProcess *r);
 void wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num);
 void wchmm_fbs_prepare(RecogProcess *r);
 void wchmm_fbs_free(RecogProcess *r);
@@ -118,6 +137,9 @@ void malloc_wordtrellis(RecogProcess *r);
 void free_wordtrellis(StackDecode *dwrk);
 void scan_word(NODE *now, HTK_Param *param, RecogProcess *r);
 void next_word(NODE *now, NODE *newParam, NEXTWORD *nword, HTK_Param *param, RecogProcess *r);
+#ifndef PASS2_STRICT_IWCD
+void next_word_wrk(NODE *now, NODE *newParam, NEXTWORD *nword, HTK_Param *param, HMMWork *wrk, RecogProcess *r);
+#endif
 void start_word(NODE *newParam, NEXTWORD *nword, HTK_Param *param, RecogProcess *r);
 void last_next_word(NODE *now, NODE *newParam, HTK_Param *param, RecogProcess *r);
 
@@ -137,6 +159,10 @@ void print_wchmm_info(WCHMM_INFO *wchmm);
 boolean build_wchmm(WCHMM_INFO *wchmm, JCONF_LM *lmconf);
 boolean build_wchmm2(WCHMM_INFO *wchmm, JCONF_LM *lmconf);
 
+/* wchmm_cache.c */
+boolean wchmm_cache_save(WCHMM_INFO *wchmm, JCONF_LM *lmconf, char *filename);
+boolean wchmm_cache_load(WCHMM_INFO *wchmm, JCONF_LM *lmconf, char *filename);
+
 /* wchmm_check.c */
 void wchmm_check_interactive(WCHMM_INFO *wchmm);
 void check_wchmm(WCHMM_INFO *wchmm);
@@ -154,6 +180,7 @@ void realbeam_free(Recog *recog);
 int mfcc_go(Recog *recog, int (*ad_check)(Recog *));
 
 /* word_align.c */
+boolean align_word_sequence(WORD_ID *words, short wnum, HTK_Param *param, int per_what, LOGPROB beam, SentenceAlign *align, HMMWork *wrk, BMALLOC_ARENA *arena, RecogProcess *r);
 void word_align(WORD_ID *words, short wnum, HTK_Param *param, SentenceAlign *align, RecogProcess *r);
 void phoneme_align(WORD_ID *words, short wnum, HTK_Param *param, SentenceAlign *align, RecogProcess *r);
 void state_align(WORD_ID *words, short wnum, HTK_Param *param, SentenceAlign *align, RecogProcess *r);
@@ -238,6 +265,9 @@ int wordgraph_sort_and_annotate_id(WordGraph **rootp, RecogProcess *r);
 void wordgraph_check_coherence(WordGraph *rootp, RecogProcess *r);
 void graph_forward_backward(WordGraph *root, RecogProcess *r);
 
+/* graph_rescore.c */
+void graph_rescore(WordGraph *root, HTK_Param *param, RecogProcess *r);
+
 /* default.c */
 void jconf_set_default_values(Jconf *j);
 void jconf_set_default_values_am(JCONF_AM *j);
@@ -303,6 +333,7 @@ boolean callback_delete(Recog *recog, int id);
 int adin_cut_callback_store_buffer(SP16 *now, int len, Recog *recog);
 SentenceAlign *result_align_new();
 void result_align_free(SentenceAlign *a);
+SentenceAlign *result_align_malloc(RecogProcess *r);
 void result_sentence_malloc(RecogProcess *r, int num);
 void result_sentence_free(RecogProcess *r);
 void clear_result(RecogProcess *r);
@@ -297,6 +297,18 @@ typedef struct __jconf_lm__ {
    * RL 3-gram in ARPA format (-nrl)
    */
   char *ngram_filename_rl_arpa;
+  /**
+   * Number of threads to parse ARPA N-gram (-arpathread)
+   */
+  int arpa_thread_num;
+  /**
+   * Binary N-gram to rescore word graph after the 2nd pass (-lmrescore)
+   */
+  char *ngram_filename_rescore;
+  /**
+   * Cache file of tree lexicon built for this LM (-wchmmcache)
+   */
+  char *wchmm_cache_filename;
   
   /**
    * DFA grammar file (-dfa, for single use)
@@ -484,6 +496,56 @@ typedef struct __jconf_search__ {
      */
 #endif
     LOGPROB score_pruning_width;
+
+    /**
+     * Adaptive beam control: target number of tokens to be generated
+     * per frame (-badapt).  0 disables token-based control.
+     */
+    int adaptive_beam_token;
+
+    /**
+     * Adaptive beam control: target CPU time per frame in msec
+     * (-badaptmsec).  0.0 disables time-based control.
+     */
+    float adaptive_beam_msec;
+
+    /**
+     * Lower bound of adapted beam width (-bmin).  -1 for auto
+     * (MINIMAL_BEAM_WIDTH, or the beam width if it is smaller).
+     */
+    int adaptive_beam_min;
+
+    /**
+     * Upper bound of adapted beam width (-bmax).  -1 for auto (the
+     * beam width given by "-b" or guessed from the dictionary).
+     */
+    int adaptive_beam_max;
+
+    /**
+     * Interval in frames to reclaim trellis words that are no longer
+     * reachable from the live tokens (-btgc).  0 disables.
+     */
+    int backtrellis_gc_interval;
+
+    /**
+     * Number of entries of LRU cache for 2-gram factoring values
+     * (-factorcache).  Used only when UNIGRAM_FACTORING is undefined.
+     */
+    int factor_cache_size;
+
+    /**
+     * Use 3-gram with two previous context words on the nodes where
+     * the word is determined on the 1st pass (-trigram1).  Requires a
+     * forward N-gram of N >= 3.
+     */
+    boolean trigram_lookahead;
+
+    /**
+     * On isolated word recognition, use flat word Viterbi instead of
+     * beam search when the number of active words is no more than
+     * this value (-flatword).  0 disables.
+     */
+    int flatword_maxnum;
     
 #if defined(WPAIR) && defined(WPAIR_KEEP_NLIMIT)
     /**
@@ -562,6 +624,57 @@ typedef struct __jconf_search__ {
      * at 2nd pass of DFA for speedup (-looktrellis)
      */
     boolean looktrellis_flag;
+
+    /**
+     * Number of threads to compute expanded words in parallel at
+     * 2nd pass (-nwthread).  1 disables parallel computation.
+     */
+    int nwthread_num;
+
+    /**
+     * Deadline of 2nd pass in msec from the end of input (-deadline).
+     * When reached, the search stops and outputs the best hypothesis
+     * found so far.  0 disables.
+     */
+    int deadline_msec;
+
+    /**
+     * Skip or reduce 2nd pass by confidence of 1st pass result
+     * (-pass2skip)
+     */
+    boolean adapt_by_confidence;
+    /**
+     * Skip 2nd pass when the score margin of 1st pass result is
+     * equal to or more than this value (-pass2skip)
+     */
+    LOGPROB adapt_skip_margin;
+    /**
+     * Reduce stack of 2nd pass when the score margin of 1st pass
+     * result is equal to or more than this value (-pass2skip)
+     */
+    LOGPROB adapt_reduce_margin;
+    /**
+     * Skip 2nd pass only for input not longer than this frames.
+     * 0 means no limit (-pass2skiplen)
+     */
+    int adapt_max_frame;
+
+    /**
+     * Number of entries of the cache for next word candidates on
+     * 2nd pass (-nwcache).  0 disables.
+     */
+    int nwcache_size;
+
+    /**
+     * Number of entries of the cache for N-gram probabilities on
+     * 2nd pass (-lmcache).  0 disables.
+     */
+    int lmcache_size;
+    /**
+     * TRUE to keep the N-gram probability cache across inputs
+     * (-lmcachekeep).  Cleared for each input if FALSE.
+     */
+    boolean lmcache_keep;
     
   } pass2;
 
@@ -621,6 +734,27 @@ typedef struct __jconf_search__ {
     boolean graphout_search_delay;
 #endif
 
+    /**
+     * GraphOut: LM weight for word graph rescoring (-lmrescorep)
+     */
+    LOGPROB rescore_weight;
+
+    /**
+     * GraphOut: word insertion penalty for word graph rescoring (-lmrescorep)
+     */
+    LOGPROB rescore_penalty;
+
+    /**
+     * GraphOut: maximum number of word histories to expand per graph word
+     * on word graph rescoring (-lmrescorehist), 0 for unlimited
+     */
+    int rescore_maxhist;
+
+    /**
+     * INTERNAL: TRUE if -lmrescorep specified
+     */
+    boolean rescore_lmp_specified;
+
   } graph;
   
   /**
@@ -640,6 +774,14 @@ typedef struct __jconf_search__ {
      */
     int sp_frame_duration;
 
+#ifndef SPSEGMENT_NAIST
+    /**
+     * Length threshold of a shorter pause to segment at when the words
+     * before the pause are already fixed on the 1st pass (0 = disabled)
+     */
+    int sp_stable_duration;
+#endif
+
     /**
      * name string of pause model
      * 
@@ -1107,6 +1249,13 @@ typedef struct __Jconf__ {
    */
   char *outprob_outfile;
 
+  /**
+   * Load N-grams in a separate thread in parallel with other models
+   * ("-parallelload")
+   * 
+   */
+  boolean parallel_load;
+
 } Jconf;
 
 enum {
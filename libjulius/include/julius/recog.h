@@ -128,6 +128,20 @@ typedef struct __FSBeam__ {
   LOGPROB score_pruning_threshold;///< Score threshold for score pruning
   int score_pruning_count;	  ///< Number of tokens pruned by score (debug)
 #endif
+  /* adaptive beam control */
+  /* beam_width (and score_pruning_width) hold the widths actually
+     applied at the current frame.  They can be read from
+     CALLBACK_EVENT_PASS1_FRAME callbacks via recog->process_list. */
+  int beam_width;         ///< Rank beam width applied at current frame
+#ifdef SCORE_PRUNING
+  LOGPROB score_pruning_width; ///< Score beam width applied at current frame
+#endif
+  boolean adapt_beam;     ///< TRUE if adaptive beam control is enabled
+  int adapt_beam_min;     ///< Lower bound of adapted rank beam width
+  int adapt_beam_max;     ///< Upper bound of adapted rank beam width
+  clock_t adapt_clock;    ///< CPU clock at beginning of current frame
+  double adapt_width_sum; ///< Sum of applied widths (for statistics)
+  int adapt_frame_num;    ///< Number of adapted frames (for statistics)
     
   /* Active token list */
   TOKENID *token;       ///< Active token list that holds currently assigned tokens for each tree node
@@ -137,6 +151,7 @@ typedef struct __FSBeam__ {
   int wordend_best_node;        ///< Node id of the best wordend nodes
   TRELLIS_ATOM *wordend_best_tre; ///< Trellis word corresponds to above
   WORD_ID wordend_best_last_cword;      ///< Last context-aware word of above
+  WORD_ID wordend_best_last_cword2;     ///< Context-aware word before above
 #endif
 
   int totalnodenum;     ///< Allocated number of nodes in @a token
@@ -169,6 +184,9 @@ typedef struct __FSBeam__ {
   char *pausemodelnames;        ///< pause model name string to detect segment
   char **pausemodel;            ///< each pause model name to detect segment
   int pausemodelnum;            ///< num of pausemodel
+  /* fast path for isolated word recognition */
+  boolean flatword;             ///< TRUE if flat word decoding is used for current input
+  FLATWORD fw;                  ///< Flat word HMMs and their Viterbi scores
 } FSBeam;
 
 
@@ -192,6 +210,98 @@ typedef struct __RealBeam__ {
 
 } RealBeam;
 
+#ifdef HAVE_PTHREAD
+/**
+ * Worker thread for next word expansion on the 2nd pass.  Each worker
+ * has its own work area for output probability computation, so that
+ * the workers need no lock while computing hypothesis scores.
+ * 
+ */
+typedef struct __NextWordWorker__ {
+  struct __NextWordExpand__ *e; ///< Work area of next word expansion
+  pthread_t thread;             ///< Thread
+  HMMWork wrk;                  ///< Work area for output probability computation
+} NextWordWorker;
+#endif
+
+/**
+ * Work area for next word expansion of a popped hypothesis on the 2nd
+ * pass.  The candidates are first collected here, then their hypotheses
+ * are generated by next_word(), in parallel when worker threads are
+ * available, and finally pushed to the stack in the collected order.
+ * The worker threads are started at the first input and kept until
+ * the recognition process is released.
+ * 
+ */
+typedef struct __NextWordExpand__ {
+  NODE **src;                   ///< Source hypothesis of each candidate
+  NODE **dst;                   ///< Hypothesis to be generated for each candidate
+  NEXTWORD **nword;             ///< Next word of each candidate
+  int num;                      ///< Number of candidates
+  int maxnum;                   ///< Allocated length of above
+#ifdef HAVE_PTHREAD
+  boolean started;              ///< TRUE when worker threads are started
+  int thread_num;               ///< Number of worker threads (not including main)
+  NextWordWorker *worker;       ///< Worker threads
+  pthread_mutex_t mutex;        ///< Lock for the job control variables below
+  pthread_cond_t cond_start;    ///< Signaled when new jobs are ready
+  pthread_cond_t cond_done;     ///< Signaled when all workers finished
+  int generation;               ///< Incremented for each set of jobs
+  int next;                     ///< Next candidate to be processed
+  int active;                   ///< Number of workers still processing
+  boolean quit;                 ///< TRUE to terminate workers
+  HTK_Param *param;             ///< Input parameter for current jobs
+  struct __recogprocess__ *r;   ///< Recognition process for current jobs
+#endif
+} NextWordExpand;
+
+/**
+ * Cached next word candidates for a word context and frame range on the
+ * 2nd pass.  Since the N-gram next word candidates of a hypothesis depend
+ * only on its last (N-1) words and the frames to look up the trellis,
+ * hypotheses sharing them can reuse the same candidates within an input.
+ * 
+ */
+typedef struct __NextWordCacheEntry__ {
+  boolean used;                 ///< TRUE if this entry holds valid data
+  WORD_ID *context;             ///< Context words, last word first (N-1)
+  short cnnum;                  ///< Number of valid words in @a context
+  boolean last_trans;           ///< TRUE if the last word is transparent
+  short tm;                     ///< Center frame of trellis lookup
+  short t_end;                  ///< Right frame boundary of trellis lookup
+  NEXTWORD *nw;                 ///< Next word candidates
+  int num;                      ///< Number of candidates in @a nw
+  int maxnum;                   ///< Allocated length of @a nw
+} NextWordCacheEntry;
+
+/**
+ * Direct-mapped cache of next word candidates on the 2nd pass ("-nwcache").
+ * 
+ */
+typedef struct __NextWordCache__ {
+  NextWordCacheEntry *entry;    ///< Cache entries
+  int size;                     ///< Number of entries, 0 if disabled
+  WORD_ID *context;             ///< Work area to build lookup key
+  int hit;                      ///< Number of lookups found in cache
+  int miss;                     ///< Number of lookups not found in cache
+} NextWordCache;
+
+/**
+ * Direct-mapped cache of N-gram probabilities on the 2nd pass
+ * ("-lmcache").  Keyed by the whole N-gram tuple, since the same
+ * tuples are looked up again and again for different hypotheses.
+ * 
+ */
+typedef struct __NgramProbCache__ {
+  WORD_ID *key;                 ///< Tuple words of entries, @a n words per entry
+  unsigned char *len;           ///< Tuple length of each entry, 0 if unused
+  LOGPROB *prob;                ///< N-gram probability of each entry
+  int size;                     ///< Number of entries, 0 if disabled
+  int n;                        ///< Maximum tuple length (N of the N-gram)
+  int hit;                      ///< Number of lookups found in cache
+  int miss;                     ///< Number of lookups not found in cache
+} NgramProbCache;
+
 /**
  * Work area for the 2nd pass
  * 
@@ -235,6 +345,8 @@ typedef struct __StackDecode__ {
 
   LOGPROB *wordtrellis[2]; ///< Buffer to compute viterbi path of a word
   LOGPROB *g;           ///< Buffer to hold source viterbi scores
+  short g_begin;        ///< Beginning frame of valid scores in @a g for v2
+  short g_end;          ///< End frame of valid scores in @a g for v2
   HMM_Logical **phmmseq;        ///< Phoneme sequence to be computed
   int phmmlen_max;              ///< Maximum length of @a phmmseq.
   boolean *has_sp;              ///< Mark which phoneme allow short pause for multi-path mode
@@ -247,6 +359,15 @@ typedef struct __StackDecode__ {
   WORD_ID *cnword;		///< Work area for N-gram computation
   WORD_ID *cnwordrev;		///< Work area for N-gram computation
 
+  NextWordExpand nwexp;         ///< Work area for next word expansion
+
+  double deadline_origin;	///< Time in msec from which the deadline (-deadline) is measured
+
+  int adapt_num[3];		///< Number of inputs processed in each 2nd pass mode (-pass2skip)
+
+  NextWordCache nwcache;	///< Cache of next word candidates (-nwcache)
+  NgramProbCache lmcache;	///< Cache of N-gram probabilities (-lmcache)
+
 } StackDecode;
 
 /**
@@ -476,6 +597,9 @@ typedef struct __Output__ {
 
   Sentence pass1;               ///< Recognition result on the 1st pass
 
+  int pass2_adapt;              ///< 2nd pass mode by 1st pass confidence (PASS2_ADAPT_*)
+  LOGPROB pass1_margin;         ///< Minimum score margin of words on the 1st pass best path
+
 } Output;  
 
 
@@ -804,6 +928,16 @@ typedef struct __process_lm__ {
    */
   NGRAM_INFO *ngram;
 
+  /**
+   * N-gram to rescore word graph after the 2nd pass (-lmrescore)
+   */
+  NGRAM_INFO *ngram_rescore;
+
+  /**
+   * Mapping from dictionary words to entries of @a ngram_rescore
+   */
+  WORD_ID *rescore_wton;
+
   /**
    * List of all loaded grammars (do not use with ngram)
    */
@@ -976,6 +1110,15 @@ typedef struct __recogprocess__ {
    */
   Output result;
 
+  /**
+   * Memory arena for per-input data: hypothesis nodes and next word
+   * lists of the 2nd pass, word graph entries, confusion network
+   * clusters and recognition results.  Released at once by
+   * clear_result() after the results are output.
+   * 
+   */
+  BMALLOC_ARENA arena;
+
   /**
    * graphout: will be set from value from jconf->graph.enabled
    * 
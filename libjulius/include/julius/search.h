@@ -95,6 +95,10 @@ typedef struct __node__ {
   short bestt;                  ///< Best connection frame of last word in word trellis
   short estimated_next_t;	///< Estimated next connection time frame (= beginning of last word on word trellis): next word hypothesis will be looked up near this frame on word trellis
   LOGPROB *g;			///< Current forward viterbi score in each frame
+#ifdef PASS2_STRICT_IWCD
+  short g_begin;		///< Beginning frame of valid scores in @a g (g[] is LOG_ZERO or less outside [g_begin..g_end])
+  short g_end;			///< End frame of valid scores in @a g
+#endif
   LOGPROB final_g;		///< Extra forward score on end of frame for multipath mode
   int state;			///< (dfa) Current DFA state ID
   TRELLIS_ATOM *tre;		///< Trellis word of last word
@@ -133,8 +137,28 @@ typedef struct __node__ {
 #ifdef USE_MBR
   float score_mbr; ///< MBR score
 #endif
+
+  int stackrank;		///< Order among hypotheses of the same score in the hypothesis stack (smaller is upper)
 } NODE;
 
+/**
+ * <JA>
+ * 2ѥβ⥹å. ɲμФȺǰκ
+ * п֤ǹԤ min-max ҡפȤݻ. 
+ * </JA>
+ * <EN>
+ * Hypothesis stack on the 2nd pass.  It is held as a min-max heap to
+ * pop the best hypothesis and drop the worst one in logarithmic time.
+ * </EN>
+ */
+typedef struct {
+  NODE **heap;			///< Min-max heap of hypotheses, the best at heap[0]
+  int num;			///< Number of hypotheses in the stack
+  int size;			///< Maximum number of hypotheses
+  int toprank;			///< Last rank given to a hypothesis put above the ones of same score
+  int bottomrank;		///< Last rank given to a hypothesis put below the ones of same score
+} HYPOSTACK;
+
 /*
   HOW SCORES ARE CALCULATED:
   
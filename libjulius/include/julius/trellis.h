@@ -31,6 +31,7 @@ typedef struct __trellis_atom__ {
   WORD_ID wid;			///< Word ID
   short begintime;		///< Beginning frame
   short endtime;		///< End frame
+  boolean gcmark;		///< Reachability mark for garbage collection on the 1st pass
 #ifdef WORD_GRAPH
   boolean within_wordgraph;	///< TRUE if within word graph
   boolean within_context;	///< TRUE if any of its following word was once survived in beam while search
@@ -48,6 +49,9 @@ typedef struct __backtrellis__ {
   int *num;			///< Number of trellis words at frame [t]
   TRELLIS_ATOM ***rw;		///< List to trellis words at frame [t]: rw[t][0..num[t]]
   TRELLIS_ATOM *list;		///< Temporary storage point used in 1st pass
+  TRELLIS_ATOM *pool;		///< Reclaimed atoms to be re-used by bt_new()
+  int listnum;			///< Number of atoms currently in @a list
+  int reclaimed;		///< Total number of atoms reclaimed by garbage collection
   BMALLOC_BASE *root;		///< memory allocation base for mybmalloc2()
 } BACKTRELLIS;
 
@@ -110,6 +110,32 @@ typedef enum {
 #endif
   
 /*************************************************************************/
+#ifndef UNIGRAM_FACTORING
+/**
+ * Entry of 2-gram factoring value cache, keyed by (last word, scid).
+ * 
+ */
+typedef struct {
+  WORD_ID lw;			///< Last N-gram word
+  int scid;			///< Successor list ID
+  LOGPROB prob;			///< Cached factoring value
+  int hnext;			///< Next entry in the same hash bucket
+  int lprev;			///< Previous (more recently used) entry
+  int lnext;			///< Next (less recently used) entry
+} FACTOR_CACHE_ENTRY;
+#endif
+
+/**
+ * Entry of 3-gram cache for the 1st pass, keyed by (w2, w1, w).
+ * 
+ */
+typedef struct {
+  WORD_ID w2;			///< Second last N-gram word
+  WORD_ID w1;			///< Last N-gram word
+  WORD_ID w;			///< Target N-gram word
+  LOGPROB prob;			///< Cached 3-gram probability (without in-class word probability)
+} TRIGRAM_CACHE_ENTRY;
+
 /**
  * LM cache for the 1st pass
  * 
@@ -145,6 +171,37 @@ typedef struct {
 #ifdef HASH_CACHE_IW
   WORD_ID *iw_lw_cache; ///< Maps hash cache id [x] to corresponding last word
 #endif
+#ifndef UNIGRAM_FACTORING
+/**
+ * @brief  Bounded LRU cache of 2-gram factoring values.
+ *
+ * On 2-gram factoring, both word-internal and cross-word factoring values
+ * are looked up by (last word, scid) in this cache instead of
+ * @a iw_sc_cache.  The number of entries is fixed at startup ("-factorcache"),
+ * and the least recently used entry is replaced when full.
+ */
+  FACTOR_CACHE_ENTRY *lru;	///< Cache entries
+  int *lru_hash;		///< Hash bucket -> first entry index, or -1
+  int lru_hashmask;		///< Number of hash buckets - 1
+  int lru_num;			///< Maximum number of entries
+  int lru_used;			///< Number of entries currently used
+  int lru_head;			///< Most recently used entry, or -1
+  int lru_tail;			///< Least recently used entry, or -1
+  unsigned long lru_hit;	///< Number of cache hits (statistics)
+  unsigned long lru_miss;	///< Number of cache misses (statistics)
+#endif
+/**
+ * @brief  Direct-mapped cache of 3-gram probabilities on the 1st pass.
+ *
+ * When "-trigram1" is specified, the LM score of the nodes where the word
+ * is determined is computed by 3-gram with two previous context words.
+ * The computed values are held here.
+ */
+  boolean trigram;		///< TRUE if 3-gram is applied on the 1st pass
+  TRIGRAM_CACHE_ENTRY *tri_cache; ///< Cache entries
+  int tri_cache_mask;		///< Number of cache entries - 1
+  unsigned long tri_hit;	///< Number of cache hits (statistics)
+  unsigned long tri_miss;	///< Number of cache misses (statistics)
   
 } LM_PROB_CACHE;
 
@@ -81,6 +81,9 @@ bt_init(BACKTRELLIS *bt)
   bt->num  = NULL;
   bt->rw   = NULL;
   bt->list = NULL;
+  bt->pool = NULL;
+  bt->listnum = 0;
+  bt->reclaimed = 0;
   bt->root = NULL;
 }
 
@@ -110,6 +113,9 @@ bt_prepare(BACKTRELLIS *bt)
   bt->num = NULL;
   bt->rw = NULL;
   bt->list = NULL;
+  bt->pool = NULL;
+  bt->listnum = 0;
+  bt->reclaimed = 0;
   bt->root = NULL;
 }  
 
@@ -136,10 +142,12 @@ bt_free(BACKTRELLIS *bt)
 
 /** 
  * <EN>
- * Allocate a new trellis word atom.
+ * Allocate a new trellis word atom.  Atoms reclaimed by bt_sweep()
+ * will be re-used first.
  * </EN>
  * <JA>
- * ȥꥹñ򿷤˳դ. 
+ * ȥꥹñ򿷤˳դ. bt_sweep() ǲ줿ΰ褬
+ * ФѤ. 
  * </JA>
  * 
  * @param bt [out] pointer to the word trellis structure.
@@ -155,7 +163,12 @@ bt_new(BACKTRELLIS *bt)
 {
   TRELLIS_ATOM *new;
 
-  new = (TRELLIS_ATOM *)mybmalloc2(sizeof(TRELLIS_ATOM), &(bt->root));
+  if (bt->pool != NULL) {
+    new = bt->pool;
+    bt->pool = new->next;
+  } else {
+    new = (TRELLIS_ATOM *)mybmalloc2(sizeof(TRELLIS_ATOM), &(bt->root));
+  }
   return new;
 }
 
@@ -193,8 +206,71 @@ bt_store(BACKTRELLIS *bt, TRELLIS_ATOM *tatom)
   tatom->within_context = FALSE;
   tatom->within_wordgraph = FALSE;
 #endif
+  tatom->gcmark = FALSE;
   tatom->next = bt->list;
   bt->list = tatom;
+  bt->listnum++;
+}
+
+/** 
+ * <JA>
+ * @brief  1ѥˡãǽȤʤäȥꥹñ. 
+ *
+ * ƤӽФ¦¸Υȡ󤫤 last_tre 򤿤ɤäãǽ
+ * ȥꥹñ gcmark ΩƤƤ. δؿϥޡ̵
+ * ȥꥹñ @a list 鳰ƺѥסᤷĤäñ
+ * ޡõ. ü郎 @a keeptime ʹߤñ
+ * ޡ˴ؤ餺ݻ. @a list λֽݤ. 
+ * 
+ * @param bt [i/o] ñȥꥹ¤
+ * @param keeptime [in] λʹߤ˽ñϾݻ
+ * 
+ * @return ȥꥹñο
+ * </JA>
+ * <EN>
+ * @brief  Reclaim unreachable trellis words while the 1st pass.
+ *
+ * The caller should set gcmark on every trellis word that is reachable
+ * from the live tokens by tracing last_tre.  This function removes the
+ * unmarked atoms from @a list and returns them to the pool for re-use,
+ * and clears the marks of the remaining ones.  Atoms whose end frame is
+ * @a keeptime or later are always kept.  The time order of @a list
+ * is preserved.
+ * 
+ * @param bt [i/o] word trellis structure
+ * @param keeptime [in] atoms ending at this frame or later are kept
+ * 
+ * @return the number of reclaimed atoms.
+ * </EN>
+ *
+ * @callergraph
+ * @callgraph
+ * 
+ */
+int
+bt_sweep(BACKTRELLIS *bt, int keeptime)
+{
+  TRELLIS_ATOM *tre, *next, *prev;
+  int n;
+
+  n = 0;
+  prev = NULL;
+  for (tre = bt->list; tre; tre = next) {
+    next = tre->next;
+    if (tre->gcmark || tre->endtime >= keeptime) {
+      tre->gcmark = FALSE;
+      prev = tre;
+    } else {
+      if (prev) prev->next = next; else bt->list = next;
+      tre->next = bt->pool;
+      bt->pool = tre;
+      n++;
+    }
+  }
+  bt->listnum -= n;
+  bt->reclaimed += n;
+
+  return n;
 }
 
 /** 
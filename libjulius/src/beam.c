@@ -332,6 +332,52 @@ trace_backptr(WORD_ID wordseq_rt[MAXSEQNUM], int *rt_wordlen, TRELLIS_ATOM *atom
   return(langscore);
 }
 
+/** 
+ * <JA>
+ * ѥγñˤĤơƱե졼ǽ¾ΥȥꥹñȤ
+ * ᡤκǾ֤ͤ. 2ѥξάȽ (-pass2skip) 
+ * Ѥ. 
+ * 
+ * @param atom [in] ѥκǸΥȥꥹñ
+ * @param bt [in] ñȥꥹ
+ * 
+ * @return ǾΥޡ. оݤ̵ -LOG_ZERO.
+ * </JA>
+ * <EN>
+ * For each word on the best path, compute the score difference from the
+ * other trellis words that end at the same frame, and return the
+ * minimum.  Used to decide skipping of the 2nd pass (-pass2skip).
+ * 
+ * @param atom [in] the last trellis word of the best path
+ * @param bt [in] word trellis
+ * 
+ * @return the minimum score margin, or -LOG_ZERO if no competitor exists.
+ * </EN>
+ */
+static LOGPROB
+path_score_margin(TRELLIS_ATOM *atom, BACKTRELLIS *bt)
+{
+  TRELLIS_ATOM *tre, *tmp;
+  LOGPROB margin, maxscore;
+  int i, t;
+
+  margin = -LOG_ZERO;
+  for (tre = atom; tre != NULL && tre->wid != WORD_INVALID; tre = tre->last_tre) {
+    t = tre->endtime;
+    maxscore = LOG_ZERO;
+    for (i=0;i<bt->num[t];i++) {
+      tmp = bt->rw[t][i];
+      if (tmp == tre) continue;
+      if (maxscore < tmp->backscore) maxscore = tmp->backscore;
+    }
+    if (maxscore > LOG_ZERO && margin > tre->backscore - maxscore) {
+      margin = tre->backscore - maxscore;
+    }
+    if (tre->begintime <= 0) break;
+  }
+  return(margin);
+}
+
 /** 
  * <JA>
  * @brief  裱ѥǧ̤ǧ̤Ƚꤷñ򸫤Ĥ. 
@@ -511,6 +557,12 @@ find_1pass_result(int framelen, RecogProcess *r)
   r->pass1_wnum = wordlen;
   r->pass1_score = best->backscore;
 
+  /* 2ѥξάȽѤ˥ޡ */
+  /* compute score margin for skipping 2nd pass */
+  if (r->config->pass2.adapt_by_confidence) {
+    r->result.pass1_margin = path_score_margin(best, backtrellis);
+  }
+
 #ifdef WORD_GRAPH
   /* ñȥꥹ顤ƥ */
   /* generate word graph from the word trellis */
@@ -1654,6 +1706,7 @@ init_nodescore(HTK_Param *param, RecogProcess *r)
     /* set initial word history */
     new->last_tre = &(d->bos);
     new->last_cword = d->bos.wid;
+    new->last_cword2 = WORD_INVALID;
     if (wchmm->hmminfo->multipath) {
       /* set initial score using the initial LM score */
       new->score = new->last_lscore;
@@ -1828,6 +1881,12 @@ get_back_trellis_init(HTK_Param *param,	RecogProcess *r)
   d->wpair_keep_nlimit = r->config->pass1.wpair_keep_nlimit;
 #endif
 
+  /* äξñǧǤʿóñHMMõԤ */
+  /* on isolated word recognition with small vocabulary, perform
+     full search on flat word HMMs instead of beam search */
+  d->flatword = flatword_init(param, r);
+  if (d->flatword) return TRUE;
+
   /* ꥢ */
   /* malloc work area */
   /* Ѥȡ = viterbiȤʤָο
@@ -1843,6 +1902,32 @@ get_back_trellis_init(HTK_Param *param,	RecogProcess *r)
     malloc_nodes(d, wchmm->n, r->trellis_beam_width * 2 + wchmm->startnum);
   }
   prepare_nodes(d, r->trellis_beam_width);
+
+  /* Ŭӡν: ȯäȤ˻ӡ鳫 */
+  /* initialize adaptive beam control: start from the given width */
+  d->beam_width = r->trellis_beam_width;
+#ifdef SCORE_PRUNING
+  d->score_pruning_width = r->config->pass1.score_pruning_width;
+#endif
+  d->adapt_beam = (r->config->pass1.adaptive_beam_token > 0 || r->config->pass1.adaptive_beam_msec > 0.0) ? TRUE : FALSE;
+  if (d->adapt_beam) {
+    if (r->config->pass1.adaptive_beam_max > 0) {
+      d->adapt_beam_max = r->config->pass1.adaptive_beam_max;
+    } else {
+      d->adapt_beam_max = r->trellis_beam_width;
+    }
+    if (d->adapt_beam_max > wchmm->n) d->adapt_beam_max = wchmm->n;
+    if (r->config->pass1.adaptive_beam_min > 0) {
+      d->adapt_beam_min = r->config->pass1.adaptive_beam_min;
+    } else {
+      d->adapt_beam_min = MINIMAL_BEAM_WIDTH;
+    }
+    if (d->adapt_beam_min > d->adapt_beam_max) d->adapt_beam_min = d->adapt_beam_max;
+    if (d->beam_width > d->adapt_beam_max) d->beam_width = d->adapt_beam_max;
+    if (d->beam_width < d->adapt_beam_min) d->beam_width = d->adapt_beam_min;
+    d->adapt_width_sum = 0.0;
+    d->adapt_frame_num = 0;
+  }
   
   /*  nodescore[tn] ˥å */
   /* set initial score to nodescore[tn] */
@@ -1851,7 +1936,7 @@ get_back_trellis_init(HTK_Param *param,	RecogProcess *r)
     return FALSE;
   }
 
-  sort_token_no_order(d, r->trellis_beam_width, &(d->n_start), &(d->n_end));
+  sort_token_no_order(d, d->beam_width, &(d->n_start), &(d->n_end));
 
   /* ϤԤʤΥ󥿡Х׻ */
   /* set interval frame for progout */
@@ -1908,11 +1993,12 @@ get_back_trellis_init(HTK_Param *param,	RecogProcess *r)
  * @param next_score [in] score when transmitted to the next node
  * @param last_tre [in] previous word context for the next node
  * @param last_cword [in] previous context-valid word for the next node
+ * @param last_cword2 [in] context-valid word before @a last_cword
  * @param last_lscore [in] LM score to be propagated
  * 
  */
 static void
-propagate_token(FSBeam *d, int next_node, LOGPROB next_score, TRELLIS_ATOM *last_tre, WORD_ID last_cword, LOGPROB last_lscore)
+propagate_token(FSBeam *d, int next_node, LOGPROB next_score, TRELLIS_ATOM *last_tre, WORD_ID last_cword, WORD_ID last_cword2, LOGPROB last_lscore)
 {
   TOKEN2 *tknext;
   TOKENID tknextid;
@@ -1929,6 +2015,7 @@ propagate_token(FSBeam *d, int next_node, LOGPROB next_score, TRELLIS_ATOM *last
       /* overwrite the content of existing destination token: not create a new token */
       tknext->last_tre = last_tre; /* propagate last word info */
       tknext->last_cword = last_cword; /* propagate last context word info */
+      tknext->last_cword2 = last_cword2;
       tknext->last_lscore = last_lscore; /* set new LM score */
       tknext->score = next_score; /* set new score */
     }
@@ -1939,6 +2026,7 @@ propagate_token(FSBeam *d, int next_node, LOGPROB next_score, TRELLIS_ATOM *last
     tknext = &(d->tlist[d->tn][tknextid]);
     tknext->last_tre = last_tre; /* propagate last word info */
     tknext->last_cword = last_cword; /* propagate last context word info */
+    tknext->last_cword2 = last_cword2;
     tknext->last_lscore = last_lscore;
     tknext->score = next_score; /* set new score */
     node_assign_token(d, next_node, tknextid); /* assign this new token to the next node */
@@ -2026,15 +2114,22 @@ beam_intra_word_core(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, int j, int n
 	  /* LM value should be update at this transition */
 	  /* N-gramΨfactoring ͤ׻ */
 	  /* compute new factoring value from N-gram probabilities */
+	  if (wchmm->lmcache.trigram) {
+	    /* ñ줬ꤹΡɤǤ 3-gram Ѥ */
+	    /* use 3-gram where the word is determined */
+	    ngram_score_cache = max_successor_prob_trigram(wchmm, tk->last_cword2, tk->last_cword, next_node);
+	  } else {
+	    ngram_score_cache = max_successor_prob(wchmm, tk->last_cword, next_node);
+	  }
 #ifdef FIX_PENALTY
 	  /* if at the beginning of sentence, not add lm_penalty */
 	  if (tk->last_cword == WORD_INVALID) {
-	    ngram_score_cache = max_successor_prob(wchmm, tk->last_cword, next_node) * d->lm_weight;
+	    ngram_score_cache = ngram_score_cache * d->lm_weight;
 	  } else {
-	    ngram_score_cache = max_successor_prob(wchmm, tk->last_cword, next_node) * d->lm_weight + d->lm_penalty;
+	    ngram_score_cache = ngram_score_cache * d->lm_weight + d->lm_penalty;
 	  }
 #else
-	  ngram_score_cache = max_successor_prob(wchmm, tk->last_cword, next_node) * d->lm_weight + d->lm_penalty;
+	  ngram_score_cache = ngram_score_cache * d->lm_weight + d->lm_penalty;
 #endif
 	  /* ι: tk->last_lscore ñǤκǸfactoringͤ
 	     äƤΤ, 򥹥ƥꥻåȤ, ʥ
@@ -2085,7 +2180,7 @@ beam_intra_word_core(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, int j, int n
   /****************************************/
   
   if (ngram_score_cache == LOG_ZERO) ngram_score_cache = tk->last_lscore;
-  propagate_token(d, next_node, tmpsum, tk->last_tre, tk->last_cword, ngram_score_cache);
+  propagate_token(d, next_node, tmpsum, tk->last_tre, tk->last_cword, tk->last_cword2, ngram_score_cache);
   
   if (d->expanded) {
     /* if work area has been expanded at 'create_token()' above,
@@ -2241,20 +2336,21 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
   TOKEN2 *tk;
   int sword;
   int node, next_node;
-  LOGPROB *iwparray; ///< Temporal pointer to hold inter-word cache array
   int stid;
 #ifdef UNIGRAM_FACTORING
+  LOGPROB *iwparray; ///< Temporal pointer to hold inter-word cache array
   int isoid; ///< Temporal work to hold isolated node
 #endif
   LOGPROB tmpprob, tmpsum, ngram_score_cache;
   int k;
-  WORD_ID last_word;
+  WORD_ID last_word, last_word2;
 
   tk = *tk_ret;
  
   node = tk->node;
   sword = wchmm->stend[node];
   last_word = wchmm->winfo->is_transparent[sword] ? tk->last_cword : sword;
+  last_word2 = wchmm->winfo->is_transparent[sword] ? tk->last_cword2 : tk->last_cword;
 
   if (wchmm->lmtype == LM_PROB) {
 
@@ -2276,10 +2372,12 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
       d->wordend_best_node = node;
       d->wordend_best_tre = tre;
       d->wordend_best_last_cword = tk->last_cword;
+      d->wordend_best_last_cword2 = tk->last_cword2;
     }
 #endif
 #endif
     
+#ifdef UNIGRAM_FACTORING
     /* N-gramˤƤϾñ³θɬפ뤿ᡤ
        ñ֤θΨͤ򤹤٤Ʒ׻Ƥ. 
        å max_successor_prob_iw() ǹθ. */
@@ -2291,6 +2389,7 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
     } else {
       iwparray = max_successor_prob_iw(wchmm, sword);
     }
+#endif
   }
 
   /* ٤ƤñüΡɤФưʲ¹ */
@@ -2351,10 +2450,22 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
       /* the shared nodes will be computed afterward, so just skip them
 	 here */
       if (isoid == -1) continue;
-      tmpprob = iwparray[isoid];
+      if (wchmm->lmcache.trigram) {
+	tmpprob = max_successor_prob_trigram(wchmm, last_word2, last_word, next_node);
+      } else {
+	tmpprob = iwparray[isoid];
+      }
 #endif /* ~WPAIR */
 #else  /* ~UNIGRAM_FACTORING */
-      tmpprob = iwparray[stid];
+      /* 2-gram factoring: ñƬΡɤȤ˷׻ (å
+	 max_successor_prob() ǹθ) */
+      /* 2-gram factoring: compute for each word head node (cache is
+	 considered in max_successor_prob()) */
+      if (wchmm->lmcache.trigram) {
+	tmpprob = max_successor_prob_trigram(wchmm, last_word2, last_word, next_node);
+      } else {
+	tmpprob = max_successor_prob(wchmm, last_word, next_node);
+      }
 #endif
     }
 
@@ -2420,7 +2531,7 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
     if (wchmm->hmminfo->multipath) {
       /* since top node has no ouput, we should go one more step further */
       if (wchmm->self_a[next_node] != LOG_ZERO) {
-	propagate_token(d, next_node, tmpsum + wchmm->self_a[next_node], tre, last_word, ngram_score_cache);
+	propagate_token(d, next_node, tmpsum + wchmm->self_a[next_node], tre, last_word, last_word2, ngram_score_cache);
 	if (d->expanded) {
 	  /* if work area has been expanded at 'create_token()' above,
 	     the inside 'realloc()' will destroy the pointers.
@@ -2430,7 +2541,7 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
 	}
       }
       if (wchmm->next_a[next_node] != LOG_ZERO) {
-	propagate_token(d, next_node+1, tmpsum + wchmm->next_a[next_node], tre, last_word, ngram_score_cache);
+	propagate_token(d, next_node+1, tmpsum + wchmm->next_a[next_node], tre, last_word, last_word2, ngram_score_cache);
 	if (d->expanded) {
 	  /* if work area has been expanded at 'create_token()' above,
 	     the inside 'realloc()' will destroy the pointers.
@@ -2441,7 +2552,7 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
       }
       for(ac=wchmm->ac[next_node];ac;ac=ac->next) {
 	for(k=0;k<ac->n;k++) {
-	  propagate_token(d, ac->arc[k], tmpsum + ac->a[k], tre, last_word, ngram_score_cache);
+	  propagate_token(d, ac->arc[k], tmpsum + ac->a[k], tre, last_word, last_word2, ngram_score_cache);
 	  if (d->expanded) {
 	    /* if work area has been expanded at 'create_token()' above,
 	       the inside 'realloc()' will destroy the pointers.
@@ -2452,7 +2563,7 @@ beam_inter_word(WCHMM_INFO *wchmm, FSBeam *d, TOKEN2 **tk_ret, TRELLIS_ATOM *tre
 	}
       }
     } else {
-      propagate_token(d, next_node, tmpsum, tre, last_word, ngram_score_cache);
+      propagate_token(d, next_node, tmpsum, tre, last_word, last_word2, ngram_score_cache);
       if (d->expanded) {
 	/* if work area has been expanded at 'create_token()' above,
 	   the inside 'realloc()' will destroy the pointers.
@@ -2507,11 +2618,12 @@ beam_inter_word_factoring(WCHMM_INFO *wchmm, FSBeam *d)
   LOGPROB tmpprob, tmpsum, ngram_score_cache;
   A_CELL2 *ac;
   int j;
-  WORD_ID last_word;
+  WORD_ID last_word, last_word2;
 
   node = d->wordend_best_node;
   sword = wchmm->stend[node];
   last_word = wchmm->winfo->is_transparent[sword] ? d->wordend_best_last_cword : sword;
+  last_word2 = wchmm->winfo->is_transparent[sword] ? d->wordend_best_last_cword2 : d->wordend_best_last_cword;
 
   for (stid = wchmm->startnum - 1; stid >= 0; stid--) {
     next_node = wchmm->startnode[stid];
@@ -2538,20 +2650,20 @@ beam_inter_word_factoring(WCHMM_INFO *wchmm, FSBeam *d)
     if (wchmm->hmminfo->multipath) {
       /* since top node has no ouput, we should go one more step further */
       if (wchmm->self_a[next_node] != LOG_ZERO) {
-	propagate_token(d, next_node, tmpsum + wchmm->self_a[next_node], d->wordend_best_tre, last_word, ngram_score_cache);
+	propagate_token(d, next_node, tmpsum + wchmm->self_a[next_node], d->wordend_best_tre, last_word, last_word2, ngram_score_cache);
 	if (d->expanded) {
 	  d->expanded = FALSE;
 	}
       }
       if (wchmm->next_a[next_node] != LOG_ZERO) {
-	propagate_token(d, next_node+1, tmpsum + wchmm->next_a[next_node], d->wordend_best_tre, last_word, ngram_score_cache);
+	propagate_token(d, next_node+1, tmpsum + wchmm->next_a[next_node], d->wordend_best_tre, last_word, last_word2, ngram_score_cache);
 	if (d->expanded) {
 	  d->expanded = FALSE;
 	}
       }
       for(ac=wchmm->ac[next_node];ac;ac=ac->next) {
 	for(j=0;j<ac->n;j++) {
-	  propagate_token(d, ac->arc[j], tmpsum + ac->a[j], d->wordend_best_tre, last_word, ngram_score_cache);
+	  propagate_token(d, ac->arc[j], tmpsum + ac->a[j], d->wordend_best_tre, last_word, last_word2, ngram_score_cache);
 	  if (d->expanded) {
 	    d->expanded = FALSE;
 	  }
@@ -2559,7 +2671,7 @@ beam_inter_word_factoring(WCHMM_INFO *wchmm, FSBeam *d)
       }
       
     } else {
-      propagate_token(d, next_node, tmpsum, d->wordend_best_tre, last_word, ngram_score_cache);
+      propagate_token(d, next_node, tmpsum, d->wordend_best_tre, last_word, last_word2, ngram_score_cache);
       if (d->expanded) {
 	d->expanded = FALSE;
       }
@@ -2570,6 +2682,112 @@ beam_inter_word_factoring(WCHMM_INFO *wchmm, FSBeam *d)
 
 #endif /* UNIGRAM_FACTORING */
 
+#ifndef WORD_GRAPH
+/** 
+ * <JA>
+ * @brief  ñȥꥹΥ١쥯
+ *
+ * ӡ¸Ƥȡ󤫤 last_tre 򤿤ɤäãǽ
+ * ȥꥹñ˥ޡդãǽȤʤäñ bt_sweep() 
+ * Ѥ. ľե졼 (@a t - 1) ˽üñ
+ * Ϥ䥻ȸФǻȤ뤿ݻ. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * @param t [in] ߤΥե졼
+ * </JA>
+ * <EN>
+ * @brief  Garbage collection of the word trellis
+ *
+ * Mark all trellis words reachable from the live tokens in the beam by
+ * tracing last_tre, and reclaim the unreachable ones by bt_sweep()
+ * for re-use.  Words ending at the last frame (@a t - 1) are always kept,
+ * since they are referred for progressive output and segmentation.
+ * 
+ * @param r [i/o] recognition process instance
+ * @param t [in] current frame
+ * </EN>
+ */
+static void
+backtrellis_gc(RecogProcess *r, int t)
+{
+  FSBeam *d;
+  TRELLIS_ATOM *tre;
+  int j;
+
+  d = &(r->pass1);
+  for (j = d->n_start; j <= d->n_end; j++) {
+    for (tre = d->tlist[d->tn][d->tindex[d->tn][j]].last_tre; tre && tre != &(d->bos) && tre->gcmark == FALSE; tre = tre->last_tre) {
+      tre->gcmark = TRUE;
+    }
+  }
+  bt_sweep(r->backtrellis, t - 1);
+}
+#endif /* WORD_GRAPH */
+
+/** 
+ * <JA>
+ * @brief  Ŭӡ桧ե졼Υӡꤹ. 
+ *
+ * ե졼줿ȡӸե졼νפ
+ * CPU֤ɸ("-badapt", "-badaptmsec")ӤΥȤ
+ * Ѥӡ򹹿. ɸĶľ㤷ƶᡤ
+ * ä ADAPTIVE_BEAM_GROW_RATE γǽ˹. 
+ * ӡबͭʾϥ󥯥ӡƱΨǿ̤. 
+ * 
+ * @param d [i/o] 1ѥõѥꥢ
+ * @param r [in] ǧ󥹥
+ * @param tnum [in] ե졼줿ȡ
+ * </JA>
+ * <EN>
+ * @brief  Adaptive beam control: decide beam width for current frame.
+ *
+ * The number of tokens generated at current frame and the CPU time
+ * spent for the frame are compared with the targets ("-badapt",
+ * "-badaptmsec"), and the beam width to be applied at the next sort
+ * is updated.  The width is narrowed at once in proportion when the
+ * budget is exceeded, and widened gradually at ADAPTIVE_BEAM_GROW_RATE
+ * otherwise.  The score beam, if enabled, is scaled at the same rate.
+ * 
+ * @param d [i/o] work area for the 1st pass
+ * @param r [in] recognition process instance
+ * @param tnum [in] number of tokens generated at current frame
+ * </EN>
+ */
+static void
+adapt_beam_width(FSBeam *d, RecogProcess *r, int tnum)
+{
+  float rate, trate;
+  float msec;
+  int width;
+
+  rate = 1.0 + ADAPTIVE_BEAM_GROW_RATE;
+  if (r->config->pass1.adaptive_beam_token > 0 && tnum > 0) {
+    trate = (float)r->config->pass1.adaptive_beam_token / (float)tnum;
+    if (rate > trate) rate = trate;
+  }
+  if (r->config->pass1.adaptive_beam_msec > 0.0) {
+    msec = (float)(clock() - d->adapt_clock) * 1000.0 / (float)CLOCKS_PER_SEC;
+    if (msec > 0.0) {
+      trate = r->config->pass1.adaptive_beam_msec / msec;
+      if (rate > trate) rate = trate;
+    }
+  }
+
+  width = (int)((float)d->beam_width * rate);
+  if (rate > 1.0 && width == d->beam_width) width++;
+  if (width < d->adapt_beam_min) width = d->adapt_beam_min;
+  if (width > d->adapt_beam_max) width = d->adapt_beam_max;
+  d->beam_width = width;
+
+#ifdef SCORE_PRUNING
+  if (r->config->pass1.score_pruning_width >= 0.0) {
+    d->score_pruning_width = r->config->pass1.score_pruning_width * (LOGPROB)width / (LOGPROB)r->trellis_beam_width;
+  }
+#endif
+
+  d->adapt_width_sum += width;
+  d->adapt_frame_num++;
+}
 
 /** 
  * <JA>
@@ -2638,6 +2856,10 @@ get_back_trellis_proceed(int t, HTK_Param *param, RecogProcess *r, boolean final
   lmtype = r->lmtype;
   lmvar  = r->lmvar;
 
+  if (d->flatword) return(flatword_proceed(t, param, r));
+
+  if (d->adapt_beam) d->adapt_clock = clock();
+
   /*********************/
   /* 1.          */
   /*    initialization */
@@ -2724,7 +2946,7 @@ get_back_trellis_proceed(int t, HTK_Param *param, RecogProcess *r, boolean final
     /* 2.2. ǥȡ򥽡Ȥӡʬξ̤ */
     /*    sort tokens by score up to beam width            */
     /*******************************************************/
-    sort_token_no_order(d, r->trellis_beam_width, &(d->n_start), &(d->n_end));
+    sort_token_no_order(d, d->beam_width, &(d->n_start), &(d->n_end));
   
     /*************************/
     /* 2.3. ñViterbi׻  */
@@ -2903,9 +3125,12 @@ get_back_trellis_proceed(int t, HTK_Param *param, RecogProcess *r, boolean final
 #endif
     }
   }
+  /* Ŭӡ: Υե졼Υӡ */
+  /* adaptive beam control: decide beam width for this frame */
+  if (d->adapt_beam) adapt_beam_width(d, r, d->tnum[tn]);
 #ifdef SCORE_PRUNING
-  if (r->config->pass1.score_pruning_width >= 0.0) {
-    d->score_pruning_threshold = d->score_pruning_max - r->config->pass1.score_pruning_width;
+  if (d->score_pruning_width >= 0.0) {
+    d->score_pruning_threshold = d->score_pruning_max - d->score_pruning_width;
     //printf("width=%f, tnum=%d\n", d->score_pruning_max - minscore, d->tnum[tn]);
   } else {
     // disable score pruning
@@ -2922,7 +3147,7 @@ get_back_trellis_proceed(int t, HTK_Param *param, RecogProcess *r, boolean final
 
   /* ҡץȤѤƤʤΥΡɽ礫(bwidth)ĤƤ */
   /* (νɬפʤ) */
-  sort_token_no_order(d, r->trellis_beam_width, &(d->n_start), &(d->n_end));
+  sort_token_no_order(d, d->beam_width, &(d->n_start), &(d->n_end));
   /***************/
   /* 5. λ */
   /*    finalize */
@@ -2960,6 +3185,14 @@ get_back_trellis_proceed(int t, HTK_Param *param, RecogProcess *r, boolean final
 #ifdef SPSEGMENT_NAIST
   }
 #endif
+
+#ifndef WORD_GRAPH
+  /* ãǽȤʤäȥꥹñֳ֤ǲ */
+  /* reclaim unreachable trellis words at every given interval */
+  if (r->config->pass1.backtrellis_gc_interval > 0 && t % r->config->pass1.backtrellis_gc_interval == 0) {
+    backtrellis_gc(r, t);
+  }
+#endif
     
   /* ӡΡɿ 0 ˤʤäƤޤä顤λ */
   if (d->tnum[tn] == 0) {
@@ -3012,6 +3245,11 @@ get_back_trellis_end(HTK_Param *param, RecogProcess *r)
   wchmm = r->wchmm;
   d = &(r->pass1);
 
+  if (d->flatword) {
+    flatword_end(param, r);
+    return;
+  }
+
   /* Ǹ˥ӡ˻Ĥäñ콪üȡ */
   /* process the last wordend tokens */
 
@@ -3041,6 +3279,20 @@ get_back_trellis_end(HTK_Param *param, RecogProcess *r)
 #ifdef SCORE_PRUNING
   if (debug2_flag) jlog("STAT: %d tokens pruned by score beam\n", d->score_pruning_count);
 #endif
+#ifndef UNIGRAM_FACTORING
+  if (debug2_flag && r->lmtype == LM_PROB) {
+    jlog("STAT: factoring LRU cache: %lu hit, %lu miss, %d / %d used\n", wchmm->lmcache.lru_hit, wchmm->lmcache.lru_miss, wchmm->lmcache.lru_used, wchmm->lmcache.lru_num);
+  }
+#endif
+  if (debug2_flag && r->lmtype == LM_PROB && wchmm->lmcache.trigram) {
+    jlog("STAT: 1st pass 3-gram cache: %lu hit, %lu miss\n", wchmm->lmcache.tri_hit, wchmm->lmcache.tri_miss);
+  }
+  if (r->backtrellis->reclaimed > 0) {
+    if (verbose_flag) jlog("STAT: %02d %s: %d trellis words reclaimed, %d kept\n", r->config->id, r->config->name, r->backtrellis->reclaimed, r->backtrellis->listnum);
+  }
+  if (d->adapt_beam && d->adapt_frame_num > 0) {
+    if (verbose_flag) jlog("STAT: %02d %s: adaptive beam: average width %d (range %d - %d)\n", r->config->id, r->config->name, (int)(d->adapt_width_sum / d->adapt_frame_num), d->adapt_beam_min, d->adapt_beam_max);
+  }
     
 }
 
@@ -3132,6 +3384,7 @@ void
 fsbeam_free(FSBeam *d)
 {
   free_nodes(d);
+  flatword_free(&(d->fw));
   if (d->pausemodelnames != NULL) {
     free(d->pausemodelnames);
     free(d->pausemodel);
@@ -214,13 +214,15 @@ graph_free_order(RecogProcess *r)
 /**
  * Create a new cluster holder.
  * 
+ * @param arena [i/o] memory arena to hold the cluster holder
+ * 
  * @return the newly allocated cluster holder.
  */
 static CN_CLUSTER *
-cn_new()
+cn_new(BMALLOC_ARENA *arena)
 {
   CN_CLUSTER *new;
-  new = (CN_CLUSTER *)mymalloc(sizeof(CN_CLUSTER));
+  new = (CN_CLUSTER *)mybarena_malloc(sizeof(CN_CLUSTER), arena);
   new->wg = (WordGraph **)mymalloc(sizeof(WordGraph *) * CN_CLUSTER_WG_STEP);
   new->wgnum_alloc = CN_CLUSTER_WG_STEP;
   new->wgnum = 0;
@@ -231,7 +233,8 @@ cn_new()
 }
 
 /**
- * Free a cluster holder
+ * Free a cluster holder.  The holder itself will be released with the
+ * memory arena.
  * 
  * @param c [out] a cluster holder to be released.
  * </EN>
@@ -242,7 +245,6 @@ cn_free(CN_CLUSTER *c)
   free(c->wg);
   if (c->words) free(c->words);
   if (c->pp) free(c->pp);
-  free(c);
 }
 
 /** 
@@ -710,7 +712,7 @@ confnet_create(WordGraph *root, RecogProcess *r)
   croot = NULL;
   wg_totalnum = 0;
   for(wg=root;wg;wg=wg->next) {
-    c = cn_new();
+    c = cn_new(&(r->arena));
     cn_add_wg(c, wg);
     c->next = croot;
     croot = c;
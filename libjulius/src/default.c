@@ -104,6 +104,7 @@ jconf_set_default_values(Jconf *j)
   j->optsection				= JCONF_OPT_DEFAULT;
   j->optsectioning			= TRUE;
   j->outprob_outfile			= NULL;
+  j->parallel_load			= FALSE;
 }
 
 /** 
@@ -185,6 +186,9 @@ jconf_set_default_values_lm(JCONF_LM *j)
   j->ngram_filename			= NULL;
   j->ngram_filename_lr_arpa		= NULL;
   j->ngram_filename_rl_arpa		= NULL;
+  j->arpa_thread_num			= 1;
+  j->ngram_filename_rescore		= NULL;
+  j->wchmm_cache_filename		= NULL;
   j->dfa_filename			= NULL;
   j->gramlist_root			= NULL;
   j->wordlist_root			= NULL;
@@ -242,6 +246,14 @@ jconf_set_default_values_search(JCONF_SEARCH *j)
 #ifdef SCORE_PRUNING
   j->pass1.score_pruning_width		= -1.0;
 #endif
+  j->pass1.adaptive_beam_token		= 0;
+  j->pass1.adaptive_beam_msec		= 0.0;
+  j->pass1.adaptive_beam_min		= -1;
+  j->pass1.adaptive_beam_max		= -1;
+  j->pass1.backtrellis_gc_interval	= 0;
+  j->pass1.factor_cache_size		= 65536;
+  j->pass1.trigram_lookahead		= FALSE;
+  j->pass1.flatword_maxnum		= 0;
 #if defined(WPAIR) && defined(WPAIR_KEEP_NLIMIT)
   j->pass1.wpair_keep_nlimit		= 3;
 #endif
@@ -267,6 +279,15 @@ jconf_set_default_values_search(JCONF_SEARCH *j)
   j->pass2.stack_size		= 500;
   j->pass2.lookup_range		= 5;
   j->pass2.looktrellis_flag	= FALSE; /* dfa */
+  j->pass2.nwthread_num		= 1;
+  j->pass2.deadline_msec	= 0;
+  j->pass2.adapt_by_confidence	= FALSE;
+  j->pass2.adapt_skip_margin	= 0.0;
+  j->pass2.adapt_reduce_margin	= 0.0;
+  j->pass2.adapt_max_frame	= 0;
+  j->pass2.nwcache_size		= 4096;
+  j->pass2.lmcache_size		= 0;
+  j->pass2.lmcache_keep		= FALSE;
 
   j->graph.enabled			= FALSE;
   j->graph.lattice			= FALSE;
@@ -281,8 +302,15 @@ jconf_set_default_values_search(JCONF_SEARCH *j)
 #ifdef   GRAPHOUT_SEARCH_DELAY_TERMINATION
   j->graph.graphout_search_delay	= FALSE;
 #endif
+  j->graph.rescore_weight		= 0.0;
+  j->graph.rescore_penalty		= 0.0;
+  j->graph.rescore_maxhist		= 64;
+  j->graph.rescore_lmp_specified	= FALSE;
   j->successive.enabled			= FALSE;
   j->successive.sp_frame_duration	= 10;
+#ifndef SPSEGMENT_NAIST
+  j->successive.sp_stable_duration	= 0;
+#endif
   j->successive.pausemodelname		= NULL;
 #ifdef SPSEGMENT_NAIST
   j->successive.sp_margin		= DEFAULT_SP_MARGIN;
@@ -571,12 +571,16 @@ adjust_sc_index(WCHMM_INFO *wchmm)
  * δؿϥץ೫ϻ˰٤ƤФ. 
  * 
  * @param wchmm [i/o] ڹ¤
+ * @param cachesize [in] 2-gram factoring ͥåΥȥ
+ * (1-gram factoring ̵뤵)
  * </JA>
  * <EN>
  * Initialize factoring cache for a tree lexicon, allocating memory for
  * cache.  This should be called only once on start up.
  * 
  * @param wchmm [i/o] tree lexicon
+ * @param cachesize [in] number of entries of 2-gram factoring value cache
+ * (ignored on 1-gram factoring)
  * </EN>
  *
  * @callgraph
@@ -584,11 +588,13 @@ adjust_sc_index(WCHMM_INFO *wchmm)
  * 
  */
 void
-max_successor_cache_init(WCHMM_INFO *wchmm)
+max_successor_cache_init(WCHMM_INFO *wchmm, int cachesize)
 {
   int i;
   LM_PROB_CACHE *l;
+#ifdef UNIGRAM_FACTORING
   WORD_ID wnum;
+#endif
 
   /* for word-internal */
   l = &(wchmm->lmcache);
@@ -598,6 +604,24 @@ max_successor_cache_init(WCHMM_INFO *wchmm)
   for (i=0;i<wchmm->scnum;i++) {
     l->lastwcache[i] = WORD_INVALID;
   }
+  /* 3-gram cache will be set up by max_successor_trigram_init() */
+  l->trigram = FALSE;
+  l->tri_cache = NULL;
+  l->tri_cache_mask = 0;
+  l->tri_hit = l->tri_miss = 0;
+#ifndef UNIGRAM_FACTORING
+  /* bounded LRU cache for both word-internal and cross-word */
+  l->lru_num = cachesize;
+  if (l->lru_num < 1) l->lru_num = 1;
+  l->lru = (FACTOR_CACHE_ENTRY *)mymalloc(sizeof(FACTOR_CACHE_ENTRY) * l->lru_num);
+  for (i = 1; i < l->lru_num; i <<= 1);
+  l->lru_hashmask = i - 1;
+  l->lru_hash = (int *)mymalloc(sizeof(int) * i);
+  for (i = 0; i <= l->lru_hashmask; i++) l->lru_hash[i] = -1;
+  l->lru_used = 0;
+  l->lru_head = l->lru_tail = -1;
+  l->lru_hit = l->lru_miss = 0;
+#else
   /* for cross-word */
   if (wchmm->ngram) {
     wnum = wchmm->ngram->max_word_num;
@@ -620,8 +644,11 @@ max_successor_cache_init(WCHMM_INFO *wchmm)
     l->iw_lw_cache[i] = WORD_INVALID;
   }
 #endif
+#endif /* UNIGRAM_FACTORING */
 }
 
+#ifdef UNIGRAM_FACTORING
+
 /** 
  * <JA>
  * ñ֤ factoring cache Υΰ. 
@@ -645,6 +672,7 @@ max_successor_prob_iw_free(WCHMM_INFO *wchmm)
     l->iw_sc_cache[i] = NULL;
   }
 }
+#endif /* UNIGRAM_FACTORING */
 
 /** 
  * <JA>
@@ -667,11 +695,82 @@ max_successor_cache_free(WCHMM_INFO *wchmm)
 {
   free(wchmm->lmcache.probcache);
   free(wchmm->lmcache.lastwcache);
+#ifdef UNIGRAM_FACTORING
   max_successor_prob_iw_free(wchmm);
   free(wchmm->lmcache.iw_sc_cache);
 #ifdef HASH_CACHE_IW
   free(wchmm->lmcache.iw_lw_cache);
 #endif
+#else
+  free(wchmm->lmcache.lru);
+  free(wchmm->lmcache.lru_hash);
+#endif
+  if (wchmm->lmcache.tri_cache) free(wchmm->lmcache.tri_cache);
+}
+
+/** 
+ * <JA>
+ * @brief  1ѥ 3-gram Ѥ뤿Υå. 
+ *
+ * 3-gram  (DIR_LR)  3-gram ʾ N-gram ͿƤ
+ * ΤѤ뤳ȤǤ. ʳξϷٹФ FALSE ֤. 
+ * 
+ * @param wchmm [i/o] ڹ¤
+ * @param cachesize [in] åΥȥ
+ * 
+ * @return 3-gram Ѥ TRUE, Ѥʤ FALSE
+ * </JA>
+ * <EN>
+ * @brief  Set up 3-gram look-ahead on the 1st pass.
+ *
+ * 3-gram can be applied only when a forward (DIR_LR) N-gram of N >= 3 is
+ * given.  Otherwise, a warning is issued and FALSE will be returned.
+ * 
+ * @param wchmm [i/o] tree lexicon
+ * @param cachesize [in] number of cache entries
+ * 
+ * @return TRUE if 3-gram will be used, or FALSE if not.
+ * </EN>
+ *
+ * @callgraph
+ * @callergraph
+ * 
+ */
+boolean
+max_successor_trigram_init(WCHMM_INFO *wchmm, int cachesize)
+{
+  LM_PROB_CACHE *l;
+  int i;
+
+  l = &(wchmm->lmcache);
+  l->trigram = FALSE;
+
+  if (wchmm->ngram == NULL || wchmm->lmvar == LM_NGRAM_USER) {
+    jlog("WARNING: factoring: 3-gram on 1st pass needs N-gram, ignored\n");
+    return FALSE;
+  }
+  if (wchmm->ngram->dir != DIR_LR) {
+    jlog("WARNING: factoring: 3-gram on 1st pass needs forward N-gram, ignored\n");
+    return FALSE;
+  }
+  if (wchmm->ngram->n < 3) {
+    jlog("WARNING: factoring: 3-gram on 1st pass needs N-gram of N >= 3, ignored\n");
+    return FALSE;
+  }
+
+  /* round up to power of 2 */
+  if (cachesize < 1) cachesize = 1;
+  for (i = 1; i < cachesize; i <<= 1);
+  if (l->tri_cache) free(l->tri_cache);
+  l->tri_cache = (TRIGRAM_CACHE_ENTRY *)mymalloc(sizeof(TRIGRAM_CACHE_ENTRY) * i);
+  l->tri_cache_mask = i - 1;
+  for (i = 0; i <= l->tri_cache_mask; i++) {
+    l->tri_cache[i].w = WORD_INVALID;
+  }
+  l->tri_hit = l->tri_miss = 0;
+  l->trigram = TRUE;
+
+  return TRUE;
 }
 
 #ifdef UNIGRAM_FACTORING
@@ -895,6 +994,140 @@ calc_successor_prob(WCHMM_INFO *wchmm, WORD_ID lastword, int node)
   return(maxprob);
 }
 
+/** 
+ * <JA>
+ * 2-gram factoring ͥåΥϥåͤ. 
+ * 
+ * @param l [in] LMå
+ * @param lw [in] ľñ N-gram ȥ ID
+ * @param scid [in] successor list ID
+ * 
+ * @return ϥå
+ * </JA>
+ * <EN>
+ * Get hash bucket of 2-gram factoring value cache.
+ * 
+ * @param l [in] LM cache
+ * @param lw [in] N-gram entry ID of last word
+ * @param scid [in] successor list ID
+ * 
+ * @return the bucket index.
+ * </EN>
+ */
+static int
+factor_cache_hash(LM_PROB_CACHE *l, WORD_ID lw, int scid)
+{
+  unsigned int x;
+
+  x = (unsigned int)lw * 2654435761U + (unsigned int)scid * 40503U;
+  return((x ^ (x >> 15)) & l->lru_hashmask);
+}
+
+/** 
+ * <JA>
+ * 2-gram factoring ͥå򸡺. Ĥä礽Υȥ
+ * ǶѤΤȤ LRU ꥹȤƬ˰ܤ. 
+ * 
+ * @param l [i/o] LMå
+ * @param lw [in] ľñ N-gram ȥ ID
+ * @param scid [in] successor list ID
+ * @param prob [out] Ĥä factoring 
+ * 
+ * @return Ĥ TRUE, ʤ FALSE
+ * </JA>
+ * <EN>
+ * Look up 2-gram factoring value cache.  If found, the entry will be
+ * moved to the head of LRU list as the most recently used one.
+ * 
+ * @param l [i/o] LM cache
+ * @param lw [in] N-gram entry ID of last word
+ * @param scid [in] successor list ID
+ * @param prob [out] the cached factoring value if found
+ * 
+ * @return TRUE if found, or FALSE if not.
+ * </EN>
+ */
+static boolean
+factor_cache_lookup(LM_PROB_CACHE *l, WORD_ID lw, int scid, LOGPROB *prob)
+{
+  FACTOR_CACHE_ENTRY *e;
+  int i;
+
+  for (i = l->lru_hash[factor_cache_hash(l, lw, scid)]; i != -1; i = e->hnext) {
+    e = &(l->lru[i]);
+    if (e->lw == lw && e->scid == scid) {
+      if (i != l->lru_head) {
+	/* unlink */
+	l->lru[e->lprev].lnext = e->lnext;
+	if (e->lnext != -1) l->lru[e->lnext].lprev = e->lprev;
+	else l->lru_tail = e->lprev;
+	/* move to head */
+	e->lprev = -1;
+	e->lnext = l->lru_head;
+	l->lru[l->lru_head].lprev = i;
+	l->lru_head = i;
+      }
+      *prob = e->prob;
+      l->lru_hit++;
+      return TRUE;
+    }
+  }
+  l->lru_miss++;
+  return FALSE;
+}
+
+/** 
+ * <JA>
+ * 2-gram factoring ͤ򥭥åϿ. å夬դξ
+ * ǤĹȤƤʤȥ֤. 
+ * 
+ * @param l [i/o] LMå
+ * @param lw [in] ľñ N-gram ȥ ID
+ * @param scid [in] successor list ID
+ * @param prob [in] factoring 
+ * </JA>
+ * <EN>
+ * Store a 2-gram factoring value to the cache.  If the cache is full,
+ * the least recently used entry will be replaced.
+ * 
+ * @param l [i/o] LM cache
+ * @param lw [in] N-gram entry ID of last word
+ * @param scid [in] successor list ID
+ * @param prob [in] factoring value
+ * </EN>
+ */
+static void
+factor_cache_store(LM_PROB_CACHE *l, WORD_ID lw, int scid, LOGPROB prob)
+{
+  FACTOR_CACHE_ENTRY *e;
+  int i, *p;
+
+  if (l->lru_used < l->lru_num) {
+    i = l->lru_used++;
+  } else {
+    /* evict the least recently used entry */
+    i = l->lru_tail;
+    e = &(l->lru[i]);
+    for (p = &(l->lru_hash[factor_cache_hash(l, e->lw, e->scid)]); *p != i; p = &(l->lru[*p].hnext));
+    *p = e->hnext;
+    l->lru_tail = e->lprev;
+    if (l->lru_tail != -1) l->lru[l->lru_tail].lnext = -1;
+    else l->lru_head = -1;
+  }
+  e = &(l->lru[i]);
+  e->lw = lw;
+  e->scid = scid;
+  e->prob = prob;
+  p = &(l->lru_hash[factor_cache_hash(l, lw, scid)]);
+  e->hnext = *p;
+  *p = i;
+  e->lprev = -1;
+  e->lnext = l->lru_head;
+  if (l->lru_head != -1) l->lru[l->lru_head].lprev = i;
+  l->lru_head = i;
+  if (l->lru_tail == -1) l->lru_tail = i;
+}
+
 #endif  /* ~UNIGRAM_FACTORING */
 
 /** 
@@ -908,6 +1141,8 @@ calc_successor_prob(WCHMM_INFO *wchmm, WORD_ID lastword, int node)
  * ñ factoring å夬θ. ʤƥΡɤˤĤ
  * ľñ줬󥢥줿ȤƱǤС
  * ֤ͤ졤Ǥʤͤ׻å夬. 
+ * 2-gram factoring Ǥϡͤη׻ (ľñ, scid) 򥭡Ȥ
+ * LRU å⻲Ȥ. 
  * 
  * @param wchmm [in] ڹ¤
  * @param lastword [in] ľñID
@@ -927,6 +1162,8 @@ calc_successor_prob(WCHMM_INFO *wchmm, WORD_ID lastword, int node)
  * If the given last word is the same as the last call on that node,
  * the last computed value will be returned, else the maximum value
  * will be computed update the cache with the last word and value.
+ * On 2-gram factoring, the LRU cache keyed by (last word, scid) is also
+ * looked up before computing the value.
  * 
  * @param wchmm [in] tree lexicon
  * @param lastword [in] word ID of last context word
@@ -989,7 +1226,10 @@ max_successor_prob(WCHMM_INFO *wchmm, WORD_ID lastword, int node)
 #else  /* UNIGRAM_FACTORING */
     /* 2-gram */
     if (last_nword != l->lastwcache[scid]) {
-      maxprob = calc_successor_prob(wchmm, lastword, node);
+      if (factor_cache_lookup(l, last_nword, scid, &maxprob) == FALSE) {
+	maxprob = calc_successor_prob(wchmm, lastword, node);
+	factor_cache_store(l, last_nword, scid, maxprob);
+      }
       /* store to cache */
       l->lastwcache[scid] = last_nword;
       l->probcache[scid] = maxprob;
@@ -1012,6 +1252,92 @@ max_successor_prob(WCHMM_INFO *wchmm, WORD_ID lastword, int node)
 
 }
 
+/** 
+ * <JA>
+ * @brief  ñ줬ꤹΡɤˤĤ 3-gram ˤ쥹֤. 
+ *
+ * ΡɤΥ֥ĥ꡼˴ޤޤñ줬Ĥ˳ꤷƤ硤2ޤǤ
+ * ñʸ̮Ѥ 3-gram Ψ׻֤. ͤϥ쥯ȥޥå
+ * åݻ. ʳΥΡɤʸ̮ 2 ñʤ
+ * max_successor_prob() ֤ͤ. 
+ * 
+ * @param wchmm [in] ڹ¤
+ * @param lastword2 [in] 2ñID
+ * @param lastword [in] ľñID
+ * @param node [in] Ρֹ
+ * 
+ * @return ǥ륹
+ * </JA>
+ * <EN>
+ * @brief  Return 3-gram LM score on a node where the word is determined.
+ *
+ * If only one word is reachable from the node, its 3-gram probability
+ * given the two previous context words will be computed and returned.
+ * The values are held in a direct-mapped cache.  On other nodes, or
+ * when the context has less than two words, the value of
+ * max_successor_prob() will be returned.
+ * 
+ * @param wchmm [in] tree lexicon
+ * @param lastword2 [in] word ID of the second last context word
+ * @param lastword [in] word ID of last context word
+ * @param node [in] node ID
+ * 
+ * @return the LM score.
+ * </EN>
+ *
+ * @callgraph
+ * @callergraph
+ * 
+ */
+LOGPROB
+max_successor_prob_trigram(WCHMM_INFO *wchmm, WORD_ID lastword2, WORD_ID lastword, int node)
+{
+  LM_PROB_CACHE *l;
+  TRIGRAM_CACHE_ENTRY *e;
+  WORD_ID w, nw[3];
+  int scid;
+  unsigned int x;
+
+  if (lastword2 == WORD_INVALID || lastword == WORD_INVALID) {
+    return(max_successor_prob(wchmm, lastword, node));
+  }
+
+  scid = wchmm->state[node].scid;
+#ifdef UNIGRAM_FACTORING
+  if (scid <= 0) return(max_successor_prob(wchmm, lastword, node));
+  w = wchmm->scword[scid];
+#else
+  if (scid <= 0 || wchmm->sclen[scid] != 1) return(max_successor_prob(wchmm, lastword, node));
+  w = wchmm->sclist[scid][0];
+#endif
+
+  l = &(wchmm->lmcache);
+  nw[0] = wchmm->winfo->wton[lastword2];
+  nw[1] = wchmm->winfo->wton[lastword];
+  nw[2] = wchmm->winfo->wton[w];
+
+  /* the cache is keyed by N-gram entries and holds only the N-gram
+     probability, since several words can share the same entry */
+  x = (unsigned int)nw[0] * 2654435761U + (unsigned int)nw[1] * 40503U + (unsigned int)nw[2];
+  e = &(l->tri_cache[(x ^ (x >> 15)) & l->tri_cache_mask]);
+  if (e->w == nw[2] && e->w1 == nw[1] && e->w2 == nw[0]) {
+    l->tri_hit++;
+  } else {
+    l->tri_miss++;
+    e->w2 = nw[0];
+    e->w1 = nw[1];
+    e->w = nw[2];
+    e->prob = ngram_prob(wchmm->ngram, 3, nw);
+  }
+
+  return(e->prob
+#ifdef CLASS_NGRAM
+	 + wchmm->winfo->cprob[w]
+#endif
+	 );
+}
+
+#ifdef UNIGRAM_FACTORING
 /** 
  * <JA>
  * @brief  ñ֤ factoring ͤΥꥹȤ֤. 
@@ -1077,27 +1403,13 @@ max_successor_prob_iw(WCHMM_INFO *wchmm, WORD_ID lastword)
 #endif
   /* allocate cache memory */
   if (l->iw_sc_cache[x] == NULL) {
-#ifdef UNIGRAM_FACTORING
     l->iw_sc_cache[x] = (LOGPROB *)mymalloc(sizeof(LOGPROB)*wchmm->isolatenum);
-#else
-    l->iw_sc_cache[x] = (LOGPROB *)mymalloc(sizeof(LOGPROB)*wchmm->startnum);
-#endif
     if (l->iw_sc_cache[x] == NULL) { /* malloc failed */
       /* clear existing cache, and retry */
       max_successor_prob_iw_free(wchmm);
       jlog("STAT: inter-word LM cache (%dMB) rehashed\n",
-	       (l->iw_cache_num * 
-#ifdef UNIGRAM_FACTORING
-		wchmm->isolatenum
-#else
-		wchmm->startnum
-#endif
-		) / 1000 * sizeof(LOGPROB) / 1000);
-#ifdef UNIGRAM_FACTORING
+	       (l->iw_cache_num * wchmm->isolatenum) / 1000 * sizeof(LOGPROB) / 1000);
       l->iw_sc_cache[x] = (LOGPROB *)mymalloc(sizeof(LOGPROB)*wchmm->isolatenum);
-#else
-      l->iw_sc_cache[x] = (LOGPROB *)mymalloc(sizeof(LOGPROB)*wchmm->startnum);
-#endif
       if (l->iw_sc_cache[x] == NULL) { /* malloc failed again? */
 	j_internal_error("max_successor_prob_iw: cannot malloc\n");
       }
@@ -1105,7 +1417,6 @@ max_successor_prob_iw(WCHMM_INFO *wchmm, WORD_ID lastword)
   }
 
   /* calc prob for all startid */
-#ifdef UNIGRAM_FACTORING
   for (j=0;j<wchmm->startnum;j++) {
     i = wchmm->start2isolate[j];
     if (i == -1) continue;
@@ -1130,18 +1441,13 @@ max_successor_prob_iw(WCHMM_INFO *wchmm, WORD_ID lastword)
       l->iw_sc_cache[x][i] = p;
     }
   }
-#else  /* ~UNIGRAM_FACTORING */
-  for (i=0;i<wchmm->startnum;i++) {
-    node = wchmm->startnode[i];
-    l->iw_sc_cache[x][i] = calc_successor_prob(wchmm, lastword, node);
-  }
-#endif
 #ifdef HASH_CACHE_IW
   l->iw_lw_cache[x] = last_nword;
 #endif
 
   return(l->iw_sc_cache[x]);
 }
+#endif /* UNIGRAM_FACTORING */
 
 /** 
  * <JA>
@@ -0,0 +1,496 @@
+/**
+ * @file   flatword.c
+ * 
+ * <JA>
+ * @brief  ñǧ⡼ɤΤʿóñHMMˤ®ǥǥ
+ *
+ * ñǧ⡼ (LM_DFA_WORD) Ǹä硤1ѥڹ¤
+ * Υӡõˡñ줴Ȥʿó¤٤ HMM 
+ * õ Viterbi ǹԤ. ޴ϹԤ鷺õñȥꥹ¸ʤ. 
+ * ϽλñκǽΤǡN-best ϸ̩˵ޤ. 
+ *
+ * ñ줴Ȥξڹ¤񤫤ФᡤܳΨȽϳΨ
+ * ̾ΥӡõƱǤ. ƥ֤ʸˡñ "-flatword" 
+ * ꤷͰʲǡ multi-path ⡼ɡ硼ȥݡơ
+ * ϤΤѤʤ˼ưŪ򤵤. 
+ * </JA>
+ * 
+ * <EN>
+ * @brief  Fast flat-HMM decoding for isolated word recognition
+ *
+ * On isolated word recognition mode (LM_DFA_WORD) with a small vocabulary,
+ * the 1st pass is performed as a full Viterbi over per-word flat HMM state
+ * sequences instead of the beam search on the tree lexicon.  No pruning
+ * is applied and no word trellis is stored while search.  Since the final
+ * scores of all words are obtained at the end of input, the N-best list
+ * is exact.
+ *
+ * The per-word state sequences are extracted from the tree lexicon, so
+ * the transition and output probabilities are the same as the beam search.
+ * This is selected automatically when the number of words in the active
+ * grammars is no more than the value of "-flatword", and none of multi-path
+ * mode, short-pause segmentation and progressive output is used.
+ * </EN>
+ * 
+ * @author Akinobu LEE
+ * @date   Mon Oct 19 10:12:41 2026
+ *
+ * $Revision: 1.1 $
+ * 
+ */
+/*
+ * Copyright (c) 1991-2013 Kawahara Lab., Kyoto University
+ * Copyright (c) 2000-2005 Shikano Lab., Nara Institute of Science and Technology
+ * Copyright (c) 2005-2013 Julius project team, Nagoya Institute of Technology
+ * All rights reserved
+ */
+
+#include <julius/julius.h>
+
+/** 
+ * <JA>
+ * ʿóñHMMγǼΰɬפ˱Ƴĥ. 
+ * 
+ * @param fw [i/o] ʿóñHMM
+ * @param wnum [in] ɬפñ
+ * @param statenum [in] ɬפʾֿ
+ * </JA>
+ * <EN>
+ * Expand the storage of flat word HMMs if needed.
+ * 
+ * @param fw [i/o] flat word HMMs
+ * @param wnum [in] required number of words
+ * @param statenum [in] required number of states
+ * </EN>
+ */
+static void
+flatword_expand(FLATWORD *fw, int wnum, int statenum)
+{
+  if (fw->maxwnum < wnum + 1) {
+    fw->maxwnum = wnum + 1;
+    fw->wid = (WORD_ID *)myrealloc(fw->wid, sizeof(WORD_ID) * fw->maxwnum);
+    fw->wbegin = (int *)myrealloc(fw->wbegin, sizeof(int) * fw->maxwnum);
+  }
+  if (fw->maxstatenum < statenum) {
+    fw->maxstatenum = statenum;
+    fw->node = (int *)myrealloc(fw->node, sizeof(int) * fw->maxstatenum);
+    fw->a_self = (LOGPROB *)myrealloc(fw->a_self, sizeof(LOGPROB) * fw->maxstatenum);
+    fw->a_next = (LOGPROB *)myrealloc(fw->a_next, sizeof(LOGPROB) * fw->maxstatenum);
+    fw->score[0] = (LOGPROB *)myrealloc(fw->score[0], sizeof(LOGPROB) * fw->maxstatenum);
+    fw->score[1] = (LOGPROB *)myrealloc(fw->score[1], sizeof(LOGPROB) * fw->maxstatenum);
+  }
+}
+
+/** 
+ * <JA>
+ * ʿóñHMMñܤɲä. 
+ * 
+ * @param fw [i/o] ʿóñHMM
+ * @param from [in] ܸξֹ
+ * @param to [in] ξֹ
+ * @param a [in] ܳΨ
+ * </JA>
+ * <EN>
+ * Add a transition arc within word to the flat word HMMs.
+ * 
+ * @param fw [i/o] flat word HMMs
+ * @param from [in] source state index
+ * @param to [in] destination state index
+ * @param a [in] transition probability
+ * </EN>
+ */
+static void
+flatword_add_arc(FLATWORD *fw, int from, int to, LOGPROB a)
+{
+  if (fw->arcnum >= fw->maxarcnum) {
+    fw->maxarcnum += 256;
+    fw->arc = (FLATWORD_ARC *)myrealloc(fw->arc, sizeof(FLATWORD_ARC) * fw->maxarcnum);
+  }
+  fw->arc[fw->arcnum].from = from;
+  fw->arc[fw->arcnum].to = to;
+  fw->arc[fw->arcnum].a = a;
+  fw->arcnum++;
+}
+
+/** 
+ * <JA>
+ * ڹ¤񤫤ñ HMM ФʿóñHMMɲä. 
+ * 
+ * @param fw [i/o] ʿóñHMM
+ * @param wchmm [in] ڹ¤
+ * @param w [in] ñID
+ * 
+ * @return  TRUE, ñξФʤä FALSE
+ * </JA>
+ * <EN>
+ * Extract HMM state sequence of a word from the tree lexicon, and append
+ * it to the flat word HMMs.
+ * 
+ * @param fw [i/o] flat word HMMs
+ * @param wchmm [in] tree lexicon
+ * @param w [in] word ID
+ * 
+ * @return TRUE on success, or FALSE if the state sequence of the word
+ * could not be extracted properly.
+ * </EN>
+ */
+static boolean
+flatword_add_word(FLATWORD *fw, WCHMM_INFO *wchmm, WORD_ID w)
+{
+  WORD_INFO *winfo;
+  A_CELL2 *ac;
+  LOGPROB *reach;
+  int b, e, len, i, j, k, p, n;
+  int arcbegin;
+
+  winfo = wchmm->winfo;
+
+  len = 0;
+  for (p = 0; p < winfo->wlen[w]; p++) {
+    len += hmm_logical_state_num(winfo->wseq[w][p]) - 2;
+  }
+  if (len <= 0) return FALSE;
+
+  b = fw->statenum;
+  e = b + len;
+  flatword_expand(fw, fw->wnum + 1, e);
+
+  /* node sequence of the word on tree lexicon */
+  i = b;
+  for (p = 0; p < winfo->wlen[w]; p++) {
+    n = hmm_logical_state_num(winfo->wseq[w][p]) - 2;
+    for (k = 0; k < n; k++) {
+      fw->node[i++] = wchmm->offset[w][p] + k;
+    }
+  }
+  /* word-end node may be duplicated for homophones */
+  fw->node[e - 1] = wchmm->wordend[w];
+
+  /* transitions within the word */
+  arcbegin = fw->arcnum;
+  for (i = b; i < e; i++) {
+    n = fw->node[i];
+    fw->a_self[i] = wchmm->self_a[n];
+    fw->a_next[i] = LOG_ZERO;
+    if (i + 1 < e && fw->node[i + 1] == n + 1) {
+      fw->a_next[i] = wchmm->next_a[n];
+    }
+    for (ac = wchmm->ac[n]; ac; ac = ac->next) {
+      for (k = 0; k < ac->n; k++) {
+	/* arcs to other words are ignored */
+	for (j = b; j < e; j++) {
+	  if (fw->node[j] == ac->arc[k]) break;
+	}
+	if (j >= e) continue;
+	if (j <= i) return FALSE; /* backward arc is not supported */
+	if (j == i + 1 && fw->a_next[i] == LOG_ZERO) {
+	  fw->a_next[i] = ac->a[k];
+	} else {
+	  flatword_add_arc(fw, i, j, ac->a[k]);
+	}
+      }
+    }
+  }
+
+  /* check if the word end is reachable from the word head */
+  reach = fw->score[0];
+  for (i = b; i < e; i++) reach[i] = LOG_ZERO;
+  reach[b] = 0.0;
+  j = arcbegin;
+  for (i = b; i < e; i++) {
+    if (reach[i] == LOG_ZERO) continue;
+    if (i + 1 < e && fw->a_next[i] != LOG_ZERO) reach[i + 1] = 0.0;
+    for (; j < fw->arcnum && fw->arc[j].from <= i; j++) {
+      if (fw->arc[j].from == i) reach[fw->arc[j].to] = 0.0;
+    }
+  }
+  if (reach[e - 1] == LOG_ZERO) return FALSE;
+
+  fw->wid[fw->wnum] = w;
+  fw->wbegin[fw->wnum] = b;
+  fw->wnum++;
+  fw->wbegin[fw->wnum] = e;
+  fw->statenum = e;
+
+  return TRUE;
+}
+
+/** 
+ * <JA>
+ * @brief  ʿóñHMMˤǥǥ󥰤ν
+ *
+ * ߤϤФʿóñHMMˤǥǥ󥰤ѤǤ뤫Ƚꤷ
+ * ǽǤХƥ֤ʸˡñ줫ʿóñHMMۤ
+ * ǽΥե졼Υ򥻥åȤ. 
+ * 
+ * @param param [in] ϥ٥ȥ (ǽΣե졼ܤΤѤ)
+ * @param r [i/o] ǧ󥹥
+ * 
+ * @return ʿóñHMMˤǥǥ󥰤Ԥ TRUE̾
+ * ӡõԤ FALSE
+ * </JA>
+ * <EN>
+ * @brief  Initialize flat word decoding.
+ *
+ * This function checks whether flat word decoding can be applied for
+ * the current input, and if so, builds the flat word HMMs from words in
+ * the active grammars and sets the scores of the first frame.
+ * 
+ * @param param [in] input vectors (only the first frame will be used)
+ * @param r [i/o] recognition process instance
+ * 
+ * @return TRUE if flat word decoding will be performed, or FALSE if the
+ * normal beam search should be used.
+ * </EN>
+ *
+ * @callergraph
+ * @callgraph
+ * 
+ */
+boolean
+flatword_init(HTK_Param *param, RecogProcess *r)
+{
+  WCHMM_INFO *wchmm;
+  FSBeam *d;
+  FLATWORD *fw;
+  MULTIGRAM *m;
+  LOGPROB *cur;
+  int num, i, k;
+
+  wchmm = r->wchmm;
+  d = &(r->pass1);
+  fw = &(d->fw);
+
+  if (r->lmtype != LM_DFA || r->lmvar != LM_DFA_WORD) return FALSE;
+  if (r->config->pass1.flatword_maxnum <= 0) return FALSE;
+  if (wchmm->hmminfo->multipath) return FALSE;
+  if (r->config->successive.enabled) return FALSE;
+  if (r->config->output.progout_flag) return FALSE;
+
+  num = 0;
+  for(m = r->lm->grammars; m; m = m->next) {
+    if (m->active) num += m->winfo->num;
+  }
+  if (num == 0 || num > r->config->pass1.flatword_maxnum) return FALSE;
+
+  /* build flat word HMMs for words in active grammars */
+  fw->wnum = 0;
+  fw->statenum = 0;
+  fw->arcnum = 0;
+  flatword_expand(fw, num, 0);
+  fw->wbegin[0] = 0;
+  for(m = r->lm->grammars; m; m = m->next) {
+    if (! m->active) continue;
+    for(i = m->word_begin; i < m->word_begin + m->winfo->num; i++) {
+      if (flatword_add_word(fw, wchmm, i) == FALSE) {
+	if (verbose_flag) jlog("STAT: %02d %s: cannot flatten word \"%s\", use beam search\n", r->config->id, r->config->name, wchmm->winfo->wname[i]);
+	return FALSE;
+      }
+    }
+  }
+
+  /* set initial score to the first state of all words */
+  d->tn = 0;
+  d->tl = 1;
+  d->bos.wid = WORD_INVALID;
+  d->bos.begintime = d->bos.endtime = -1;
+#ifdef PASS1_IWCD
+  outprob_style_cache_init(wchmm);
+#endif
+  cur = fw->score[d->tn];
+  for (i = 0; i < fw->statenum; i++) cur[i] = LOG_ZERO;
+  for (k = 0; k < fw->wnum; k++) {
+    i = fw->wbegin[k];
+    cur[i] = outprob_style(wchmm, fw->node[i], d->bos.wid, 0, param);
+  }
+
+  if (debug2_flag) {
+    jlog("DEBUG: flat word decoding: %d words, %d states, %d extra arcs\n", fw->wnum, fw->statenum, fw->arcnum);
+  }
+
+  return TRUE;
+}
+
+/** 
+ * <JA>
+ * @brief  ʿóñHMMˤǥǥ󥰤1ե졼ʤ. 
+ *
+ * ñ֤ˤĤ Viterbi 黻Ԥ. ޴ϹԤʤ. 
+ * 
+ * @param t [in] ߤΥե졼
+ * @param param [in] ϥ٥ȥ
+ * @param r [i/o] ǧ󥹥
+ * 
+ * @return ̾ TRUEĤä̵֤ FALSE
+ * </JA>
+ * <EN>
+ * @brief  Proceed flat word decoding for one frame.
+ *
+ * Viterbi computation is performed on all states of all words, without
+ * pruning.
+ * 
+ * @param t [in] current frame
+ * @param param [in] input vectors
+ * @param r [i/o] recognition process instance
+ * 
+ * @return TRUE on success, or FALSE when no state survived.
+ * </EN>
+ *
+ * @callergraph
+ * @callgraph
+ * 
+ */
+boolean
+flatword_proceed(int t, HTK_Param *param, RecogProcess *r)
+{
+  WCHMM_INFO *wchmm;
+  FSBeam *d;
+  FLATWORD *fw;
+  FLATWORD_ARC *arc;
+  LOGPROB *prev, *cur;
+  LOGPROB s, x;
+  int i, k, b, e;
+  boolean alive;
+
+  wchmm = r->wchmm;
+  d = &(r->pass1);
+  fw = &(d->fw);
+
+  d->tl = d->tn;
+  if (d->tn == 0) d->tn = 1; else d->tn = 0;
+  prev = fw->score[d->tl];
+  cur = fw->score[d->tn];
+
+  /* self-loop and next-state transitions */
+  for (k = 0; k < fw->wnum; k++) {
+    b = fw->wbegin[k];
+    e = fw->wbegin[k + 1];
+    for (i = b; i < e; i++) {
+      s = LOG_ZERO;
+      if (prev[i] > LOG_ZERO) s = prev[i] + fw->a_self[i];
+      if (i > b && prev[i - 1] > LOG_ZERO && fw->a_next[i - 1] != LOG_ZERO) {
+	x = prev[i - 1] + fw->a_next[i - 1];
+	if (s < x) s = x;
+      }
+      cur[i] = s;
+    }
+  }
+  /* other transitions */
+  for (k = 0; k < fw->arcnum; k++) {
+    arc = &(fw->arc[k]);
+    if (prev[arc->from] > LOG_ZERO) {
+      x = prev[arc->from] + arc->a;
+      if (cur[arc->to] < x) cur[arc->to] = x;
+    }
+  }
+  /* add output probabilities */
+  alive = FALSE;
+  for (i = 0; i < fw->statenum; i++) {
+    if (cur[i] > LOG_ZERO) {
+      cur[i] += outprob_style(wchmm, fw->node[i], d->bos.wid, t, param);
+      alive = TRUE;
+    }
+  }
+
+  if (! alive) {
+    jlog("ERROR: flatword_proceed: %02d %s: frame %d: no state survived, now terminates search\n", r->config->id, r->config->name, t);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/** 
+ * <JA>
+ * @brief  ʿóñHMMˤǥǥ󥰤λ. 
+ *
+ * ǽե졼ñ콪ü֤ãƤññȥꥹ
+ * Ǽ. ʹߤν̾ΥӡõƱͤ finalize_1st_pass() 
+ * Ԥ. 
+ * 
+ * @param param [in] ϥ٥ȥ (param->samplenum ͤΤѤ)
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * @brief  Finish flat word decoding.
+ *
+ * All words whose word-end state has been reached at the last frame
+ * are stored to the word trellis.  The rest will be done in
+ * finalize_1st_pass() as the same as normal beam search.
+ * 
+ * @param param [in] input vectors (only param->samplenum is referred)
+ * @param r [i/o] recognition process instance
+ * </EN>
+ *
+ * @callergraph
+ * @callgraph
+ * 
+ */
+void
+flatword_end(HTK_Param *param, RecogProcess *r)
+{
+  FSBeam *d;
+  FLATWORD *fw;
+  TRELLIS_ATOM *tre;
+  LOGPROB *cur;
+  int i, k, num;
+
+  d = &(r->pass1);
+  fw = &(d->fw);
+  cur = fw->score[d->tn];
+
+  num = 0;
+  for (k = 0; k < fw->wnum; k++) {
+    i = fw->wbegin[k + 1] - 1;
+    if (cur[i] <= LOG_ZERO) continue;
+    tre = bt_new(r->backtrellis);
+    tre->wid = fw->wid[k];
+    tre->backscore = cur[i];
+    tre->begintime = 0;
+    tre->endtime = param->samplenum - 1;
+    tre->last_tre = &(d->bos);
+    tre->lscore = 0.0;
+    bt_store(r->backtrellis, tre);
+#ifdef WORD_GRAPH
+    tre->within_context = TRUE;
+#endif
+    num++;
+  }
+  if (verbose_flag) jlog("STAT: %02d %s: flat word decoding: %d / %d words reached end\n", r->config->id, r->config->name, num, fw->wnum);
+}
+
+/** 
+ * <JA>
+ * ʿóñHMMΰ. 
+ * 
+ * @param fw [i/o] ʿóñHMM
+ * </JA>
+ * <EN>
+ * Free flat word HMMs.
+ * 
+ * @param fw [i/o] flat word HMMs
+ * </EN>
+ *
+ * @callergraph
+ * @callgraph
+ * 
+ */
+void
+flatword_free(FLATWORD *fw)
+{
+  if (fw->maxwnum > 0) {
+    free(fw->wid);
+    free(fw->wbegin);
+  }
+  if (fw->maxstatenum > 0) {
+    free(fw->node);
+    free(fw->a_self);
+    free(fw->a_next);
+    free(fw->score[0]);
+    free(fw->score[1]);
+  }
+  if (fw->maxarcnum > 0) free(fw->arc);
+  memset(fw, 0, sizeof(FLATWORD));
+}
+
+/* end of file */
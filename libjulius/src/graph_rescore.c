@@ -0,0 +1,686 @@
+/**
+ * @file   graph_rescore.c
+ *
+ * <JA>
+ * @brief  絬 N-gram ˤñ쥰դΥꥹ
+ *
+ * 2ѥ줿ñ쥰դ"-lmrescore" ǻꤵ줿̤
+ * ̾Ϥ礭ʡN-gram Ǻɾ. վγñ򡤤
+ * N-gram ɬפȤĹ (N-1) ñ򤴤ȤŸŸ줿
+ * ƥǿ쥹Ѥ forward-backward ˤΨ
+ * Ⱥѥ. Ψϳƥñ graph_cm ˳Ǽ졤
+ * ѥ1̤ǧ̤֤.
+ *
+ * ʻ礵줿ñܤñȶפʤȤꡤ
+ * ޤĴʿѲ (amavg) ϼºݤζ֤бʤ.
+ * ǳƥñζ֤ñľ夫Ȥζ֤
+ * ñ HMM  Viterbi ׻ƲȤ. ˤ
+ * ɤΥѥǤƤΥե졼ब礦1󤺤Ŀ.
+ * ꥹ N-gram ϥХʥͿmkbingram  "-mmap" 
+ *  v6/v7 ǤХľܥޥåפ졤Ȥ줿
+ * ڡΤߤɤ߹ޤ.
+ * </JA>
+ *
+ * <EN>
+ * @brief  Word graph rescoring with a large N-gram
+ *
+ * The word graph generated at the 2nd pass is re-evaluated with another
+ * (usually much larger) N-gram specified by "-lmrescore".  Each graph
+ * word is expanded for each distinct word history of length (N-1) required
+ * by the N-gram, and the posterior probabilities and the best path are
+ * computed on the expanded lattice by forward-backward with the new LM
+ * scores.  The posteriors are stored to graph_cm of each graph word, and
+ * the best path replaces the first recognition result.
+ *
+ * Merged graph words may not abut their neighbors, and the average
+ * acoustic score (amavg) no longer matches the actual span after the
+ * boundary adjustment.  So on each arc a word is taken to span from the
+ * frame just after the previous word, and its acoustic score is computed
+ * by Viterbi matching of the word HMM on that span.  Every frame is thus
+ * counted exactly once on any path.  The rescoring N-gram should be
+ * given in binary format.  When it is in v6/v7 format made by
+ * "mkbingram -mmap", it is
+ * mapped to memory directly and only the referred pages are read.
+ * </EN>
+ *
+ * @author Akinobu LEE
+ * @date   Mon Oct 19 14:05:37 2026
+ *
+ * $Revision: 1.1 $
+ *
+ */
+/*
+ * Copyright (c) 1991-2013 Kawahara Lab., Kyoto University
+ * Copyright (c) 2000-2005 Shikano Lab., Nara Institute of Science and Technology
+ * Copyright (c) 2005-2013 Julius project team, Nagoya Institute of Technology
+ * All rights reserved
+ */
+
+#include <julius/julius.h>
+
+/// Expanded lattice node: a graph word with its N-gram history
+typedef struct __rescore_node__ {
+  WordGraph *wg;		///< Graph word of this node
+  WORD_ID *hist;		///< Word history in N-gram ID, oldest first
+  int hlen;			///< Length of @a hist
+  LOGPROB best;			///< Best path score until this node
+  LOGPROB best_lscore;		///< LM score of the arc to this node on the best path
+  struct __rescore_node__ *bp;	///< Previous node on the best path
+  LOGPROB alpha;		///< Forward score (scaled by cm_alpha)
+  LOGPROB beta;			///< Backward score (scaled by cm_alpha)
+  struct __rescore_node__ *next; ///< Next node of the same graph word
+} RescoreNode;
+
+/// Arc between expanded lattice nodes
+typedef struct {
+  RescoreNode *from;		///< Source node
+  RescoreNode *to;		///< Destination node
+  LOGPROB lscore;		///< LM score of this arc (weighted)
+  LOGPROB amscore;		///< Acoustic score of the destination word on this arc
+} RescoreArc;
+
+/// Acoustic score of a graph word on a span, cached per word
+typedef struct __rescore_am__ {
+  int bgn;			///< Begin frame
+  int end;			///< End frame
+  LOGPROB score;		///< Viterbi score of the word on [bgn..end]
+  struct __rescore_am__ *next;	///< Next cached span of the same word
+} RescoreAM;
+
+/**
+ * <EN>
+ * qsort callback function to order words from right to left.
+ * </EN>
+ * <JA>
+ * ñ򱦤麸¤٤뤿 qsort Хåؿ
+ * </JA>
+ *
+ * @param x [in] 1st element
+ * @param y [in] 2nd element
+ *
+ * @return value required by qsort
+ *
+ */
+static int
+compare_righttime_rev(WordGraph **x, WordGraph **y)
+{
+  if ((*x)->righttime < (*y)->righttime) return 1;
+  else if ((*x)->righttime > (*y)->righttime) return -1;
+  else if ((*x)->lefttime < (*y)->lefttime) return 1;
+  else if ((*x)->lefttime > (*y)->lefttime) return -1;
+  else return 0;
+}
+
+/**
+ * <EN>
+ * Compute addition of two probabilities in log10 form.
+ * </EN>
+ * <JA>
+ * пɽƤΨ¤׻.
+ * </JA>
+ *
+ * @param x [in] first value
+ * @param y [in] second value
+ *
+ * @return value of log(10^x + 10^y)
+ *
+ */
+static LOGPROB
+addlog10(LOGPROB x, LOGPROB y)
+{
+  if (x < y) {
+    return(y + log(1 + pow(10, x-y)) * INV_LOG_TEN);
+  } else {
+    return(x + log(1 + pow(10, y-x)) * INV_LOG_TEN);
+  }
+}
+
+/**
+ * <EN>
+ * Build the HMM of a graph word, with the context dependent phones at
+ * its head and tail as applied in the 2nd pass.
+ * </EN>
+ * <JA>
+ * ñ HMM . ñƬˤ2ѥŬѤ줿
+ * ƥȰ¸βǤѤ.
+ * </JA>
+ *
+ * @param wg [in] graph word
+ * @param r [in] recognition process instance
+ *
+ * @return the newly allocated HMM, or NULL on failure.
+ *
+ */
+static HMM *
+word_hmm_new(WordGraph *wg, RecogProcess *r)
+{
+  WORD_INFO *winfo;
+  HTK_HMM_INFO *hmminfo;
+  HMM_Logical **phones;
+  boolean *has_sp;
+  HMM *hmm;
+  int len, i;
+
+  winfo = r->lm->winfo;
+  hmminfo = r->am->hmminfo;
+  len = winfo->wlen[wg->wid];
+  phones = (HMM_Logical **)mymalloc(sizeof(HMM_Logical *) * len);
+  for(i=0;i<len;i++) phones[i] = winfo->wseq[wg->wid][i];
+  phones[0] = wg->headphone;
+  phones[len-1] = wg->tailphone;
+  has_sp = NULL;
+  if (hmminfo->multipath && r->lm->config->enable_iwsp) {
+    has_sp = (boolean *)mymalloc(sizeof(boolean) * len);
+    for(i=0;i<len;i++) has_sp[i] = FALSE;
+    has_sp[len-1] = TRUE;
+  }
+  hmm = new_make_word_hmm(hmminfo, phones, len, has_sp);
+  if (has_sp) free(has_sp);
+  free(phones);
+
+  return hmm;
+}
+
+/**
+ * <EN>
+ * Compute the Viterbi score of a word HMM on the given span of input.
+ * The path should start at the first frame and end at the last frame.
+ * </EN>
+ * <JA>
+ * Ϥλ֤Фñ HMM  Viterbi ׻. ѥ
+ * ֤κǽΥե졼ǻϤޤꡤǸΥե졼ǽΤȤ.
+ * </JA>
+ *
+ * @param hmm [in] word HMM
+ * @param bgn [in] first frame of the span
+ * @param end [in] last frame of the span
+ * @param param [in] input parameter vectors
+ * @param wrk [i/o] HMM computation work area
+ * @param multipath [in] TRUE if multi-path mode
+ *
+ * @return the Viterbi score, or LOG_ZERO if the span is too short.
+ *
+ */
+static LOGPROB
+word_hmm_viterbi(HMM *hmm, int bgn, int end, HTK_Param *param, HMMWork *wrk, boolean multipath)
+{
+  LOGPROB *cur, *nxt, *tmp;
+  LOGPROB s, result;
+  A_CELL *ac;
+  int t, n, last;
+
+  last = hmm->len - 1;
+  cur = (LOGPROB *)mymalloc(sizeof(LOGPROB) * hmm->len);
+  nxt = (LOGPROB *)mymalloc(sizeof(LOGPROB) * hmm->len);
+  for(n=0;n<hmm->len;n++) cur[n] = LOG_ZERO;
+
+  /* first frame */
+  if (multipath) {
+    /* enter from the initial non-emitting state */
+    for(ac = hmm->state[0].ac; ac; ac = ac->next) {
+      if (ac->arc == last) continue;
+      if (cur[ac->arc] < ac->a) cur[ac->arc] = ac->a;
+    }
+    for(n=1;n<last;n++) {
+      if (cur[n] > LOG_ZERO) cur[n] += outprob(wrk, bgn, &(hmm->state[n]), param);
+    }
+  } else {
+    cur[0] = outprob(wrk, bgn, &(hmm->state[0]), param);
+  }
+
+  /* rest frames */
+  for(t=bgn+1;t<=end;t++) {
+    for(n=0;n<hmm->len;n++) nxt[n] = LOG_ZERO;
+    for(n=0;n<hmm->len;n++) {
+      if (cur[n] <= LOG_ZERO) continue;
+      for(ac = hmm->state[n].ac; ac; ac = ac->next) {
+	if (multipath && ac->arc == last) continue;
+	s = cur[n] + ac->a;
+	if (nxt[ac->arc] < s) nxt[ac->arc] = s;
+      }
+    }
+    for(n=0;n<hmm->len;n++) {
+      if (nxt[n] > LOG_ZERO) nxt[n] += outprob(wrk, t, &(hmm->state[n]), param);
+    }
+    tmp = cur;
+    cur = nxt;
+    nxt = tmp;
+  }
+
+  /* end at the final state */
+  if (multipath) {
+    result = LOG_ZERO;
+    for(n=1;n<last;n++) {
+      if (cur[n] <= LOG_ZERO) continue;
+      for(ac = hmm->state[n].ac; ac; ac = ac->next) {
+	if (ac->arc != last) continue;
+	s = cur[n] + ac->a;
+	if (result < s) result = s;
+      }
+    }
+  } else {
+    result = cur[last];
+  }
+  if (result <= LOG_ZERO) result = LOG_ZERO;
+
+  free(nxt);
+  free(cur);
+
+  return result;
+}
+
+/**
+ * <EN>
+ * Get acoustic score of a graph word on the given span.  The word HMM
+ * and the computed scores are cached per graph word.
+ * </EN>
+ * <JA>
+ * ֤ˤ륰ñβ. ñ HMM ȷ׻Ѥߤ
+ * ϥñ줴Ȥݻ.
+ * </JA>
+ *
+ * @param wg [in] graph word
+ * @param bgn [in] first frame of the span
+ * @param end [in] last frame of the span
+ * @param whmm [i/o] word HMM for each graph word
+ * @param amcache [i/o] computed scores for each graph word
+ * @param param [in] input parameter vectors
+ * @param r [i/o] recognition process instance
+ * @param arena [i/o] memory arena for allocation
+ *
+ * @return the acoustic score, or LOG_ZERO if not computable.
+ *
+ */
+static LOGPROB
+word_am_score(WordGraph *wg, int bgn, int end, HMM **whmm, RescoreAM **amcache, HTK_Param *param, RecogProcess *r, BMALLOC_BASE **arena)
+{
+  RescoreAM *a;
+
+  if (bgn > end) return LOG_ZERO;
+  for(a = amcache[wg->id]; a; a = a->next) {
+    if (a->bgn == bgn && a->end == end) return a->score;
+  }
+  if (whmm[wg->id] == NULL) {
+    whmm[wg->id] = word_hmm_new(wg, r);
+    if (whmm[wg->id] == NULL) return LOG_ZERO;
+  }
+  a = (RescoreAM *)mybmalloc2(sizeof(RescoreAM), arena);
+  a->bgn = bgn;
+  a->end = end;
+  a->score = word_hmm_viterbi(whmm[wg->id], bgn, end, param, r->wchmm->hmmwrk, r->am->hmminfo->multipath);
+  a->next = amcache[wg->id];
+  amcache[wg->id] = a;
+
+  return a->score;
+}
+
+/**
+ * <JA>
+ * ñǻꤵ줿ŸΡɤõʤ
+ * ˺. 1ñ줢ΥΡɿ¤ãƤϡ
+ * ǤĹפ¸ΥΡɤʻ礹.
+ *
+ * @param head [i/o] ñΥΡɥꥹȤƬ
+ * @param wg [in] ñ
+ * @param hist [in] ñ
+ * @param hlen [in] @a hist Ĺ
+ * @param maxnum [in] 1ñ줢ΥΡɿξ (0 ̵)
+ * @param merged [out] ʻ礬Ԥ줿Ȥ TRUE åȤ
+ * @param arena [i/o] ΰ
+ *
+ * @return Ĥä뤤Ϻ줿Ρ
+ * </JA>
+ * <EN>
+ * Find an expanded node of the graph word with the given history, or
+ * create a new one if not found.  When the number of nodes of the word
+ * has reached the limit, it is merged to an existing node whose history
+ * shares the longest tail with the given one.
+ *
+ * @param head [i/o] head of the node list of the graph word
+ * @param wg [in] graph word
+ * @param hist [in] word history
+ * @param hlen [in] length of @a hist
+ * @param maxnum [in] maximum number of nodes per word (0 for unlimited)
+ * @param merged [out] set to TRUE when merged
+ * @param arena [i/o] memory arena for allocation
+ *
+ * @return the found or created node.
+ * </EN>
+ */
+static RescoreNode *
+rescore_node_get(RescoreNode **head, WordGraph *wg, WORD_ID *hist, int hlen, int maxnum, boolean *merged, BMALLOC_BASE **arena)
+{
+  RescoreNode *n, *nbest;
+  int i, num, match, bestmatch;
+
+  num = 0;
+  nbest = NULL;
+  bestmatch = -1;
+  for(n = *head; n; n = n->next) {
+    for(match = 0; match < n->hlen && match < hlen; match++) {
+      if (n->hist[n->hlen - 1 - match] != hist[hlen - 1 - match]) break;
+    }
+    if (match == hlen && match == n->hlen) return n;
+    if (match > bestmatch) {
+      bestmatch = match;
+      nbest = n;
+    }
+    num++;
+  }
+  if (maxnum > 0 && num >= maxnum) {
+    *merged = TRUE;
+    return nbest;
+  }
+
+  n = (RescoreNode *)mybmalloc2(sizeof(RescoreNode), arena);
+  n->wg = wg;
+  n->hlen = hlen;
+  n->hist = NULL;
+  if (hlen > 0) {
+    n->hist = (WORD_ID *)mybmalloc2(sizeof(WORD_ID) * hlen, arena);
+    for(i=0;i<hlen;i++) n->hist[i] = hist[i];
+  }
+  n->best = LOG_ZERO;
+  n->best_lscore = 0.0;
+  n->bp = NULL;
+  n->alpha = LOG_ZERO;
+  n->beta = LOG_ZERO;
+  n->next = *head;
+  *head = n;
+
+  return n;
+}
+
+/**
+ * <JA>
+ * @brief  ñ쥰դ絬 N-gram ǥꥹ󥰤.
+ *
+ * ñ쥰դ N-gram ʤ麸鱦ʤ鱦麸
+ * ʤ顤ƥññ򤴤ȤŸ쥹
+ * ѥ forward-backward ˤΨ. Ψϳƥ
+ * ñ graph_cm ˾񤭤졤ѥ1̤ǧ
+ * (r->result.sent[0]) ֤.
+ *
+ * ñϤ餫 wordgraph_sort_and_annotate_id()  ID 
+ * Ƥɬפ.
+ * </JA>
+ * <EN>
+ * @brief  Rescore the word graph with a large N-gram.
+ *
+ * The word graph is traversed in the direction of the N-gram (from left
+ * to right for forward N-gram, from right to left for backward N-gram),
+ * and each graph word is expanded for each word history.  The best path
+ * and the posterior probabilities by forward-backward are computed with
+ * the new LM scores.  The posteriors overwrite graph_cm of each graph
+ * word, and the best path replaces the first recognition result
+ * (r->result.sent[0]).
+ *
+ * The graph words should have been annotated their IDs by
+ * wordgraph_sort_and_annotate_id() beforehand.
+ * </EN>
+ *
+ * @param root [i/o] root graph node
+ * @param param [in] input parameter vectors
+ * @param r [i/o] recognition process instance
+ *
+ * @callgraph
+ * @callergraph
+ *
+ */
+void
+graph_rescore(WordGraph *root, HTK_Param *param, RecogProcess *r)
+{
+  NGRAM_INFO *ngram;
+  WORD_INFO *winfo;
+  WORD_ID *wton;
+  WordGraph *wg, *pwg;
+  WordGraph **wlist, **plist;
+  RescoreNode **head;
+  RescoreNode *n, *p, *nbest;
+  RescoreArc *arc;
+  int arcnum, arcalloc;
+  int count, nodenum, i, j, k, plen, hlen;
+  int mergenum;
+  boolean merged;
+  boolean forward;
+  boolean changed;
+  WORD_ID *q;
+  WORD_ID w;
+  LOGPROB rawscore, lscore, s, am, sum;
+  int bgn, end;
+  LOGPROB weight, penalty, cm_alpha;
+  BMALLOC_BASE *arena;
+  HMM **whmm;
+  RescoreAM **amcache;
+  Sentence *sent;
+  WordGraph *seq[MAXSEQNUM];
+  LOGPROB totallscore;
+  int seqnum;
+
+  ngram = r->lm->ngram_rescore;
+  winfo = r->lm->winfo;
+  wton = r->lm->rescore_wton;
+  if (ngram == NULL || wton == NULL) return;
+
+  count = 0;
+  for(wg=root;wg;wg=wg->next) count++;
+  if (count == 0) return;
+
+  weight = r->config->graph.rescore_weight;
+  penalty = r->config->graph.rescore_penalty;
+  cm_alpha = r->config->annotate.cm_alpha;
+  forward = (ngram->dir == DIR_RL) ? FALSE : TRUE;
+
+  /* order the graph words in the direction of the N-gram */
+  wlist = (WordGraph **)mymalloc(sizeof(WordGraph *) * count);
+  i = 0;
+  for(wg=root;wg;wg=wg->next) wlist[i++] = wg;
+  if (! forward) {
+    qsort(wlist, count, sizeof(WordGraph *), (int (*)(const void *, const void *))compare_righttime_rev);
+  }
+
+  head = (RescoreNode **)mymalloc(sizeof(RescoreNode *) * count);
+  whmm = (HMM **)mymalloc(sizeof(HMM *) * count);
+  amcache = (RescoreAM **)mymalloc(sizeof(RescoreAM *) * count);
+  for(i=0;i<count;i++) {
+    head[i] = NULL;
+    whmm[i] = NULL;
+    amcache[i] = NULL;
+  }
+  arcalloc = count * 4;
+  arcnum = 0;
+  arc = (RescoreArc *)mymalloc(sizeof(RescoreArc) * arcalloc);
+  q = (WORD_ID *)mymalloc(sizeof(WORD_ID) * ngram->n);
+  arena = NULL;
+  nodenum = 0;
+  mergenum = 0;
+
+  /* expand lattice and compute the best path and forward scores */
+  for(i=0;i<count;i++) {
+    wg = wlist[i];
+    w = wton[wg->wid];
+    if (forward) {
+      plist = wg->leftword;
+      plen = (wg->lefttime == 0) ? 0 : wg->leftwordnum;
+    } else {
+      plist = wg->rightword;
+      plen = (wg->righttime == r->peseqlen - 1) ? 0 : wg->rightwordnum;
+    }
+    if (plen == 0) {
+      /* start word: no LM score is given, and covers from the input edge */
+      if (forward) {
+	am = word_am_score(wg, 0, wg->righttime, whmm, amcache, param, r, &arena);
+      } else {
+	am = word_am_score(wg, wg->lefttime, r->peseqlen - 1, whmm, amcache, param, r, &arena);
+      }
+      if (am <= LOG_ZERO) continue;
+      merged = FALSE;
+      if (winfo->is_transparent[wg->wid]) {
+	n = rescore_node_get(&(head[wg->id]), wg, NULL, 0, 0, &merged, &arena);
+      } else {
+	n = rescore_node_get(&(head[wg->id]), wg, &w, 1, 0, &merged, &arena);
+      }
+      n->best = am;
+      n->alpha = am * cm_alpha;
+      continue;
+    }
+    for(j=0;j<plen;j++) {
+      pwg = plist[j];
+      /* this word covers from just after the previous word, so that every
+	 frame is counted once even when the boundaries do not match */
+      if (forward) {
+	bgn = pwg->righttime + 1;
+	end = wg->righttime;
+      } else {
+	bgn = wg->lefttime;
+	end = pwg->lefttime - 1;
+      }
+      am = word_am_score(wg, bgn, end, whmm, amcache, param, r, &arena);
+      if (am <= LOG_ZERO) continue;
+      for(p = head[pwg->id]; p; p = p->next) {
+	if (p->best == LOG_ZERO) continue;
+	/* compute N-gram probability of this word given the history */
+	for(k=0;k<p->hlen;k++) q[k] = p->hist[k];
+	q[p->hlen] = w;
+	rawscore = ngram_prob(ngram, p->hlen + 1, q);
+#ifdef CLASS_NGRAM
+	rawscore += winfo->cprob[wg->wid];
+#endif
+	lscore = rawscore * weight + penalty;
+	if (winfo->is_transparent[wg->wid] && winfo->is_transparent[pwg->wid]) {
+	  lscore += r->config->lmp.lm_penalty_trans;
+	}
+	/* new history */
+	if (winfo->is_transparent[wg->wid]) {
+	  hlen = p->hlen;
+	} else if (p->hlen + 1 > ngram->n - 1) {
+	  hlen = ngram->n - 1;
+	  for(k=0;k<hlen;k++) q[k] = q[k+1];
+	} else {
+	  hlen = p->hlen + 1;
+	}
+	merged = FALSE;
+	n = rescore_node_get(&(head[wg->id]), wg, q, hlen, r->config->graph.rescore_maxhist, &merged, &arena);
+	if (merged) mergenum++;
+	/* store arc */
+	if (arcnum >= arcalloc) {
+	  arcalloc *= 2;
+	  arc = (RescoreArc *)myrealloc(arc, sizeof(RescoreArc) * arcalloc);
+	}
+	arc[arcnum].from = p;
+	arc[arcnum].to = n;
+	arc[arcnum].lscore = lscore;
+	arc[arcnum].amscore = am;
+	arcnum++;
+	/* viterbi */
+	s = p->best + lscore + am;
+	if (n->best < s) {
+	  n->best = s;
+	  n->best_lscore = lscore;
+	  n->bp = p;
+	}
+	/* forward */
+	n->alpha = addlog10(n->alpha, p->alpha + (lscore + am) * cm_alpha);
+      }
+    }
+  }
+
+  /* find the best end node and the total forward score */
+  nbest = NULL;
+  sum = LOG_ZERO;
+  for(i=0;i<count;i++) {
+    wg = wlist[i];
+    for(n = head[wg->id]; n; n = n->next) nodenum++;
+    if (forward) {
+      if (wg->righttime != r->peseqlen - 1) continue;
+    } else {
+      if (wg->lefttime != 0) continue;
+    }
+    for(n = head[wg->id]; n; n = n->next) {
+      if (n->best == LOG_ZERO) continue;
+      n->beta = 0.0;
+      sum = addlog10(sum, n->alpha);
+      if (nbest == NULL || nbest->best < n->best) nbest = n;
+    }
+  }
+
+  if (nbest == NULL) {
+    jlog("WARNING: graph_rescore: no path found on the expanded lattice, rescoring skipped\n");
+  } else {
+    /* backward procedure: arcs are stored in topological order of the
+       destination, so processing them in reverse order gives backward
+       scores */
+    for(k=arcnum-1;k>=0;k--) {
+      n = arc[k].to;
+      if (n->beta == LOG_ZERO) continue;
+      p = arc[k].from;
+      p->beta = addlog10(p->beta, n->beta + (arc[k].lscore + arc[k].amscore) * cm_alpha);
+    }
+    /* posterior probability of each graph word */
+    for(i=0;i<count;i++) {
+      wg = wlist[i];
+      s = LOG_ZERO;
+      for(n = head[wg->id]; n; n = n->next) {
+	if (n->alpha == LOG_ZERO || n->beta == LOG_ZERO) continue;
+	s = addlog10(s, n->alpha + n->beta);
+      }
+      wg->graph_cm = (s == LOG_ZERO) ? 0.0 : pow(10, s - sum);
+    }
+
+    /* trace back the best path */
+    seqnum = 0;
+    totallscore = 0.0;
+    for(n = nbest; n; n = n->bp) {
+      if (seqnum >= MAXSEQNUM) break;
+      seq[seqnum++] = n->wg;
+      totallscore += n->best_lscore;
+    }
+    if (n != NULL) {
+      jlog("WARNING: graph_rescore: best path too long (> %d), result not replaced\n", MAXSEQNUM);
+    } else if (r->result.sentnum > 0) {
+      sent = &(r->result.sent[0]);
+      if (verbose_flag) {
+	/* compare with the 2nd pass result: when rescored with the same LM
+	   as the 2nd pass, the sentence should be the same */
+	changed = (sent->word_num != seqnum);
+	for(i=0;i<seqnum && !changed;i++) {
+	  wg = forward ? seq[seqnum - 1 - i] : seq[i];
+	  if (sent->word[i] != wg->wid) changed = TRUE;
+	}
+	jlog("STAT: graph_rescore: 2nd pass score = %f, rescored score = %f, sentence %s\n", sent->score, nbest->best, changed ? "changed" : "unchanged");
+      }
+      /* replace the first result */
+      sent->word_num = seqnum;
+      for(i=0;i<seqnum;i++) {
+	wg = forward ? seq[seqnum - 1 - i] : seq[i];
+	sent->word[i] = wg->wid;
+#ifdef CONFIDENCE_MEASURE
+	sent->confidence[i] = wg->graph_cm;
+#endif
+      }
+      sent->score = nbest->best;
+      sent->score_lm = totallscore;
+      sent->score_am = nbest->best - totallscore;
+    }
+  }
+
+  if (verbose_flag) {
+    jlog("STAT: graph_rescore: %d words expanded to %d nodes, %d arcs", count, nodenum, arcnum);
+    if (mergenum > 0) jlog(" (%d merged)", mergenum);
+    jlog("\n");
+    if (nbest) jlog("STAT: graph_rescore: best score = %f, forward score = %f\n", nbest->best, sum);
+  }
+
+  for(i=0;i<count;i++) {
+    if (whmm[i]) free_hmm(whmm[i]);
+  }
+  free(amcache);
+  free(whmm);
+  free(q);
+  free(arc);
+  free(head);
+  free(wlist);
+  mybfree2(&arena);
+}
+
+/* end of file */
@@ -77,6 +77,7 @@ wordgraph_init(WCHMM_INFO *wchmm)
  * @param gscore_tail [in] ǤüViterbi (g)
  * @param lscore [in] ñθ쥹 (Julian Ǥͤ˰̣ʤ)
  * @param cm [in] ñο٥ (õưŪ˷׻줿)
+ * @param arena [i/o] ñ֤ꥢ꡼
  * 
  * @return 줿ñؤΥݥ
  * </JA>
@@ -94,16 +95,17 @@ wordgraph_init(WCHMM_INFO *wchmm)
  * @param gscore_tail [in] Viterbi score accumulated from input end at word tail (g)
  * @param lscore [in] language score of the word (bogus in Julian)
  * @param cm [in] word confidence score (computed on search time)
+ * @param arena [i/o] memory arena to hold the graph word
  * 
  * @return pointer to the newly created graph word.
  * </EN>
  */
 static WordGraph *
-wordgraph_new(WORD_ID wid, HMM_Logical *headphone, HMM_Logical *tailphone, int leftframe, int rightframe, LOGPROB fscore_head, LOGPROB fscore_tail, LOGPROB gscore_head, LOGPROB gscore_tail, LOGPROB lscore, LOGPROB cm)
+wordgraph_new(WORD_ID wid, HMM_Logical *headphone, HMM_Logical *tailphone, int leftframe, int rightframe, LOGPROB fscore_head, LOGPROB fscore_tail, LOGPROB gscore_head, LOGPROB gscore_tail, LOGPROB lscore, LOGPROB cm, BMALLOC_ARENA *arena)
 {
   WordGraph *new;
 
-  new = (WordGraph *)mymalloc(sizeof(WordGraph));
+  new = (WordGraph *)mybarena_malloc(sizeof(WordGraph), arena);
   new->wid = wid;
   new->lefttime = leftframe;
   new->righttime = rightframe;
@@ -163,12 +165,15 @@ wordgraph_new(WORD_ID wid, HMM_Logical *headphone, HMM_Logical *tailphone, int l
 
 /** 
  * <JA>
- * 륰ñΥΰ. 
+ * 륰ñΥΰ. Ĺʸ̮ñΥꥹȤ
+ * . ñ켫Τϥꥢ꡼ʤȤȤ˲. 
  * 
  * @param wg [in] ñ
  * </JA>
  * <EN>
- * Free a graph word.
+ * Free a graph word.  This frees the context word lists, which grow
+ * by realloc().  The graph word itself will be released with the
+ * memory arena.
  * 
  * @param wg [in] graph word to be freed.
  * </EN>
@@ -184,7 +189,6 @@ wordgraph_free(WordGraph *wg)
   free(wg->right_lscore);
   free(wg->leftword);
   free(wg->left_lscore);
-  free(wg);
 }
 
 /**************************************************************/
@@ -1206,6 +1210,7 @@ wordgraph_depth_cut(WordGraph **rootp, RecogProcess *r)
  * @param lmtype
  * @param p_framelist
  * @param p_framescorelist
+ * @param arena [i/o] ʣñ֤ꥢ꡼
  * 
  * @return ñ줬İʾѹ TRUEѹʤǤ FALSE
  * ֤. 
@@ -1229,12 +1234,13 @@ wordgraph_depth_cut(WordGraph **rootp, RecogProcess *r)
  * @param lmtype
  * @param p_framelist
  * @param p_framescorelist
+ * @param arena [i/o] memory arena to hold duplicated words
  * 
  * @return TRUE if any word has been changed, or FALSE if no word has been altered.
  * </EN>
  */
 static boolean
-wordgraph_adjust_boundary_sub(WordGraph **rootp, int *mov_num_ret, int *dup_num_ret, int *del_num_ret, int *mod_num_ret, int count, int *maxfnum, int peseqlen, int lmtype, int **p_framelist, LOGPROB **p_framescorelist)
+wordgraph_adjust_boundary_sub(WordGraph **rootp, int *mov_num_ret, int *dup_num_ret, int *del_num_ret, int *mod_num_ret, int count, int *maxfnum, int peseqlen, int lmtype, int **p_framelist, LOGPROB **p_framescorelist, BMALLOC_ARENA *arena)
 {
   WordGraph *wg, *left, *new;
   int i, j, k;
@@ -1427,7 +1433,7 @@ wordgraph_adjust_boundary_sub(WordGraph **rootp, int *mov_num_ret, int *dup_num_
 #else
 			      , LOG_ZERO
 #endif
-			      );
+			      , arena);
 	  /* copy corresponding link */
 	  for(i=0;i<wg->leftwordnum;i++) {
 	    if ((wg->leftword[i])->mark) continue;
@@ -1616,7 +1622,7 @@ wordgraph_adjust_boundary(WordGraph **rootp, RecogProcess *r)
 
   do {
     /* do adjust */
-    flag = wordgraph_adjust_boundary_sub(rootp, &mov_num, &dup_num, &del_num, &mod_num, count, &maxfnum, r->peseqlen, r->lmtype, &framelist, &framescorelist);
+    flag = wordgraph_adjust_boundary_sub(rootp, &mov_num, &dup_num, &del_num, &mod_num, count, &maxfnum, r->peseqlen, r->lmtype, &framelist, &framescorelist, &(r->arena));
     /* do compaction */
     wordgraph_compaction_thesame_sub(rootp, &count, &merged);
     if (verbose_flag) jlog("STAT: graphout: #%d: %d moved, %d duplicated, %d purged, %d modified, %d idential, %d left\n", loopcount + 1, mov_num, dup_num, del_num, mod_num, merged, count);
@@ -1926,7 +1932,7 @@ wordgraph_assign(WORD_ID wid, WORD_ID wid_left, WORD_ID wid_right, int leftframe
   }
 
   /* generate a new graph word hypothesis */
-  newarc = wordgraph_new(wid, head, tail, leftframe, rightframe, fscore_head, fscore_tail, gscore_head, gscore_tail, lscore, cm);
+  newarc = wordgraph_new(wid, head, tail, leftframe, rightframe, fscore_head, fscore_tail, gscore_head, gscore_tail, lscore, cm, &(r->arena));
   //jlog("DEBUG:     [%d..%d] %d\n", leftframe, rightframe, wid);
   return newarc;
 }
@@ -232,6 +232,8 @@ j_process_lm_free(PROCESS_LM *lm)
 {
   if (lm->winfo) word_info_free(lm->winfo);
   if (lm->ngram) ngram_info_free(lm->ngram);
+  if (lm->ngram_rescore) ngram_info_free(lm->ngram_rescore);
+  if (lm->rescore_wton) free(lm->rescore_wton);
   if (lm->grammars) multigram_free_all(lm->grammars);
   if (lm->dfa) dfa_info_free(lm->dfa);
   /* not free lm->jconf  */
@@ -265,6 +267,7 @@ j_recogprocess_new(Recog *recog, JCONF_SEARCH *sconf)
   new->live = FALSE;
   new->active = 0;
   new->next = NULL;
+  mybarena_init(&(new->arena));
 
   /* assign configuration */
   new->config = sconf;
@@ -310,6 +313,8 @@ j_recogprocess_free(RecogProcess *process)
   if (process->backtrellis) bt_free(process->backtrellis);
   /* free pass1 work area */
   fsbeam_free(&(process->pass1));
+  /* free memory arena for per-input data */
+  mybarena_free(&(process->arena));
   free(process);
 }
 
@@ -691,6 +696,7 @@ j_jconf_new()
   /* set gmm am jconf */
   jconf->gmm = NULL;
   jconf->outprob_outfile = NULL;
+  jconf->parallel_load = FALSE;
 
   return(jconf);
 }
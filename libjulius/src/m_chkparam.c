@@ -308,6 +308,9 @@ j_jconf_finalize(Jconf *jconf)
 	jlog("WARNING: m_chkparam: \"-sepnum\" only for N-gram, ignored\n");
       }
 #endif
+      if (lm->wchmm_cache_filename) {
+	jlog("WARNING: m_chkparam: \"-wchmmcache\" only for N-gram, ignored\n");
+      }
     }  
     if (lm->lmtype != LM_DFA) {
       /* in case not a deterministic model */
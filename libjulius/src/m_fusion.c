@@ -31,6 +31,9 @@
  */
 
 #include <julius/julius.h>
+#ifdef PARALLEL_LOAD
+#include <pthread.h>
+#endif
 
 /** 
  * <JA>
@@ -414,44 +417,41 @@ initialize_dict(JCONF_LM *lmconf, HTK_HMM_INFO *hmminfo)
 
 /** 
  * <JA>
- * @brief  ñN-gramե뤫ɤ߹ǥåȥåפ. 
+ * @brief  ñN-gramե뤫ɤ߹. 
  *
  * ARPA եޥåȤǻϡLRե RL եȹ礻
  * ưۤʤ. LR Τߡ뤤 RL Τ߻ϡ򤽤Τޤɤ߹. 
  * ȤꤵƤϡRLޤǥȤɤ߹塤
  * LR  2-gram 1ѥѤ˼ǥɲɤ߹ߤ. 
- *
- * ޤɤ߹߽λ塤N-gramȥȤΥޥå󥰤. 
  * 
  * </JA>
  * <EN>
- * @brief  Read in word N-gram from file and setup for recognition.
+ * @brief  Read in word N-gram from file.
  *
  * When N-gram is specified in ARPA format, the behavior relies on whether
  * N-grams are specified in "-nlr" and "-nrl".  When either of them was
  * solely specified,  this function simply read it.  If both are specified,
  * it will read the RL model fully as a primary model, and additionally
  * read only the 2-gram part or the LR model as the first pass LM.
- *
- * Also, this function create mapping from dictionary words to LM entry.
  * 
  * </EN>
  *
  * @param lmconf [in] LM configuration variables
- * @param winfo [i/o] word dictionary that will be used with this N-gram.
- * each word in the dictionary will be assigned to an N-gram entry here.
  *
  * @return the newly created N-gram information data, or NULL on failure.
  * 
  */
 static NGRAM_INFO *
-initialize_ngram(JCONF_LM *lmconf, WORD_INFO *winfo)
+read_ngram(JCONF_LM *lmconf)
 {
   NGRAM_INFO *ngram;
   boolean ret;
+  double t;
 
+  t = pass2_clock_msec();
   /* allocate new */
   ngram = ngram_info_new();
+  ngram->read_thread_num = lmconf->arpa_thread_num;
   /* load LM */
   if (lmconf->ngram_filename != NULL) {	/* binary format */
     ret = init_ngram_bin(ngram, lmconf->ngram_filename);
@@ -486,6 +486,42 @@ initialize_ngram(JCONF_LM *lmconf, WORD_INFO *winfo)
     set_unknown_id(ngram, lmconf->unknown_name);
   }
 
+  jlog("STAT: load time: LM%02d %s N-gram: %.2f sec\n", lmconf->id, lmconf->name, (pass2_clock_msec() - t) / 1000.0);
+
+  return(ngram);
+}
+
+/** 
+ * <JA>
+ * @brief  ñN-gramɤ߹ߡȤΥޥå󥰤. 
+ *
+ * N-gram ɤ߹ޤƤФѤ. 
+ * 
+ * @param lmconf [in] LMѥ᡼
+ * @param winfo [i/o] ñ켭
+ * @param ngram [in] ɤ߹ߺѤߤ N-gramե뤫ɤ߹ NULL
+ * 
+ * @return  N-gramԻ NULL ֤. 
+ * </JA>
+ * <EN>
+ * @brief  Read in word N-gram and map dictionary words to it.
+ *
+ * If the N-gram has been already read, it is used.
+ * 
+ * @param lmconf [in] LM configuration variables
+ * @param winfo [i/o] word dictionary that will be used with this N-gram.
+ * @param ngram [in] N-gram already read, or NULL to read it from file
+ * 
+ * @return the N-gram information data, or NULL on failure.
+ * </EN>
+ */
+static NGRAM_INFO *
+initialize_ngram(JCONF_LM *lmconf, WORD_INFO *winfo, NGRAM_INFO *ngram)
+{
+  if (ngram == NULL) {
+    if ((ngram = read_ngram(lmconf)) == NULL) return NULL;
+  }
+
   /* map dict item to N-gram entry */
   if (make_voca_ref(ngram, winfo) == FALSE) {
     ngram_info_free(ngram);
@@ -498,6 +534,144 @@ initialize_ngram(JCONF_LM *lmconf, WORD_INFO *winfo)
   return(ngram);
 }
 
+/** 
+ * <JA>
+ * γñ줫顤ñ쥰դΥꥹ N-gram Υȥؤ
+ * бɽ. 
+ * 
+ * @param lm [i/o] LM󥹥
+ * 
+ * @return  TRUEN-gram бդʤñ줬 FALSE ֤. 
+ * </JA>
+ * <EN>
+ * Make mapping from each dictionary word to the entry of N-gram for
+ * word graph rescoring.
+ * 
+ * @param lm [i/o] LM process instance
+ * 
+ * @return TRUE on success, or FALSE if some words can not be mapped to
+ * the N-gram.
+ * </EN>
+ */
+static boolean
+map_ngram_rescore(PROCESS_LM *lm)
+{
+  NGRAM_INFO *ngram;
+  WORD_INFO *winfo;
+  WORD_ID w;
+  int count;
+
+  ngram = lm->ngram_rescore;
+  winfo = lm->winfo;
+
+  if (lm->rescore_wton) free(lm->rescore_wton);
+  lm->rescore_wton = (WORD_ID *)mymalloc(sizeof(WORD_ID) * winfo->maxnum);
+
+  jlog("STAT: m_fusion: mapping dictonary words to rescoring n-gram entries\n");
+  count = 0;
+  ngram->unk_num = 0;
+  for (w = 0; w < winfo->num; w++) {
+    lm->rescore_wton[w] = make_ngram_ref(ngram, winfo->wname[w]);
+    if (lm->rescore_wton[w] == WORD_INVALID) {
+      count++;
+    } else if (lm->rescore_wton[w] == ngram->unk_id) {
+      (ngram->unk_num)++;
+    }
+  }
+  if (count > 0) {
+    jlog("ERROR: m_fusion: failed to map %d words in dictionary to rescoring N-gram\n", count);
+    return FALSE;
+  }
+  if (ngram->unk_num == 0) {
+    ngram->unk_num_log = 0.0;
+  } else {
+    ngram->unk_num_log = (float)log10(ngram->unk_num);
+  }
+
+  return TRUE;
+}
+
+/** 
+ * <JA>
+ * @brief  ñ쥰դΥꥹ N-gram ɤ߹. 
+ *
+ * "-lmrescore" ǻꤵ줿Хʥ N-gram ɤ߹. 
+ * mkbingram  "-mmap" Ǻ v6/v7 Ǥ
+ * եϥľܥޥåפ졤ºݤ˻Ȥ줿ʬΤߤ
+ * ɤ߹ޤ. 
+ * 
+ * @param lmconf [in] LMѥ᡼
+ * 
+ * @return  N-gramԻ NULL ֤. 
+ * </JA>
+ * <EN>
+ * @brief  Read N-gram for word graph rescoring.
+ *
+ * The binary N-gram specified by "-lmrescore" is read.  When it is in
+ * v6/v7 format made by "mkbingram -mmap", the file is mapped to memory
+ * directly and only the part actually referred will be read.
+ * 
+ * @param lmconf [in] LM configuration variables
+ * 
+ * @return the newly created N-gram, or NULL on failure.
+ * </EN>
+ */
+static NGRAM_INFO *
+read_ngram_rescore(JCONF_LM *lmconf)
+{
+  NGRAM_INFO *ngram;
+  double t;
+
+  t = pass2_clock_msec();
+  ngram = ngram_info_new();
+  if (init_ngram_bin(ngram, lmconf->ngram_filename_rescore) == FALSE) {
+    ngram_info_free(ngram);
+    return NULL;
+  }
+  /* set unknown (=OOV) word id */
+  if (strcmp(lmconf->unknown_name, UNK_WORD_DEFAULT)) {
+    set_unknown_id(ngram, lmconf->unknown_name);
+  }
+  jlog("STAT: load time: LM%02d %s rescoring N-gram: %.2f sec\n", lmconf->id, lmconf->name, (pass2_clock_msec() - t) / 1000.0);
+
+  return(ngram);
+}
+
+/** 
+ * <JA>
+ * @brief  ñ쥰դΥꥹ N-gram 򥻥åȥåפ. 
+ *
+ * N-gram ɤ߹ޤƤʤɤ߹ߡñȤ
+ * б. 
+ * 
+ * @param lm [i/o] LM󥹥
+ * @param ngram [in] ɤ߹ߺѤߤ N-gramե뤫ɤ߹ NULL
+ * 
+ * @return  TRUEԻ FALSE ֤. 
+ * </JA>
+ * <EN>
+ * @brief  Set up N-gram for word graph rescoring.
+ *
+ * The N-gram is read if not read yet, and mapped to the dictionary words.
+ * 
+ * @param lm [i/o] LM process instance
+ * @param ngram [in] N-gram already read, or NULL to read it from file
+ * 
+ * @return TRUE on success, or FALSE on failure.
+ * </EN>
+ */
+static boolean
+initialize_ngram_rescore(PROCESS_LM *lm, NGRAM_INFO *ngram)
+{
+  if (ngram == NULL) {
+    if ((ngram = read_ngram_rescore(lm->config)) == NULL) return FALSE;
+  }
+  lm->ngram_rescore = ngram;
+
+  /* map dict item to N-gram entry */
+  return(map_ngram_rescore(lm));
+}
+
 /** 
  * <EN>
  * @brief  Load an acoustic model.
@@ -534,7 +708,9 @@ boolean
 j_load_am(Recog *recog, JCONF_AM *amconf)
 {
   PROCESS_AM *am;
+  double t;
 
+  t = pass2_clock_msec();
   jlog("STAT: *** loading AM%02d %s\n", amconf->id, amconf->name);
 
   /* create AM process instance */
@@ -576,57 +752,42 @@ j_load_am(Recog *recog, JCONF_AM *amconf)
   amconf->analysis.para.loaded = 0;
 
   jlog("STAT: *** AM%02d %s loaded\n", amconf->id, amconf->name);
+  jlog("STAT: load time: AM%02d %s: %.2f sec\n", amconf->id, amconf->name, (pass2_clock_msec() - t) / 1000.0);
 
   return TRUE;
 }
 
 /** 
- * <EN>
- * @brief  Load a language model.
- *
- * This function will create an LM process instance using the given LM
- * configuration, and load models specified in the configuration into
- * the instance.  Then the created instance will be installed to the
- * engine instance.  The lmconf should be registered to the 
- * recog->jconf before calling this function.
- *
- * To convert phoneme sequence to triphone at loading, you should
- * specify which AM to use with this LM by the argument am.
- *
- * </EN>
- *
  * <JA>
- * @brief ǥɤ߹ࡥ
+ * @brief  LM󥹥󥹤ޤʸˡɤ߹. 
  *
- * δؿϡͿ줿 LM ˽ä LM 󥹥󥹤
- * ˸ǥɤޤθ塤LM󥹥󥹤
- * ˥󥸥󥤥󥹥󥹤ϿޤLMϤδؿ
- * Ƥˤ餫recog->jconfϿƤɬפޤ
- *
- * ɤ߹߻˥ȥ饤եؤѴӲǥȤΥ󥯤
- * Ʊ˹ԤޤΤᡤθǥ뤬Ѥ벻ǥ
- * 󥹥󥹤 am Ȥƻꤹɬפޤ
+ * б AM 󥹥󥹤ϴɤ߹ޤƤɬפ. 
+ * N-gram ɤ߹ߤ load_lm_ngram() ǹԤ. 
  * 
+ * @param recog [i/o] 󥸥󥤥󥹥
+ * @param lmconf [in] ɤ߹ LM 
+ * 
+ * @return  LM 󥹥󥹡顼 NULL ֤. 
  * </JA>
+ * <EN>
+ * @brief  Create an LM process instance and load dictionary or grammars.
+ *
+ * The corresponding AM process instance should be already loaded.
+ * The N-gram will be loaded by load_lm_ngram().
  * 
  * @param recog [i/o] engine instance
  * @param lmconf [in] LM configuration to load
  * 
- * @return TRUE on success, or FALSE on error.
- * 
- * @callgraph
- * @callergraph
- * @ingroup instance
- * 
+ * @return the created LM process instance, or NULL on error.
+ * </EN>
  */
-boolean
-j_load_lm(Recog *recog, JCONF_LM *lmconf)
+static PROCESS_LM *
+load_lm_dict(Recog *recog, JCONF_LM *lmconf)
 {
   JCONF_SEARCH *sh;
   PROCESS_LM *lm;
   PROCESS_AM *am, *atmp;
-
-  jlog("STAT: *** loading LM%02d %s\n", lmconf->id, lmconf->name);
+  double t;
 
   /* find which am process instance to assign to each LM */
   am = NULL;
@@ -642,7 +803,7 @@ j_load_lm(Recog *recog, JCONF_LM *lmconf)
   if (am == NULL) {
     jlog("ERROR: cannot find corresponding AM for LM%02d %s\n", lmconf->id, lmconf->name);
     jlog("ERROR: you should write all AM/LM combinations to be used for recognition with \"-SR\"\n");
-    return FALSE;
+    return NULL;
   }
 
   /* create LM process instance */
@@ -651,19 +812,14 @@ j_load_lm(Recog *recog, JCONF_LM *lmconf)
   /* assign AM process instance to the LM instance */
   lm->am = am;
 
-  /* load language model */
+  t = pass2_clock_msec();
   if (lm->lmtype == LM_PROB) {
-    /* LM (N-gram) */
+    /* dictionary for N-gram */
     if ((lm->winfo = initialize_dict(lm->config, lm->am->hmminfo)) == NULL) {
       jlog("ERROR: m_fusion: failed to initialize dictionary\n");
-      return FALSE;
-    }
-    if (lm->config->ngram_filename_lr_arpa || lm->config->ngram_filename_rl_arpa || lm->config->ngram_filename) {
-      if ((lm->ngram = initialize_ngram(lm->config, lm->winfo)) == NULL) {
-	jlog("ERROR: m_fusion: failed to initialize N-gram\n");
-	return FALSE;
-      }
+      return NULL;
     }
+    jlog("STAT: load time: LM%02d %s dictionary: %.2f sec\n", lmconf->id, lmconf->name, (pass2_clock_msec() - t) / 1000.0);
   }
   if (lm->lmtype == LM_DFA) {
     /* DFA */
@@ -674,20 +830,356 @@ j_load_lm(Recog *recog, JCONF_LM *lmconf)
     /* load all the specified grammars */
     if (multigram_load_all_gramlist(lm) == FALSE) {
       jlog("ERROR: m_fusion: some error occured in reading grammars\n");
-      return FALSE;
+      return NULL;
     }
     /* setup for later wchmm building */
     multigram_update(lm);
     /* the whole lexicon will be forced to built in the boot sequence,
        so reset the global modification flag here */
     lm->global_modified = FALSE;
+    jlog("STAT: load time: LM%02d %s grammar: %.2f sec\n", lmconf->id, lmconf->name, (pass2_clock_msec() - t) / 1000.0);
+  }
+
+  return(lm);
+}
+
+/** 
+ * <JA>
+ * @brief  LM󥹥󥹤 N-gram ɤ߹. 
+ *
+ *  load_lm_dict() Ǵɤ߹ޤƤɬפ. 
+ * 
+ * @param lm [i/o] LM󥹥
+ * @param ngram [in] ɤ߹ߺѤߤ N-gramե뤫ɤ߹ NULL
+ * @param ngram_rescore [in] ɤ߹ߺѤߤΥꥹ N-gram
+ * ե뤫ɤ߹ NULL
+ * 
+ * @return  TRUEԻ FALSE ֤. 
+ * </JA>
+ * <EN>
+ * @brief  Load N-gram into an LM process instance.
+ *
+ * The dictionary should be already loaded by load_lm_dict().
+ * 
+ * @param lm [i/o] LM process instance
+ * @param ngram [in] N-gram already read, or NULL to read it from file
+ * @param ngram_rescore [in] rescoring N-gram already read, or NULL to
+ * read it from file
+ * 
+ * @return TRUE on success, or FALSE on failure.
+ * </EN>
+ */
+static boolean
+load_lm_ngram(PROCESS_LM *lm, NGRAM_INFO *ngram, NGRAM_INFO *ngram_rescore)
+{
+  if (lm->lmtype != LM_PROB) return TRUE;
+
+  if (lm->config->ngram_filename_lr_arpa || lm->config->ngram_filename_rl_arpa || lm->config->ngram_filename) {
+    if ((lm->ngram = initialize_ngram(lm->config, lm->winfo, ngram)) == NULL) {
+      jlog("ERROR: m_fusion: failed to initialize N-gram\n");
+      return FALSE;
+    }
   }
+  if (lm->config->ngram_filename_rescore) {
+    if (initialize_ngram_rescore(lm, ngram_rescore) == FALSE) {
+      jlog("ERROR: m_fusion: failed to initialize N-gram for graph rescoring\n");
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/** 
+ * <EN>
+ * @brief  Load a language model.
+ *
+ * This function will create an LM process instance using the given LM
+ * configuration, and load models specified in the configuration into
+ * the instance.  Then the created instance will be installed to the
+ * engine instance.  The lmconf should be registered to the 
+ * recog->jconf before calling this function.
+ *
+ * To convert phoneme sequence to triphone at loading, you should
+ * specify which AM to use with this LM by the argument am.
+ *
+ * </EN>
+ *
+ * <JA>
+ * @brief ǥɤ߹ࡥ
+ *
+ * δؿϡͿ줿 LM ˽ä LM 󥹥󥹤
+ * ˸ǥɤޤθ塤LM󥹥󥹤
+ * ˥󥸥󥤥󥹥󥹤ϿޤLMϤδؿ
+ * Ƥˤ餫recog->jconfϿƤɬפޤ
+ *
+ * ɤ߹߻˥ȥ饤եؤѴӲǥȤΥ󥯤
+ * Ʊ˹ԤޤΤᡤθǥ뤬Ѥ벻ǥ
+ * 󥹥󥹤 am Ȥƻꤹɬפޤ
+ * 
+ * </JA>
+ * 
+ * @param recog [i/o] engine instance
+ * @param lmconf [in] LM configuration to load
+ * 
+ * @return TRUE on success, or FALSE on error.
+ * 
+ * @callgraph
+ * @callergraph
+ * @ingroup instance
+ * 
+ */
+boolean
+j_load_lm(Recog *recog, JCONF_LM *lmconf)
+{
+  PROCESS_LM *lm;
+
+  jlog("STAT: *** loading LM%02d %s\n", lmconf->id, lmconf->name);
+
+  /* create LM process instance and load dictionary or grammars */
+  if ((lm = load_lm_dict(recog, lmconf)) == NULL) return FALSE;
+
+  /* load N-gram */
+  if (load_lm_ngram(lm, NULL, NULL) == FALSE) return FALSE;
   
   jlog("STAT: *** LM%02d %s loaded\n", lmconf->id, lmconf->name);
 
   return TRUE;
 }
 
+/** 
+ * <JA>
+ * GMM ɤ߹. 
+ * 
+ * @param recog [i/o] 󥸥󥤥󥹥
+ * @param jconf [in] ѥ᡼
+ * 
+ * @return  TRUEԻ FALSE ֤. 
+ * </JA>
+ * <EN>
+ * Load GMM.
+ * 
+ * @param recog [i/o] engine instance
+ * @param jconf [in] global configuration variables
+ * 
+ * @return TRUE on success, or FALSE on failure.
+ * </EN>
+ */
+static boolean
+load_gmm(Recog *recog, Jconf *jconf)
+{
+  double t;
+
+  jlog("STAT: loading GMM\n");
+  t = pass2_clock_msec();
+  if ((recog->gmm = initialize_GMM(jconf)) == NULL) {
+    jlog("ERROR: m_fusion: failed to initialize GMM\n");
+    return FALSE;
+  }
+  jlog("STAT: load time: GMM: %.2f sec\n", (pass2_clock_msec() - t) / 1000.0);
+
+  return TRUE;
+}
+
+#ifdef PARALLEL_LOAD
+
+/// Work area for the N-gram loading thread
+typedef struct {
+  int num;			///< Number of LM configurations
+  JCONF_LM **lmconf;		///< List of LM configurations
+  NGRAM_INFO **ngram;		///< N-gram read for each LM
+  NGRAM_INFO **ngram_rescore;	///< Rescoring N-gram read for each LM
+  boolean ok_p;			///< FALSE if failed to read some N-gram
+} NgramLoadJob;
+
+/** 
+ * <JA>
+ * N-gram ɤ߹ߥåɤΥᥤؿ. Ƥ N-gram LM ˤĤ
+ * N-gram (ӥꥹ N-gram) ե뤫ɤ߹. 
+ * Ȥбդɤ߹߸˥ᥤ󥹥åɤǹԤ. 
+ * N-gram ɤ߹ߴؿŪѿ (ngram_read_arpa.c, ngram_read_bin.c)
+ * ϤΥåɤΤ༡Ū˻Ѥ. ޤ N-gram ɤ߹ߤǤ
+ * åɴ֤Ǿ֤ͭ strtok()  mystrtok() ϻѤʤ. 
+ * 
+ * @param arg [i/o] ΰ (NgramLoadJob)
+ * 
+ * @return NULL
+ * </JA>
+ * <EN>
+ * Main function of N-gram loading thread.  It reads N-gram (and
+ * rescoring N-gram) from file for all N-gram LM configurations.  Mapping
+ * to dictionary will be done at the main thread after loading.
+ * The static variables in the N-gram readers (ngram_read_arpa.c,
+ * ngram_read_bin.c) are used only from this thread, one file after
+ * another.  The N-gram readers do not use strtok() or mystrtok(),
+ * whose state is shared among threads.
+ * 
+ * @param arg [i/o] work area (NgramLoadJob)
+ * 
+ * @return NULL
+ * </EN>
+ */
+static void *
+ngram_load_worker(void *arg)
+{
+  NgramLoadJob *job;
+  JCONF_LM *lmconf;
+  int i;
+
+  job = (NgramLoadJob *)arg;
+  for(i=0;i<job->num;i++) {
+    lmconf = job->lmconf[i];
+    if (lmconf->lmtype != LM_PROB) continue;
+    if (lmconf->ngram_filename_lr_arpa || lmconf->ngram_filename_rl_arpa || lmconf->ngram_filename) {
+      if ((job->ngram[i] = read_ngram(lmconf)) == NULL) {
+	job->ok_p = FALSE;
+	break;
+      }
+    }
+    if (lmconf->ngram_filename_rescore) {
+      if ((job->ngram_rescore[i] = read_ngram_rescore(lmconf)) == NULL) {
+	job->ok_p = FALSE;
+	break;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/** 
+ * <JA>
+ * @brief  ƤΥǥɤ߹. 
+ *
+ * N-gram ɤ߹ߤ̥åɤǹԤδ֤˥ᥤ󥹥åɤ
+ * ǥ롤ʸˡGMM ɤ߹. libsent γɤ߹ߴؿ
+ * ǽǤʤޤɤ߹ߤˤϲǥ뤬ɬפʤᡤ
+ * 󲽤 N-gram Ȥʳ2ĤʬƹԤ. ξԤɤ߹ߴλ
+ * N-gram ȼбդԤ. 
+ * 
+ * @param recog [i/o] 󥸥󥤥󥹥
+ * @param jconf [in] ѥ᡼
+ * 
+ * @return  TRUEԻ FALSE ֤. 
+ * </JA>
+ * <EN>
+ * @brief  Read in all models in parallel.
+ *
+ * N-grams are read in a separate thread, while acoustic models,
+ * dictionaries, grammars and GMM are read in the main thread.  Since
+ * the readers in libsent are not reentrant and a dictionary requires
+ * its acoustic model, the loading is split into the two: N-grams and
+ * others.  The N-grams are mapped to the dictionaries after both are
+ * finished.
+ * 
+ * @param recog [i/o] engine instance
+ * @param jconf [in] global configuration variables
+ * 
+ * @return TRUE on success, or FALSE on failure.
+ * </EN>
+ */
+static boolean
+load_all_parallel(Recog *recog, Jconf *jconf)
+{
+  JCONF_AM *amconf;
+  JCONF_LM *lmconf;
+  PROCESS_LM **lmlist;
+  NgramLoadJob job;
+  pthread_t th;
+  boolean running;
+  boolean ok_p;
+  int i;
+
+  /* make list of LM configurations */
+  job.num = 0;
+  for(lmconf=jconf->lm_root;lmconf;lmconf=lmconf->next) job.num++;
+  job.lmconf = (JCONF_LM **)mymalloc(sizeof(JCONF_LM *) * job.num);
+  job.ngram = (NGRAM_INFO **)mymalloc(sizeof(NGRAM_INFO *) * job.num);
+  job.ngram_rescore = (NGRAM_INFO **)mymalloc(sizeof(NGRAM_INFO *) * job.num);
+  lmlist = (PROCESS_LM **)mymalloc(sizeof(PROCESS_LM *) * job.num);
+  i = 0;
+  for(lmconf=jconf->lm_root;lmconf;lmconf=lmconf->next) {
+    job.lmconf[i] = lmconf;
+    job.ngram[i] = NULL;
+    job.ngram_rescore[i] = NULL;
+    lmlist[i] = NULL;
+    i++;
+  }
+  job.ok_p = TRUE;
+
+  /* initialize block allocator here, since its lazy initialization
+     is not thread-safe */
+  {
+    BMALLOC_BASE *tmp = NULL;
+    mybmalloc2(1, &tmp);
+    mybfree2(&tmp);
+  }
+
+  /* start N-gram loading thread */
+  running = (pthread_create(&th, NULL, ngram_load_worker, &job) == 0);
+  if (! running) {
+    jlog("WARNING: m_fusion: failed to create N-gram loading thread, read N-gram in main thread\n");
+  }
+
+  ok_p = TRUE;
+
+  /* load acoustic models */
+  for(amconf=jconf->am_root;amconf;amconf=amconf->next) {
+    if (j_load_am(recog, amconf) == FALSE) {
+      ok_p = FALSE;
+      break;
+    }
+  }
+
+  /* load dictionaries and grammars */
+  if (ok_p) {
+    for(i=0;i<job.num;i++) {
+      jlog("STAT: *** loading LM%02d %s\n", job.lmconf[i]->id, job.lmconf[i]->name);
+      if ((lmlist[i] = load_lm_dict(recog, job.lmconf[i])) == NULL) {
+	ok_p = FALSE;
+	break;
+      }
+    }
+  }
+
+  /* GMM */
+  if (ok_p && jconf->reject.gmm_filename != NULL) {
+    if (load_gmm(recog, jconf) == FALSE) ok_p = FALSE;
+  }
+
+  /* wait for the N-gram loading thread */
+  if (running) {
+    pthread_join(th, NULL);
+  } else if (ok_p) {
+    ngram_load_worker(&job);
+  }
+  if (job.ok_p == FALSE) ok_p = FALSE;
+
+  /* map N-gram to dictionary */
+  if (ok_p) {
+    for(i=0;i<job.num;i++) {
+      ok_p = load_lm_ngram(lmlist[i], job.ngram[i], job.ngram_rescore[i]);
+      job.ngram[i] = job.ngram_rescore[i] = NULL;
+      if (! ok_p) break;
+      jlog("STAT: *** LM%02d %s loaded\n", job.lmconf[i]->id, job.lmconf[i]->name);
+    }
+  }
+
+  /* free N-grams not used */
+  for(i=0;i<job.num;i++) {
+    if (job.ngram[i]) ngram_info_free(job.ngram[i]);
+    if (job.ngram_rescore[i]) ngram_info_free(job.ngram_rescore[i]);
+  }
+  free(lmlist);
+  free(job.ngram_rescore);
+  free(job.ngram);
+  free(job.lmconf);
+
+  return(ok_p);
+}
+
+#endif /* PARALLEL_LOAD */
+
 /**********************************************************************/
 /** 
  * <JA>
@@ -697,6 +1189,7 @@ j_load_lm(Recog *recog, JCONF_LM *lmconf)
  * ѥ᡼¤ΤΤ줾ФơAM/LM󥹥󥹤
  * . Ƥ줾Υ󥹥󥹤ˤĤƤ˥ǥɤ߹ߡ
  * ǧѤ˥åȥåפ. GMM⤳ɤ߹ޤ. 
+ * "-parallelload"  N-gram ̥åɤɤ߹. 
  * 
  * </JA>
  * <EN>
@@ -705,6 +1198,8 @@ j_load_lm(Recog *recog, JCONF_LM *lmconf)
  * This function create AM/LM processing instance for each AM/LM
  * configurations in jconf.  Then the model for each instance will be loaded
  * into memory and set up for recognition.  GMM will also be read here.
+ * When "-parallelload" is specified, N-grams are read in parallel
+ * in a separate thread.
  * 
  * </EN>
  *
@@ -722,10 +1217,18 @@ j_load_all(Recog *recog, Jconf *jconf)
 {
   JCONF_AM *amconf;
   JCONF_LM *lmconf;
+  double t;
 
   /* set global jconf */
   recog->jconf = jconf;
 
+  t = pass2_clock_msec();
+
+#ifdef PARALLEL_LOAD
+  if (jconf->parallel_load) {
+    if (load_all_parallel(recog, jconf) == FALSE) return FALSE;
+  } else {
+#endif
   /* load acoustic models */
   for(amconf=jconf->am_root;amconf;amconf=amconf->next) {
     if (j_load_am(recog, amconf) == FALSE) return FALSE;
@@ -738,12 +1241,13 @@ j_load_all(Recog *recog, Jconf *jconf)
 
   /* GMM */
   if (jconf->reject.gmm_filename != NULL) {
-    jlog("STAT: loading GMM\n");
-    if ((recog->gmm = initialize_GMM(jconf)) == NULL) {
-      jlog("ERROR: m_fusion: failed to initialize GMM\n");
-      return FALSE;
-    }
+    if (load_gmm(recog, jconf) == FALSE) return FALSE;
+  }
+#ifdef PARALLEL_LOAD
   }
+#endif
+
+  jlog("STAT: load time: total: %.2f sec\n", (pass2_clock_msec() - t) / 1000.0);
 
   /* check sampling rate requirement on AMs and set it to global jconf */
   {
@@ -1129,6 +1633,15 @@ j_launch_recognition_instance(Recog *recog, JCONF_SEARCH *sconf)
     if (p->config->lmp.lmp_specified != p->config->lmp.lmp2_specified) {
       jlog("WARNING: m_fusion: only -lmp or -lmp2 specified, LM weights may be unbalanced\n");
     }
+    if (p->lm->ngram_rescore) {
+      if (!p->config->graph.rescore_lmp_specified) {
+	p->config->graph.rescore_weight = p->config->lmp.lm_weight2;
+	p->config->graph.rescore_penalty = p->config->lmp.lm_penalty2;
+      }
+      if (!p->config->graph.enabled) {
+	jlog("WARNING: m_fusion: -lmrescore requires -lattice or -confnet, graph rescoring disabled\n");
+      }
+    }
   }
 
   /****************************/
@@ -1169,9 +1682,19 @@ j_launch_recognition_instance(Recog *recog, JCONF_SEARCH *sconf)
 	}
       }
     } else {
-      if (build_wchmm2(p->wchmm, p->lm->config) == FALSE) {
-	jlog("ERROR: m_fusion: error in bulding wchmm\n");
-	return FALSE;
+      /* load from cache file if exist and match the current models */
+      if (p->lm->config->wchmm_cache_filename == NULL
+	  || wchmm_cache_load(p->wchmm, p->lm->config, p->lm->config->wchmm_cache_filename) == FALSE) {
+	if (build_wchmm2(p->wchmm, p->lm->config) == FALSE) {
+	  jlog("ERROR: m_fusion: error in bulding wchmm\n");
+	  return FALSE;
+	}
+	/* save the built tree for the next start up */
+	if (p->lm->config->wchmm_cache_filename != NULL) {
+	  if (wchmm_cache_save(p->wchmm, p->lm->config, p->lm->config->wchmm_cache_filename) == FALSE) {
+	    jlog("WARNING: m_fusion: failed to save lexicon tree cache\n");
+	  }
+	}
       }
     }
 
@@ -1185,7 +1708,10 @@ j_launch_recognition_instance(Recog *recog, JCONF_SEARCH *sconf)
     p->trellis_beam_width = set_beam_width(p->wchmm, p->config->pass1.specified_trellis_beam_width);
 
     /* initialize cache for factoring */
-    max_successor_cache_init(p->wchmm);
+    max_successor_cache_init(p->wchmm, p->config->pass1.factor_cache_size);
+    if (p->config->pass1.trigram_lookahead) {
+      max_successor_trigram_init(p->wchmm, TRIGRAM1_CACHE_SIZE);
+    }
   }
 
   /* backtrellis initialization */
@@ -1475,6 +2001,12 @@ j_reload_adddict(Recog *recog, PROCESS_LM *lm)
 	return FALSE;
       }
     }
+    if (lm->ngram_rescore) {
+      if (map_ngram_rescore(lm) == FALSE) {
+	jlog("ERROR: m_fusion: failed to map words in additional dictionary to rescoring N-gram\n");
+	return FALSE;
+      }
+    }
   }
   if (lm->lmtype == LM_DFA) {
     /* DFA */
@@ -56,6 +56,9 @@ print_jconf_overview(Jconf *jconf)
   jlog(" LM=%d,", i);
   i = 0; for(sconf=jconf->search_root;sconf;sconf=sconf->next) i++;
   jlog(" SR=%d\n", i);
+  if (jconf->parallel_load) {
+    jlog(" (-parallelload) N-grams are loaded in parallel\n");
+  }
   
   jlog("\n");
   
@@ -96,6 +99,15 @@ print_jconf_overview(Jconf *jconf)
 	} else if (lmconf->ngram_filename_lr_arpa != NULL) {
 	  jlog("\tforward n-gram filename=%s\n", lmconf->ngram_filename_lr_arpa);
 	}
+	if (lmconf->arpa_thread_num > 1) {
+	  jlog("\tthreads to parse ARPA=%d\n", lmconf->arpa_thread_num);
+	}
+      }
+      if (lmconf->ngram_filename_rescore != NULL) {
+	jlog("\tgraph rescoring n-gram=%s\n", lmconf->ngram_filename_rescore);
+      }
+      if (lmconf->wchmm_cache_filename != NULL) {
+	jlog("\tlexicon tree cache=%s\n", lmconf->wchmm_cache_filename);
       }
     }
     if (lmconf->lmtype == LM_DFA) {
@@ -527,6 +539,7 @@ print_engine_info(Recog *recog)
 	len = r->wchmm->startnum;
 	jlog("\troot node to be cached = %d (all)\n", len);
 #endif
+#ifdef UNIGRAM_FACTORING
 #ifdef HASH_CACHE_IW
 	num = (r->config->pass1.iw_cache_rate * r->lm->ngram->max_word_num) / 100;
 	jlog("\tword ends to be cached = %d / %d\n", num, r->lm->ngram->max_word_num);
@@ -535,6 +548,13 @@ print_engine_info(Recog *recog)
 	jlog("\tword ends to be cached = %d (all)\n", num);
 #endif
 	jlog("\t  max. allocation size = %dMB\n", num * len / 1000 * sizeof(LOGPROB) / 1000);
+#else
+	num = r->wchmm->lmcache.lru_num;
+	jlog("\t(-factorcache) LRU size = %d entries (%dKB)\n", num, (int)(num * sizeof(FACTOR_CACHE_ENTRY) / 1024));
+#endif
+	if (r->wchmm->lmcache.trigram) {
+	  jlog("\t(-trigram1) 3-gram cache = %d entries\n", r->wchmm->lmcache.tri_cache_mask + 1);
+	}
       }
     }
 
@@ -571,6 +591,11 @@ print_engine_info(Recog *recog)
     }
 
     if (r->lmvar == LM_DFA_WORD) {
+      if (r->config->pass1.flatword_maxnum > 0) {
+	jlog("    flat word decoding:  (-flatword) <= %d words\n", r->config->pass1.flatword_maxnum);
+      } else {
+	jlog("    flat word decoding:  (-flatword) disabled\n");
+      }
 #ifdef DETERMINE
       jlog("    early word determination:  (-wed)\n");
       jlog("\tscore threshold    = %f\n", r->config->pass1.determine_score_thres);
@@ -599,10 +624,68 @@ print_engine_info(Recog *recog)
     } else {
       jlog("\t(-bs)score pruning thres= %f\n", r->config->pass1.score_pruning_width);
     }
+#endif
+    if (r->config->pass1.adaptive_beam_token > 0 || r->config->pass1.adaptive_beam_msec > 0.0) {
+      jlog("\t   adaptive beam control = ");
+      if (r->config->pass1.adaptive_beam_token > 0) {
+	jlog("(-badapt) %d tokens/frame ", r->config->pass1.adaptive_beam_token);
+      }
+      if (r->config->pass1.adaptive_beam_msec > 0.0) {
+	jlog("(-badaptmsec) %.2f msec/frame ", r->config->pass1.adaptive_beam_msec);
+      }
+      jlog("\n");
+      jlog("\t(-bmin/-bmax) beam range = ");
+      if (r->config->pass1.adaptive_beam_min < 0) jlog("auto - ");
+      else jlog("%d - ", r->config->pass1.adaptive_beam_min);
+      if (r->config->pass1.adaptive_beam_max < 0) jlog("auto\n");
+      else jlog("%d\n", r->config->pass1.adaptive_beam_max);
+    } else {
+      jlog("\t   adaptive beam control = off\n");
+    }
+#ifndef WORD_GRAPH
+    if (r->config->pass1.backtrellis_gc_interval > 0) {
+      jlog("\t(-btgc) trellis GC      = every %d frames\n", r->config->pass1.backtrellis_gc_interval);
+    } else {
+      jlog("\t(-btgc) trellis GC      = off\n");
+    }
 #endif
     jlog("\t(-n)search candidate num= %d\n", r->config->pass2.nbest);
     jlog("\t(-s)  search stack size = %d\n", r->config->pass2.stack_size);
     jlog("\t(-m)    search overflow = after %d hypothesis poped\n", r->config->pass2.hypo_overflow);
+    if (r->config->pass2.nwthread_num > 1) {
+#ifdef PASS2_STRICT_IWCD
+      jlog("\t(-nwthread) word expand = 1 thread (not supported with strict IWCD)\n");
+#else
+      if (r->am->hmminfo->is_tied_mixture && r->am->config->gprune_method != GPRUNE_SEL_NONE) {
+	jlog("\t(-nwthread) word expand = 1 thread (not supported with Gaussian pruning on tied-mixture)\n");
+      } else {
+	jlog("\t(-nwthread) word expand = %d threads\n", r->config->pass2.nwthread_num);
+      }
+#endif
+    }
+    if (r->config->pass2.deadline_msec > 0) {
+      jlog("\t(-deadline) 2nd pass deadline = %d msec after input end\n", r->config->pass2.deadline_msec);
+    }
+    if (r->config->pass2.adapt_by_confidence) {
+      jlog("\t(-pass2skip) skip 2nd pass if margin >= %.1f", r->config->pass2.adapt_skip_margin);
+      if (r->config->pass2.adapt_max_frame > 0) {
+	jlog(" and len <= %d frames", r->config->pass2.adapt_max_frame);
+      }
+      jlog("\n");
+      jlog("\t             reduce stack by 1/%d if margin >= %.1f\n", PASS2_REDUCE_RATE, r->config->pass2.adapt_reduce_margin);
+    }
+    if (r->lmtype == LM_PROB) {
+      if (r->config->pass2.nwcache_size > 0) {
+	jlog("\t(-nwcache) nextword cache = %d entries\n", r->config->pass2.nwcache_size);
+      } else {
+	jlog("\t(-nwcache) nextword cache = off\n");
+      }
+      if (r->config->pass2.lmcache_size > 0) {
+	jlog("\t(-lmcache) N-gram prob. cache = %d entries, %s\n", r->config->pass2.lmcache_size, r->config->pass2.lmcache_keep ? "kept across inputs" : "cleared per input");
+      } else {
+	jlog("\t(-lmcache) N-gram prob. cache = off\n");
+      }
+    }
     jlog("\t        2nd pass method = ");
     if (r->config->graph.enabled) {
 #ifdef GRAPHOUT_DYNAMIC
@@ -733,12 +816,26 @@ print_engine_info(Recog *recog)
 	jlog("disabled\n");
       }
 #endif
+      if (r->lm->ngram_rescore) {
+	jlog("\t(-lmrescorep) rescoring LM weight = %2.1f  ins. penalty = %+2.1f\n", r->config->graph.rescore_weight, r->config->graph.rescore_penalty);
+	jlog("\t(-lmrescorehist) max. histories = ");
+	if (r->config->graph.rescore_maxhist > 0) {
+	  jlog("%d per word\n", r->config->graph.rescore_maxhist);
+	} else {
+	  jlog("unlimited\n");
+	}
+      }
 
     }
     
     if (r->config->successive.enabled) {
       jlog("\tshort pause segmentation = on\n");
       jlog("\t      sp duration length = %d frames\n", r->config->successive.sp_frame_duration);
+#ifndef SPSEGMENT_NAIST
+      if (r->config->successive.sp_stable_duration > 0) {
+	jlog("\tsp length on fixed words = %d frames\n", r->config->successive.sp_stable_duration);
+      }
+#endif
 #ifdef SPSEGMENT_NAIST
       jlog("      backstep margin on trigger = %d frames\n", r->config->successive.sp_margin);
       jlog("\t        delay on trigger = %d frames\n", r->config->successive.sp_delay);
@@ -503,6 +503,49 @@ opt_parse(int argc, char *argv[], char *cwd, Jconf *jconf)
       GET_TMPARG;
       jconf->searchnow->pass2.lookup_range = atoi(tmparg);
       continue;
+    } else if (strmatch(argv[i],"-nwthread")) { /* threads for word expansion */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->pass2.nwthread_num = atoi(tmparg);
+#ifndef HAVE_PTHREAD
+      if (jconf->searchnow->pass2.nwthread_num > 1) {
+	jlog("WARNING: m_options: \"-nwthread\" needs pthread support, ignored\n");
+	jconf->searchnow->pass2.nwthread_num = 1;
+      }
+#endif
+      continue;
+    } else if (strmatch(argv[i],"-deadline")) { /* deadline of 2nd pass */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->pass2.deadline_msec = atoi(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-pass2skip")) { /* skip 2nd pass by confidence */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->pass2.adapt_skip_margin = atof(tmparg);
+      GET_TMPARG;
+      jconf->searchnow->pass2.adapt_reduce_margin = atof(tmparg);
+      jconf->searchnow->pass2.adapt_by_confidence = TRUE;
+      continue;
+    } else if (strmatch(argv[i],"-pass2skiplen")) { /* max length to skip */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->pass2.adapt_max_frame = atoi(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-nwcache")) { /* next word cache size */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->pass2.nwcache_size = atoi(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-lmcache")) { /* N-gram prob. cache size */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->pass2.lmcache_size = atoi(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-lmcachekeep")) { /* keep across inputs */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      jconf->searchnow->pass2.lmcache_keep = TRUE;
+      continue;
     } else if (strmatch(argv[i],"-graphout")) { /* enable graph output */
       if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
       jconf->searchnow->graph.enabled = TRUE;
@@ -534,6 +577,19 @@ opt_parse(int argc, char *argv[], char *cwd, Jconf *jconf)
       GET_TMPARG;
       jconf->searchnow->graph.graph_merge_neighbor_range = atoi(tmparg);
       continue;
+    } else if (strmatch(argv[i],"-lmrescorep")) { /* LM weight and penalty for graph rescoring */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->graph.rescore_weight = (LOGPROB)atof(tmparg);
+      GET_TMPARG;
+      jconf->searchnow->graph.rescore_penalty = (LOGPROB)atof(tmparg);
+      jconf->searchnow->graph.rescore_lmp_specified = TRUE;
+      continue;
+    } else if (strmatch(argv[i],"-lmrescorehist")) { /* max. histories per graph word */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->graph.rescore_maxhist = atoi(tmparg);
+      continue;
 #ifdef GRAPHOUT_DEPTHCUT
     } else if (strmatch(argv[i],"-graphcut")) { /* cut graph word by depth */
       if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
@@ -590,6 +646,53 @@ opt_parse(int argc, char *argv[], char *cwd, Jconf *jconf)
       jconf->searchnow->pass1.score_pruning_width = atof(tmparg);
       continue;
 #endif
+    } else if (strmatch(argv[i],"-badapt")) { /* target token num per frame for adaptive beam */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      GET_TMPARG;
+      jconf->searchnow->pass1.adaptive_beam_token = atoi(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-badaptmsec")) { /* target CPU msec per frame for adaptive beam */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      GET_TMPARG;
+      jconf->searchnow->pass1.adaptive_beam_msec = atof(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-bmin")) { /* lower bound of adaptive beam */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      GET_TMPARG;
+      jconf->searchnow->pass1.adaptive_beam_min = atoi(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-bmax")) { /* upper bound of adaptive beam */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      GET_TMPARG;
+      jconf->searchnow->pass1.adaptive_beam_max = atoi(tmparg);
+      continue;
+    } else if (strmatch(argv[i],"-btgc")) { /* trellis garbage collection interval */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      GET_TMPARG;
+#ifdef WORD_GRAPH
+      jlog("WARNING: m_options: WORD_GRAPH enabled, \"-btgc\" ignored\n");
+#else
+      jconf->searchnow->pass1.backtrellis_gc_interval = atoi(tmparg);
+#endif
+      continue;
+    } else if (strmatch(argv[i],"-factorcache")) { /* LRU cache size for 2-gram factoring */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      GET_TMPARG;
+#ifdef UNIGRAM_FACTORING
+      jlog("WARNING: m_options: UNIGRAM_FACTORING enabled, \"-factorcache\" ignored\n");
+#else
+      jconf->searchnow->pass1.factor_cache_size = atoi(tmparg);
+#endif
+      continue;
+    } else if (strmatch(argv[i],"-trigram1")) { /* 3-gram on the 1st pass */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      jconf->searchnow->pass1.trigram_lookahead = TRUE;
+      continue;
+    } else if (strmatch(argv[i],"-flatword")) { /* flat word decoding for small vocabulary */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE;
+      GET_TMPARG;
+      jconf->searchnow->pass1.flatword_maxnum = atoi(tmparg);
+      continue;
     } else if (strmatch(argv[i],"-discount")) {	/* (bogus) */
       jlog("WARNING: m_options: option \"-discount\" is now bogus, ignored\n");
       continue;
@@ -821,6 +924,27 @@ opt_parse(int argc, char *argv[], char *cwd, Jconf *jconf)
       jconf->lmnow->ngram_filename_rl_arpa = filepath(tmparg, cwd);
       FREE_MEMORY(jconf->lmnow->ngram_filename);
       continue;
+    } else if (strmatch(argv[i],"-lmrescore")) { /* n-gram for graph rescoring */
+      if (!check_section(jconf, argv[i], JCONF_OPT_LM)) return FALSE; 
+      FREE_MEMORY(jconf->lmnow->ngram_filename_rescore);
+      GET_TMPARG;
+      jconf->lmnow->ngram_filename_rescore = filepath(tmparg, cwd);
+      continue;
+    } else if (strmatch(argv[i],"-wchmmcache")) { /* cache file of tree lexicon */
+      if (!check_section(jconf, argv[i], JCONF_OPT_LM)) return FALSE; 
+      FREE_MEMORY(jconf->lmnow->wchmm_cache_filename);
+      GET_TMPARG;
+      jconf->lmnow->wchmm_cache_filename = filepath(tmparg, cwd);
+      continue;
+    } else if (strmatch(argv[i],"-arpathread")) { /* threads to parse ARPA n-gram */
+      if (!check_section(jconf, argv[i], JCONF_OPT_LM)) return FALSE; 
+      GET_TMPARG;
+      jconf->lmnow->arpa_thread_num = atoi(tmparg);
+      if (jconf->lmnow->arpa_thread_num < 1) {
+	jlog("ERROR: m_options: -arpathread: number of threads should be > 0: %s\n", tmparg);
+	return FALSE;
+      }
+      continue;
     } else if (strmatch(argv[i],"-lmp")) { /* LM weight and penalty (pass1) */
       if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
       GET_TMPARG;
@@ -1023,6 +1147,13 @@ opt_parse(int argc, char *argv[], char *cwd, Jconf *jconf)
       GET_TMPARG;
       jconf->searchnow->successive.sp_frame_duration = atoi(tmparg);
       continue;
+#ifndef SPSEGMENT_NAIST
+    } else if (strmatch(argv[i],"-spstable")) { /* shorter pause duration to segment at after fixed words */
+      if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
+      GET_TMPARG;
+      jconf->searchnow->successive.sp_stable_duration = atoi(tmparg);
+      continue;
+#endif
 #ifdef SPSEGMENT_NAIST
     } else if (strmatch(argv[i],"-spmargin")) { /* speech up-trigger backstep margin in frame */
       if (!check_section(jconf, argv[i], JCONF_OPT_SR)) return FALSE; 
@@ -1329,6 +1460,14 @@ opt_parse(int argc, char *argv[], char *cwd, Jconf *jconf)
       GET_TMPARG;
       jconf->outprob_outfile = filepath(tmparg, cwd);
       continue;
+    } else if (strmatch(argv[i],"-parallelload")) {
+      if (!check_section(jconf, argv[i], JCONF_OPT_GLOBAL)) return FALSE; 
+#ifdef PARALLEL_LOAD
+      jconf->parallel_load = TRUE;
+#else
+      jlog("WARNING: m_options: \"-parallelload\" needs pthread and zlib support, ignored\n");
+#endif
+      continue;
     }
     if (argv[i][0] == '-' && strlen(argv[i]) == 2) {
       /* 1-letter options */
@@ -1514,6 +1653,8 @@ opt_release(Jconf *jconf)
     FREE_MEMORY(lm->ngram_filename);
     FREE_MEMORY(lm->ngram_filename_lr_arpa);
     FREE_MEMORY(lm->ngram_filename_rl_arpa);
+    FREE_MEMORY(lm->ngram_filename_rescore);
+    FREE_MEMORY(lm->wchmm_cache_filename);
     FREE_MEMORY(lm->dfa_filename);
     FREE_MEMORY(lm->head_silname);
     FREE_MEMORY(lm->tail_silname);
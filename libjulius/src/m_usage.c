@@ -165,6 +165,7 @@ j_output_argument_help(FILE *fp)
   fprintf(fp, "    [-check (wchmm|trellis)] (for debug) check internal structure\n");
   fprintf(fp, "    [-check triphone]   triphone mapping check\n");
   fprintf(fp, "    [-outprobout file]  Output state probabilities to file\n");
+  fprintf(fp, "    [-parallelload]     load N-grams in parallel with other models\n");
   fprintf(fp, "    [-setting]          print engine configuration and exit\n");
   fprintf(fp, "    [-help]             print this message and exit\n");
 
@@ -261,6 +262,9 @@ j_output_argument_help(FILE *fp)
   fprintf(fp, "    -d file.bingram     n-gram file in Julius binary format\n");
   fprintf(fp, "    -nlr file.arpa      forward n-gram file in ARPA format\n");
   fprintf(fp, "    -nrl file.arpa      backward n-gram file in ARPA format\n");
+  fprintf(fp, "    [-arpathread num]   threads to parse ARPA n-gram (%d)\n", jconf->lm_root->arpa_thread_num);
+  fprintf(fp, "    [-lmrescore file.bingram] n-gram to rescore word graph (needs -lattice or -confnet)\n");
+  fprintf(fp, "    [-wchmmcache file]  load/save lexicon tree from/to cache file\n");
   fprintf(fp, "    [-lmp float float]  weight and penalty (tri: %.1f %.1f mono: %.1f %1.f)\n", DEFAULT_LM_WEIGHT_TRI_PASS1, DEFAULT_LM_PENALTY_TRI_PASS1, DEFAULT_LM_WEIGHT_MONO_PASS1, DEFAULT_LM_PENALTY_MONO_PASS1);
   fprintf(fp, "    [-lmp2 float float]       for 2nd pass (tri: %.1f %.1f mono: %.1f %1.f)\n", DEFAULT_LM_WEIGHT_TRI_PASS2, DEFAULT_LM_PENALTY_TRI_PASS2, DEFAULT_LM_WEIGHT_MONO_PASS2, DEFAULT_LM_PENALTY_MONO_PASS2);
   fprintf(fp, "    [-transp float]     penalty for transparent word (%+2.1f)\n", jconf->search_root->lmp.lm_penalty_trans);
@@ -305,6 +309,15 @@ j_output_argument_help(FILE *fp)
 #ifdef SCORE_PRUNING
   fprintf(fp, "    [-bs score_width]   beam width (by score offset)          (disabled)\n");
   fprintf(fp, "                        (-1: disable)\n");
+#endif
+  fprintf(fp, "    [-badapt tokennum]  adapt beam to this token num per frame (%d)\n", jconf->search_root->pass1.adaptive_beam_token);
+  fprintf(fp, "    [-badaptmsec msec]  adapt beam to this CPU time per frame  (%.1f)\n", jconf->search_root->pass1.adaptive_beam_msec);
+  fprintf(fp, "                        (0: disable)\n");
+  fprintf(fp, "    [-bmin beamwidth]   lower bound of adapted beam width     (auto)\n");
+  fprintf(fp, "    [-bmax beamwidth]   upper bound of adapted beam width     (auto)\n");
+#ifndef WORD_GRAPH
+  fprintf(fp, "    [-btgc frames]      reclaim unreachable trellis words every N frames (%d)\n", jconf->search_root->pass1.backtrellis_gc_interval);
+  fprintf(fp, "                        (0: disable)\n");
 #endif
 #ifdef WPAIR
 # ifdef WPAIR_KEEP_NLIMIT
@@ -317,6 +330,11 @@ j_output_argument_help(FILE *fp)
 #ifdef HASH_CACHE_IW
   fprintf(fp, "    [-iwcache percent]  (n-gram) amount of inter-word LM cache (%3d)\n", jconf->search_root->pass1.iw_cache_rate);
 #endif
+#ifndef UNIGRAM_FACTORING
+  fprintf(fp, "    [-factorcache num]  (n-gram) entries of LM factoring cache (%d)\n", jconf->search_root->pass1.factor_cache_size);
+#endif
+  fprintf(fp, "    [-trigram1]         (n-gram) use 3-gram on 1st pass where word is determined\n");
+  fprintf(fp, "    [-flatword num]     (word) full search w/o beam if vocab. <= num, 0 to disable (%d)\n", jconf->search_root->pass1.flatword_maxnum);
   fprintf(fp, "    [-1pass]            do 1st pass only, omit 2nd pass\n");
   fprintf(fp, "    [-inactive]         recognition process not active on startup\n");
 
@@ -332,6 +350,13 @@ j_output_argument_help(FILE *fp)
 
   fprintf(fp, "    [-lookuprange N]    frame lookup range in word expansion  (%d)\n", jconf->search_root->pass2.lookup_range);
   fprintf(fp, "    [-looktrellis]      (dfa) expand only backtrellis words\n");
+  fprintf(fp, "    [-nwthread num]     threads for word expansion on 2nd pass (%d)\n", jconf->search_root->pass2.nwthread_num);
+  fprintf(fp, "    [-deadline msec]    stop 2nd pass at msec after input end (%d)\n", jconf->search_root->pass2.deadline_msec);
+  fprintf(fp, "    [-pass2skip s r]    skip (>=s) or reduce (>=r) 2nd pass by 1st pass margin (off)\n");
+  fprintf(fp, "    [-pass2skiplen N]   skip 2nd pass only for input <= N frames (%d)\n", jconf->search_root->pass2.adapt_max_frame);
+  fprintf(fp, "    [-nwcache num]      (n-gram) entries of next word cache   (%d)\n", jconf->search_root->pass2.nwcache_size);
+  fprintf(fp, "    [-lmcache num]      (n-gram) entries of N-gram prob. cache (%d)\n", jconf->search_root->pass2.lmcache_size);
+  fprintf(fp, "    [-lmcachekeep]      (n-gram) keep N-gram prob. cache across inputs\n");
   fprintf(fp, "    [-[no]multigramout] (dfa) output per-grammar results\n");
   fprintf(fp, "    [-oldtree]          (dfa) use old build_wchmm()\n");
 #ifdef PASS1_IWCD
@@ -343,6 +368,9 @@ j_output_argument_help(FILE *fp)
   fprintf(fp, "\n Short-pause Segmentation:\n");
   fprintf(fp, "    [-spsegment]        enable short-pause segmentation\n");
   fprintf(fp, "    [-spdur]            length threshold of sp frames         (%d)\n", jconf->search_root->successive.sp_frame_duration);
+#ifndef SPSEGMENT_NAIST
+  fprintf(fp, "    [-spstable]         sp frames to break after fixed words  (%d)\n", jconf->search_root->successive.sp_stable_duration);
+#endif
 #ifdef SPSEGMENT_NAIST
   fprintf(fp, "    [-spmargin]         backstep margin on speech trigger     (%d)\n", jconf->search_root->successive.sp_margin);
   fprintf(fp, "    [-spdelay]          delay on speech trigger               (%d)\n", jconf->search_root->successive.sp_delay);
@@ -357,6 +385,8 @@ j_output_argument_help(FILE *fp)
   fprintf(fp, "                        -1: not merge, leave same loc. with diff. score\n");
   fprintf(fp, "                         0: merge same words at same location\n");
   fprintf(fp, "                        >0: merge same words around the margin\n");
+  fprintf(fp, "    [-lmrescorep float float] LM weight and penalty for graph rescoring (=-lmp2)\n");
+  fprintf(fp, "    [-lmrescorehist num] max. histories per word on graph rescoring (%d)\n", jconf->search_root->graph.rescore_maxhist);
 #ifdef GRAPHOUT_DEPTHCUT
   fprintf(fp, "    [-graphcut num]     graph cut depth at postprocess (-1: disable)(%d)\n", jconf->search_root->graph.graphout_cut_depth);
 #endif
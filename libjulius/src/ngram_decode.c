@@ -120,6 +120,96 @@ search_nw(NEXTWORD **nw, WORD_ID w, int num)
   }
 }
 
+/** 
+ * <JA>
+ * N-gram ΨåΥϥåͤ. 
+ * 
+ * @param c [in] N-gram Ψå
+ * @param n [in] N-gram Ĺ
+ * @param w [in] N-gram ñ (N-gram ñID)
+ * 
+ * @return ϥå (ȥֹ)
+ * </JA>
+ * <EN>
+ * Compute hash value of the N-gram probability cache.
+ * 
+ * @param c [in] N-gram probability cache
+ * @param n [in] length of the N-gram tuple
+ * @param w [in] word sequence of the tuple (N-gram word IDs)
+ * 
+ * @return the hash value (entry index)
+ * </EN>
+ */
+static int
+lmcache_hash(NgramProbCache *c, int n, WORD_ID *w)
+{
+  unsigned int h;
+  int i;
+
+  h = n;
+  for (i = 0; i < n; i++) h = h * 131 + w[i];
+
+  return(h % c->size);
+}
+
+/** 
+ * <JA>
+ * åѤ N-gram Ψ. ƱñγΨ
+ * åˤФ֤ʤ ngram_prob() ǵ
+ * å˳Ǽ. å夬̵ΤȤ ngram_prob() 
+ * Τޤ޸Ƥ. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * @param n [in] N-gram Ĺ
+ * @param w [in] N-gram ñ (N-gram ñID)
+ * 
+ * @return N-gram Ψ (log10)
+ * </JA>
+ * <EN>
+ * Get N-gram probability with cache.  If the probability of the same
+ * word sequence is in the cache, it is returned.  Otherwise it is
+ * computed by ngram_prob() and stored to the cache.  When the cache is
+ * disabled, ngram_prob() is simply called.
+ * 
+ * @param r [i/o] recognition process instance
+ * @param n [in] length of the N-gram tuple
+ * @param w [in] word sequence of the tuple (N-gram word IDs)
+ * 
+ * @return the N-gram probability in log10.
+ * </EN>
+ */
+static LOGPROB
+ngram_prob_cached(RecogProcess *r, int n, WORD_ID *w)
+{
+  NgramProbCache *c;
+  WORD_ID *key;
+  int i, e;
+
+  c = &(r->pass2.lmcache);
+  if (c->size == 0) return(ngram_prob(r->lm->ngram, n, w));
+
+  e = lmcache_hash(c, n, w);
+  key = &(c->key[e * c->n]);
+  if (c->len[e] == n) {
+    for (i = 0; i < n; i++) {
+      if (key[i] != w[i]) break;
+    }
+    if (i == n) {
+      /* found */
+      c->hit++;
+      return(c->prob[e]);
+    }
+  }
+
+  /* not found, compute and store */
+  c->miss++;
+  c->prob[e] = ngram_prob(r->lm->ngram, n, w);
+  for (i = 0; i < n; i++) key[i] = w[i];
+  c->len[e] = n;
+
+  return(c->prob[e]);
+}
+
 /** 
  * <EN>
  * Compute backward N-gram score from forward N-gram.
@@ -128,7 +218,7 @@ search_nw(NEXTWORD **nw, WORD_ID w, int num)
  *  N-gram  N-gram 黻Ф. 
  * </JA>
  * 
- * @param ngram [in] N-gram data structure
+ * @param r [i/o] recognition process instance
  * @param w [in] word sequence
  * @param wlen [in] length of @a w
  * 
@@ -136,20 +226,22 @@ search_nw(NEXTWORD **nw, WORD_ID w, int num)
  * 
  */
 static LOGPROB
-ngram_forw2back(NGRAM_INFO *ngram, WORD_ID *w, int wlen)
+ngram_forw2back(RecogProcess *r, WORD_ID *w, int wlen)
 {
+  NGRAM_INFO *ngram;
   int i;
   LOGPROB p1, p2;
 
+  ngram = r->lm->ngram;
   p1 = 0.0;
   for(i = 1; i < ngram->n; i++) {
     if (i >= wlen) break;
-    p1 += ngram_prob(ngram, i, &(w[1]));
+    p1 += ngram_prob_cached(r, i, &(w[1]));
   }
   p2 = 0.0;
   for(i = 0; i < ngram->n; i++) {
     if (i >= wlen) break;
-    p2 += ngram_prob(ngram, i+1, w);
+    p2 += ngram_prob_cached(r, i+1, w);
   }
 
   return(p2 - p1);
@@ -265,10 +357,10 @@ pick_backtrellis_words(RecogProcess *r, NEXTWORD **nw, int oldnum, NODE *hypo, s
       if (ngram->dir == DIR_RL) {
 	/* just compute N-gram prob of the word candidate */
 	dwrk->cnwordrev[cnnum] = winfo->wton[w];
-	rawscore = ngram_prob(ngram, cnnum + 1, dwrk->cnwordrev);
+	rawscore = ngram_prob_cached(r, cnnum + 1, dwrk->cnwordrev);
       } else {
 	dwrk->cnword[0] = winfo->wton[w];
-	rawscore = ngram_forw2back(ngram, dwrk->cnword, cnnum + 1);
+	rawscore = ngram_forw2back(r, dwrk->cnword, cnnum + 1);
       }
 #ifdef CLASS_NGRAM
       rawscore += winfo->cprob[w];
@@ -398,6 +490,326 @@ get_backtrellis_words(RecogProcess *r, NEXTWORD **nw, NODE *hypo, short tm, shor
   return num;
 }
 
+/** 
+ * <JA>
+ * ñ쥭åΥϥåͤ. 
+ * 
+ * @param c [in] ñ쥭å
+ * @param cnnum [in] ʸ̮ñ
+ * @param last_trans [in] ľñ줬ƩñǤ TRUE
+ * @param tm [in] ñõ濴Ȥʤե졼
+ * @param t_end [in] ñõե졼αü
+ * 
+ * @return ϥå (ȥֹ)
+ * </JA>
+ * <EN>
+ * Compute hash value of the next word cache.
+ * 
+ * @param c [in] next word cache
+ * @param cnnum [in] number of context words in c->context
+ * @param last_trans [in] TRUE if the last word is transparent
+ * @param tm [in] center time frame to look up the words
+ * @param t_end [in] right frame boundary for the lookup
+ * 
+ * @return the hash value (entry index)
+ * </EN>
+ */
+static int
+nwcache_hash(NextWordCache *c, int cnnum, boolean last_trans, short tm, short t_end)
+{
+  unsigned int h;
+  int i;
+
+  h = (unsigned int)tm * 31 + (unsigned int)t_end;
+  for (i = 0; i < cnnum; i++) h = h * 131 + c->context[i];
+  h = h * 2 + (last_trans ? 1 : 0);
+
+  return(h % c->size);
+}
+
+/** 
+ * <JA>
+ * @brief  åѤñȥꥹ鼡ñ콸ꤹ. 
+ *
+ * N-gram μñ콸ϲľ N-1 ñȥȥꥹ򻲾Ȥե졼
+ * ΤߤǷޤΤǡ餬ƱФƤϡƱǰ
+ * ᤿ñ콸򤽤Τޤ֤. åˤʤ
+ * get_backtrellis_words() ǵƥå˳Ǽ. 
+ * 
+ * @param r [in] ǧ󥹥
+ * @param nw [out] ñ콸Ǽ빽¤ΤؤΥݥ
+ * @param hypo [in] Ÿʬʸ
+ * @param tm [in] ñõ濴Ȥʤե졼
+ * @param t_end [in] ñõե졼αü
+ * 
+ * @return @a nw ˳Ǽ줿ñο֤. 
+ * </JA>
+ * <EN>
+ * @brief  Determine next word candidates from the word trellis, with cache.
+ *
+ * As the N-gram next word candidates of a hypothesis depend only on its
+ * last N-1 words and the frames to look up the trellis, the candidates
+ * computed before within the same input are returned for hypotheses that
+ * share them.  If not found in the cache, they are computed by
+ * get_backtrellis_words() and stored to the cache.
+ * 
+ * @param r [in] recognition process instance
+ * @param nw [out] pointer to hold the extracted words as list of next word candidates
+ * @param hypo [in] partial sentence hypothesis from which the words will be expanded
+ * @param tm [in] center time frame to look up the words
+ * @param t_end [in] right frame boundary for the lookup.
+ * 
+ * @return the number of next words candidates stored in @a nw.
+ * </EN>
+ */
+static int
+get_backtrellis_words_cached(RecogProcess *r, NEXTWORD **nw, NODE *hypo, short tm, short t_end)
+{
+  NextWordCache *c;
+  NextWordCacheEntry *e;
+  WORD_INFO *winfo;
+  int i, num;
+  int cnnum;
+  boolean last_trans;
+
+  c = &(r->pass2.nwcache);
+  winfo = r->lm->winfo;
+
+  /* set context words, last word first, skipping transparent words */
+  cnnum = 0;
+  for(i=hypo->seqnum-1;i>=0;i--) {
+    if (! winfo->is_transparent[hypo->seq[i]]) {
+      c->context[cnnum++] = hypo->seq[i];
+      if (cnnum >= r->lm->ngram->n - 1) break;
+    }
+  }
+  last_trans = winfo->is_transparent[hypo->seq[hypo->seqnum-1]];
+
+  e = &(c->entry[nwcache_hash(c, cnnum, last_trans, tm, t_end)]);
+  if (e->used && e->tm == tm && e->t_end == t_end && e->cnnum == cnnum && e->last_trans == last_trans) {
+    for (i = 0; i < cnnum; i++) {
+      if (e->context[i] != c->context[i]) break;
+    }
+    if (i == cnnum) {
+      /* found */
+      for (i = 0; i < e->num; i++) memcpy(nw[i], &(e->nw[i]), sizeof(NEXTWORD));
+      c->hit++;
+      return(e->num);
+    }
+  }
+
+  /* not found, compute and store */
+  c->miss++;
+  num = get_backtrellis_words(r, nw, hypo, tm, t_end);
+  /* re-allocate when too small, or much larger than needed so that an
+     entry does not keep the largest list it has ever held */
+  if (e->maxnum < num || e->maxnum > num * 2) {
+    if (e->nw) free(e->nw);
+    e->nw = NULL;
+    e->maxnum = num;
+    if (num > 0) e->nw = (NEXTWORD *)mymalloc(sizeof(NEXTWORD) * e->maxnum);
+  }
+  for (i = 0; i < num; i++) memcpy(&(e->nw[i]), nw[i], sizeof(NEXTWORD));
+  e->num = num;
+  for (i = 0; i < cnnum; i++) e->context[i] = c->context[i];
+  e->cnnum = cnnum;
+  e->last_trans = last_trans;
+  e->tm = tm;
+  e->t_end = t_end;
+  e->used = TRUE;
+
+  return num;
+}
+
+/** 
+ * <JA>
+ * ñ쥭åݤ. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Allocate the next word cache.
+ * 
+ * @param r [i/o] recognition process instance
+ * </EN>
+ */
+void
+nwcache_init(RecogProcess *r)
+{
+  NextWordCache *c;
+  int i, len;
+
+  c = &(r->pass2.nwcache);
+  c->entry = NULL;
+  c->context = NULL;
+  c->size = 0;
+  c->hit = c->miss = 0;
+
+  /* user-defined LM function may depend on the whole word sequence */
+  if (r->lmtype != LM_PROB || r->lmvar == LM_NGRAM_USER || r->lm->ngram == NULL) return;
+  if (r->config->pass2.nwcache_size <= 0) return;
+
+  c->size = r->config->pass2.nwcache_size;
+  len = r->lm->ngram->n - 1;
+  if (len < 1) len = 1;
+  c->entry = (NextWordCacheEntry *)mymalloc(sizeof(NextWordCacheEntry) * c->size);
+  for (i = 0; i < c->size; i++) {
+    c->entry[i].used = FALSE;
+    c->entry[i].context = (WORD_ID *)mymalloc(sizeof(WORD_ID) * len);
+    c->entry[i].nw = NULL;
+    c->entry[i].num = c->entry[i].maxnum = 0;
+  }
+  c->context = (WORD_ID *)mymalloc(sizeof(WORD_ID) * len);
+}
+
+/** 
+ * <JA>
+ * ñ쥭åˤ. åϥȥꥹñ򻲾ȤΤǡ
+ * ϤȤ˸Ƥɬפ. γǼΰ⤳ǲ. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Clear the next word cache.  Since the cache refers to trellis words,
+ * this should be called for each input.  The candidate lists are also
+ * released here, so that memory is not held across inputs.
+ * 
+ * @param r [i/o] recognition process instance
+ * </EN>
+ */
+void
+nwcache_clear(RecogProcess *r)
+{
+  NextWordCache *c;
+  int i;
+
+  c = &(r->pass2.nwcache);
+  for (i = 0; i < c->size; i++) {
+    c->entry[i].used = FALSE;
+    if (c->entry[i].nw) free(c->entry[i].nw);
+    c->entry[i].nw = NULL;
+    c->entry[i].num = c->entry[i].maxnum = 0;
+  }
+  c->hit = c->miss = 0;
+}
+
+/** 
+ * <JA>
+ * ñ쥭å. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Free the next word cache.
+ * 
+ * @param r [i/o] recognition process instance
+ * </EN>
+ */
+void
+nwcache_free(RecogProcess *r)
+{
+  NextWordCache *c;
+  int i;
+
+  c = &(r->pass2.nwcache);
+  for (i = 0; i < c->size; i++) {
+    free(c->entry[i].context);
+    if (c->entry[i].nw) free(c->entry[i].nw);
+  }
+  if (c->entry) free(c->entry);
+  if (c->context) free(c->context);
+  c->entry = NULL;
+  c->context = NULL;
+  c->size = 0;
+}
+
+/** 
+ * <JA>
+ * N-gram Ψåݤ. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Allocate the N-gram probability cache.
+ * 
+ * @param r [i/o] recognition process instance
+ * </EN>
+ */
+void
+lmcache_init(RecogProcess *r)
+{
+  NgramProbCache *c;
+
+  c = &(r->pass2.lmcache);
+  c->key = NULL;
+  c->len = NULL;
+  c->prob = NULL;
+  c->size = 0;
+  c->n = 0;
+  c->hit = c->miss = 0;
+
+  if (r->lmtype != LM_PROB || r->lm->ngram == NULL) return;
+  if (r->config->pass2.lmcache_size <= 0) return;
+
+  c->size = r->config->pass2.lmcache_size;
+  c->n = r->lm->ngram->n;
+  c->key = (WORD_ID *)mymalloc(sizeof(WORD_ID) * c->n * c->size);
+  c->len = (unsigned char *)mymalloc(sizeof(unsigned char) * c->size);
+  c->prob = (LOGPROB *)mymalloc(sizeof(LOGPROB) * c->size);
+  memset(c->len, 0, sizeof(unsigned char) * c->size);
+}
+
+/** 
+ * <JA>
+ * N-gram Ψåˤ. åƤϤ˰¸ʤ
+ * Τǡ-lmcachekeep ϸƤФ줺Ϥޤݻ. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Clear the N-gram probability cache.  Since the cached values do not
+ * depend on input, this is not called and the cache is kept across
+ * inputs when "-lmcachekeep" is specified.
+ * 
+ * @param r [i/o] recognition process instance
+ * </EN>
+ */
+void
+lmcache_clear(RecogProcess *r)
+{
+  NgramProbCache *c;
+
+  c = &(r->pass2.lmcache);
+  if (c->size > 0) memset(c->len, 0, sizeof(unsigned char) * c->size);
+}
+
+/** 
+ * <JA>
+ * N-gram Ψå. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Free the N-gram probability cache.
+ * 
+ * @param r [i/o] recognition process instance
+ * </EN>
+ */
+void
+lmcache_free(RecogProcess *r)
+{
+  NgramProbCache *c;
+
+  c = &(r->pass2.lmcache);
+  if (c->key) free(c->key);
+  if (c->len) free(c->len);
+  if (c->prob) free(c->prob);
+  c->key = NULL;
+  c->len = NULL;
+  c->prob = NULL;
+  c->size = 0;
+}
+
 /** 
  * <JA>
  * @brief  Ÿñ. 
@@ -573,7 +985,11 @@ ngram_nextwords(NODE *hypo, NEXTWORD **nw, int maxnw, RecogProcess *r)
 
   /* ο꽪üˤ backtrellis˻ĤäƤñ */
   /* get survived words on backtrellis at the estimated end frame */
-  num = get_backtrellis_words(r, nw, hypo, hypo->estimated_next_t, hypo->bestt);
+  if (r->pass2.nwcache.size > 0) {
+    num = get_backtrellis_words_cached(r, nw, hypo, hypo->estimated_next_t, hypo->bestt);
+  } else {
+    num = get_backtrellis_words(r, nw, hypo, hypo->estimated_next_t, hypo->bestt);
+  }
 
   /* ŸǤʤñåƳ */
   /* exclude unallowed words */
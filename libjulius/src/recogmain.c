@@ -192,12 +192,16 @@ print_mem()
 
 /** 
  * <EN>
- * allocate storage of recognition alignment results.
+ * allocate storage of recognition alignment results.  The alignment
+ * data set by word_align() etc. are allocated from the arena of the
+ * recognition process, and valid until the next clear_result().
  *
  * @return the new pointer
  * </EN>
  * <JA>
- * 饤ȷ̤γǼ
+ * 饤ȷ̤γǼ. word_align() ǳǼ
+ * 饤ȥǡǧ󥹥󥹤Υ꡼ʾ˳ݤ졤
+ *  clear_result() ޤͭǤ. 
  *
  * @return ݤ줿ΰؤΥݥ
  * </JA>
@@ -224,12 +228,17 @@ result_align_new()
 
 /** 
  * <EN>
- * free storage of recognition alignment results.
+ * free storage of recognition alignment results allocated by
+ * result_align_new().  The alignment data in it are in the arena
+ * of the recognition process and released there by clear_result(),
+ * so only the storage itself is freed here.
  *
  * @param a [i/o] alignment data to be released
  * </EN>
  * <JA>
- * 饤ȷ̤γǼ
+ * result_align_new() ǳݤ饤ȷ̤γǼ. 
+ * Υ饤ȥǡǧ󥹥󥹤Υ꡼ʾˤ
+ * clear_result() ǲ뤿ᡤǤϳǼ꼫ΤΤߤ. 
  *
  * @param a [i/o] 륢饤ȥǡ
  * </JA>
@@ -241,22 +250,55 @@ result_align_new()
 void
 result_align_free(SentenceAlign *a)
 {
-  if (a->w) free(a->w);
-  if (a->ph) free(a->ph);
-  if (a->loc) free(a->loc);
-  if (a->begin_frame) free(a->begin_frame);
-  if (a->end_frame) free(a->end_frame);
-  if (a->avgscore) free(a->avgscore);
-  if (a->is_iwsp) free(a->is_iwsp);
   free(a);
 }
 
 /** 
  * <EN>
- * Allocate storage of recognition results.
+ * allocate storage of recognition alignment results on the arena of
+ * the recognition process.  It will be released with other results by
+ * clear_result().
+ *
+ * @param r [i/o] recognition process instance
+ *
+ * @return the new pointer
  * </EN>
  * <JA>
- * ǧ̤γǼݤ. 
+ * 饤ȷ̤γǼ. clear_result() ¾η̤
+ * Ȥ˲. 
+ *
+ * @param r [i/o] ǧ󥹥
+ *
+ * @return ݤ줿ΰؤΥݥ
+ * </JA>
+ *
+ * @callgraph
+ * @callergraph
+ * 
+ */
+SentenceAlign *
+result_align_malloc(RecogProcess *r)
+{
+  SentenceAlign *new;
+  new = (SentenceAlign *)mybarena_malloc(sizeof(SentenceAlign), &(r->arena));
+  new->w = NULL;
+  new->ph = NULL;
+  new->loc = NULL;
+  new->begin_frame = NULL;
+  new->end_frame = NULL;
+  new->avgscore = NULL;
+  new->is_iwsp = NULL;
+  new->next = NULL;
+  return new;
+}
+
+/** 
+ * <EN>
+ * Allocate storage of recognition results.  It will be released by
+ * clear_result().
+ * </EN>
+ * <JA>
+ * ǧ̤γǼݤ. clear_result() ǲ. 
  * </JA>
  * 
  * @param r [out] recognition process instance
@@ -270,17 +312,19 @@ void
 result_sentence_malloc(RecogProcess *r, int num)
 {
   int i;
-  r->result.sent = (Sentence *)mymalloc(sizeof(Sentence) * num);
+  r->result.sent = (Sentence *)mybarena_malloc(sizeof(Sentence) * num, &(r->arena));
   for(i=0;i<num;i++) r->result.sent[i].align = NULL;
   r->result.sentnum = 0;
 }
 
 /** 
  * <EN>
- * Free storage of recognition results.
+ * Free storage of recognition results.  The memory itself is held in
+ * the arena until clear_result().
  * </EN>
  * <JA>
- * ǧ̤γǼ. 
+ * ǧ̤γǼ. 꼫Τ clear_result() ޤ
+ * ꡼ʤݻ. 
  * </JA>
  * 
  * @param r [i/o] recognition process instance
@@ -291,28 +335,17 @@ result_sentence_malloc(RecogProcess *r, int num)
 void
 result_sentence_free(RecogProcess *r)
 {  
-  int i;
-  SentenceAlign *a, *atmp;
-  if (r->result.sent) {
-    for(i=0;i<r->result.sentnum;i++) {
-      a = r->result.sent[i].align;
-      while(a) {
-	atmp = a->next;
-	result_align_free(a);
-	a = atmp;
-      }
-    }
-    free(r->result.sent);
-    r->result.sent = NULL;
-  }
+  r->result.sent = NULL;
 }
 
 /** 
  * <EN>
- * Clear all result storages for next input.
+ * Clear all result storages for next input.  The memory arena of
+ * per-input data is released here at once.
  * </EN>
  * <JA>
- * ǧ̤γǼƥꥢ. 
+ * ǧ̤γǼƥꥢ. ϤȤΥǡ֤
+ * ꡼ʤ⤳ǰ礷Ʋ. 
  * </JA>
  * 
  * @param r [in] recognition process instance.
@@ -331,7 +364,7 @@ clear_result(RecogProcess *r)
   if (r->lmvar == LM_DFA_WORD) {
     if (r->result.status == J_RESULT_STATUS_SUCCESS) {
       /* clear word recog result of first pass as in final result */
-      free(r->result.sent);
+      r->result.sent = NULL;
     }
   } else {
     if (r->graphout) {
@@ -345,6 +378,18 @@ clear_result(RecogProcess *r)
     }
     result_sentence_free(r);
   }
+
+  /* node stocker holds nodes in the arena */
+  clear_stocker(&(r->pass2));
+
+  /* release per-input memory at once */
+  if (verbose_flag) {
+    jlog("STAT: %02d %s: arena: %d KB used, peak %d KB, %d KB held\n",
+	 r->config->id, r->config->name,
+	 (int)(r->arena.used / 1024), (int)(r->arena.peak / 1024),
+	 (int)(r->arena.total / 1024));
+  }
+  mybarena_reset(&(r->arena));
 }
 
 /* --------------------- speech buffering ------------------ */
@@ -1290,6 +1335,15 @@ j_recognize_stream_core(Recog *recog)
     }
     if (pass2_p) callback_exec(CALLBACK_EVENT_PASS2_BEGIN, recog);
 
+    /* the deadline of 2nd pass is measured from here */
+    if (pass2_p) {
+      double msec;
+      msec = pass2_clock_msec();
+      for(r=recog->process_list;r;r=r->next) {
+	r->pass2.deadline_origin = msec;
+      }
+    }
+
 #if !defined(PASS2_STRICT_IWCD) || defined(FIX_35_PASS2_STRICT_SCORE)    
     /* adjust trellis score not to contain outprob of the last frames */
     for(r=recog->process_list;r;r=r->next) {
@@ -1322,6 +1376,8 @@ j_recognize_stream_core(Recog *recog)
       } else {
 	result_sentence_malloc(r, r->config->output.output_hypo_maxnum);
       }
+      /* skip or reduce 2nd pass by confidence of 1st pass result */
+      if (pass2_adapt_by_confidence(r)) continue;
       /* do 2nd pass */
       if (r->lmtype == LM_PROB) {
 	wchmm_fbs(r->am->mfcc->param, r, 0, 0);
@@ -1331,16 +1387,24 @@ j_recognize_stream_core(Recog *recog)
 	  /* to output result for each grammar */
 	  MULTIGRAM *m;
 	  boolean has_success = FALSE;
+	  boolean has_truncated = FALSE;
 	  for(m = r->lm->grammars; m; m = m->next) {
 	    if (m->active) {
 	      jlog("STAT: execute 2nd pass limiting words for gram #%d\n", m->id);
 	      wchmm_fbs(r->am->mfcc->param, r, m->cate_begin, m->dfa->term_num);
 	      if (r->result.status == J_RESULT_STATUS_SUCCESS) {
 		has_success = TRUE;
+	      } else if (r->result.status == J_RESULT_STATUS_TRUNCATED) {
+		has_success = TRUE;
+		has_truncated = TRUE;
 	      }
 	    }
 	  }
-	  r->result.status = (has_success == TRUE) ? J_RESULT_STATUS_SUCCESS : J_RESULT_STATUS_FAIL;
+	  if (has_truncated == TRUE) {
+	    r->result.status = J_RESULT_STATUS_TRUNCATED;
+	  } else {
+	    r->result.status = (has_success == TRUE) ? J_RESULT_STATUS_SUCCESS : J_RESULT_STATUS_FAIL;
+	  }
 	} else {
 	  /* only the best among all grammar will be output */
 	  wchmm_fbs(r->am->mfcc->param, r, 0, r->lm->dfa->term_num);
@@ -46,11 +46,13 @@
  */
 
 #include <julius/julius.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 /* declaration of local functions */
 static NODE *get_best_from_stack(NODE **start, int *stacknum);
 static int put_to_stack(NODE *new, NODE **start, NODE **bottom, int *stacknum, int stacksize);
-static void put_all_in_stack(NODE **start, int *stacknum, WORD_INFO *winfo);
 static void free_all_nodes(NODE *node);
 static void put_hypo_woutput(NODE *hypo, WORD_INFO *winfo);
 static void put_hypo_wname(NODE *hypo, WORD_INFO *winfo);
@@ -64,33 +66,38 @@ static void put_hypo_wname(NODE *hypo, WORD_INFO *winfo);
  * <JA>
  * ñγǼΰγ. 
  * ñǼ뤿 NEXTWORD ˥դ. 
+ * ΰϤȤΥꥢ꡼ʤݤ졤̤ȤȤ˲. 
  * 
  * @param maxlen [out] Ǽǽñ
  * @param root [out] դΰƬؤΥݥ
  * @param max [in] դΰΥ
+ * @param arena [i/o] ꥢ꡼
  * 
  * @return դ줿ñؤΥݥ󥿤֤. 
  * </JA>
  * <EN>
  * Allocate memory for next word candidates.
  * Allocate NEXTWORD array for storing list of candidate next words.
+ * The area is taken from the per-input memory arena, and will be
+ * released together with the results.
  * 
  * @param maxlen [out] maximum number of words that can be stored
  * @param root [out] pointer to the top address of allocated data
  * @param max [in] number of elementes to be allocated
+ * @param arena [i/o] memory arena
  * 
  * @return the newly allocated pointer of NEXTWORD array.
  * </EN>
  */
 static NEXTWORD **
-nw_malloc(int *maxlen, NEXTWORD **root, int max)
+nw_malloc(int *maxlen, NEXTWORD **root, int max, BMALLOC_ARENA *arena)
 {
   NEXTWORD *nwtmp;
   NEXTWORD **nw;
   int i;
 
-  nw = (NEXTWORD **)mymalloc(max * sizeof(NEXTWORD *));
-  nwtmp = (NEXTWORD *)mymalloc(max * sizeof(NEXTWORD));
+  nw = (NEXTWORD **)mybarena_malloc(max * sizeof(NEXTWORD *), arena);
+  nwtmp = (NEXTWORD *)mybarena_malloc(max * sizeof(NEXTWORD), arena);
   for (i=0;i<max; i++) {
     nw[i] = &(nwtmp[i]);
   }
@@ -99,27 +106,6 @@ nw_malloc(int *maxlen, NEXTWORD **root, int max)
   return nw;
 }
 
-/** 
- * <JA>
- * ñγǼΰβ. 
- * 
- * @param nw [in] NEXTWORD
- * @param root [in] nw_malloc() Ϳ줿ΰƬؤΥݥ
- * </JA>
- * <EN>
- * Free next word candidate area.
- * 
- * @param nw [in] pointer to NEXTWORD structure to be free.
- * @param root [in] pointer to the top address of allocated data previously
- * returned by nw_malloc()
- * </EN>
- */
-static void
-nw_free(NEXTWORD **nw, NEXTWORD *root)
-{
-  free(root);
-  free(nw);
-}
 
 /** 
  * <JA>
@@ -131,6 +117,7 @@ nw_free(NEXTWORD **nw, NEXTWORD *root)
  * ñN-gramѻϸƤФ뤳ȤϤʤ. ʸˡǧǤϡ硼ȥݡ
  * å׽ˤ֤ΰۤʤƱŸΤǡ
  * ñÿ礭Ȥꤦ. 
+ * ΰϥꥢ꡼ʤݤ졤Ƥԡ. 
  * 
  * @param nwold [i/o] NEXTWORD
  * @param maxlen [i/o] ǼǼݥ. ߤκǼ
@@ -138,6 +125,7 @@ nw_free(NEXTWORD **nw, NEXTWORD *root)
  * @param root [i/o] ΰƬؤΥݥ󥿤Ǽ륢ɥ쥹. ؿ
  * 񤭴.
  * @param num [in] ĹĹ
+ * @param arena [i/o] ꥢ꡼
  * 
  * @return ĥ줿ʼñؤΥݥ󥿤֤. 
  * </JA>
@@ -147,6 +135,7 @@ nw_free(NEXTWORD **nw, NEXTWORD *root)
  * In DFA mode, the number of nextwords can exceed the vocabulary size when
  * more than one DFA states are expanded by short-pause skipping.
  * In such case, the nextword data area should expanded here.
+ * The new area is taken from the memory arena and the content is copied.
  * 
  * @param nwold [i/o] NEXTWORD array
  * @param maxlen [i/o] pointer to the maximum number of words that can be
@@ -155,12 +144,13 @@ nw_free(NEXTWORD **nw, NEXTWORD *root)
  * @param root [i/o] address to the pointer of the allocated data.  The
  * value will be updated by reallocation in this function.
  * @param num [in] size to expand
+ * @param arena [i/o] memory arena
  * 
  * @return the newlly re-allocated pointer of NEXTWORD array.
  * </EN>
  */
 static NEXTWORD **
-nw_expand(NEXTWORD **nwold, int *maxlen, NEXTWORD **root, int num)
+nw_expand(NEXTWORD **nwold, int *maxlen, NEXTWORD **root, int num, BMALLOC_ARENA *arena)
 {
   NEXTWORD *nwtmp;
   NEXTWORD **nw;
@@ -169,8 +159,9 @@ nw_expand(NEXTWORD **nwold, int *maxlen, NEXTWORD **root, int num)
 
   nwmaxlen = *maxlen + num;
 
-  nwtmp = (NEXTWORD *)myrealloc(*root, nwmaxlen * sizeof(NEXTWORD));
-  nw = (NEXTWORD **)myrealloc(nwold, nwmaxlen * sizeof(NEXTWORD *));
+  nwtmp = (NEXTWORD *)mybarena_malloc(nwmaxlen * sizeof(NEXTWORD), arena);
+  memcpy(nwtmp, *root, *maxlen * sizeof(NEXTWORD));
+  nw = (NEXTWORD **)mybarena_malloc(nwmaxlen * sizeof(NEXTWORD *), arena);
   nw[0] = nwtmp;
   for (i=1;i<nwmaxlen; i++) {
     nw[i] = &(nwtmp[i]);
@@ -223,43 +214,6 @@ get_best_from_stack(NODE **start, int *stacknum)
   }
 }
 
-/** 
- * <JA>
- * 벾⤬å˳Ǽ뤫ɤå. 
- * 
- * @param new [in] å벾
- * @param bottom [in] åΡɤؤΥݥ
- * @param stacknum [in] å˸߳ǼƤΡɿؤΥݥ
- * @param stacksize [in] åΥΡɿξ
- * 
- * @return åΥ¤ãƤʤΡɤ
- * 褱гǼȤ 0 򡤤ʳǤгǼǤʤȤ -1 
- * ֤. 
- * </JA>
- * <EN>
- * Check whether a hypothesis will be stored in the stack.
- * 
- * @param new [in] hypothesis to be checked
- * @param bottom [in] pointer to stack bottom node
- * @param stacknum [in] pointer to current stack size
- * @param stacksize [in] pointer to maximum stack size limit
- * 
- * @return 0 if it will be stored in the stack (in case @a stacknum <
- * @a stacksize or the score of @a new is better than bottom.  Otherwise
- * returns -1, which means it can not be pushed to the stack.
- * </EN>
- */
-static int
-can_put_to_stack(NODE *new, NODE **bottom, int *stacknum, int stacksize)
-{
-  /* stack size check */
-  if ((*stacknum + 1) > stacksize && (*bottom)->score >= new->score) {
-    /* new node is below the bottom: discard it */
-    return(-1);
-  }
-  return(0);
-}
-
 /** 
  * <JA>
  * å˿ʲǼ. 
@@ -362,56 +316,462 @@ put_to_stack(NODE *new, NODE **start, NODE **bottom, int *stacknum, int stacksiz
 
 /** 
  * <JA>
- * åȤƽϤ. åȤϼ. (ǥХå)
+ * å. 
  * 
- * @param start [i/o] åΥȥåץΡɤؤΥݥ
- * @param stacknum [i/o] å˸߳ǼƤΡɿؤΥݥ
- * @param winfo [in] ñ켭
+ * @param start [i/o] åΥȥåץΡ
  * </JA>
  * <EN>
- * Output all nodes in the stack. All nodes will be lost (for debug).
+ * Free all nodes in a stack.
  * 
- * @param start [i/o] pointer to stack top node
- * @param stacknum [i/o] pointer to current stack size
- * @param winfo [in] word dictionary
+ * @param start [i/o] stack top node
  * </EN>
  */
 static void
-put_all_in_stack(NODE **start, int *stacknum, WORD_INFO *winfo)
+free_all_nodes(NODE *start)
 {
-  NODE *ntmp;
-  
-  jlog("DEBUG: hypotheses remained in global stack\n");
-  while ((ntmp = get_best_from_stack(start, stacknum)) != NULL) {
-    jlog("DEBUG: %3d: s=%f",*stacknum, ntmp->score);
-    put_hypo_woutput(ntmp, winfo);
-    free_node(ntmp);
+  NODE *tmp;
+  NODE *next;
+
+  tmp=start;
+  while(tmp) {
+    next=tmp->next;
+    free_node(tmp);
+    tmp=next;
   }
 }
 
+/* 貾⥹å min-max ҡפȤݻ. (ޤ)
+   ۲ΥΡɤɤ⡤ʤ۲ΥΡɤⰭ. 
+   Ʊβ֤ν stackrank ݻꥹȤˤ
+   ƱǼФ. */
+/* The global hypothesis stack is held as a min-max heap: nodes on even
+   levels (including root) are better than their descendants, and nodes
+   on odd levels are worse than their descendants.  Order among hypotheses
+   of the same score is kept by stackrank, so that they are popped in
+   exactly the same order as the sorted list implementation. */
+
 /** 
  * <JA>
- * å. 
+ *  a  b ꥹåǾ̤ˤ뤫ɤ֤. 
  * 
- * @param start [i/o] åΥȥåץΡ
+ * @param a [in] 
+ * @param b [in] 
+ * 
+ * @return a ̤Ǥ TRUE.
  * </JA>
  * <EN>
- * Free all nodes in a stack.
+ * Return whether hypothesis a is placed above hypothesis b in the stack.
  * 
- * @param start [i/o] stack top node
+ * @param a [in] hypothesis
+ * @param b [in] hypothesis
+ * 
+ * @return TRUE if a is upper than b.
+ * </EN>
+ */
+static boolean
+hs_upper(NODE *a, NODE *b)
+{
+  if (a->score > b->score) return TRUE;
+  if (a->score < b->score) return FALSE;
+  return(a->stackrank < b->stackrank);
+}
+
+/** 
+ * <JA>
+ * ҡ׾2ĤǤؤ. 
+ * 
+ * @param s [i/o] ⥹å
+ * @param i [in] ֹ
+ * @param j [in] ֹ
+ * </JA>
+ * <EN>
+ * Swap two elements in the heap.
+ * 
+ * @param s [i/o] hypothesis stack
+ * @param i [in] element index
+ * @param j [in] element index
  * </EN>
  */
 static void
-free_all_nodes(NODE *start)
+hs_swap(HYPOSTACK *s, int i, int j)
 {
   NODE *tmp;
-  NODE *next;
+  tmp = s->heap[i];
+  s->heap[i] = s->heap[j];
+  s->heap[j] = tmp;
+}
 
-  tmp=start;
-  while(tmp) {
-    next=tmp->next;
-    free_node(tmp);
-    tmp=next;
+/** 
+ * <JA>
+ * ҡ׾Ǥ()ˤ뤫ɤ֤. 
+ * 
+ * @param i [in] ֹ
+ * 
+ * @return ʤǤ TRUE.
+ * </JA>
+ * <EN>
+ * Return whether the element is on an upper (even) level of the heap.
+ * 
+ * @param i [in] element index
+ * 
+ * @return TRUE if on even level.
+ * </EN>
+ */
+static boolean
+hs_upper_level(int i)
+{
+  int level;
+
+  for (level = 0; i > 0; i = (i - 1) / 2) level++;
+  return((level % 2) == 0);
+}
+
+/** 
+ * <JA>
+ * ֤줿Ǥ˸äưưҡ׾. 
+ * 
+ * @param s [i/o] ⥹å
+ * @param i [in] ֹ
+ * </JA>
+ * <EN>
+ * Move the element toward the root to restore the heap condition.
+ * 
+ * @param s [i/o] hypothesis stack
+ * @param i [in] element index
+ * </EN>
+ */
+static void
+hs_bubble_up(HYPOSTACK *s, int i)
+{
+  int p;
+  boolean upper;
+
+  if (i == 0) return;
+  p = (i - 1) / 2;
+  upper = hs_upper_level(i);
+  if (upper) {
+    if (hs_upper(s->heap[p], s->heap[i])) {
+      hs_swap(s, i, p);
+      i = p;
+      upper = FALSE;
+    }
+  } else {
+    if (hs_upper(s->heap[i], s->heap[p])) {
+      hs_swap(s, i, p);
+      i = p;
+      upper = TRUE;
+    }
+  }
+  /* go up on the same type of levels */
+  while (i >= 3) {
+    p = ((i - 1) / 2 - 1) / 2;
+    if (upper ? hs_upper(s->heap[i], s->heap[p]) : hs_upper(s->heap[p], s->heap[i])) {
+      hs_swap(s, i, p);
+      i = p;
+    } else {
+      break;
+    }
+  }
+}
+
+/** 
+ * <JA>
+ * Ǥ¹˸äưưҡ׾. 
+ * 
+ * @param s [i/o] ⥹å
+ * @param i [in] ֹ
+ * </JA>
+ * <EN>
+ * Move the element toward the leaves to restore the heap condition.
+ * 
+ * @param s [i/o] hypothesis stack
+ * @param i [in] element index
+ * </EN>
+ */
+static void
+hs_trickle_down(HYPOSTACK *s, int i)
+{
+  int m, c, k, p;
+  boolean upper;
+
+  upper = hs_upper_level(i);
+  for(;;) {
+    c = 2 * i + 1;
+    if (c >= s->num) break;
+    /* find the best (or worst) one in children and grandchildren */
+    m = c;
+    for (k = c; k <= c + 1 && k < s->num; k++) {
+      if (upper ? hs_upper(s->heap[k], s->heap[m]) : hs_upper(s->heap[m], s->heap[k])) m = k;
+    }
+    for (k = 2 * c + 1; k <= 2 * c + 4 && k < s->num; k++) {
+      if (upper ? hs_upper(s->heap[k], s->heap[m]) : hs_upper(s->heap[m], s->heap[k])) m = k;
+    }
+    if (! (upper ? hs_upper(s->heap[m], s->heap[i]) : hs_upper(s->heap[i], s->heap[m]))) break;
+    hs_swap(s, i, m);
+    if (m <= c + 1) break;	/* child */
+    /* grandchild: check against its parent on the opposite level */
+    p = (m - 1) / 2;
+    if (upper ? hs_upper(s->heap[p], s->heap[m]) : hs_upper(s->heap[m], s->heap[p])) {
+      hs_swap(s, m, p);
+    }
+    i = m;
+  }
+}
+
+/** 
+ * <JA>
+ * ҡ׾κǰֹ֤. 
+ * 
+ * @param s [in] ⥹å
+ * 
+ * @return ǰֹ, åǤ -1.
+ * </JA>
+ * <EN>
+ * Return the index of the worst hypothesis in the heap.
+ * 
+ * @param s [in] hypothesis stack
+ * 
+ * @return index of the worst hypothesis, or -1 if the stack is empty.
+ * </EN>
+ */
+static int
+hs_bottom(HYPOSTACK *s)
+{
+  if (s->num == 0) return -1;
+  if (s->num == 1) return 0;
+  if (s->num == 2) return 1;
+  return(hs_upper(s->heap[1], s->heap[2]) ? 2 : 1);
+}
+
+/** 
+ * <JA>
+ * ҡ׾Ǥ. 
+ * 
+ * @param s [i/o] ⥹å
+ * @param i [in] ֹ
+ * 
+ * @return 
+ * </JA>
+ * <EN>
+ * Remove an element from the heap.
+ * 
+ * @param s [i/o] hypothesis stack
+ * @param i [in] element index
+ * 
+ * @return the removed hypothesis
+ * </EN>
+ */
+static NODE *
+hs_remove(HYPOSTACK *s, int i)
+{
+  NODE *tmp;
+
+  tmp = s->heap[i];
+  s->num--;
+  if (i < s->num) {
+    s->heap[i] = s->heap[s->num];
+    hs_trickle_down(s, i);
+  }
+  return(tmp);
+}
+
+/** 
+ * <JA>
+ * ⥹å. 
+ * 
+ * @param s [out] ⥹å
+ * @param stacksize [in] åΥΡɿξ
+ * </JA>
+ * <EN>
+ * Initialize a hypothesis stack.
+ * 
+ * @param s [out] hypothesis stack
+ * @param stacksize [in] maximum stack size limit
+ * </EN>
+ */
+static void
+hs_init(HYPOSTACK *s, int stacksize)
+{
+  s->heap = (NODE **)mymalloc(sizeof(NODE *) * stacksize);
+  s->size = stacksize;
+  s->num = 0;
+  s->toprank = 0;
+  s->bottomrank = 0;
+}
+
+/** 
+ * <JA>
+ * ⥹åȺΰ. 
+ * 
+ * @param s [i/o] ⥹å
+ * </JA>
+ * <EN>
+ * Free all hypotheses in a hypothesis stack and its work area.
+ * 
+ * @param s [i/o] hypothesis stack
+ * </EN>
+ */
+static void
+hs_free(HYPOSTACK *s)
+{
+  int i;
+
+  for(i=0;i<s->num;i++) free_node(s->heap[i]);
+  s->num = 0;
+  free(s->heap);
+  s->heap = NULL;
+}
+
+/** 
+ * <JA>
+ * ⥹åಾФ. get_best_from_stack() 
+ * ҡ. 
+ * 
+ * @param s [i/o] ⥹å
+ * 
+ * @return ФಾΥݥ, Ǥ NULL.
+ * </JA>
+ * <EN>
+ * Pop the best hypothesis from a hypothesis stack.  This is the heap
+ * version of get_best_from_stack().
+ * 
+ * @param s [i/o] hypothesis stack
+ * 
+ * @return pointer to the popped hypothesis, or NULL if empty.
+ * </EN>
+ */
+static NODE *
+hs_get_best(HYPOSTACK *s)
+{
+  if (s->num == 0) return NULL;
+  return(hs_remove(s, 0));
+}
+
+/** 
+ * <JA>
+ * ⤬⥹å˳Ǽ뤫ɤå. 
+ * 
+ * @param s [in] ⥹å
+ * @param new [in] å벾
+ * 
+ * @return åΥ¤ãƤʤǰ
+ * 褱гǼȤ 0 򡤤ʳǤ -1 ֤. 
+ * </JA>
+ * <EN>
+ * Check whether a hypothesis will be stored in a hypothesis stack.
+ * 
+ * @param s [in] hypothesis stack
+ * @param new [in] hypothesis to be checked
+ * 
+ * @return 0 if it will be stored in the stack (in case the stack is not
+ * full or the score of @a new is better than the worst one).  Otherwise
+ * returns -1, which means it can not be pushed to the stack.
+ * </EN>
+ */
+static int
+hs_can_put(HYPOSTACK *s, NODE *new)
+{
+  if (s->num + 1 > s->size && s->heap[hs_bottom(s)]->score >= new->score) {
+    /* new node is below the bottom: discard it */
+    return(-1);
+  }
+  return(0);
+}
+
+/** 
+ * <JA>
+ * ⥹å˿ʲǼ. put_to_stack() ΥҡǤǡ
+ * Ʊβ֤ν put_to_stack() Ʊˤʤ. 
+ * ǼǤʤä硤Ϳ줿 free_node() . 
+ * 
+ * @param s [i/o] ⥹å
+ * @param new [in] Ǽ벾
+ * 
+ * @return ǼǤ 0 򡤤Ǥʤä -1 ֤. 
+ * </JA>
+ * <EN>
+ * Push a new hypothesis into a hypothesis stack.  This is the heap
+ * version of put_to_stack(), and the order among hypotheses of the
+ * same score is also the same as put_to_stack().
+ * If not succeeded, the given new hypothesis will be freed by free_node().
+ * 
+ * @param s [i/o] hypothesis stack
+ * @param new [in] hypothesis to be pushed
+ * 
+ * @return 0 if succeded, or -1 if failed to push because of number
+ * limitation or too low score.
+ * </EN>
+ */
+static int
+hs_put(HYPOSTACK *s, NODE *new)
+{
+  NODE *top, *bottom;
+  int b;
+
+  /* stack size check */
+  if (s->num + 1 > s->size) {
+    /* stack size overflow */
+    b = hs_bottom(s);
+    if (s->heap[b]->score < new->score) {
+      /* new node will be inserted in the stack: free the bottom */
+      free_node(hs_remove(s, b));
+    } else {
+      /* new node is below the bottom: discard it */
+      free_node(new);
+      return(-1);
+    }
+  }
+
+  /* decide the position among the nodes of the same score, in the same
+     way as put_to_stack() */
+  if (s->num == 0) {
+    new->stackrank = 0;
+  } else {
+    top = s->heap[0];
+    bottom = s->heap[hs_bottom(s)];
+    if (top->score <= new->score) {
+      new->stackrank = --(s->toprank);
+    } else if (bottom->score >= new->score) {
+      new->stackrank = ++(s->bottomrank);
+    } else if ((top->score + bottom->score) / 2 > new->score) {
+      new->stackrank = ++(s->bottomrank);
+    } else {
+      new->stackrank = --(s->toprank);
+    }
+  }
+
+  s->heap[s->num] = new;
+  s->num++;
+  hs_bubble_up(s, s->num - 1);
+
+  return(0);
+}
+
+/** 
+ * <JA>
+ * ⥹åȤƽϤ. åȤϼ. (ǥХå)
+ * 
+ * @param s [i/o] ⥹å
+ * @param winfo [in] ñ켭
+ * </JA>
+ * <EN>
+ * Output all nodes in the hypothesis stack. All nodes will be lost
+ * (for debug).
+ * 
+ * @param s [i/o] hypothesis stack
+ * @param winfo [in] word dictionary
+ * </EN>
+ */
+static void
+hs_put_all(HYPOSTACK *s, WORD_INFO *winfo)
+{
+  NODE *ntmp;
+  
+  jlog("DEBUG: hypotheses remained in global stack\n");
+  while ((ntmp = hs_get_best(s)) != NULL) {
+    jlog("DEBUG: %3d: s=%f", s->num, ntmp->score);
+    put_hypo_woutput(ntmp, winfo);
+    free_node(ntmp);
   }
 }
 
@@ -870,9 +1230,16 @@ static void
 envl_update(StackDecode *s, NODE *n, int framenum)
 {
   int t;
+#ifdef PASS2_STRICT_IWCD
+  /* g[] has no valid score outside [g_begin..g_end] */
+  for(t=n->g_end;t>=n->g_begin;t--) {
+    if (s->framemaxscore[t] < n->g[t]) s->framemaxscore[t] = n->g[t];
+  }
+#else
   for(t=framenum-1;t>=0;t--) {
     if (s->framemaxscore[t] < n->g[t]) s->framemaxscore[t] = n->g[t];
   }
+#endif
 }
 #endif /* SCAN_BEAM */
 
@@ -1198,6 +1565,520 @@ pass2_finalize_on_no_result(RecogProcess *r, boolean use_1pass_as_final)
   free_node(now);
 }
 
+/** 
+ * <JA>
+ * ڤ (-deadline) ¬Ѥ˸߻ߥä֤. 
+ * 
+ * @return ߻ (msec)
+ * </JA>
+ * <EN>
+ * Return current wall-clock time in msec for the deadline (-deadline).
+ * 
+ * @return current time in msec
+ * </EN>
+ */
+double
+pass2_clock_msec()
+{
+#if !defined(_WIN32) || defined(__CYGWIN32__) || defined(__MINGW32__)
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return((double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0);
+#else
+  /* clock() returns wall-clock time on win32 */
+  return((double)clock() * 1000.0 / (double)CLOCKS_PER_SEC);
+#endif
+}
+
+/** 
+ * <JA>
+ * ڤˤ2ѥǤڤäݡʸ䤬Ĥ̵
+ * ǧλԤɤʬʸλĤ򡤤κǸñ˻
+ * 1ѥñ䴰Ʒ̤Ȥ롥䴰Ǥʤ1ѥ
+ * ̤Ѥ롥
+ * 
+ * @param hypo [in] ɤʬʸ
+ * @param r [in] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Finalize the result when the 2nd pass was cut by the deadline before
+ * any sentence candidate was found.  The best partial hypothesis is
+ * completed by the word sequence of the 1st pass that leads to its
+ * last word.  If it cannot be completed, the 1st pass result is used.
+ * 
+ * @param hypo [in] the best partial hypothesis
+ * @param r [in] recognition process instance
+ * </EN>
+ */
+static void
+pass2_finalize_on_deadline(NODE *hypo, RecogProcess *r)
+{
+  NODE *now;
+  TRELLIS_ATOM *tre;
+#ifdef CM_MULTIPLE_ALPHA
+  int j;
+#endif
+
+  if (hypo == NULL || hypo->tre == NULL) {
+    pass2_finalize_on_no_result(r, TRUE);
+    r->result.status = J_RESULT_STATUS_TRUNCATED;
+    return;
+  }
+
+  now = newnode(r);
+  cpy_node(now, hypo);
+  /* 1ѥΥȥꥹñ򤿤ɤäʸƬޤ䴰 */
+  /* trace the trellis words of the 1st pass toward the beginning */
+  for (tre = hypo->tre; tre->begintime > 0; tre = tre->last_tre) {
+    if (tre->last_tre == NULL || tre->last_tre->wid == WORD_INVALID) break;
+    if (now->seqnum >= MAXSEQNUM) break;
+    now->seq[now->seqnum] = tre->last_tre->wid;
+    now->totallscore += tre->last_tre->lscore;
+#ifdef CONFIDENCE_MEASURE
+    /* fill in null values */
+#ifdef CM_MULTIPLE_ALPHA
+    for(j=0;j<r->config->annotate.cm_alpha_num;j++) {
+      now->cmscore[now->seqnum][j] = 0.0;
+    }
+#else
+    now->cmscore[now->seqnum] = 0.0;
+#endif
+#endif /* CONFIDENCE_MEASURE */
+    now->seqnum++;
+  }
+
+  if (r->lmtype == LM_PROB && r->config->successive.enabled) {
+    /* if in sp segment mode, */
+    /* find segment restart words from the result */
+    segment_set_last_nword(now, r);
+  }
+
+  store_result_pass2(now, r);
+  r->result.status = J_RESULT_STATUS_TRUNCATED;
+  
+  free_node(now);
+}
+
+/** 
+ * <JA>
+ * 1ѥη̤γΤ餷2ѥμ¹ˡ (-pass2skip). 
+ * 1ѥκѥñΥޡ (find_1pass_result() 
+ * ׻) ʬ礭Ϥû2ѥά1ѥη̤
+ * ǽ̤Ȥ. ޡ󤬤礭Хå̾2ѥ
+ * Ԥ. 
+ * 
+ * @param r [i/o] ǧ󥹥
+ * 
+ * @return 2ѥά TRUE, 2ѥԤ FALSE.
+ * </JA>
+ * <EN>
+ * Decide how to perform the 2nd pass from the confidence of the 1st pass
+ * result (-pass2skip).  When the score margin of words on the 1st pass
+ * best path (computed at find_1pass_result()) is large enough and the
+ * input is short, the 2nd pass is skipped and the 1st pass result
+ * becomes the final result.  When the margin is moderately large, the
+ * 2nd pass will be done with reduced stack.
+ * 
+ * @param r [i/o] recognition process instance
+ * 
+ * @return TRUE if the 2nd pass was skipped, or FALSE if the 2nd pass
+ * should be performed.
+ * </EN>
+ */
+boolean
+pass2_adapt_by_confidence(RecogProcess *r)
+{
+  JCONF_SEARCH *jconf;
+  StackDecode *dwrk;
+  int mode;
+
+  jconf = r->config;
+  dwrk = &(r->pass2);
+
+  r->result.pass2_adapt = PASS2_ADAPT_FULL;
+  if (! jconf->pass2.adapt_by_confidence) return FALSE;
+
+  mode = PASS2_ADAPT_FULL;
+  if (r->result.pass1_margin >= jconf->pass2.adapt_skip_margin
+      && (jconf->pass2.adapt_max_frame <= 0
+	  || r->backtrellis->framelen <= jconf->pass2.adapt_max_frame)) {
+    mode = PASS2_ADAPT_SKIPPED;
+  } else if (r->result.pass1_margin >= jconf->pass2.adapt_reduce_margin) {
+    mode = PASS2_ADAPT_REDUCED;
+  }
+  r->result.pass2_adapt = mode;
+  dwrk->adapt_num[mode]++;
+
+  if (verbose_flag) {
+    jlog("STAT: %02d %s: 1st pass margin = %f, ", jconf->id, jconf->name, r->result.pass1_margin);
+    switch(mode) {
+    case PASS2_ADAPT_FULL:    jlog("full 2nd pass\n"); break;
+    case PASS2_ADAPT_REDUCED: jlog("2nd pass with reduced stack\n"); break;
+    case PASS2_ADAPT_SKIPPED: jlog("2nd pass skipped\n"); break;
+    }
+  }
+
+  if (mode == PASS2_ADAPT_SKIPPED) {
+    /* 1ѥη̤򤽤Τޤ޽Ϥ */
+    /* output the result of the 1st pass as a final result */
+    pass2_finalize_on_no_result(r, TRUE);
+    /* 2ѥ¹ԤʤΤǤǥΡɳǼˤˤ */
+    /* the node stocker should be cleared here since wchmm_fbs() will
+       not be called, as the next input may have different length */
+    clear_stocker(dwrk);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+
+/**********************************************************************/
+/********** ñŸ         ****************************************/
+/********** Next word expansion ***************************************/
+/**********************************************************************/
+
+/* Ф⤫μñŸǤϡƸ next_word() ϸߤ
+   ΩǤ. Ǥޤ򽸤ᡤnext_word() åɤ
+   ˼¹Ԥθ彸᤿˥åسǼ. Ǽ
+   ༡ƱʤΤǷ̤Ѥʤ. */
+/* On next word expansion from a popped hypothesis, next_word() of each
+   candidate is independent of others.  So the candidates are first
+   collected, next_word() is performed for them in parallel by worker
+   threads, and then they are pushed to the stack in the collected order.
+   Since the order of pushing is the same as serial processing, the
+   results does not change. */
+
+/** 
+ * <JA>
+ * Ǽΰݤ. 
+ * 
+ * @param e [i/o] ñŸѥꥢ
+ * @param num [in] ɬפʸ
+ * </JA>
+ * <EN>
+ * Allocate area to hold candidates.
+ * 
+ * @param e [i/o] work area for next word expansion
+ * @param num [in] required number of candidates
+ * </EN>
+ */
+static void
+nwexp_jobs_alloc(NextWordExpand *e, int num)
+{
+  if (e->maxnum >= num) return;
+  if (e->maxnum == 0) {
+    e->src = (NODE **)mymalloc(sizeof(NODE *) * num);
+    e->dst = (NODE **)mymalloc(sizeof(NODE *) * num);
+    e->nword = (NEXTWORD **)mymalloc(sizeof(NEXTWORD *) * num);
+  } else {
+    e->src = (NODE **)myrealloc(e->src, sizeof(NODE *) * num);
+    e->dst = (NODE **)myrealloc(e->dst, sizeof(NODE *) * num);
+    e->nword = (NEXTWORD **)myrealloc(e->nword, sizeof(NEXTWORD *) * num);
+  }
+  e->maxnum = num;
+}
+
+#ifdef HAVE_PTHREAD
+#ifndef PASS2_STRICT_IWCD
+/** 
+ * <JA>
+ * ̤θ˼Ф next_word() ¹Ԥ. 
+ * 
+ * @param e [i/o] ñŸѥꥢ
+ * @param wrk [i/o] ΥåɤνϳΨ׻ѥꥢ
+ * </JA>
+ * <EN>
+ * Take unprocessed candidates one by one and perform next_word().
+ * 
+ * @param e [i/o] work area for next word expansion
+ * @param wrk [i/o] work area for output probability computation of
+ * this thread
+ * </EN>
+ */
+static void
+nwexp_jobs_process(NextWordExpand *e, HMMWork *wrk)
+{
+  int k;
+
+  for(;;) {
+    pthread_mutex_lock(&(e->mutex));
+    k = e->next++;
+    pthread_mutex_unlock(&(e->mutex));
+    if (k >= e->num) break;
+    next_word_wrk(e->src[k], e->dst[k], e->nword[k], e->param, wrk, e->r);
+  }
+}
+
+/** 
+ * <JA>
+ * ñŸΥå. 
+ * 
+ * @param arg [in] åɤξ
+ * 
+ * @return NULL
+ * </JA>
+ * <EN>
+ * Worker thread for next word expansion.
+ * 
+ * @param arg [in] worker thread information
+ * 
+ * @return NULL
+ * </EN>
+ */
+static void *
+nwexp_worker(void *arg)
+{
+  NextWordWorker *w;
+  NextWordExpand *e;
+  int gen;
+
+  w = (NextWordWorker *)arg;
+  e = w->e;
+  gen = 0;
+  pthread_mutex_lock(&(e->mutex));
+  for(;;) {
+    while (e->generation == gen && e->quit == FALSE) {
+      pthread_cond_wait(&(e->cond_start), &(e->mutex));
+    }
+    if (e->quit) break;
+    gen = e->generation;
+    pthread_mutex_unlock(&(e->mutex));
+    nwexp_jobs_process(e, &(w->wrk));
+    pthread_mutex_lock(&(e->mutex));
+    e->active--;
+    if (e->active == 0) pthread_cond_signal(&(e->cond_done));
+  }
+  pthread_mutex_unlock(&(e->mutex));
+  return NULL;
+}
+#endif /* PASS2_STRICT_IWCD */
+#endif /* HAVE_PTHREAD */
+
+/** 
+ * <JA>
+ * ñŸѥꥢ. åɤϺǽϤ
+ * ư. 
+ * 
+ * @param e [out] ñŸѥꥢ
+ * </JA>
+ * <EN>
+ * Initialize work area for next word expansion.  The worker threads
+ * will be started at the first input.
+ * 
+ * @param e [out] work area for next word expansion
+ * </EN>
+ */
+static void
+nwexp_init(NextWordExpand *e)
+{
+  e->src = NULL;
+  e->dst = NULL;
+  e->nword = NULL;
+  e->num = 0;
+  e->maxnum = 0;
+#ifdef HAVE_PTHREAD
+  e->started = FALSE;
+  e->thread_num = 0;
+  e->worker = NULL;
+#endif
+}
+
+/** 
+ * <JA>
+ * åɤư. ƥåɤϽϳΨ׻Ѥ
+ * ꥢ̤˻. ưѤߤξϲ⤷ʤ. 
+ * tied-mixture ǥǥʬۤλ޴Ԥ硤޴꤬
+ * ե졼η׻̤˰¸׻ͤѤ뤿ᡤ󲽤ʤ. 
+ * 
+ * @param e [i/o] ñŸѥꥢ
+ * @param thread_num [in] ŸѤ륹åɿ (1 󲽤ʤ)
+ * @param r [in] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Start worker threads.  Each thread has its own work area for output
+ * probability computation.  Do nothing if already started.  No thread
+ * is started for a tied-mixture model with Gaussian pruning, since the
+ * pruning refers to the previous computation and the scores would
+ * depend on the order in which the threads run.
+ * 
+ * @param e [i/o] work area for next word expansion
+ * @param thread_num [in] number of threads for expansion (1 disables
+ * parallel processing)
+ * @param r [in] recognition process instance
+ * </EN>
+ */
+static void
+nwexp_start(NextWordExpand *e, int thread_num, RecogProcess *r)
+{
+#ifdef HAVE_PTHREAD
+#ifndef PASS2_STRICT_IWCD
+  /* next_word() of PASS2_STRICT_IWCD uses shared work area */
+  PROCESS_AM *am;
+  NextWordWorker *w;
+  int i;
+
+  if (e->started) return;
+  e->started = TRUE;
+  if (thread_num <= 1) return;
+
+  am = r->am;
+  if (am->hmminfo->is_tied_mixture && am->config->gprune_method != GPRUNE_SEL_NONE) {
+    jlog("WARNING: \"-nwthread\" is ignored with Gaussian pruning on tied-mixture model\n");
+    return;
+  }
+  pthread_mutex_init(&(e->mutex), NULL);
+  pthread_cond_init(&(e->cond_start), NULL);
+  pthread_cond_init(&(e->cond_done), NULL);
+  e->generation = 0;
+  e->active = 0;
+  e->quit = FALSE;
+  e->worker = (NextWordWorker *)mymalloc(sizeof(NextWordWorker) * (thread_num - 1));
+  for(i=0;i<thread_num-1;i++) {
+    w = &(e->worker[i]);
+    w->e = e;
+    memset(&(w->wrk), 0, sizeof(HMMWork));
+    /* inherit plugin functions, if any */
+    w->wrk.compute_gaussset = am->hmmwrk.compute_gaussset;
+    w->wrk.compute_gaussset_init = am->hmmwrk.compute_gaussset_init;
+    w->wrk.compute_gaussset_free = am->hmmwrk.compute_gaussset_free;
+    if (outprob_init(&(w->wrk), am->hmminfo, am->hmm_gs, am->config->gs_statenum, am->config->gprune_method, am->config->mixnum_thres) == FALSE) {
+      jlog("WARNING: failed to initialize work area for next word expansion, use %d threads\n", i + 1);
+      break;
+    }
+    if (pthread_create(&(w->thread), NULL, nwexp_worker, w) != 0) {
+      jlog("WARNING: failed to create thread for next word expansion, use %d threads\n", i + 1);
+      outprob_free(&(w->wrk));
+      break;
+    }
+  }
+  e->thread_num = i;
+#endif
+#endif
+}
+
+/** 
+ * <JA>
+ * ϤȤ˥åɤνϳΨ׻ѥꥢ. 
+ * 
+ * @param e [i/o] ñŸѥꥢ
+ * @param framenum [in] Ĺ
+ * </JA>
+ * <EN>
+ * Prepare the work areas for output probability computation of the
+ * worker threads for an input.
+ * 
+ * @param e [i/o] work area for next word expansion
+ * @param framenum [in] input length
+ * </EN>
+ */
+static void
+nwexp_prepare(NextWordExpand *e, int framenum)
+{
+#ifdef HAVE_PTHREAD
+  int i;
+
+  for(i=0;i<e->thread_num;i++) {
+    outprob_prepare(&(e->worker[i].wrk), framenum);
+  }
+#endif
+}
+
+/** 
+ * <JA>
+ * åɤλñŸѥꥢ. 
+ * 
+ * @param e [i/o] ñŸѥꥢ
+ * </JA>
+ * <EN>
+ * Terminate worker threads and free the work area for next word expansion.
+ * 
+ * @param e [i/o] work area for next word expansion
+ * </EN>
+ */
+static void
+nwexp_free(NextWordExpand *e)
+{
+#ifdef HAVE_PTHREAD
+  int i;
+
+  if (e->worker != NULL) {
+    pthread_mutex_lock(&(e->mutex));
+    e->quit = TRUE;
+    pthread_cond_broadcast(&(e->cond_start));
+    pthread_mutex_unlock(&(e->mutex));
+    for(i=0;i<e->thread_num;i++) {
+      pthread_join(e->worker[i].thread, NULL);
+      outprob_free(&(e->worker[i].wrk));
+    }
+    free(e->worker);
+    e->worker = NULL;
+    e->thread_num = 0;
+    pthread_cond_destroy(&(e->cond_start));
+    pthread_cond_destroy(&(e->cond_done));
+    pthread_mutex_destroy(&(e->mutex));
+  }
+  e->started = FALSE;
+#endif
+  if (e->maxnum > 0) {
+    free(e->src);
+    free(e->dst);
+    free(e->nword);
+    e->maxnum = 0;
+  }
+}
+
+/** 
+ * <JA>
+ * ᤿ˤĤ next_word() ¹Ԥ. åɤ
+ *  NW_PARALLEL_MIN_NUM ʾΤȤ˼¹Ԥ. 
+ * 
+ * @param e [i/o] ñŸѥꥢ
+ * @param param [in] ϥѥ᡼
+ * @param r [in] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Perform next_word() for all the collected candidates.  They will be
+ * processed in parallel when worker threads exist and the number of
+ * candidates is NW_PARALLEL_MIN_NUM or more.
+ * 
+ * @param e [i/o] work area for next word expansion
+ * @param param [in] input parameter vectors
+ * @param r [in] recognition process instance
+ * </EN>
+ */
+static void
+nwexp_run(NextWordExpand *e, HTK_Param *param, RecogProcess *r)
+{
+  int k;
+
+#ifdef HAVE_PTHREAD
+#ifndef PASS2_STRICT_IWCD
+  if (e->thread_num > 0 && e->num >= NW_PARALLEL_MIN_NUM) {
+    pthread_mutex_lock(&(e->mutex));
+    e->param = param;
+    e->r = r;
+    e->next = 0;
+    e->active = e->thread_num;
+    e->generation++;
+    pthread_cond_broadcast(&(e->cond_start));
+    pthread_mutex_unlock(&(e->mutex));
+    /* main thread also works, with the work area of the AM */
+    nwexp_jobs_process(e, &(r->am->hmmwrk));
+    pthread_mutex_lock(&(e->mutex));
+    while (e->active > 0) {
+      pthread_cond_wait(&(e->cond_done), &(e->mutex));
+    }
+    pthread_mutex_unlock(&(e->mutex));
+    return;
+  }
+#endif
+#endif
+  for(k=0;k<e->num;k++) {
+    next_word(e->src[k], e->dst[k], e->nword[k], param, r);
+  }
+}
 
 /**********************************************************************/
 /********* Main stack decoding function *******************************/
@@ -1235,9 +2116,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 {
   /* ʸ⥹å */
   /* hypothesis stack (double-linked list) */
-  int stacknum;			/* current stack size */
-  NODE *start = NULL;		/* top node */
-  NODE *bottom = NULL;		/* bottom node */
+  HYPOSTACK stack;		/* hypothesis stack */
 
   /* ǧ̳Ǽå(̤Ϥؤä󽸤) */
   /* result sentence stack (found results will be stored here and then re-ordered) */
@@ -1275,12 +2154,16 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 
   /* local temporal parameter */
   int stacksize, ncan, maxhypo, peseqlen;
+  boolean deadline_p = FALSE;	/* TRUE if the search was cut by deadline */
+  NODE *deadline_hypo = NULL;	/* best hypothesis at the deadline */
   JCONF_SEARCH *jconf;
   WORD_INFO *winfo;
   NGRAM_INFO *ngram;
   DFA_INFO *gdfa;
   BACKTRELLIS *backtrellis;
   StackDecode *dwrk;
+  NextWordExpand *nwexp;
+  int k;
 
   if (r->lmtype == LM_DFA) {
     if (debug2_flag) jlog("DEBUG: only words in these categories will be expanded: %d-%d\n", cate_bgn, cate_bgn + cate_num-1);
@@ -1305,6 +2188,14 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
   stacksize = jconf->pass2.stack_size;
   ncan = jconf->pass2.nbest;
   maxhypo = jconf->pass2.hypo_overflow;
+  if (r->result.pass2_adapt == PASS2_ADAPT_REDUCED) {
+    /* 1ѥη̤Τ餷Τǥå̾ */
+    /* the 1st pass result is confident, reduce stack */
+    stacksize /= PASS2_REDUCE_RATE;
+    if (stacksize < 1) stacksize = 1;
+    maxhypo /= PASS2_REDUCE_RATE;
+    if (maxhypo < 1) maxhypo = 1;
+  }
   peseqlen = backtrellis->framelen;
 
   /* store data for sub routines */
@@ -1313,14 +2204,18 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
   /* ͽ¬ñǼΰ */
   /* malloc area for word prediction */
   /* the initial maximum number of nextwords is the size of vocabulary */
-  nextword = nw_malloc(&maxnwnum, &nwroot, winfo->num);
+  nextword = nw_malloc(&maxnwnum, &nwroot, winfo->num, &(r->arena));
   /* ׻Ѥΰ */
   /* malloc are for forward viterbi (scan_word()) */
   malloc_wordtrellis(r);		/* scan_wordΰ */
   /* ⥹å */
   /* initialize hypothesis stack */
-  start = bottom = NULL;
-  stacknum = 0;
+  hs_init(&stack, stacksize);
+  /* ñŸѥåɤ */
+  /* prepare worker threads for next word expansion */
+  nwexp = &(dwrk->nwexp);
+  nwexp_start(nwexp, jconf->pass2.nwthread_num, r);
+  nwexp_prepare(nwexp, param->samplenum);
   /* ̳Ǽå */
   /* initialize result stack */
   r_stacksize = ncan;
@@ -1333,6 +2228,13 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
   dwrk->genectr = 0;
   dwrk->pushctr = 0;
   dwrk->finishnum = 0;
+  /* ñ쥭åϤȤ˥ꥢ */
+  /* next word cache is valid only within an input */
+  if (dwrk->nwcache.size > 0) nwcache_clear(r);
+  /* N-gram Ψåϻ꤬ʤϤȤ˥ꥢ */
+  /* N-gram probability cache is cleared for each input unless kept */
+  if (dwrk->lmcache.size > 0 && !jconf->pass2.lmcache_keep) lmcache_clear(r);
+  dwrk->lmcache.hit = dwrk->lmcache.miss = 0;
   
 #ifdef CM_SEARCH
   /* initialize local stack */
@@ -1370,7 +2272,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
     /* If the number of nextwords can exceed the buffer size, expand the
        nextword data area */
     while (nwnum < 0) {
-      nextword = nw_expand(nextword, &maxnwnum, &nwroot, winfo->num);
+      nextword = nw_expand(nextword, &maxnwnum, &nwroot, winfo->num, &(r->arena));
       nwnum = dfa_firstwords(nextword, peseqlen, maxnwnum, r);
     }
   }
@@ -1402,7 +2304,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
     cm_store(dwrk, new);
 #else 
     /* put to stack */
-    if (put_to_stack(new, &start, &bottom, &stacknum, stacksize) != -1) {
+    if (hs_put(&stack, new) != -1) {
       dwrk->current = new;
       //callback_exec(CALLBACK_DEBUG_PASS2_PUSH, r);
       if (jconf->graph.enabled) {
@@ -1443,7 +2345,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
     }
 #endif /* CM_SEARCH_LIMIT */
     
-    if (put_to_stack(new, &start, &bottom, &stacknum, stacksize) != -1) {
+    if (hs_put(&stack, new) != -1) {
       dwrk->current = new;
       //callback_exec(CALLBACK_DEBUG_PASS2_PUSH, r);
       if (r->graphout) {
@@ -1480,7 +2382,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 #ifdef DEBUG
     jlog("DEBUG: get one hypothesis\n");
 #endif
-    now = get_best_from_stack(&start,&stacknum);
+    now = hs_get_best(&stack);
     if (now == NULL) {  /* stack empty ---> õλ*/
       jlog("WARNING: %02d %s: hypothesis stack exhausted, terminate search now\n", r->config->id, r->config->name);
       jlog("STAT: %02d %s: %d sentences have been found\n", r->config->id, r->config->name, dwrk->finishnum);
@@ -1663,10 +2565,21 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
       jlog("WARNING: %02d %s: num of popped hypotheses reached the limit (%d)\n", r->config->id, r->config->name, maxhypo);
       /* (for debug) õԻˡå˻ĤäǤФ */
       /* (for debug) output all hypothesis remaining in the stack */
-      if (debug2_flag) put_all_in_stack(&start, &stacknum, r->lm->winfo);
+      if (debug2_flag) hs_put_all(&stack, r->lm->winfo);
       free_node(now);
       break;			/* end of search */
     }
+    /* ڤ᤮õǤڤ. ФϸǺɤ
+       ʬʸȤƻĤ */
+    /* if the deadline has passed, stop search.  The popped hypothesis
+       is kept as the best partial hypothesis at this point */
+    if (jconf->pass2.deadline_msec > 0 && pass2_clock_msec() - dwrk->deadline_origin >= jconf->pass2.deadline_msec) {
+      jlog("WARNING: %02d %s: 2nd pass reached the deadline (%d msec)\n", r->config->id, r->config->name, jconf->pass2.deadline_msec);
+      if (debug2_flag) hs_put_all(&stack, r->lm->winfo);
+      deadline_p = TRUE;
+      deadline_hypo = now;
+      break;			/* end of search */
+    }
     /* ĹͤۤȤβ˴ */
     /* check hypothesis word length overflow */
     if (now->seqnum >= MAXSEQNUM) {
@@ -1742,7 +2655,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	jlog("DEBUG  This hypo itself was pushed with final score=%f\n", new->score);
       }
       new->endflag = TRUE;
-      if (put_to_stack(new, &start, &bottom, &stacknum, stacksize) != -1) {
+      if (hs_put(&stack, new) != -1) {
 	if (r->graphout) {
 	  if (new->score > LOG_ZERO) {
 	    new->lastcontext = now->prevgraph;
@@ -1784,7 +2697,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	    new->lastcontext = now->lastcontext;
 	    new->prevgraph = now->prevgraph;
 	  }
-	} /* put_to_stack() != -1 */
+	} /* hs_put() != -1 */
       }	/* recog->graphout */
       /* βϤǽ餺, 餵ñŸ */
       /* continue with the 'now' hypothesis, not terminate here */
@@ -1818,7 +2731,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
       /* If the number of nextwords can exceed the buffer size, expand the
 	 nextword data area */
       while (nwnum < 0) {
-	nextword = nw_expand(nextword, &maxnwnum, &nwroot, winfo->num);
+	nextword = nw_expand(nextword, &maxnwnum, &nwroot, winfo->num, &(r->arena));
 	nwnum = dfa_nextwords(now, nextword, maxnwnum, r);
       }
     }
@@ -1851,6 +2764,11 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	    );
 #endif
 
+    /* ñŸθ򽸤 */
+    /* collect candidates of next word expansion */
+    nwexp_jobs_alloc(nwexp, nwnum);
+    nwexp->num = 0;
+
     /* for each nextword, generate a new hypothesis */
     for (w = 0; w < nwnum; w++) {
       if (r->lmtype == LM_DFA) {
@@ -1900,9 +2818,24 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	       for each frame compared with now->g[] */
 	    next_word(now, now_noise, &fornoise, param, r);
 	    scan_word(now_noise, param, r);
+#ifdef PASS2_STRICT_IWCD
+	    for(t=now->g_begin;t<=now->g_end;t++) {
+	      now_noise->g[t] = max(now_noise->g[t], now->g[t]);
+	    }
+	    if (now->g_begin <= now->g_end) {
+	      if (now_noise->g_begin > now_noise->g_end) {
+		now_noise->g_begin = now->g_begin;
+		now_noise->g_end = now->g_end;
+	      } else {
+		if (now_noise->g_begin > now->g_begin) now_noise->g_begin = now->g_begin;
+		if (now_noise->g_end < now->g_end) now_noise->g_end = now->g_end;
+	      }
+	    }
+#else
 	    for(t=0;t<peseqlen;t++) {
 	      now_noise->g[t] = max(now_noise->g[t], now->g[t]);
 	    }
+#endif
 	    /* Υ򶴤ݤθ׻Τǡ
 	       ǺǸΥΥñ now_noise ä */
 	    /* now that score has been computed considering pause insertion,
@@ -1924,7 +2857,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	  
 	  /* ' new'  'now_noise'  */
 	  /* generate a new hypothesis 'new' from 'now_noise' */
-	  next_word(now_noise, new, nextword[w], param, r);
+	  nwexp->src[nwexp->num] = now_noise;
 	  
 	} else {
 	  
@@ -1940,7 +2873,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	  
 	  /* ' new'  'now_noise'  */
 	  /* generate a new hypothesis 'new' from 'now_noise' */
-	  next_word(now, new, nextword[w], param, r);
+	  nwexp->src[nwexp->num] = now;
 	  
 	}
       }
@@ -1951,10 +2884,24 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	   N-gram ξϥΥ̰ʤ */
 	/* generate a new hypothesis 'new' from 'now'.
 	   pause insertion is treated as same as normal words in N-gram mode. */
-	next_word(now, new, nextword[w], param, r);
+	nwexp->src[nwexp->num] = now;
 
       }
 
+      nwexp->dst[nwexp->num] = new;
+      nwexp->nword[nwexp->num] = nextword[w];
+      nwexp->num++;
+    }
+
+    /* ᤿ˤĤƿΥ׻ */
+    /* compute scores of the new hypotheses for the collected candidates */
+    nwexp_run(nwexp, param, r);
+
+    /* ᤿˿򥹥åسǼ */
+    /* push the new hypotheses to stack in the collected order */
+    for (k = 0; k < nwexp->num; k++) {
+      new = nwexp->dst[k];
+
       if (new->score <= LOG_ZERO) { /* not on trellis */
 	free_node(new);
 	continue;
@@ -1970,7 +2917,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
       /* push the generated hypothesis 'new' to stack */
 
       /* stack overflow */
-      if (can_put_to_stack(new, &bottom, &stacknum, stacksize) == -1) {
+      if (hs_can_put(&stack, new) == -1) {
 	free_node(new);
 	continue;
       }
@@ -2017,7 +2964,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 					  r
 					  );
       }	/* recog->graphout */
-      put_to_stack(new, &start, &bottom, &stacknum, stacksize);
+      hs_put(&stack, new);
       if (debug2_flag) {
 	j = new->seq[new->seqnum-1];
 	jlog("DEBUG:  %15s [%15s](id=%5d)(%f) [%d-%d] pushed\n",winfo->wname[j], winfo->woutput[j], j, new->score, new->estimated_next_t + 1, new->bestt);
@@ -2060,7 +3007,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 	      printf("  %15s [%15s](id=%5d)(%f) [%d-%d] cm=%f\n",winfo->wname[j], winfo->woutput[j], j, new->score, new->estimated_next_t + 1, new->bestt, new->cmscore[new->seqnum-1]);*/
 
       /* stack overflow */
-      if (can_put_to_stack(new, &bottom, &stacknum, stacksize) == -1) {
+      if (hs_can_put(&stack, new) == -1) {
 	free_node(new);
 	continue;
       }
@@ -2107,7 +3054,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
 					  );
       }	/* recog->graphout */
       
-      put_to_stack(new, &start, &bottom, &stacknum, stacksize);
+      hs_put(&stack, new);
       if (debug2_flag) {
 	j = new->seq[new->seqnum-1];
 	jlog("DEBUG:  %15s [%15s](id=%5d)(%f) [%d-%d] pushed\n",winfo->wname[j], winfo->woutput[j], j, new->score, new->estimated_next_t + 1, new->bestt);
@@ -2139,15 +3086,23 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
   /* output */
   if (dwrk->finishnum == 0) {		/* if search failed */
 
-    /* finalize result when no hypothesis was obtained */
-    if (verbose_flag) {
-      if (r->config->sw.fallback_pass1_flag) {
-	jlog("%02d %s: got no candidates, output 1st pass result as a final result\n", r->config->id, r->config->name);
-      } else {
-	jlog("WARNING: %02d %s: got no candidates, search failed\n", r->config->id, r->config->name);
+    if (deadline_p) {
+      /* complete the best partial hypothesis */
+      if (verbose_flag) {
+	jlog("%02d %s: got no candidates by deadline, output the best partial hypothesis completed by 1st pass\n", r->config->id, r->config->name);
       }
+      pass2_finalize_on_deadline(deadline_hypo, r);
+    } else {
+      /* finalize result when no hypothesis was obtained */
+      if (verbose_flag) {
+	if (r->config->sw.fallback_pass1_flag) {
+	  jlog("%02d %s: got no candidates, output 1st pass result as a final result\n", r->config->id, r->config->name);
+	} else {
+	  jlog("WARNING: %02d %s: got no candidates, search failed\n", r->config->id, r->config->name);
+	}
+      }
+      pass2_finalize_on_no_result(r, r->config->sw.fallback_pass1_flag);
     }
-    pass2_finalize_on_no_result(r, r->config->sw.fallback_pass1_flag);
 
   } else {			/* if at least 1 candidate found */
 
@@ -2168,10 +3123,11 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
       if (debug2_flag) jlog("DEBUG: done\n");
       result_reorder_and_output(&r_start, &r_bottom, &r_stacknum, jconf->output.output_hypo_maxnum, r, param);
 
-      r->result.status = J_RESULT_STATUS_SUCCESS;
+      r->result.status = deadline_p ? J_RESULT_STATUS_TRUNCATED : J_RESULT_STATUS_SUCCESS;
       //callback_exec(CALLBACK_RESULT, r);
       //callback_exec(CALLBACK_EVENT_PASS2_END, r);
   }
+  if (deadline_hypo != NULL) free_node(deadline_hypo);
   
   /* Ƽ參󥿤 */
   /* output counters */
@@ -2179,6 +3135,18 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
     jlog("STAT: %02d %s: %d generated, %d pushed, %d nodes popped in %d\n",
 	 r->config->id, r->config->name,
 	 dwrk->genectr, dwrk->pushctr, dwrk->popctr, backtrellis->framelen);
+    if (dwrk->nwcache.size > 0 && dwrk->nwcache.hit + dwrk->nwcache.miss > 0) {
+      jlog("STAT: %02d %s: nextword cache: %d hits in %d lookups (%.1f%%)\n",
+	   r->config->id, r->config->name,
+	   dwrk->nwcache.hit, dwrk->nwcache.hit + dwrk->nwcache.miss,
+	   100.0 * (float)dwrk->nwcache.hit / (float)(dwrk->nwcache.hit + dwrk->nwcache.miss));
+    }
+    if (dwrk->lmcache.size > 0 && dwrk->lmcache.hit + dwrk->lmcache.miss > 0) {
+      jlog("STAT: %02d %s: N-gram prob. cache: %d hits in %d lookups (%.1f%%)\n",
+	   r->config->id, r->config->name,
+	   dwrk->lmcache.hit, dwrk->lmcache.hit + dwrk->lmcache.miss,
+	   100.0 * (float)dwrk->lmcache.hit / (float)(dwrk->lmcache.hit + dwrk->lmcache.miss));
+    }
     jlog_flush();
 #ifdef GRAPHOUT_DYNAMIC
     if (r->graphout) {
@@ -2218,6 +3186,10 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
       wordgraph_check_coherence(wordgraph_root, r);
       /* compute graph CM by forward-backward processing */
       graph_forward_backward(wordgraph_root, r);
+      /* rescore the graph with large N-gram if specified */
+      if (r->lmtype == LM_PROB && r->lm->ngram_rescore) {
+	graph_rescore(wordgraph_root, param, r);
+      }
       if (verbose_flag) jlog("STAT: ------ wordgraph post-processing end ------\n");
 
       r->result.wg = wordgraph_root;
@@ -2254,6 +3226,10 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
       wordgraph_check_coherence(wordgraph_root, r);
       /* compute graph CM by forward-backward processing */
       graph_forward_backward(wordgraph_root, r);
+      /* rescore the graph with large N-gram if specified */
+      if (r->lmtype == LM_PROB && r->lm->ngram_rescore) {
+	graph_rescore(wordgraph_root, param, r);
+      }
       if (verbose_flag) jlog("STAT: ------ wordgraph post-processing end ------\n");
       /* output graph */
       r->result.wg = wordgraph_root;
@@ -2270,8 +3246,7 @@ wchmm_fbs(HTK_Param *param, RecogProcess *r, int cate_bgn, int cate_num)
   
   /* λ */
   /* finalize */
-  nw_free(nextword, nwroot);
-  free_all_nodes(start);
+  hs_free(&stack);
   free_wordtrellis(dwrk);
 #ifdef SCAN_BEAM
   free(dwrk->framemaxscore);
@@ -2311,6 +3286,18 @@ wchmm_fbs_prepare(RecogProcess *r)
     dwrk->cnword = dwrk->cnwordrev = NULL;
   }
   dwrk->stocker_root = NULL;
+  dwrk->adapt_num[PASS2_ADAPT_FULL] = 0;
+  dwrk->adapt_num[PASS2_ADAPT_REDUCED] = 0;
+  dwrk->adapt_num[PASS2_ADAPT_SKIPPED] = 0;
+  /* ñ쥭å */
+  /* allocate next word cache */
+  nwcache_init(r);
+  /* N-gram Ψå */
+  /* allocate N-gram probability cache */
+  lmcache_init(r);
+  /* ñŸѥꥢ */
+  /* initialize work area for next word expansion */
+  nwexp_init(&(dwrk->nwexp));
 #ifdef CONFIDENVE_MEASURE
 #ifdef CM_MULTIPLE_ALPHA
   dwrk->cmsumlist = NULL;
@@ -2349,6 +3336,9 @@ wchmm_fbs_free(RecogProcess *r)
     free(dwrk->cnwordrev);
     dwrk->cnword = dwrk->cnwordrev = NULL;
   }
+  nwcache_free(r);
+  lmcache_free(r);
+  nwexp_free(&(dwrk->nwexp));
 
 #ifdef CONFIDENVE_MEASURE
 #ifdef CM_MULTIPLE_ALPHA
@@ -122,35 +122,6 @@ static int new_num = 0;
 static int request_num = 0;
 #endif
 
-/** 
- * <JA>
- * Ρɤºݤ˥夫. 
- * 
- * @param node [in] Ρ
- * </JA>
- * <EN>
- * Free a hypothesis node actually.
- * 
- * @param node [in] hypothesis node
- * </EN>
- */
-static void
-free_node_exec(NODE *node)
-{
-  if (node == NULL) return;
-
-  free(node->g);
-  if (node->g_prev != NULL) free(node->g_prev);
-#ifdef GRAPHOUT_PRECISE_BOUNDARY
-  if (node->region->graphout) {
-    free(node->wordend_frame);
-    free(node->wordend_gscore);
-  }
-#endif
-
-  free(node);
-}
-
 /** 
  * <JA>
  * ΡɤѤλƥꥵѤ˥ȥå
@@ -205,13 +176,7 @@ free_node(NODE *node)
 void
 clear_stocker(StackDecode *s)
 {
-  NODE *node, *tmp;
-  node = s->stocker_root;
-  while(node) {
-    tmp = node->next;
-    free_node_exec(node);
-    node = tmp;
-  }
+  /* nodes are in the per-input memory arena and released with it */
   s->stocker_root = NULL;
 
 #ifdef STOCKER_DEBUG
@@ -341,18 +306,18 @@ newnode(RecogProcess *r)
 #endif
   } else {
     /* allocate new */
-    tmp =(NODE *)mymalloc(sizeof(NODE));
-    tmp->g = (LOGPROB *)mymalloc(sizeof(LOGPROB) * peseqlen);
+    tmp =(NODE *)mybarena_malloc(sizeof(NODE), &(r->arena));
+    tmp->g = (LOGPROB *)mybarena_malloc(sizeof(LOGPROB) * peseqlen, &(r->arena));
     if (r->ccd_flag) {
-      tmp->g_prev = (LOGPROB *)mymalloc(sizeof(LOGPROB) * peseqlen);
+      tmp->g_prev = (LOGPROB *)mybarena_malloc(sizeof(LOGPROB) * peseqlen, &(r->arena));
     } else {
       tmp->g_prev = NULL;
     }
 
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
     if (r->graphout) {
-      tmp->wordend_frame = (short *)mymalloc(sizeof(short) * peseqlen);
-      tmp->wordend_gscore = (LOGPROB *)mymalloc(sizeof(LOGPROB) * peseqlen);
+      tmp->wordend_frame = (short *)mybarena_malloc(sizeof(short) * peseqlen, &(r->arena));
+      tmp->wordend_gscore = (LOGPROB *)mybarena_malloc(sizeof(LOGPROB) * peseqlen, &(r->arena));
     }
 #endif
 #ifdef STOCKER_DEBUG
@@ -1360,18 +1325,22 @@ scan_word(NODE *now, HTK_Param *param, RecogProcess *r)
  * @param new [out] 줿⤬Ǽ
  * @param nword [in] ³뼡ñξ
  * @param param [in] ϥѥ᡼
+ * @param wrk [i/o] ϳΨ׻ѥꥢ
  * @param r [in] ǧ󥹥
  *
  * </JA>
  * <EN>
  * Connect a new word to generate a next hypothesis.  The optimal connection
  * point and new sentence score of the new hypothesis will be estimated by
- * looking up the corresponding words on word trellis.
+ * looking up the corresponding words on word trellis.  Output
+ * probabilities are computed on the given work area, so this can be
+ * called from several threads at once, each with its own work area.
  * 
  * @param now [in] source hypothesis
  * @param new [out] pointer to save the newly generated hypothesis
  * @param nword [in] next word to be connected
  * @param param [in] input parameter vector
+ * @param wrk [i/o] work area for output probability computation
  * @param r [in] recognition process instance
  * 
  * </EN>
@@ -1379,7 +1348,7 @@ scan_word(NODE *now, HTK_Param *param, RecogProcess *r)
  * @callergraph
  */
 void
-next_word(NODE *now, NODE *new,	NEXTWORD *nword, HTK_Param *param, RecogProcess *r)
+next_word_wrk(NODE *now, NODE *new, NEXTWORD *nword, HTK_Param *param, HMMWork *wrk, RecogProcess *r)
 {
   int   t;
   HMM_Logical *newphone;
@@ -1516,9 +1485,9 @@ next_word(NODE *now, NODE *new,	NEXTWORD *nword, HTK_Param *param, RecogProcess
       totalscore = new->g[t] + tre->backscore;
       if (! hmminfo->multipath) {
 	if (newphone->is_pseudo) {
-	  tmpp = outprob_cd(&(r->am->hmmwrk), t, &(newphone->body.pseudo->stateset[newphone->body.pseudo->state_num-2]), param);
+	  tmpp = outprob_cd(wrk, t, &(newphone->body.pseudo->stateset[newphone->body.pseudo->state_num-2]), param);
 	} else {
-	  tmpp = outprob_state(&(r->am->hmmwrk), t, newphone->body.defined->s[newphone->body.defined->state_num-2], param);
+	  tmpp = outprob_state(wrk, t, newphone->body.defined->s[newphone->body.defined->state_num-2], param);
 	}
 	totalscore += tmpp;
       }
@@ -1544,9 +1513,9 @@ next_word(NODE *now, NODE *new,	NEXTWORD *nword, HTK_Param *param, RecogProcess
     totalscore = new->g[t] + tre->backscore;
     if (! hmminfo->multipath) {
       if (newphone->is_pseudo) {
-	tmpp = outprob_cd(&(r->am->hmmwrk), t, &(newphone->body.pseudo->stateset[newphone->body.pseudo->state_num-2]), param);
+	tmpp = outprob_cd(wrk, t, &(newphone->body.pseudo->stateset[newphone->body.pseudo->state_num-2]), param);
       } else {
-	tmpp = outprob_state(&(r->am->hmmwrk), t, newphone->body.defined->s[newphone->body.defined->state_num-2], param);
+	tmpp = outprob_state(wrk, t, newphone->body.defined->s[newphone->body.defined->state_num-2], param);
       }
       totalscore += tmpp;
     }
@@ -1564,9 +1533,9 @@ next_word(NODE *now, NODE *new,	NEXTWORD *nword, HTK_Param *param, RecogProcess
     totalscore = new->g[t] + tre->backscore;
     if (! hmminfo->multipath) {
       if (newphone->is_pseudo) {
-	tmpp = outprob_cd(&(r->am->hmmwrk), t, &(newphone->body.pseudo->stateset[newphone->body.pseudo->state_num-2]), param);
+	tmpp = outprob_cd(wrk, t, &(newphone->body.pseudo->stateset[newphone->body.pseudo->state_num-2]), param);
       } else {
-	tmpp = outprob_state(&(r->am->hmmwrk), t, newphone->body.defined->s[newphone->body.defined->state_num-2], param);
+	tmpp = outprob_state(wrk, t, newphone->body.defined->s[newphone->body.defined->state_num-2], param);
       }
       totalscore += tmpp;
     }
@@ -1580,6 +1549,38 @@ next_word(NODE *now, NODE *new,	NEXTWORD *nword, HTK_Param *param, RecogProcess
 
 }
 
+/** 
+ * <JA>
+ * Ÿ˼ñ³ƿ. ϳΨη׻ˤ
+ * ǥΥꥢѤ. 
+ * 
+ * @param now [in] Ÿ
+ * @param new [out] 줿⤬Ǽ
+ * @param nword [in] ³뼡ñξ
+ * @param param [in] ϥѥ᡼
+ * @param r [in] ǧ󥹥
+ *
+ * </JA>
+ * <EN>
+ * Connect a new word to generate a next hypothesis, using the work area
+ * of the acoustic model for output probability computation.
+ * 
+ * @param now [in] source hypothesis
+ * @param new [out] pointer to save the newly generated hypothesis
+ * @param nword [in] next word to be connected
+ * @param param [in] input parameter vector
+ * @param r [in] recognition process instance
+ * 
+ * </EN>
+ * @callgraph
+ * @callergraph
+ */
+void
+next_word(NODE *now, NODE *new,	NEXTWORD *nword, HTK_Param *param, RecogProcess *r)
+{
+  next_word_wrk(now, new, nword, param, &(r->am->hmmwrk), r);
+}
+
 /**********************************************************************/
 /**********                  ****************************/
 /********** Generate an initial hypothesis ****************************/
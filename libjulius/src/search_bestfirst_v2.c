@@ -83,32 +83,6 @@ static int new_num = 0;
 static int request_num = 0;
 #endif
 
-/** 
- * <JA>
- * Ρɤºݤ˥夫. 
- * 
- * @param node [in] Ρ
- * </JA>
- * <EN>
- * Free a hypothesis node actually.
- * 
- * @param node [in] hypothesis node
- * </EN>
- */
-static void
-free_node_exec(NODE *node)
-{
-  if (node == NULL) return;
-  free(node->g);
-#ifdef GRAPHOUT_PRECISE_BOUNDARY
-  if (node->region->graphout) {
-    free(node->wordend_frame);
-    free(node->wordend_gscore);
-  }
-#endif
-  free(node);
-}
-
 /** 
  * <JA>
  * ΡɤѤλƥꥵѤ˥ȥå
@@ -162,13 +136,7 @@ free_node(NODE *node)
 void
 clear_stocker(StackDecode *s)
 {
-  NODE *node, *tmp;
-  node = s->stocker_root;
-  while(node) {
-    tmp = node->next;
-    free_node_exec(node);
-    node = tmp;
-  }
+  /* nodes are in the per-input memory arena and released with it */
   s->stocker_root = NULL;
 
 #ifdef STOCKER_DEBUG
@@ -204,12 +172,20 @@ NODE *
 cpy_node(NODE *dst, NODE *src)
 {
   int peseqlen;
+  int t;
 
   peseqlen = src->region->peseqlen;
   
   dst->next = src->next;
   dst->prev = src->prev;
-  memcpy(dst->g, src->g, sizeof(LOGPROB) * peseqlen);
+  /* g[] ͭϰϤΤߥԡ */
+  /* only the valid range of g[] needs to be copied */
+  for(t = dst->g_begin; t <= dst->g_end; t++) dst->g[t] = LOG_ZERO;
+  if (src->g_begin <= src->g_end) {
+    memcpy(&(dst->g[src->g_begin]), &(src->g[src->g_begin]), sizeof(LOGPROB) * (src->g_end - src->g_begin + 1));
+  }
+  dst->g_begin = src->g_begin;
+  dst->g_end = src->g_end;
   memcpy(dst->seq, src->seq, sizeof(WORD_ID) * MAXSEQNUM);
 #ifdef CM_SEARCH
 #ifdef CM_MULTIPLE_ALPHA
@@ -295,12 +271,15 @@ newnode(RecogProcess *r)
 #endif
   } else {
     /* allocate new */
-    tmp = (NODE *)mymalloc(sizeof(NODE));
-    tmp->g = (LOGPROB *)mymalloc(sizeof(LOGPROB) * peseqlen);
+    tmp = (NODE *)mybarena_malloc(sizeof(NODE), &(r->arena));
+    tmp->g = (LOGPROB *)mybarena_malloc(sizeof(LOGPROB) * peseqlen, &(r->arena));
+    for(i = 0; i < peseqlen; i++) tmp->g[i] = LOG_ZERO;
+    tmp->g_begin = 0;
+    tmp->g_end = -1;
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
     if (r->graphout) {
-      tmp->wordend_frame = (short *)mymalloc(sizeof(short) * peseqlen);
-      tmp->wordend_gscore = (LOGPROB *)mymalloc(sizeof(LOGPROB) * peseqlen);
+      tmp->wordend_frame = (short *)mybarena_malloc(sizeof(short) * peseqlen, &(r->arena));
+      tmp->wordend_gscore = (LOGPROB *)mybarena_malloc(sizeof(LOGPROB) * peseqlen, &(r->arena));
     }
 #endif
 #ifdef STOCKER_DEBUG
@@ -319,9 +298,14 @@ newnode(RecogProcess *r)
   }
   tmp->endflag = FALSE;
   tmp->seqnum = 0;
-  for(i = 0; i < peseqlen; i++) {
+  /* g[] ͭϰϳǤϾ LOG_ZERO ʲʤΤǡͭϰϤΤߥꥢ */
+  /* g[] is always kept LOG_ZERO or less outside of the valid range,
+     so only the valid range needs clearing */
+  for(i = tmp->g_begin; i <= tmp->g_end; i++) {
     tmp->g[i] = LOG_ZERO;
   }
+  tmp->g_begin = 0;
+  tmp->g_end = -1;
   tmp->final_g = LOG_ZERO;
 #ifdef VISUALIZE
   tmp->popnode = NULL;
@@ -371,6 +355,12 @@ malloc_wordtrellis(RecogProcess *r)
   dwrk->wordtrellis[1] = (LOGPROB *)mymalloc(sizeof(LOGPROB) * maxwn);
 
   dwrk->g = (LOGPROB *)mymalloc(sizeof(LOGPROB) * r->peseqlen);
+  {
+    int t;
+    for(t=0;t<r->peseqlen;t++) dwrk->g[t] = LOG_ZERO;
+  }
+  dwrk->g_begin = 0;
+  dwrk->g_end = -1;
 
   dwrk->phmmlen_max = r->lm->winfo->maxwlen + 2;
   dwrk->phmmseq = (HMM_Logical **)mymalloc(sizeof(HMM_Logical *) * dwrk->phmmlen_max);
@@ -440,6 +430,82 @@ free_wordtrellis(StackDecode *dwrk)
 /************ Compute forward score of a hypothesis *******************/
 /**********************************************************************/
 
+/** 
+ * <JA>
+ * ͭϰϤĤ򥳥ԡ. src[t+shift] + a + b 
+ * dst[t] (0 <= t <= limit) ˳Ǽdst ͭϰϤ򹹿. 
+ * limit Υե졼ѹʤ. 
+ * 
+ * @param dst [i/o] ԡΥ
+ * @param dbegin [i/o] @a dst ͭϰϤλü
+ * @param dend [i/o] @a dst ͭϰϤνü
+ * @param src [in] ԡΥ (@a dst ƱǤ褤)
+ * @param sbegin [in] @a src ͭϰϤλü
+ * @param send [in] @a src ͭϰϤνü
+ * @param shift [in] ե졼Τ餷 (0 ޤ 1)
+ * @param a [in] û륹
+ * @param b [in] û륹
+ * @param limit [in] ǽե졼
+ * </JA>
+ * <EN>
+ * Copy forward scores with valid range: store src[t+shift] + a + b to
+ * dst[t] for 0 <= t <= limit, and update the valid range of dst.
+ * Frames after @a limit are left untouched.  Only the valid ranges of
+ * both buffers are scanned, since the scores outside them are known to
+ * be LOG_ZERO or less.
+ * 
+ * @param dst [i/o] destination score buffer
+ * @param dbegin [i/o] beginning of valid range of @a dst
+ * @param dend [i/o] end of valid range of @a dst
+ * @param src [in] source score buffer (may be the same as @a dst)
+ * @param sbegin [in] beginning of valid range of @a src
+ * @param send [in] end of valid range of @a src
+ * @param shift [in] frame shift (0 or 1)
+ * @param a [in] score to be added
+ * @param b [in] score to be added
+ * @param limit [in] last frame to be updated
+ * </EN>
+ */
+static void
+copy_g_band(LOGPROB *dst, short *dbegin, short *dend, LOGPROB *src, short sbegin, short send, int shift, LOGPROB a, LOGPROB b, int limit)
+{
+  int bgn, end, lo, hi, t;
+
+  /* new valid range */
+  bgn = sbegin - shift;
+  if (bgn < 0) bgn = 0;
+  end = send - shift;
+  if (end > limit) end = limit;
+
+  /* scan the new range and the old range to be cleared, in ascending
+     order so that in-place shifting works */
+  lo = bgn; hi = end;
+  if (*dbegin <= *dend) {
+    if (lo > *dbegin) lo = *dbegin;
+    if (hi < *dend) hi = *dend;
+    if (hi > limit) hi = limit;
+  }
+  for (t = lo; t <= hi; t++) {
+    if (t >= bgn && t <= end) {
+      dst[t] = src[t+shift] + a + b;
+    } else {
+      dst[t] = LOG_ZERO;
+    }
+  }
+
+  /* the old values after limit still remain */
+  if (*dbegin <= *dend && *dend > limit) {
+    if (*dbegin < limit + 1) *dbegin = limit + 1;
+    if (bgn <= end) *dbegin = bgn;
+  } else if (bgn <= end) {
+    *dbegin = bgn;
+    *dend = end;
+  } else {
+    *dbegin = 0;
+    *dend = -1;
+  }
+}
+
 /* Ϳ줿ǤΤʤ phmmseq[0..phmmlen-1]Фviterbi׻Ԥ. 
    g[0..framelen-1] ΥͤȤ g_new[0..framelen-1]˹ͤ. 
     least_frame ޤǤscan. */
@@ -453,7 +519,11 @@ free_wordtrellis(StackDecode *dwrk)
  * Ѵؿ. 
  * 
  * @param g [in] ߤλ֤Ȥ
+ * @param g_begin [in] @a g ͭϰϤλü
+ * @param g_end [in] @a g ͭϰϤνü
  * @param g_new [out] οǼХåե
+ * @param g_new_begin [i/o] @a g_new ͭϰϤλü
+ * @param g_new_end [i/o] @a g_new ͭϰϤνü
  * @param phmmseq [in] HMM¤
  * @param has_sp [in] short-pause location
  * @param phmmlen [in] @a phmmseq Ĺ
@@ -472,7 +542,11 @@ free_wordtrellis(StackDecode *dwrk)
  * sequence.
  * 
  * @param g [in] current forward scores at each input frame
+ * @param g_begin [in] beginning of valid range of @a g
+ * @param g_end [in] end of valid range of @a g
  * @param g_new [out] buffer to save the resulting score updates
+ * @param g_new_begin [i/o] beginning of valid range of @a g_new
+ * @param g_new_end [i/o] end of valid range of @a g_new
  * @param phmmseq [in] phoneme sequence to perform Viterbi
  * @param has_sp [in] short-pause location
  * @param phmmlen [in] length of @a phmmseq.
@@ -489,7 +563,7 @@ free_wordtrellis(StackDecode *dwrk)
  * </EN>
  */
 static void
-do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, int phmmlen, HTK_Param *param, int framelen, int least_frame, LOGPROB *final_g, short *wordend_frame_src, short *wordend_frame_dst, LOGPROB *wordend_gscore_src, LOGPROB *wordend_gscore_dst, RecogProcess *r) /* has_sp and final_g is for multipath only */
+do_viterbi(LOGPROB *g, short g_begin, short g_end, LOGPROB *g_new, short *g_new_begin, short *g_new_end, HMM_Logical **phmmseq, boolean *has_sp, int phmmlen, HTK_Param *param, int framelen, int least_frame, LOGPROB *final_g, short *wordend_frame_src, short *wordend_frame_dst, LOGPROB *wordend_gscore_src, LOGPROB *wordend_gscore_dst, RecogProcess *r) /* has_sp and final_g is for multipath only */
 {
   HMM *whmm;			/* HMM */
   int wordhmmnum;		/* length of above */
@@ -500,6 +574,9 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
   boolean node_exist_p;
   int tn;		       ///< Temporal pointer to current buffer
   int tl;		       ///< Temporal pointer to previous buffer
+  boolean l2r;		       ///< TRUE if all transitions go to the same or later state
+  int top;		       ///< Highest state that can survive at current frame
+  int hi;		       ///< Highest survived state at previous frame
 
   /* store global values to local for rapid access */
   StackDecode *dwrk;
@@ -538,9 +615,26 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
     j_internal_error("do_viterbi: word too long (>%d)\n", winfo->maxwn + 10);
   }
 
+  /* ܤƱξ֤ظʤ顤ե졼Ĥä
+     ֤ξ֤ g[] Ϥ̵¤Ĥʤ */
+  /* when all transitions go to the same or later states, states after
+     the highest survived state in the previous frame cannot survive
+     unless they get input from g[] */
+  l2r = TRUE;
+  for(i=0;i<wordhmmnum && l2r;i++) {
+    for (ac=whmm->state[i].ac;ac;ac=ac->next) {
+      if (ac->arc < i) {
+	l2r = FALSE;
+	break;
+      }
+    }
+  }
+
   /* scan򸡺 -> startt*/
   /* search for the start frame -> set to startt */
-  for(t = framelen-1; t >=0 ; t--) {
+  /* g[] ͭϰϳˤ LOG_ZERO 礭̵ */
+  /* no score > LOG_ZERO exists outside the valid range of g[] */
+  for(t = g_end; t >= g_begin; t--) {
     if (
 #ifdef SCAN_BEAM
 	g[t] > framemaxscore[t] - scan_beam_thres &&
@@ -549,17 +643,19 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
       break;
     }
   }
-  if (t < 0) {			/* no node has score > LOG_ZERO */
+  if (t < g_begin) {		/* no node has score > LOG_ZERO */
     /* reset all scores and end */
-    for(t=0;t<framelen;t++) {
-      g_new[t] = LOG_ZERO;
+    for(t = *g_new_begin; t <= *g_new_end; t++) g_new[t] = LOG_ZERO;
+    *g_new_begin = 0;
+    *g_new_end = -1;
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
-      if (r->graphout) {
+    if (r->graphout) {
+      for(t=0;t<framelen;t++) {
 	wordend_frame_dst[t] = -1;
 	wordend_gscore_dst[t] = LOG_ZERO;
       }
-#endif
     }
+#endif
     free_hmm(whmm);
     return;
   }
@@ -567,15 +663,15 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
   
   /* ʹ[startt+1..framelen-1]  g_new[] ꥻå */
   /* clear g_new[] for [startt+1..framelen-1] */
-  for(t=framelen-1;t>startt;t--) {
-    g_new[t] = LOG_ZERO;
+  for(t = *g_new_end; t > startt; t--) g_new[t] = LOG_ZERO;
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
-    if (r->graphout) {
+  if (r->graphout) {
+    for(t=framelen-1;t>startt;t--) {
       wordend_frame_dst[t] = -1;
       wordend_gscore_dst[t] = LOG_ZERO;
     }
-#endif
   }
+#endif
 
   /*****************/
   /* viterbi start */
@@ -583,6 +679,8 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
 
   /* set initial swap buffer */
   tn = 0; tl = 1;
+  /* no state has survived before [startt] in multipath */
+  hi = hmminfo->multipath ? -1 : wordhmmnum - 1;
 
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
   if (r->graphout) {
@@ -619,7 +717,26 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
 
     node_exist_p = FALSE;	/* TRUE if there is at least 1 survived node in this frame */
 
-    if (! hmminfo->multipath) {
+    /* Υե졼Ĥꤦ֤ξ */
+    /* upper bound of states that can survive in this frame */
+    if (!l2r || (t >= g_begin && t <= g_end)) {
+      top = wordhmmnum - 1;
+    } else {
+      top = hi;
+    }
+    hi = -1;
+
+    if (! hmminfo->multipath && top < wordhmmnum - 1) {
+      /* üΥΡɤؤϤ̵ */
+      /* no input to the edge node */
+      dwrk->wordtrellis[tn][wordhmmnum-1] = LOG_ZERO;
+#ifdef GRAPHOUT_PRECISE_BOUNDARY
+      if (r->graphout) {
+	dwrk->wend_token_frame[tn][wordhmmnum-1] = -1;
+	dwrk->wend_token_gscore[tn][wordhmmnum-1] = LOG_ZERO;
+      }
+#endif
+    } else if (! hmminfo->multipath) {
     
       /* üΥΡ [t][wordhmmnum-1]ϡ  g[]ι⤤ˤʤ */
       /* the edge node [t][wordhmmnum-1] is either internal transitin or g[] */
@@ -665,30 +782,49 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
 #endif
       } else {
 	node_exist_p = TRUE;
+	hi = wordhmmnum - 1;
 	dwrk->wordtrellis[tn][wordhmmnum-1] = tmpmax + outprob(&(r->am->hmmwrk), t, &(whmm->state[wordhmmnum-1]), param);
       }
 
     }
 
-    /* node[wordhmmnum-2..0]ˤĤƥȥꥹŸ */
-    /* expand trellis for node [t][wordhmmnum-2..0] */
-    for(i=wordhmmnum-2;i>=0;i--) {
+    /* ¤ξ֤ܤĴ٤Ȥ */
+    /* states after the upper bound are dropped without checking arcs */
+    for(i=wordhmmnum-2;i>top;i--) {
+      dwrk->wordtrellis[tn][i] = LOG_ZERO;
+#ifdef GRAPHOUT_PRECISE_BOUNDARY
+      if (r->graphout) {
+	dwrk->wend_token_frame[tn][i] = -1;
+	dwrk->wend_token_gscore[tn][i] = LOG_ZERO;
+      }
+#endif
+    }
+
+    /* node[top..0]ˤĤƥȥꥹŸ */
+    /* expand trellis for node [t][top..0] */
+    for(;i>=0;i--) {
       
       /* ѥȺॹ tmpmax 򸫤Ĥ */
       /* find most likely path and the max score 'tmpmax' */
       tmpmax = LOG_ZERO;
-      for (ac=whmm->state[i].ac;ac;ac=ac->next) {
-	if (hmminfo->multipath) {
+      if (hmminfo->multipath) {
+	for (ac=whmm->state[i].ac;ac;ac=ac->next) {
 	  if (ac->arc == wordhmmnum-1) tmpscore = g[t];
 	  else if (t + 1 > startt) tmpscore = LOG_ZERO;
 	  else tmpscore = dwrk->wordtrellis[tl][ac->arc];
 	  tmpscore += ac->a;
-	} else {
-	  tmpscore = dwrk->wordtrellis[tl][ac->arc] + ac->a;
+	  if (tmpmax < tmpscore) {
+	    tmpmax = tmpscore;
+	    j = ac->arc;
+	  }
 	}
-	if (tmpmax < tmpscore) {
-	  tmpmax = tmpscore;
-	  j = ac->arc;
+      } else {
+	for (ac=whmm->state[i].ac;ac;ac=ac->next) {
+	  tmpscore = dwrk->wordtrellis[tl][ac->arc] + ac->a;
+	  if (tmpmax < tmpscore) {
+	    tmpmax = tmpscore;
+	    j = ac->arc;
+	  }
 	}
       }
       
@@ -711,6 +847,7 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
       } else {
 	/* survived node */
 	node_exist_p = TRUE;
+	if (hi < i) hi = i;
  	dwrk->wordtrellis[tn][i] = tmpmax;
 	if (! hmminfo->multipath || i > 0) {
 	  dwrk->wordtrellis[tn][i] += outprob(&(r->am->hmmwrk), t, &(whmm->state[i]), param);
@@ -753,21 +890,26 @@ do_viterbi(LOGPROB *g, LOGPROB *g_new, HMM_Logical **phmmseq, boolean *has_sp, i
        frame ([0..t-1]). */
     if (t < least_frame && (!node_exist_p)) {
       /* crear the rest scores */
-      for (i=t-1;i>=0;i--) {
-	g_new[i] = LOG_ZERO;
+      for (i=t-1;i>=*g_new_begin;i--) g_new[i] = LOG_ZERO;
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
-	if (r->graphout) {
+      if (r->graphout) {
+	for (i=t-1;i>=0;i--) {
 	  wordend_frame_dst[i] = -1;
 	  wordend_gscore_dst[i] = LOG_ZERO;
 	}
-#endif
       }
+#endif
       /* terminate loop */
       break;
     }
     
   } /* end of time loop */
 
+  /* g_new[] ͭϰϤ [t..startt] */
+  /* valid range of g_new[] is now [t..startt] */
+  *g_new_begin = (t < 0) ? 0 : t;
+  *g_new_end = startt;
+
   if (hmminfo->multipath) {
     /* κǽͤ׻ ( 0  0 ؤ) */
     /* compute the total forward score (transition from state 0 to frame 0 */
@@ -841,21 +983,21 @@ do_viterbi_next_word(NODE *now, NODE *new, HMM_Logical *lastphone, boolean sp, H
     if (r->lm->winfo->wlen[now->seq[now->seqnum-1]] > 1) {
       n = hmm_logical_state_num(lastphone);
       a_value = (hmm_logical_trans(lastphone))->a[n-2][n-1];
-      for(t=0; t<peseqlen-1; t++) dwrk->g[t] = now->g[t+1] + a_value;
-      dwrk->g[peseqlen-1] = LOG_ZERO;
+      copy_g_band(dwrk->g, &(dwrk->g_begin), &(dwrk->g_end), now->g, now->g_begin, now->g_end, 1, a_value, 0.0, peseqlen-1);
     } else {
-      for(t=0; t<peseqlen; t++) dwrk->g[t] = now->g[t];
+      copy_g_band(dwrk->g, &(dwrk->g_begin), &(dwrk->g_end), now->g, now->g_begin, now->g_end, 0, 0.0, 0.0, peseqlen-1);
     }
 
   } else {
   
-    for(t=0; t<peseqlen; t++) dwrk->g[t] = now->g[t];
+    copy_g_band(dwrk->g, &(dwrk->g_begin), &(dwrk->g_end), now->g, now->g_begin, now->g_end, 0, 0.0, 0.0, peseqlen-1);
     dwrk->phmmseq[0] = lastphone;
     if (r->lm->config->enable_iwsp) dwrk->has_sp[0] = sp;
 
   }
   
-  do_viterbi(dwrk->g, new->g,
+  do_viterbi(dwrk->g, dwrk->g_begin, dwrk->g_end,
+	     new->g, &(new->g_begin), &(new->g_end),
 	     multipath ? dwrk->phmmseq : &lastphone,
 	     (r->lm->config->enable_iwsp && multipath) ? dwrk->has_sp : NULL,
 	     1, param, peseqlen, now->estimated_next_t, &(new->final_g)
@@ -1027,7 +1169,7 @@ scan_word(NODE *now, HTK_Param *param, RecogProcess *r)
 
   /* g[]򤤤ä򤷤Ƥ */
   /* temporally keeps the original g[] */
-  for (t=0;t<peseqlen;t++) dwrk->g[t] = now->g[t];
+  copy_g_band(dwrk->g, &(dwrk->g_begin), &(dwrk->g_end), now->g, now->g_begin, now->g_end, 0, 0.0, 0.0, peseqlen-1);
 
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
   if (r->graphout) {
@@ -1042,7 +1184,8 @@ scan_word(NODE *now, HTK_Param *param, RecogProcess *r)
 
   /* viterbi¹Ԥ g[]  now->g[] 򹹿 */
   /* do viterbi computation for phmmseq from g[] to now->g[] */
-  do_viterbi(dwrk->g, now->g, dwrk->phmmseq, (enable_iwsp && hmminfo->multipath) ? dwrk->has_sp : NULL, 
+  do_viterbi(dwrk->g, dwrk->g_begin, dwrk->g_end,
+	     now->g, &(now->g_begin), &(now->g_end), dwrk->phmmseq, (enable_iwsp && hmminfo->multipath) ? dwrk->has_sp : NULL, 
 	     phmmlen, param, peseqlen, now->estimated_next_t, &(now->final_g)
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
 	     /* ñ춭 we[]  now->wordend_frame[] 򹹿 */
@@ -1117,6 +1260,7 @@ next_word(NODE *now, NODE *new, NEXTWORD *nword, HTK_Param *param, RecogProcess
 {
   HMM_Logical *lastphone, *newphone;
   LOGPROB *g_src;
+  short g_src_begin, g_src_end;
   int   t;
   int lastword;
   int   i;
@@ -1210,8 +1354,12 @@ next_word(NODE *now, NODE *new, NEXTWORD *nword, HTK_Param *param, RecogProcess
 			 hmminfo->multipath ? now->last_ph_sp_attached : FALSE,
 			 param, r);
     g_src = new->g;
+    g_src_begin = new->g_begin;
+    g_src_end = new->g_end;
   } else {
     g_src = now->g;
+    g_src_begin = now->g_begin;
+    g_src_end = now->g_end;
 #ifdef GRAPHOUT_PRECISE_BOUNDARY
     if (r->graphout) {
       memcpy(new->wordend_frame, now->wordend_frame, sizeof(short)*peseqlen);
@@ -1230,13 +1378,9 @@ next_word(NODE *now, NODE *new, NEXTWORD *nword, HTK_Param *param, RecogProcess
   i = hmm_logical_state_num(newphone);
   a_value = (hmm_logical_trans(newphone))->a[i-2][i-1];
   if (hmminfo->multipath) {
-    for(t=0; t <= startt; t++) {
-      new->g[t] = g_src[t] + nword->lscore;
-    }
+    copy_g_band(new->g, &(new->g_begin), &(new->g_end), g_src, g_src_begin, g_src_end, 0, nword->lscore, 0.0, startt);
   } else {
-    for(t=0; t <= startt; t++) {
-      new->g[t] = g_src[t+1] + a_value + nword->lscore;
-    }
+    copy_g_band(new->g, &(new->g_begin), &(new->g_end), g_src, g_src_begin, g_src_end, 1, a_value, nword->lscore, startt);
   }
 
   /***************************************************************************/
@@ -1395,6 +1539,8 @@ start_word(NODE *new, NEXTWORD *nword, HTK_Param *param, RecogProcess *r)
   }
   
   new->g[peseqlen-1] = nword->lscore;
+  if (new->g_begin > new->g_end) new->g_begin = peseqlen-1;
+  new->g_end = peseqlen-1;
   
   for (t=peseqlen-1; t>=0; t--) {
     tre = bt_binsearch_atom(backtrellis, t, word);
@@ -211,6 +211,67 @@ mfcc_shrink(MFCCCalc *mfcc, int p)
   }
 }
 
+#ifndef SPSEGMENT_NAIST
+/** 
+ * <JA>
+ * @brief  ݡñ1ѥǳꤷƤ뤫Ĵ٤
+ *
+ * ߥӡ˻ĤäƤȡñ򤿤ɤꡤݡ֤
+ * Ϥ˽ñ줬٤ƱΥȥꥹñǤСޤǤ
+ * ñϰʹߤ1ѥѲʤΤǳȤߤʤ. 
+ * ݡñΤߤʤñϳȤߤʤʤ. 
+ * 
+ * @param r [in] ǧ󥹥
+ * @param start [in] ݡ֤γϥե졼
+ * 
+ * @return ꤷƤ TRUE, Ǥʤ FALSE. 
+ * </JA>
+ * <EN>
+ * @brief  Check if the words before a pause are fixed on the 1st pass.
+ *
+ * The word history of all tokens currently in the beam are traced back,
+ * and if they all pass through the same trellis word that ends before
+ * the pause area, the word sequence up to the word will not change in the
+ * rest of the 1st pass.  A sequence of pause words only is not treated
+ * as fixed.
+ * 
+ * @param r [in] recognition process instance
+ * @param start [in] beginning frame of the pause area
+ * 
+ * @return TRUE if fixed, or FALSE if not.
+ * </EN>
+ */
+static boolean
+words_fixed_before(RecogProcess *r, int start)
+{
+  FSBeam *d;
+  TOKEN2 *tk;
+  TRELLIS_ATOM *tre, *fixed;
+  int j;
+
+  d = &(r->pass1);
+
+  fixed = NULL;
+  for (j = d->n_start; j <= d->n_end; j++) {
+    tk = &(d->tlist[d->tn][d->tindex[d->tn][j]]);
+    for (tre = tk->last_tre; tre && tre != &(d->bos) && tre->endtime >= start; tre = tre->last_tre);
+    if (fixed == NULL) {
+      fixed = tre;
+    } else if (tre != fixed) {
+      /* histories differ */
+      return FALSE;
+    }
+  }
+  if (fixed == NULL) return FALSE;
+
+  /* should contain a non-pause word */
+  for (tre = fixed; tre && tre != &(d->bos); tre = tre->last_tre) {
+    if (! is_sil(tre->wid, r)) return TRUE;
+  }
+  return FALSE;
+}
+#endif /* ~SPSEGMENT_NAIST */
+
 /** 
  * <JA>
  * @brief  ȯöֽλθ
@@ -218,7 +279,9 @@ mfcc_shrink(MFCCCalc *mfcc, int p)
  * 硼ȥݡơ
  * ȯö֤νλ򸡽Ф. ̵ñ줬Ϣ³ƺȤʤե졼
  * Ȥֻ³ˤդӲȥꥬϤ
- * ڤ. 
+ * ڤ. ޤñ1ѥǳꤷƤϡû
+ * ³ (r->config->successive.sp_stable_duration) Ǥڤꡤ
+ * Ϥ椫2ѥʤ褦ˤ. 
  *
  * SPSEGMENT_NAIST ϡꥻ塦̵֤֤Ĺ
  * ꤷǥ١ VAD ڤؤ. ξ硤ȥꥬ
@@ -240,6 +303,9 @@ mfcc_shrink(MFCCCalc *mfcc, int p)
  * segmentation is enabled.  When a pause word gets maximum score for a
  * successive frames, the segment will be treated as a pause frames.
  * When speech re-triggers, the current input will be segmented at that point.
+ * A shorter pause (r->config->successive.sp_stable_duration) also segments
+ * the input when the words before the pause are already fixed on the 1st
+ * pass, so that the 2nd pass can process them while input continues.
  *
  * When SPSEGMENT_NAIST is defined, this function performs extended version
  * of the short pause segmentation, called "decoder-based VAD".  When before
@@ -269,6 +335,9 @@ detect_end_of_segment(RecogProcess *r, int time)
   TRELLIS_ATOM *tremax = NULL;
   int count = 0;
   boolean detected = FALSE;
+#ifndef SPSEGMENT_NAIST
+  boolean fixed = FALSE;
+#endif
 #ifdef SPSEGMENT_NAIST
   MFCCCalc *mfcc;
   WORD_ID wid;
@@ -553,15 +622,22 @@ detect_end_of_segment(RecogProcess *r, int time)
 #ifdef SP_BREAK_DEBUG
     jlog("DEBUG: sp end %d\n", time);
 #endif /* SP_BREAK_DEBUG */
+    /* ûݡǤ⡤ñ󤬳ꤷƤжڤ */
+    /* a shorter pause also breaks if the words before it are fixed */
+    if (r->config->successive.sp_stable_duration > 0
+	&& d->sp_duration < r->config->successive.sp_frame_duration
+	&& d->sp_duration >= r->config->successive.sp_stable_duration) {
+      fixed = words_fixed_before(r, d->tmp_sparea_start);
+    }
     /* sp Ĺå */
     /* check length of the duration*/
-    if (d->sp_duration < r->config->successive.sp_frame_duration) {
+    if (d->sp_duration < r->config->successive.sp_frame_duration && !fixed) {
       /* û: 裱ѥǤ³ */
       /* too short segment: not break, continue 1st pass */
 #ifdef SP_BREAK_DEBUG
       jlog("DEBUG: too short (%d<%d), ignored\n", d->sp_duration, r->config->successive.sp_frame_duration);
 #endif /* SP_BREAK_DEBUG */
-    } else if (d->first_sparea) {
+    } else if (d->first_sparea && !fixed) {
       /* ǽsp֤ silB ˤΤ,裱ѥǤ³ */
       /* do not break at first sp segment: they are silB */
       d->first_sparea = FALSE;
@@ -572,7 +648,7 @@ detect_end_of_segment(RecogProcess *r, int time)
       /* ֽλ, 裱ѥǤ2ѥ */
       /* break 1st pass */
 #ifdef SP_BREAK_DEBUG
-      jlog("DEBUG: >> segment [%d..%d]\n", r->am->mfcc->sparea_start, time-1);
+      jlog("DEBUG: >> segment [%d..%d]%s\n", r->am->mfcc->sparea_start, time-1, fixed ? " (fixed words)" : "");
 #endif /* SP_BREAK_DEBUG */
       /* store begging frame of the segment */
       r->am->mfcc->sparea_start = d->tmp_sparea_start;
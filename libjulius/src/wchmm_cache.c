@@ -0,0 +1,1146 @@
+/**
+ * @file   wchmm_cache.c
+ *
+ * <JA>
+ * @brief  ڹ¤Υåեؤ¸ɤ߹
+ *
+ * N-gram Ѥ˹ۤ줿ڹ¤ (Ρɡܡñ콪ü
+ * ñƬΡɡsuccessor list  1-gram factoring ) 
+ * Хʥե¸εưˤɤ߹ळȤ
+ * ڹ¤ιۤά.
+ *
+ * եˤϼ񡦲ǥ롦ǥ뤪ӹۥѥ᡼
+ * ᤿ϥåͤϿ. ɤ߹߻ˤ餬ߤΥǥ
+ * פʤ硤åϻȤ줺ڹ¤񤬺ƹۤ.
+ *
+ * HMM ξ֤ HMM ؤΥݥ󥿤ϡեǤϾ ID 
+ * ǥꥹȾν֤ɽ졤ɤ߹߻˥ݥ󥿤ᤵ.
+ * եϥӥåǥǽ񤭹ޤ.
+ * </JA>
+ *
+ * <EN>
+ * @brief  Save and load tree lexicon to/from cache file
+ *
+ * The tree lexicon built for N-gram (nodes, transitions, word ends,
+ * word head nodes, successor lists and 1-gram factoring values) is
+ * saved to a binary file, and will be loaded at the next start up
+ * to skip building the tree lexicon.
+ *
+ * The file holds hash values computed from the dictionary, the
+ * acoustic model, the language model and the build parameters.  If they
+ * do not match the current models when loading, the cache is not used
+ * and the tree lexicon is built again.
+ *
+ * Pointers to HMM states and logical HMMs are stored as state IDs or
+ * their order on the model lists in the file, and restored to pointers
+ * when loaded.  The file is written in big endian.
+ * </EN>
+ *
+ * @author Akinobu LEE
+ * @date   Mon Oct 19 16:20:11 2026
+ *
+ * $Revision: 1.1 $
+ *
+ */
+/*
+ * Copyright (c) 1991-2013 Kawahara Lab., Kyoto University
+ * Copyright (c) 2000-2005 Shikano Lab., Nara Institute of Science and Technology
+ * Copyright (c) 2005-2013 Julius project team, Nagoya Institute of Technology
+ * All rights reserved
+ */
+
+#include <julius/julius.h>
+
+/// Header string of the cache file
+#define WCHMM_CACHE_HEADER "JWCHMM\n"
+/// Version number of the cache file format
+#define WCHMM_CACHE_VERSION 1
+/// Magic number at the end of the cache file to detect truncation
+#define WCHMM_CACHE_ENDMARK 0x4a574548
+
+/// Keys to check whether the cache file matches the current models
+typedef struct {
+  unsigned int param;		///< Hash of build parameters and compile options
+  unsigned int dict;		///< Hash of the dictionary
+  unsigned int hmm;		///< Hash of the acoustic model
+  unsigned int lm;		///< Hash of the language model
+} WCHMM_CACHE_KEY;
+
+/// Entry of pointer-to-index table
+typedef struct {
+  void *ptr;			///< Pointer
+  int id;			///< Index
+} PTR_INDEX;
+
+/// Lookup tables to convert pointers in tree lexicon from/to indices
+typedef struct {
+  HTK_HMM_State **st;		///< Physical states [state id]
+  int stnum;			///< Length of @a st
+  HMM_Logical **lg;		///< Logical HMMs in list order
+  int lgnum;			///< Length of @a lg
+  CD_Set **cd;			///< Pseudo phone sets in index tree order
+  int cdnum;			///< Length of @a cd
+  PTR_INDEX *lgidx;		///< @a lg sorted by pointer (for saving)
+  PTR_INDEX *cdidx;		///< State sets of @a cd sorted by pointer (for saving)
+} WCHMM_CACHE_TABLE;
+
+/* work area to gather pseudo phone sets from index tree */
+static CD_Set **cdlist;		///< Gathered pseudo phone sets
+static int cdlistnum;		///< Number of gathered sets
+static int cdlistmax;		///< Allocated length of @a cdlist
+
+/**********************************************************************/
+/* hash functions */
+
+/**
+ * Update hash value with data.
+ *
+ * @param h [in] hash value
+ * @param ptr [in] data
+ * @param len [in] length of data in bytes
+ *
+ * @return the updated hash value.
+ */
+static unsigned int
+hash_data(unsigned int h, void *ptr, size_t len)
+{
+  unsigned char *p;
+  size_t i;
+
+  p = (unsigned char *)ptr;
+  for(i=0;i<len;i++) h = (h ^ p[i]) * 16777619U;
+  return h;
+}
+
+/**
+ * Update hash value with an integer.
+ *
+ * @param h [in] hash value
+ * @param v [in] value
+ *
+ * @return the updated hash value.
+ */
+static unsigned int
+hash_int(unsigned int h, int v)
+{
+  return(hash_data(h, &v, sizeof(int)));
+}
+
+/**
+ * Update hash value with a string.
+ *
+ * @param h [in] hash value
+ * @param s [in] string, or NULL
+ *
+ * @return the updated hash value.
+ */
+static unsigned int
+hash_str(unsigned int h, char *s)
+{
+  if (s == NULL) return(hash_data(h, "", 1));
+  return(hash_data(h, s, strlen(s) + 1));
+}
+
+/**
+ * Callback to gather pseudo phone sets from index tree.
+ *
+ * @param arg [in] pseudo phone set
+ */
+static void
+cdlist_add(void *arg)
+{
+  if (cdlistnum >= cdlistmax) {
+    cdlistmax += 256;
+    cdlist = (CD_Set **)myrealloc(cdlist, sizeof(CD_Set *) * cdlistmax);
+  }
+  cdlist[cdlistnum++] = (CD_Set *)arg;
+}
+
+/**
+ * <JA>
+ * ڹ¤ιۤ˴طǥ꤫饭.
+ *
+ * @param wchmm [in] ڹ¤ (ǥ뤬ƺѤߤǤ뤳)
+ * @param lmconf [in] LMѥ᡼
+ * @param t [in] ȥơ֥
+ * @param key [out] 
+ * </JA>
+ * <EN>
+ * Compute keys from the models and settings related to tree lexicon.
+ *
+ * @param wchmm [in] tree lexicon (models should be assigned)
+ * @param lmconf [in] LM configuration
+ * @param t [in] lookup tables
+ * @param key [out] keys
+ * </EN>
+ */
+static void
+compute_key(WCHMM_INFO *wchmm, JCONF_LM *lmconf, WCHMM_CACHE_TABLE *t, WCHMM_CACHE_KEY *key)
+{
+  WORD_INFO *winfo;
+  HTK_HMM_INFO *hmminfo;
+  HTK_HMM_Data *d;
+  HMM_Logical *lg;
+  CD_Set *cd;
+  LOGPROB p;
+  unsigned int h;
+  int w, i, j, k;
+
+  winfo = wchmm->winfo;
+  hmminfo = wchmm->hmminfo;
+
+  /* build parameters and compile-time options */
+  h = 2166136261U;
+  h = hash_int(h, sizeof(WORD_ID));
+  h = hash_int(h, sizeof(LOGPROB));
+#ifdef PASS1_IWCD
+  h = hash_int(h, 1);
+#endif
+#ifdef UNIGRAM_FACTORING
+  h = hash_int(h, 2);
+#endif
+#ifdef FAST_FACTOR1_SUCCESSOR_LIST
+  h = hash_int(h, 3);
+#endif
+#ifdef SEPARATE_BY_UNIGRAM
+  h = hash_int(h, 4);
+  h = hash_int(h, lmconf->separate_wnum);
+#endif
+#ifdef NO_SEPARATE_SHORT_WORD
+  h = hash_int(h, 5);
+#endif
+#ifdef CLASS_NGRAM
+  h = hash_int(h, 6);
+#endif
+  h = hash_int(h, wchmm->lmtype);
+  h = hash_int(h, wchmm->lmvar);
+  h = hash_int(h, wchmm->category_tree);
+  h = hash_int(h, wchmm->ccd_flag);
+  h = hash_int(h, lmconf->enable_iwsp);
+  key->param = h;
+
+  /* dictionary */
+  h = 2166136261U;
+  h = hash_int(h, winfo->num);
+  for(w=0;w<winfo->num;w++) {
+    h = hash_int(h, winfo->wlen[w]);
+    h = hash_int(h, winfo->wton[w]);
+    for(i=0;i<winfo->wlen[w];i++) {
+      h = hash_str(h, winfo->wseq[w][i]->name);
+    }
+#ifdef CLASS_NGRAM
+    if (winfo->cprob != NULL) {
+      h = hash_data(h, &(winfo->cprob[w]), sizeof(LOGPROB));
+    }
+#endif
+  }
+  h = hash_int(h, winfo->head_silwid);
+  h = hash_int(h, winfo->tail_silwid);
+  key->dict = h;
+
+  /* acoustic model: models, states, transitions and pseudo phones */
+  h = 2166136261U;
+  h = hash_int(h, hmminfo->multipath);
+  h = hash_int(h, hmminfo->totalstatenum);
+  for(d=hmminfo->start;d;d=d->next) {
+    h = hash_str(h, d->name);
+    h = hash_int(h, d->state_num);
+    for(i=0;i<d->state_num;i++) {
+      h = hash_int(h, (d->s[i] != NULL) ? d->s[i]->id : -1);
+    }
+    h = hash_int(h, d->tr->statenum);
+    for(i=0;i<d->tr->statenum;i++) {
+      h = hash_data(h, d->tr->a[i], sizeof(PROB) * d->tr->statenum);
+    }
+  }
+  for(lg=hmminfo->lgstart;lg;lg=lg->next) {
+    h = hash_str(h, lg->name);
+    h = hash_int(h, lg->is_pseudo);
+    h = hash_str(h, lg->is_pseudo ? lg->body.pseudo->name : lg->body.defined->name);
+  }
+  for(i=0;i<t->cdnum;i++) {
+    cd = t->cd[i];
+    h = hash_str(h, cd->name);
+    h = hash_int(h, cd->state_num);
+    h = hash_int(h, cd->tr->id);
+    for(j=0;j<cd->state_num;j++) {
+      for(k=0;k<cd->stateset[j].num;k++) {
+	h = hash_int(h, cd->stateset[j].s[k]->id);
+      }
+    }
+  }
+  key->hmm = h;
+
+  /* language model: 1-gram probabilities used for factoring */
+  h = 2166136261U;
+  if (wchmm->ngram) {
+    for(w=0;w<winfo->num;w++) {
+      p = uni_prob(wchmm->ngram, winfo->wton[w]);
+      h = hash_data(h, &p, sizeof(LOGPROB));
+    }
+  }
+  key->lm = h;
+}
+
+/**********************************************************************/
+/* lookup tables */
+
+/**
+ * qsort callback to sort pointer-to-index table by pointer.
+ *
+ * @param a [in] entry 1
+ * @param b [in] entry 2
+ *
+ * @return -1, 0 or 1 according to the order of the pointers
+ */
+static int
+compare_ptr(PTR_INDEX *a, PTR_INDEX *b)
+{
+  if (a->ptr < b->ptr) return -1;
+  if (a->ptr > b->ptr) return 1;
+  return 0;
+}
+
+/**
+ * Find the entry whose pointer is the largest one not exceeding the
+ * given pointer.
+ *
+ * @param idx [in] pointer-to-index table sorted by pointer
+ * @param num [in] length of @a idx
+ * @param ptr [in] pointer to find
+ *
+ * @return the index of the found entry, or -1 if not found.
+ */
+static int
+find_ptr(PTR_INDEX *idx, int num, void *ptr)
+{
+  int left, right, mid;
+
+  if (num == 0 || ptr < idx[0].ptr) return -1;
+  left = 0;
+  right = num - 1;
+  while (left < right) {
+    mid = (left + right + 1) / 2;
+    if (idx[mid].ptr <= ptr) {
+      left = mid;
+    } else {
+      right = mid - 1;
+    }
+  }
+  return(left);
+}
+
+/**
+ * <JA>
+ * ݥ󥿤ȥǥåѴơ֥.
+ *
+ * @param hmminfo [in] HMM
+ * @param t [out] ȥơ֥
+ * @param for_save [in] ¸Ѥεհơ֥ TRUE
+ * </JA>
+ * <EN>
+ * Make lookup tables between pointers and indices.
+ *
+ * @param hmminfo [in] HMM definition
+ * @param t [out] lookup tables
+ * @param for_save [in] TRUE if also make reverse tables for saving
+ * </EN>
+ */
+static void
+table_make(HTK_HMM_INFO *hmminfo, WCHMM_CACHE_TABLE *t, boolean for_save)
+{
+  HTK_HMM_State *s;
+  HMM_Logical *lg;
+  int i;
+
+  t->stnum = hmminfo->totalstatenum;
+  t->st = (HTK_HMM_State **)mymalloc(sizeof(HTK_HMM_State *) * t->stnum);
+  for(i=0;i<t->stnum;i++) t->st[i] = NULL;
+  for(s=hmminfo->ststart;s;s=s->next) {
+    if (s->id >= 0 && s->id < t->stnum) t->st[s->id] = s;
+  }
+
+  t->lgnum = 0;
+  for(lg=hmminfo->lgstart;lg;lg=lg->next) t->lgnum++;
+  t->lg = (HMM_Logical **)mymalloc(sizeof(HMM_Logical *) * t->lgnum);
+  i = 0;
+  for(lg=hmminfo->lgstart;lg;lg=lg->next) t->lg[i++] = lg;
+
+  cdlist = NULL;
+  cdlistnum = cdlistmax = 0;
+  if (hmminfo->cdset_info.cdtree != NULL) {
+    aptree_traverse_and_do(hmminfo->cdset_info.cdtree, cdlist_add);
+  }
+  t->cd = cdlist;
+  t->cdnum = cdlistnum;
+  cdlist = NULL;
+
+  t->lgidx = NULL;
+  t->cdidx = NULL;
+  if (for_save) {
+    t->lgidx = (PTR_INDEX *)mymalloc(sizeof(PTR_INDEX) * (t->lgnum + 1));
+    for(i=0;i<t->lgnum;i++) {
+      t->lgidx[i].ptr = t->lg[i];
+      t->lgidx[i].id = i;
+    }
+    qsort(t->lgidx, t->lgnum, sizeof(PTR_INDEX), (int (*)(const void *, const void *))compare_ptr);
+    t->cdidx = (PTR_INDEX *)mymalloc(sizeof(PTR_INDEX) * (t->cdnum + 1));
+    for(i=0;i<t->cdnum;i++) {
+      t->cdidx[i].ptr = t->cd[i]->stateset;
+      t->cdidx[i].id = i;
+    }
+    qsort(t->cdidx, t->cdnum, sizeof(PTR_INDEX), (int (*)(const void *, const void *))compare_ptr);
+  }
+}
+
+/**
+ * Free lookup tables.
+ *
+ * @param t [i/o] lookup tables
+ */
+static void
+table_free(WCHMM_CACHE_TABLE *t)
+{
+  if (t->cdidx) free(t->cdidx);
+  if (t->lgidx) free(t->lgidx);
+  if (t->cd) free(t->cd);
+  free(t->lg);
+  free(t->st);
+}
+
+/**********************************************************************/
+/* file I/O */
+
+/**
+ * Binary write function with byte swap (file is in big endian).
+ *
+ * @param fp [in] file pointer
+ * @param buf [in] data to write
+ * @param unitbyte [in] size of a unit in bytes
+ * @param unitnum [in] number of unit to write
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+wrtfunc(FILE *fp, void *buf, size_t unitbyte, size_t unitnum)
+{
+  size_t r;
+
+  if (unitnum == 0) return TRUE;
+#ifndef WORDS_BIGENDIAN
+  if (unitbyte != 1) swap_bytes((char *)buf, unitbyte, unitnum);
+#endif
+  r = myfwrite(buf, unitbyte, unitnum, fp);
+#ifndef WORDS_BIGENDIAN
+  if (unitbyte != 1) swap_bytes((char *)buf, unitbyte, unitnum);
+#endif
+  if (r < unitnum) {
+    jlog("Error: wchmm_cache: failed to write %d bytes\n", unitbyte * unitnum);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * Binary read function with byte swap (file is in big endian).
+ *
+ * @param fp [in] file pointer
+ * @param buf [out] read data
+ * @param unitbyte [in] size of a unit in bytes
+ * @param unitnum [in] number of unit to read
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+rdfunc(FILE *fp, void *buf, size_t unitbyte, size_t unitnum)
+{
+  if (unitnum == 0) return TRUE;
+  if (myfread(buf, unitbyte, unitnum, fp) < unitnum) {
+    jlog("Error: wchmm_cache: failed to read %d bytes\n", unitbyte * unitnum);
+    return FALSE;
+  }
+#ifndef WORDS_BIGENDIAN
+  if (unitbyte != 1) swap_bytes((char *)buf, unitbyte, unitnum);
+#endif
+  return TRUE;
+}
+
+/**
+ * Read an integer value.
+ *
+ * @param fp [in] file pointer
+ * @param v [out] read value
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+rdfunc_int(FILE *fp, int *v)
+{
+  return(rdfunc(fp, v, sizeof(int), 1));
+}
+
+/**********************************************************************/
+/* save */
+
+/**
+ * <JA>
+ * ڹ¤Τե˽񤭹.
+ *
+ * @param fp [in] եݥ
+ * @param wchmm [in] ڹ¤
+ * @param t [in] ȥơ֥
+ *
+ * @return  TRUEԻ FALSE ֤.
+ * </JA>
+ * <EN>
+ * Write body of tree lexicon to file.
+ *
+ * @param fp [in] file pointer
+ * @param wchmm [in] tree lexicon
+ * @param t [in] lookup tables
+ *
+ * @return TRUE on success, FALSE on failure.
+ * </EN>
+ */
+static boolean
+wt_body(FILE *fp, WCHMM_INFO *wchmm, WCHMM_CACHE_TABLE *t)
+{
+  int *ibuf, *ref1, *ref2;
+  int n, w, i, x;
+  int len;
+  A_CELL2 *ac;
+  WORD_ID *sbuf;
+#ifdef PASS1_IWCD
+  void *ptr;
+#endif
+
+  len = wchmm->n;
+  if (len < wchmm->winfo->num + 1) len = wchmm->winfo->num + 1;
+  if (len < wchmm->startnum) len = wchmm->startnum;
+  ibuf = (int *)mymalloc(sizeof(int) * len);
+
+  /* node states */
+  for(n=0;n<wchmm->n;n++) ibuf[n] = wchmm->state[n].scid;
+  if (!wrtfunc(fp, ibuf, sizeof(int), wchmm->n)) goto error;
+
+  ref1 = (int *)mymalloc(sizeof(int) * wchmm->n);
+  ref2 = (int *)mymalloc(sizeof(int) * wchmm->n);
+  for(n=0;n<wchmm->n;n++) {
+    ref1[n] = ref2[n] = -1;
+#ifdef PASS1_IWCD
+    /* node without output (multipath word head) */
+    if (wchmm->state[n].out.state == NULL) continue;
+    switch(wchmm->outstyle[n]) {
+    case AS_STATE:
+      ref1[n] = wchmm->state[n].out.state->id;
+      break;
+    case AS_LSET:
+      ptr = wchmm->state[n].out.lset;
+      x = find_ptr(t->cdidx, t->cdnum, ptr);
+      if (x >= 0) {
+	i = wchmm->state[n].out.lset - t->cd[t->cdidx[x].id]->stateset;
+	if (i < t->cd[t->cdidx[x].id]->state_num) {
+	  ref1[n] = t->cdidx[x].id;
+	  ref2[n] = i;
+	}
+      }
+      break;
+    case AS_RSET:
+      ptr = wchmm->state[n].out.rset->hmm;
+      x = find_ptr(t->lgidx, t->lgnum, ptr);
+      if (x >= 0 && t->lgidx[x].ptr == ptr) {
+	ref1[n] = t->lgidx[x].id;
+	ref2[n] = wchmm->state[n].out.rset->state_loc;
+      }
+      break;
+    case AS_LRSET:
+      ptr = wchmm->state[n].out.lrset->hmm;
+      x = find_ptr(t->lgidx, t->lgnum, ptr);
+      if (x >= 0 && t->lgidx[x].ptr == ptr) {
+	ref1[n] = t->lgidx[x].id;
+	ref2[n] = wchmm->state[n].out.lrset->state_loc;
+      }
+      break;
+    }
+    if (ref1[n] < 0) {
+      jlog("Error: wchmm_cache: node %d: failed to find output reference\n", n);
+      free(ref2); free(ref1);
+      goto error;
+    }
+#else
+    if (wchmm->state[n].out != NULL) ref1[n] = wchmm->state[n].out->id;
+#endif
+  }
+#ifdef PASS1_IWCD
+  if (!wrtfunc(fp, wchmm->outstyle, sizeof(unsigned char), wchmm->n)) {
+    free(ref2); free(ref1);
+    goto error;
+  }
+#endif
+  if (!wrtfunc(fp, ref1, sizeof(int), wchmm->n) || !wrtfunc(fp, ref2, sizeof(int), wchmm->n)) {
+    free(ref2); free(ref1);
+    goto error;
+  }
+  free(ref2);
+  free(ref1);
+
+  /* transitions */
+  if (!wrtfunc(fp, wchmm->self_a, sizeof(LOGPROB), wchmm->n)) goto error;
+  if (!wrtfunc(fp, wchmm->next_a, sizeof(LOGPROB), wchmm->n)) goto error;
+  for(n=0;n<wchmm->n;n++) {
+    i = 0;
+    for(ac=wchmm->ac[n];ac;ac=ac->next) i++;
+    ibuf[n] = i;
+  }
+  if (!wrtfunc(fp, ibuf, sizeof(int), wchmm->n)) goto error;
+  for(n=0;n<wchmm->n;n++) {
+    for(ac=wchmm->ac[n];ac;ac=ac->next) {
+      x = ac->n;
+      if (!wrtfunc(fp, &x, sizeof(int), 1)) goto error;
+      if (!wrtfunc(fp, ac->arc, sizeof(int), ac->n)) goto error;
+      if (!wrtfunc(fp, ac->a, sizeof(LOGPROB), ac->n)) goto error;
+    }
+  }
+  if (!wrtfunc(fp, wchmm->stend, sizeof(WORD_ID), wchmm->n)) goto error;
+
+  /* word-indexed data */
+  for(w=0;w<wchmm->winfo->num;w++) {
+    if (!wrtfunc(fp, wchmm->offset[w], sizeof(int), wchmm->winfo->wlen[w])) goto error;
+  }
+  if (!wrtfunc(fp, wchmm->wordend, sizeof(int), wchmm->winfo->num)) goto error;
+  if (wchmm->hmminfo->multipath) {
+    if (!wrtfunc(fp, wchmm->wordbegin, sizeof(int), wchmm->winfo->num)) goto error;
+  } else {
+    if (!wrtfunc(fp, wchmm->wordend_a, sizeof(LOGPROB), wchmm->winfo->num)) goto error;
+  }
+
+  /* start nodes */
+  if (!wrtfunc(fp, wchmm->startnode, sizeof(int), wchmm->startnum)) goto error;
+
+  /* factoring data */
+#ifdef UNIGRAM_FACTORING
+  x = (wchmm->start2isolate != NULL) ? 1 : 0;
+  if (!wrtfunc(fp, &x, sizeof(int), 1)) goto error;
+  if (x) {
+    if (!wrtfunc(fp, wchmm->start2isolate, sizeof(int), wchmm->startnum)) goto error;
+  }
+  x = (wchmm->scword != NULL) ? 1 : 0;
+  if (!wrtfunc(fp, &x, sizeof(int), 1)) goto error;
+  if (x) {
+    if (!wrtfunc(fp, wchmm->scword, sizeof(WORD_ID), wchmm->scnum)) goto error;
+  }
+  x = (wchmm->fscore != NULL) ? 1 : 0;
+  if (!wrtfunc(fp, &x, sizeof(int), 1)) goto error;
+  if (x) {
+    if (!wrtfunc(fp, wchmm->fscore, sizeof(LOGPROB), wchmm->fsnum)) goto error;
+  }
+#endif
+  x = (wchmm->sclist != NULL) ? 1 : 0;
+  if (!wrtfunc(fp, &x, sizeof(int), 1)) goto error;
+  if (x) {
+    if (!wrtfunc(fp, wchmm->sclen, sizeof(WORD_ID), wchmm->scnum)) goto error;
+    for(i=1;i<wchmm->scnum;i++) {
+      sbuf = wchmm->sclist[i];
+      if (!wrtfunc(fp, sbuf, sizeof(WORD_ID), wchmm->sclen[i])) goto error;
+    }
+  }
+
+  x = WCHMM_CACHE_ENDMARK;
+  if (!wrtfunc(fp, &x, sizeof(int), 1)) goto error;
+
+  free(ibuf);
+  return TRUE;
+
+ error:
+  free(ibuf);
+  return FALSE;
+}
+
+/**
+ * <JA>
+ * @brief  ۺѤߤڹ¤򥭥åե¸.
+ *
+ *  N-gram Ѥڹ¤Τ¸Ǥ.
+ *
+ * @param wchmm [in] ڹ¤
+ * @param lmconf [in] LMѥ᡼
+ * @param filename [in] ¸ե̾
+ *
+ * @return  TRUEԻ FALSE ֤.
+ * </JA>
+ * <EN>
+ * @brief  Save a built tree lexicon to cache file.
+ *
+ * Currently only tree lexicon for N-gram can be saved.
+ *
+ * @param wchmm [in] tree lexicon
+ * @param lmconf [in] LM configuration
+ * @param filename [in] file name to save
+ *
+ * @return TRUE on success, FALSE on failure.
+ * </EN>
+ * @callgraph
+ * @callergraph
+ */
+boolean
+wchmm_cache_save(WCHMM_INFO *wchmm, JCONF_LM *lmconf, char *filename)
+{
+  FILE *fp;
+  WCHMM_CACHE_TABLE t;
+  WCHMM_CACHE_KEY key;
+  unsigned int kbuf[4];
+  int ibuf[9];
+  boolean ret;
+
+  if (wchmm->lmtype != LM_PROB || wchmm->category_tree || wchmm->lmvar == LM_NGRAM_USER) {
+    jlog("Warning: wchmm_cache: lexicon cache is supported only for N-gram, not saved\n");
+    return FALSE;
+  }
+
+  if ((fp = fopen_writefile(filename)) == NULL) {
+    jlog("Error: wchmm_cache: failed to open %s for writing\n", filename);
+    return FALSE;
+  }
+
+  table_make(wchmm->hmminfo, &t, TRUE);
+  compute_key(wchmm, lmconf, &t, &key);
+
+  /* header */
+  ret = wrtfunc(fp, WCHMM_CACHE_HEADER, 1, strlen(WCHMM_CACHE_HEADER));
+  if (ret) {
+    kbuf[0] = WCHMM_CACHE_VERSION;
+    kbuf[1] = key.param;
+    kbuf[2] = key.dict;
+    kbuf[3] = key.hmm;
+    ret = wrtfunc(fp, kbuf, sizeof(unsigned int), 4);
+  }
+  if (ret) {
+    kbuf[0] = key.lm;
+    ret = wrtfunc(fp, kbuf, sizeof(unsigned int), 1);
+  }
+  /* sizes */
+  if (ret) {
+    ibuf[0] = wchmm->winfo->num;
+    ibuf[1] = wchmm->n;
+    ibuf[2] = wchmm->startnum;
+    ibuf[3] = wchmm->scnum;
+#ifdef UNIGRAM_FACTORING
+    ibuf[4] = wchmm->fsnum;
+    ibuf[5] = wchmm->isolatenum;
+#else
+    ibuf[4] = ibuf[5] = 0;
+#endif
+    ibuf[6] = wchmm->separated_word_count;
+    ibuf[7] = t.lgnum;
+    ibuf[8] = t.cdnum;
+    ret = wrtfunc(fp, ibuf, sizeof(int), 9);
+  }
+  /* body */
+  if (ret) ret = wt_body(fp, wchmm, &t);
+
+  table_free(&t);
+
+  if (fclose_writefile(fp) != 0) ret = FALSE;
+  if (ret == FALSE) {
+    jlog("Error: wchmm_cache: failed to write lexicon cache to %s\n", filename);
+    remove(filename);
+    return FALSE;
+  }
+
+  jlog("STAT: lexicon tree saved to %s\n", filename);
+  return TRUE;
+}
+
+/**********************************************************************/
+/* load */
+
+/**
+ * <JA>
+ * ɤ߹ڹ¤ΰ̤ۤξ֤᤹.
+ *
+ * @param wchmm [i/o] ڹ¤
+ * </JA>
+ * <EN>
+ * Free the area of a partly loaded tree lexicon, and make it unbuilt.
+ *
+ * @param wchmm [i/o] tree lexicon
+ * </EN>
+ */
+static void
+rd_abort(WCHMM_INFO *wchmm)
+{
+  mybfree2(&(wchmm->malloc_root));
+  wchmm->malloc_root = NULL;
+#ifdef UNIGRAM_FACTORING
+  if (wchmm->fscore) free(wchmm->fscore);
+  if (wchmm->start2isolate) free(wchmm->start2isolate);
+#endif
+#ifdef PASS1_IWCD
+  if (wchmm->outstyle) free(wchmm->outstyle);
+#endif
+  if (wchmm->wordbegin) free(wchmm->wordbegin);
+  if (wchmm->wordend_a) free(wchmm->wordend_a);
+  if (wchmm->startnode) free(wchmm->startnode);
+  if (wchmm->wordend) free(wchmm->wordend);
+  if (wchmm->offset) free(wchmm->offset);
+  if (wchmm->stend) free(wchmm->stend);
+  if (wchmm->ac) free(wchmm->ac);
+  if (wchmm->next_a) free(wchmm->next_a);
+  if (wchmm->self_a) free(wchmm->self_a);
+  if (wchmm->state) free(wchmm->state);
+  if (wchmm->wrk.out_from_len != 0) {
+    free(wchmm->wrk.out_from);
+    free(wchmm->wrk.out_from_next);
+    free(wchmm->wrk.out_a);
+    free(wchmm->wrk.out_a_next);
+    wchmm->wrk.out_from_len = 0;
+  }
+}
+
+/**
+ * <JA>
+ * ڹ¤Τե뤫ɤ߹.
+ *
+ * @param fp [in] եݥ
+ * @param wchmm [i/o] ڹ¤ (ѤߤǤ뤳)
+ * @param t [in] ȥơ֥
+ *
+ * @return  TRUEԻ FALSE ֤.
+ * </JA>
+ * <EN>
+ * Read body of tree lexicon from file.
+ *
+ * @param fp [in] file pointer
+ * @param wchmm [i/o] tree lexicon (sizes should be already set)
+ * @param t [in] lookup tables
+ *
+ * @return TRUE on success, FALSE on failure.
+ * </EN>
+ */
+static boolean
+rd_body(FILE *fp, WCHMM_INFO *wchmm, WCHMM_CACHE_TABLE *t)
+{
+  WORD_INFO *winfo;
+  int *ibuf, *ref2;
+  int n, w, i, x;
+#ifdef UNIGRAM_FACTORING
+  int fsnum, isolatenum;
+#endif
+  A_CELL2 *ac, *aclast;
+#ifdef PASS1_IWCD
+  RC_INFO *rset;
+  LRC_INFO *lrset;
+#endif
+  boolean ok_p;
+
+  winfo = wchmm->winfo;
+#ifdef UNIGRAM_FACTORING
+  fsnum = wchmm->fsnum;
+  isolatenum = wchmm->isolatenum;
+#endif
+
+  /* allocate */
+  wchmm->maxwcn = wchmm->n;
+  wchmm->state = (WCHMM_STATE *)mymalloc(sizeof(WCHMM_STATE) * wchmm->maxwcn);
+  wchmm->self_a = (LOGPROB *)mymalloc(sizeof(LOGPROB) * wchmm->maxwcn);
+  wchmm->next_a = (LOGPROB *)mymalloc(sizeof(LOGPROB) * wchmm->maxwcn);
+  wchmm->ac = (A_CELL2 **)mymalloc(sizeof(A_CELL2 *) * wchmm->maxwcn);
+  wchmm->stend = (WORD_ID *)mymalloc(sizeof(WORD_ID) * wchmm->maxwcn);
+#ifdef PASS1_IWCD
+  wchmm->outstyle = (unsigned char *)mymalloc(sizeof(unsigned char) * wchmm->maxwcn);
+#endif
+  wchmm->offset = (int **)mymalloc(sizeof(int *) * winfo->num);
+  wchmm->wordend = (int *)mymalloc(sizeof(int) * winfo->num);
+  wchmm->maxstartnum = wchmm->startnum + 1;
+  wchmm->startnode = (int *)mymalloc(sizeof(int) * wchmm->maxstartnum);
+  if (wchmm->hmminfo->multipath) {
+    wchmm->wordbegin = (int *)mymalloc(sizeof(int) * winfo->num);
+    wchmm->wrk.out_from = (int *)mymalloc(sizeof(int) * winfo->maxwn);
+    wchmm->wrk.out_from_next = (int *)mymalloc(sizeof(int) * winfo->maxwn);
+    wchmm->wrk.out_a = (LOGPROB *)mymalloc(sizeof(LOGPROB) * winfo->maxwn);
+    wchmm->wrk.out_a_next = (LOGPROB *)mymalloc(sizeof(LOGPROB) * winfo->maxwn);
+    wchmm->wrk.out_from_len = winfo->maxwn;
+  } else {
+    wchmm->wordend_a = (LOGPROB *)mymalloc(sizeof(LOGPROB) * winfo->num);
+  }
+
+  ibuf = (int *)mymalloc(sizeof(int) * wchmm->n);
+  ref2 = (int *)mymalloc(sizeof(int) * wchmm->n);
+  ok_p = FALSE;
+
+  /* node states */
+  if (!rdfunc(fp, ibuf, sizeof(int), wchmm->n)) goto end;
+  for(n=0;n<wchmm->n;n++) wchmm->state[n].scid = ibuf[n];
+#ifdef PASS1_IWCD
+  if (!rdfunc(fp, wchmm->outstyle, sizeof(unsigned char), wchmm->n)) goto end;
+#endif
+  if (!rdfunc(fp, ibuf, sizeof(int), wchmm->n)) goto end;
+  if (!rdfunc(fp, ref2, sizeof(int), wchmm->n)) goto end;
+  for(n=0;n<wchmm->n;n++) {
+    x = ibuf[n];
+#ifdef PASS1_IWCD
+    if (x < 0) {
+      wchmm->state[n].out.state = NULL;
+      continue;
+    }
+    switch(wchmm->outstyle[n]) {
+    case AS_STATE:
+      if (x >= t->stnum) goto invalid;
+      wchmm->state[n].out.state = t->st[x];
+      break;
+    case AS_LSET:
+      if (x >= t->cdnum || ref2[n] < 0 || ref2[n] >= t->cd[x]->state_num) goto invalid;
+      wchmm->state[n].out.lset = &(t->cd[x]->stateset[ref2[n]]);
+      break;
+    case AS_RSET:
+      if (x >= t->lgnum) goto invalid;
+      rset = (RC_INFO *)mybmalloc2(sizeof(RC_INFO), &(wchmm->malloc_root));
+      rset->hmm = t->lg[x];
+      rset->state_loc = ref2[n];
+      rset->last_is_lset = FALSE;
+      rset->cache.state = NULL;
+      rset->lastwid_cache = WORD_INVALID;
+      wchmm->state[n].out.rset = rset;
+      break;
+    case AS_LRSET:
+      if (x >= t->lgnum) goto invalid;
+      lrset = (LRC_INFO *)mybmalloc2(sizeof(LRC_INFO), &(wchmm->malloc_root));
+      lrset->hmm = t->lg[x];
+      lrset->state_loc = ref2[n];
+      lrset->last_is_lset = FALSE;
+      lrset->category = 0;
+      lrset->cache.state = NULL;
+      lrset->lastwid_cache = WORD_INVALID;
+      wchmm->state[n].out.lrset = lrset;
+      break;
+    default:
+      goto invalid;
+    }
+#else
+    if (x >= t->stnum) goto invalid;
+    wchmm->state[n].out = (x < 0) ? NULL : t->st[x];
+#endif
+  }
+
+  /* transitions */
+  if (!rdfunc(fp, wchmm->self_a, sizeof(LOGPROB), wchmm->n)) goto end;
+  if (!rdfunc(fp, wchmm->next_a, sizeof(LOGPROB), wchmm->n)) goto end;
+  if (!rdfunc(fp, ibuf, sizeof(int), wchmm->n)) goto end;
+  for(n=0;n<wchmm->n;n++) {
+    wchmm->ac[n] = aclast = NULL;
+    for(i=0;i<ibuf[n];i++) {
+      if (!rdfunc_int(fp, &x)) goto end;
+      if (x <= 0 || x > A_CELL2_ALLOC_STEP) goto invalid;
+      ac = (A_CELL2 *)mybmalloc2(sizeof(A_CELL2), &(wchmm->malloc_root));
+      ac->n = x;
+      ac->next = NULL;
+      if (!rdfunc(fp, ac->arc, sizeof(int), ac->n)) goto end;
+      if (!rdfunc(fp, ac->a, sizeof(LOGPROB), ac->n)) goto end;
+      if (aclast == NULL) {
+	wchmm->ac[n] = ac;
+      } else {
+	aclast->next = ac;
+      }
+      aclast = ac;
+    }
+  }
+  if (!rdfunc(fp, wchmm->stend, sizeof(WORD_ID), wchmm->n)) goto end;
+
+  /* word-indexed data */
+  for(w=0;w<winfo->num;w++) {
+    wchmm->offset[w] = (int *)mybmalloc2(sizeof(int) * winfo->wlen[w], &(wchmm->malloc_root));
+    if (!rdfunc(fp, wchmm->offset[w], sizeof(int), winfo->wlen[w])) goto end;
+  }
+  if (!rdfunc(fp, wchmm->wordend, sizeof(int), winfo->num)) goto end;
+  if (wchmm->hmminfo->multipath) {
+    if (!rdfunc(fp, wchmm->wordbegin, sizeof(int), winfo->num)) goto end;
+  } else {
+    if (!rdfunc(fp, wchmm->wordend_a, sizeof(LOGPROB), winfo->num)) goto end;
+  }
+
+  /* start nodes */
+  if (!rdfunc(fp, wchmm->startnode, sizeof(int), wchmm->startnum)) goto end;
+
+  /* factoring data */
+#ifdef UNIGRAM_FACTORING
+  if (!rdfunc_int(fp, &x)) goto end;
+  if (x) {
+    wchmm->start2isolate = (int *)mymalloc(sizeof(int) * wchmm->startnum);
+    if (!rdfunc(fp, wchmm->start2isolate, sizeof(int), wchmm->startnum)) goto end;
+  }
+  if (!rdfunc_int(fp, &x)) goto end;
+  if (x) {
+    wchmm->scword = (WORD_ID *)mybmalloc2(sizeof(WORD_ID) * wchmm->scnum, &(wchmm->malloc_root));
+    if (!rdfunc(fp, wchmm->scword, sizeof(WORD_ID), wchmm->scnum)) goto end;
+  }
+  if (!rdfunc_int(fp, &x)) goto end;
+  if (x) {
+    wchmm->fscore = (LOGPROB *)mymalloc(sizeof(LOGPROB) * fsnum);
+    if (!rdfunc(fp, wchmm->fscore, sizeof(LOGPROB), fsnum)) goto end;
+  }
+  wchmm->fsnum = fsnum;
+  wchmm->isolatenum = isolatenum;
+#endif
+  if (!rdfunc_int(fp, &x)) goto end;
+  if (x) {
+    wchmm->sclen = (WORD_ID *)mybmalloc2(sizeof(WORD_ID) * wchmm->scnum, &(wchmm->malloc_root));
+    if (!rdfunc(fp, wchmm->sclen, sizeof(WORD_ID), wchmm->scnum)) goto end;
+    wchmm->sclist = (WORD_ID **)mybmalloc2(sizeof(WORD_ID *) * wchmm->scnum, &(wchmm->malloc_root));
+    wchmm->sclist[0] = NULL;
+    for(i=1;i<wchmm->scnum;i++) {
+      wchmm->sclist[i] = (WORD_ID *)mybmalloc2(sizeof(WORD_ID) * wchmm->sclen[i], &(wchmm->malloc_root));
+      if (!rdfunc(fp, wchmm->sclist[i], sizeof(WORD_ID), wchmm->sclen[i])) goto end;
+    }
+  }
+
+  if (!rdfunc_int(fp, &x)) goto end;
+  if (x != WCHMM_CACHE_ENDMARK) goto invalid;
+
+  ok_p = TRUE;
+  goto end;
+
+ invalid:
+  jlog("Error: wchmm_cache: invalid data in lexicon cache\n");
+ end:
+  free(ref2);
+  free(ibuf);
+  return ok_p;
+}
+
+/**
+ * <JA>
+ * @brief  åե뤫ڹ¤ɤ߹.
+ *
+ * ڹ¤ˤ build_wchmm2() Ʊͤ˥ǥ뤬ƺѤߤ
+ * ɬפ. ե뤬¸ߤʤ䡤Ͽ줿
+ * ߤΥǥȰפʤ FALSE ֤. ΤȤڹ¤
+ * ̤ۤξ֤ΤޤޤǤꡤbuild_wchmm2() ǹۤǤ.
+ *
+ * @param wchmm [i/o] ڹ¤
+ * @param lmconf [in] LMѥ᡼
+ * @param filename [in] åե̾
+ *
+ * @return ɤ߹ߤ TRUEǤʤ FALSE ֤.
+ * </JA>
+ * <EN>
+ * @brief  Load tree lexicon from cache file.
+ *
+ * The models should be assigned to the tree lexicon as same as
+ * build_wchmm2().  It returns FALSE when the file does not exist or
+ * the keys in the file does not match the current models.  In that
+ * case the tree lexicon is left unbuilt, and can be built by
+ * build_wchmm2().
+ *
+ * @param wchmm [i/o] tree lexicon
+ * @param lmconf [in] LM configuration
+ * @param filename [in] cache file name
+ *
+ * @return TRUE when successfully loaded, or FALSE if not.
+ * </EN>
+ * @callgraph
+ * @callergraph
+ */
+boolean
+wchmm_cache_load(WCHMM_INFO *wchmm, JCONF_LM *lmconf, char *filename)
+{
+  FILE *fp;
+  WCHMM_CACHE_TABLE t;
+  WCHMM_CACHE_KEY key;
+  char buf[sizeof(WCHMM_CACHE_HEADER)];
+  unsigned int kbuf[5];
+  int ibuf[9];
+  boolean ret;
+
+  if (wchmm->lmtype != LM_PROB || wchmm->category_tree || wchmm->lmvar == LM_NGRAM_USER) {
+    return FALSE;
+  }
+  if (access(filename, R_OK) != 0) {
+    jlog("STAT: lexicon cache %s not found, build lexicon tree\n", filename);
+    return FALSE;
+  }
+  if ((fp = fopen_readfile(filename)) == NULL) {
+    jlog("Warning: wchmm_cache: failed to open %s\n", filename);
+    return FALSE;
+  }
+
+  /* check header */
+  if (!rdfunc(fp, buf, 1, strlen(WCHMM_CACHE_HEADER))
+      || strncmp(buf, WCHMM_CACHE_HEADER, strlen(WCHMM_CACHE_HEADER)) != 0
+      || !rdfunc(fp, kbuf, sizeof(unsigned int), 5)
+      || kbuf[0] != WCHMM_CACHE_VERSION) {
+    jlog("Warning: wchmm_cache: %s is not a lexicon cache of this version\n", filename);
+    fclose_readfile(fp);
+    return FALSE;
+  }
+
+  /* check keys */
+  table_make(wchmm->hmminfo, &t, FALSE);
+  compute_key(wchmm, lmconf, &t, &key);
+  if (kbuf[1] != key.param || kbuf[2] != key.dict || kbuf[3] != key.hmm || kbuf[4] != key.lm) {
+    jlog("STAT: lexicon cache %s does not match current models, build lexicon tree\n", filename);
+    if (kbuf[1] != key.param) jlog("STAT: - build parameters changed\n");
+    if (kbuf[2] != key.dict) jlog("STAT: - dictionary changed\n");
+    if (kbuf[3] != key.hmm) jlog("STAT: - acoustic model changed\n");
+    if (kbuf[4] != key.lm) jlog("STAT: - language model changed\n");
+    table_free(&t);
+    fclose_readfile(fp);
+    return FALSE;
+  }
+
+  /* sizes */
+  if (!rdfunc(fp, ibuf, sizeof(int), 9)
+      || ibuf[0] != wchmm->winfo->num || ibuf[1] <= 0
+      || ibuf[7] != t.lgnum || ibuf[8] != t.cdnum) {
+    jlog("Warning: wchmm_cache: %s: size mismatch, ignored\n", filename);
+    table_free(&t);
+    fclose_readfile(fp);
+    return FALSE;
+  }
+  wchmm->n = ibuf[1];
+  wchmm->startnum = ibuf[2];
+  wchmm->scnum = ibuf[3];
+#ifdef UNIGRAM_FACTORING
+  wchmm->fsnum = ibuf[4];
+  wchmm->isolatenum = ibuf[5];
+#endif
+  wchmm->separated_word_count = ibuf[6];
+
+  /* reset pointers so that rd_abort() can free partly loaded data */
+  wchmm->state = NULL;
+  wchmm->self_a = wchmm->next_a = NULL;
+  wchmm->ac = NULL;
+  wchmm->stend = NULL;
+  wchmm->offset = NULL;
+  wchmm->wordend = NULL;
+  wchmm->startnode = NULL;
+  wchmm->wordbegin = NULL;
+  wchmm->wordend_a = NULL;
+  wchmm->start2wid = NULL;
+#ifdef PASS1_IWCD
+  wchmm->outstyle = NULL;
+#endif
+#ifdef UNIGRAM_FACTORING
+  wchmm->start2isolate = NULL;
+  wchmm->scword = NULL;
+  wchmm->fscore = NULL;
+#endif
+  wchmm->sclist = NULL;
+  wchmm->sclen = NULL;
+
+  /* body */
+  ret = rd_body(fp, wchmm, &t);
+
+  table_free(&t);
+  fclose_readfile(fp);
+
+  if (ret == FALSE) {
+    jlog("Warning: wchmm_cache: failed to load %s, build lexicon tree\n", filename);
+    rd_abort(wchmm);
+    return FALSE;
+  }
+
+  jlog("STAT: lexicon tree loaded from %s: %d nodes\n", filename, wchmm->n);
+  return TRUE;
+}
+
+/* end of file */
@@ -164,28 +164,48 @@ make_phseq(WORD_ID *wseq, short num, boolean **has_sp_ret, int *num_ret, int **e
 
 /** 
  * <JA>
- * ʸΤHMMۤViterbi饤Ȥ¹Ԥ̤Ϥ. 
+ * ʸΤHMMۤViterbi饤Ȥ¹Ԥ̤Ǽ. 
+ * HMM׻ѥꥢȷ̤γǼͿΤǡ
+ * ꥢ̤˻ƤʣåɤƱ˸ƤӽФ. 
  * 
  * @param words [in] ʸ򤢤魯ñ
  * @param wnum [in] @a words Ĺ
  * @param param [in] ħѥ᡼
  * @param per_what [in] ñ졦ǡ֤Τɤñ̤ǥ饤Ȥ뤫
+ * @param beam [in] 饤ȤΥӡ (0.0 ̵)
  * @param align [out] 饤ȷ̤ǼSentence¤
- * @param r [i/o] ǧ󥹥
+ * @param wrk [i/o] HMM׻ѥꥢ
+ * @param arena [i/o] ̤Ǽΰ
+ * @param r [in] ǧ󥹥
+ *
+ * @return 饤Ȥ TRUEǽ֤ãǤ
+ *  FALSE (̤ñ̿ 0 Ȥʤ)
  * </JA>
  * <EN>
- * Build sentence HMM, call viterbi_segment() and output result.
+ * Build sentence HMM, call viterbi_segment_band() and store the result.
+ * Since the HMM work area and the memory area for the result are given
+ * as arguments, this can be called from several threads at once as far
+ * as each has its own work area.
  * 
  * @param words [in] word sequence of the sentence
  * @param wnum [in] number of words in @a words
  * @param param [in] input parameter vector
  * @param per_what [in] specify the alignment unit (word / phoneme / state)
- * @param s [out] Sentence data area to store the alignment result
- * @param r [i/o] recognition process instance
+ * @param beam [in] beam width of the alignment (0.0 to disable)
+ * @param align [out] Sentence data area to store the alignment result
+ * @param wrk [i/o] HMM computation work area
+ * @param arena [i/o] memory area to store the result
+ * @param r [in] recognition process instance
+ *
+ * @return TRUE on success, or FALSE if the final state could not be
+ * reached (the number of units in the result is 0).
  * </EN>
+ *
+ * @callgraph
+ * @callergraph
  */
-static void
-do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAlign *align, RecogProcess *r)
+boolean
+align_word_sequence(WORD_ID *words, short wnum, HTK_Param *param, int per_what, LOGPROB beam, SentenceAlign *align, HMMWork *wrk, BMALLOC_ARENA *arena, RecogProcess *r)
 {
   HMM_Logical **phones;		/* phoneme sequence */
   boolean *has_sp;		/* whether phone can follow short pause */
@@ -212,7 +232,6 @@ do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAli
   /* initialize result storage buffer */
   switch(per_what) {
   case PER_WORD:
-    jlog("ALIGN: === word alignment begin ===\n");
     end_num = wnum;
     phloc = (int *)mymalloc(sizeof(int)*wnum);
     i = 0;
@@ -222,12 +241,10 @@ do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAli
     }
     break;
   case PER_PHONEME:
-    jlog("ALIGN: === phoneme alignment begin ===\n");
     end_num = 0;
     for(w=0;w<wnum;w++) end_num += winfo->wlen[words[w]];
     break;
   case PER_STATE:
-    jlog("ALIGN: === state alignment begin ===\n");
     end_num = 0;
     for(w=0;w<wnum;w++) {
       for (i=0;i<winfo->wlen[words[w]]; i++) {
@@ -274,14 +291,15 @@ do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAli
   }
 
   /* call viterbi segmentation function */
-  allscore = viterbi_segment(shmm, param, r->wchmm->hmmwrk, hmminfo->multipath, end_state, end_num, &id_seq, &end_frame, &end_score, &rlen);
+  allscore = viterbi_segment_band(shmm, param, wrk, hmminfo->multipath, end_state, end_num, beam, &id_seq, &end_frame, &end_score, &rlen);
+  if (allscore <= LOG_ZERO) rlen = 0;
 
   /* store result to s */
   align->num = rlen;
   align->unittype = per_what;
-  align->begin_frame = (int *)mymalloc(sizeof(int) * rlen);
-  align->end_frame   = (int *)mymalloc(sizeof(int) * rlen);
-  align->avgscore    = (LOGPROB *)mymalloc(sizeof(LOGPROB) * rlen);
+  align->begin_frame = (int *)mybarena_malloc(sizeof(int) * rlen, arena);
+  align->end_frame   = (int *)mybarena_malloc(sizeof(int) * rlen, arena);
+  align->avgscore    = (LOGPROB *)mybarena_malloc(sizeof(LOGPROB) * rlen, arena);
   for(i=0;i<rlen;i++) {
     align->begin_frame[i] = (i == 0) ? 0 : end_frame[i-1] + 1;
     align->end_frame[i]   = end_frame[i];
@@ -289,21 +307,21 @@ do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAli
   }
   switch(per_what) {
   case PER_WORD:
-    align->w = (WORD_ID *)mymalloc(sizeof(WORD_ID) * rlen);
+    align->w = (WORD_ID *)mybarena_malloc(sizeof(WORD_ID) * rlen, arena);
     for(i=0;i<rlen;i++) {
       align->w[i] = words[id_seq[i]];
     }
     break;
   case PER_PHONEME:
-    align->ph = (HMM_Logical **)mymalloc(sizeof(HMM_Logical *) * rlen);
+    align->ph = (HMM_Logical **)mybarena_malloc(sizeof(HMM_Logical *) * rlen, arena);
     for(i=0;i<rlen;i++) {
       align->ph[i] = phones[id_seq[i]];
     }
     break;
   case PER_STATE:
-    align->ph = (HMM_Logical **)mymalloc(sizeof(HMM_Logical *) * rlen);
-    align->loc = (short *)mymalloc(sizeof(short) * rlen);
-    if (hmminfo->multipath) align->is_iwsp = (boolean *)mymalloc(sizeof(boolean) * rlen);
+    align->ph = (HMM_Logical **)mybarena_malloc(sizeof(HMM_Logical *) * rlen, arena);
+    align->loc = (short *)mybarena_malloc(sizeof(short) * rlen, arena);
+    if (hmminfo->multipath) align->is_iwsp = (boolean *)mybarena_malloc(sizeof(boolean) * rlen, arena);
     for(i=0;i<rlen;i++) {
       align->ph[i]  = phones[phloc[id_seq[i]]];
       if (hmminfo->multipath) {
@@ -324,11 +342,11 @@ do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAli
   align->allscore = allscore;
 
   free_hmm(shmm);
-  free(id_seq);
+  if (id_seq) free(id_seq);
   free(phones);
   if (has_sp) free(has_sp);
-  free(end_score);
-  free(end_frame);
+  if (end_score) free(end_score);
+  if (end_frame) free(end_frame);
   free(end_state);
 
   switch(per_what) {
@@ -341,7 +359,49 @@ do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAli
     free(phloc);
     free(stloc);
   }
-  
+
+  return (rlen > 0) ? TRUE : FALSE;
+}
+
+/** 
+ * <JA>
+ * ǧ̤Фƥ饤Ȥ¹Ԥ̤Ǽ. 
+ * 
+ * @param words [in] ʸ򤢤魯ñ
+ * @param wnum [in] @a words Ĺ
+ * @param param [in] ħѥ᡼
+ * @param per_what [in] ñ졦ǡ֤Τɤñ̤ǥ饤Ȥ뤫
+ * @param align [out] 饤ȷ̤ǼSentence¤
+ * @param r [i/o] ǧ󥹥
+ * </JA>
+ * <EN>
+ * Do alignment for a recognition result and store the result.
+ * 
+ * @param words [in] word sequence of the sentence
+ * @param wnum [in] number of words in @a words
+ * @param param [in] input parameter vector
+ * @param per_what [in] specify the alignment unit (word / phoneme / state)
+ * @param align [out] Sentence data area to store the alignment result
+ * @param r [i/o] recognition process instance
+ * </EN>
+ */
+static void
+do_align(WORD_ID *words, short wnum, HTK_Param *param, int per_what, SentenceAlign *align, RecogProcess *r)
+{
+  switch(per_what) {
+  case PER_WORD:
+    jlog("ALIGN: === word alignment begin ===\n");
+    break;
+  case PER_PHONEME:
+    jlog("ALIGN: === phoneme alignment begin ===\n");
+    break;
+  case PER_STATE:
+    jlog("ALIGN: === state alignment begin ===\n");
+    break;
+  }
+  if (align_word_sequence(words, wnum, param, per_what, 0.0, align, r->wchmm->hmmwrk, &(r->arena), r) == FALSE) {
+    jlog("WARNING: alignment failed: final state not reached\n");
+  }
 }
 
 /** 
@@ -554,21 +614,21 @@ do_alignment_all(RecogProcess *r, HTK_Param *param)
     s = &(r->result.sent[n]);
     /* do forced alignment if needed */
     if (r->config->annotate.align_result_word_flag) {
-      now = result_align_new();
+      now = result_align_malloc(r);
       word_align(s->word, s->word_num, param, now, r);
       if (s->align == NULL) s->align = now;
       else prev->next = now;
       prev = now;
     }
     if (r->config->annotate.align_result_phoneme_flag) {
-      now = result_align_new();
+      now = result_align_malloc(r);
       phoneme_align(s->word, s->word_num, param, now, r);
       if (s->align == NULL) s->align = now;
       else prev->next = now;
       prev = now;
     }
     if (r->config->annotate.align_result_state_flag) {
-      now = result_align_new();
+      now = result_align_malloc(r);
       state_align(s->word, s->word_num, param, now, r);
       if (s->align == NULL) s->align = now;
       else prev->next = now;
@@ -108,6 +108,7 @@ HMM *new_make_word_hmm_with_lm(HTK_HMM_INFO *, HMM_Logical  **, int, boolean *,
 void free_hmm(HMM *);
 /* vsegment.c */
 LOGPROB viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int *endstates, int ulen, int **id_ret, int **seg_ret, LOGPROB **uscore_ret, int *retlen);
+LOGPROB viterbi_segment_band(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int *endstates, int ulen, LOGPROB beam, int **id_ret, int **seg_ret, LOGPROB **uscore_ret, int *retlen);
 
 /* hmminfo/outprob.c */
 LOGPROB outprob(HMMWork *wrk, int t, HMM_STATE *hmmstate, HTK_Param *param);
@@ -108,6 +108,18 @@ typedef struct {
 /// A header qualifier string for V2: has mixture pdf macro def
 #define BINHMM_HEADER_V2_MPDFMACRO 'M'
 
+/// A header qualifier string for V2: vectors are stored in a memory-mappable image
+#define BINHMM_HEADER_V2_IMAGE 'I'
+
+/// Alignment of the top of the vector image in binary HMM file in bytes
+#define BINHMM_IMAGE_PAGE 4096
+
+/// Alignment of each vector in the vector image in bytes
+#define BINHMM_IMAGE_ALIGN 16
+
+/// Magic number at the top of the vector image to detect its byte order
+#define BINHMM_IMAGE_MAGIC 0x4a42494d
+
 /// Maximum number of input stream
 #define MAXSTREAMNUM 50
 
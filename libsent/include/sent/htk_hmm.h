@@ -406,6 +406,8 @@ typedef struct {
   BMALLOC_BASE *mroot;		///< Pointer for block memory allocation
   BMALLOC_BASE *lroot;		///< Pointer for block memory allocation for logical HMM
   BMALLOC_BASE *cdset_root;		///< Pointer for block memory allocation for logical HMM
+  void *mmap_base;		///< Top of the vector image when memory-mapped from binhmm, NULL if not mapped
+  size_t mmap_len;		///< Length of the mapped image in bytes
 
   int *tmp_mixnum;		///< Work area for state reading
 
@@ -535,7 +537,9 @@ int param_check_and_adjust(HTK_HMM_INFO *hmm, HTK_Param *pinfo, boolean vflag);
 
 /* binary format */
 boolean write_binhmm(FILE *fp, HTK_HMM_INFO *hmm, Value *para);
+boolean write_binhmm_image(FILE *fp, HTK_HMM_INFO *hmm, Value *para);
 boolean read_binhmm(FILE *fp, HTK_HMM_INFO *hmm, boolean gzfile_p, Value *para);
+boolean read_binhmm_file(char *filename, HTK_HMM_INFO *hmm, Value *para);
 
 #ifdef __cplusplus
 }
@@ -152,8 +152,25 @@ typedef struct {
   NNID_UPPER *nnid2ctid_upper;	///< Index to map tuple ID of this m-gram to valid context id (upper 8bit)
   NNID_LOWER *nnid2ctid_lower;	///< Index to map tuple ID of this m-gram to valid context id (upper 16bit)
 
+  boolean packed;		///< TRUE if quantized and bit-packed (v7 bingram), in which case @a bgn, @a num, @a nnid2wid, @a prob and @a bo_wt are not used
+  int bgn_bits;			///< Bit width of an entry in @a bgn_pk
+  int num_bits;			///< Bit width of an entry in @a num_pk
+  int wid_bits;			///< Bit width of an entry in @a wid_pk
+  unsigned int *bgn_pk;		///< Bit-packed @a bgn, 0 when the context has no tuple
+  unsigned int *num_pk;		///< Bit-packed @a num
+  unsigned int *wid_pk;		///< Bit-packed @a nnid2wid
+  LOGPROB *prob_cb;		///< Codebook of quantized @a prob (NGRAM_QUANT_CBSIZE entries)
+  unsigned char *prob_q;	///< Codebook index of each probability
+  LOGPROB *bo_wt_cb;		///< Codebook of quantized @a bo_wt (NGRAM_QUANT_CBSIZE entries)
+  unsigned char *bo_wt_q;	///< Codebook index of each back-off weight
+
 } NGRAM_TUPLE_INFO;
 
+/// Number of codebook entries for quantized N-gram (8bit)
+#define NGRAM_QUANT_CBSIZE 256
+/// Number of 32bit words to hold @a N entries of @a B bits, with one word for margin
+#define NGRAM_PACK_WORDS(N,B) (((size_t)(N) * (B) + 31) / 32 + 1)
+
 /**
  * @brief Main N-gram structure
  *
@@ -168,6 +185,7 @@ typedef struct __ngram_info__ {
   boolean from_bin;		///< TRUE if source was bingram, otherwise ARPA
   boolean bigram_index_reversed;		///< TRUE if read from old (<=3.5.3) bingram, in which case the 2-gram tuple index is reversed (DIR_LR) against the RL 3-gram.
   boolean bos_eos_swap;		///< TRUE if swap BOS and SOS on backward N-gram
+  int read_thread_num;		///< Number of threads to parse ARPA N-gram file (1 = no thread)
   WORD_ID max_word_num;		///< N-gram vocabulary size
   char **wname;			///< List of word strings.
   PATNODE *root;		///< Root of index tree to search n-gram word ID from its name
@@ -185,6 +203,9 @@ typedef struct __ngram_info__ {
 
   BMALLOC_BASE *mroot;		///< Pointer for block memory allocation for lookup index
 
+  void *mmap_base;		///< Top of the file image when memory-mapped from v6 bingram, NULL if not mapped
+  size_t mmap_len;		///< Length of the mapped image in bytes
+
 } NGRAM_INFO;
 
 
@@ -196,6 +217,12 @@ typedef struct __ngram_info__ {
 #define BINGRAM_IDSTR_V4 "julius_bingram_v4"
 /// Header string to identify version of bingram (v5: >= rev.4.0)
 #define BINGRAM_IDSTR_V5 "julius_bingram_v5"
+/// Header string to identify version of bingram (v6: v5 with aligned sections for memory mapping)
+#define BINGRAM_IDSTR_V6 "julius_bingram_v6"
+/// Header string to identify version of bingram (v7: v6 with quantized and bit-packed 2-gram and above)
+#define BINGRAM_IDSTR_V7 "julius_bingram_v7"
+/// Alignment of each array section in v6 bingram in bytes
+#define BINGRAM_ALIGN_V6 4096
 /// Bingram header size in bytes
 #define BINGRAM_HDSIZE 512
 /// Bingram header info string to identify the unit byte (head)
@@ -233,6 +260,10 @@ void bi_prob_func_set(NGRAM_INFO *ndata);
 boolean ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition);
 boolean ngram_read_bin(FILE *fp, NGRAM_INFO *ndata);
 boolean ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *header_str);
+boolean ngram_write_bin_mmap(FILE *fp, NGRAM_INFO *ndata, char *header_str);
+boolean ngram_write_bin_quant(FILE *fp, NGRAM_INFO *ndata, char *header_str);
+int ngram_mmap_bin(char *filename, NGRAM_INFO *ndata);
+boolean ngram_quantize(NGRAM_INFO *ndata);
 
 boolean ngram_compact_context(NGRAM_INFO *ndata, int n);
 
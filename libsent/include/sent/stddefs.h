@@ -53,6 +53,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 #if !defined(_WIN32) || defined(__CYGWIN32__) || defined(__MINGW32__)
 /* unixen */
 #ifdef HAVE_UNISTD_H
@@ -57,6 +57,15 @@ typedef struct _bmalloc_base {
   struct _bmalloc_base *next;	///< Link to next data, NULL if no more
 } BMALLOC_BASE;
 
+/// Resettable memory arena for mybarena_malloc()
+typedef struct _bmalloc_arena {
+  BMALLOC_BASE *root;		///< Blocks in use, current block first
+  BMALLOC_BASE *spare;		///< Blocks released by reset, kept for reuse
+  size_t used;			///< Bytes allocated since last reset
+  size_t peak;			///< Maximum of @a used ever reached
+  size_t total;			///< Bytes of all blocks held in the arena
+} BMALLOC_ARENA;
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -82,6 +91,10 @@ int myfrewind(FILE *fp);
 void *mybmalloc2(unsigned int size, BMALLOC_BASE **list);
 char *mybstrdup2(char *, BMALLOC_BASE **list);
 void mybfree2(BMALLOC_BASE **list);
+void mybarena_init(BMALLOC_ARENA *a);
+void *mybarena_malloc(unsigned int size, BMALLOC_ARENA *a);
+void mybarena_reset(BMALLOC_ARENA *a);
+void mybarena_free(BMALLOC_ARENA *a);
 
 /* mymalloc.c */
 void *mymalloc(size_t size);
@@ -49,6 +49,19 @@
 /// Memory allocation step in number of words when loading a word dictionary
 #define	MAXWSTEP 4000
 
+/// Header string to detect binary word dictionary
+#define BINDICT_HEADER "JBINDICT\n"
+/// Format version of binary word dictionary
+#define BINDICT_VERSION 1
+/// Flag in binary word dictionary: phone sequences are stored
+#define BINDICT_HAS_PHONE 0x01
+/// Flag in binary word dictionary: phones are converted to word-internal triphones
+#define BINDICT_TRIPHONE 0x02
+/// Flag in binary word dictionary: in-class word probabilities are stored
+#define BINDICT_HAS_CPROB 0x04
+/// Flag in binary word dictionary: word weights for MBR are stored
+#define BINDICT_HAS_WEIGHT 0x08
+
 /// Word dictionary structure to hold vocabulary
 typedef struct {
   WORD_ID	maxnum;		///< Allocated number of word space
@@ -79,6 +92,10 @@ typedef struct {
 #ifdef USE_MBR
   float *weight; ///< Word weight (use minimization WWER on MBR)
 #endif
+  WORD_ID	*hashtop;	///< Top word of each hash bucket of word name lookup index [hashsize], built by voca_lookup_wid()
+  WORD_ID	*hashnext;	///< Next word in the same hash bucket [wid]
+  int		hashsize;	///< Number of hash buckets (power of 2), 0 if index not built yet
+  WORD_ID	hashnum;	///< Number of words registered in the lookup index
   APATNODE	*errph_root; ///< Root node of index tree for gathering error %HMM name appeared when reading the dictionary 
   BMALLOC_BASE *mroot;		///< Pointer for block memory allocation
   void		*work;		///< Work buffer for dictionary reading
@@ -110,7 +127,10 @@ boolean voca_load_wordlist(FILE *fp, WORD_INFO *winfo, HTK_HMM_INFO *hmminfo, ch
 boolean voca_load_wordlist_fp(FILE *fp, WORD_INFO *winfo, HTK_HMM_INFO *hmminfo, char *headphone, char *tailphone, char *contextphone);
 boolean voca_load_wordlist_line(char *buf, WORD_ID *vnum, int linenum, WORD_INFO *winfo, HTK_HMM_INFO *hmminfo, boolean do_conv, boolean *ok_flag, char *headphone, char *tailphone, char *contextphone);
 boolean voca_mono2tri(WORD_INFO *winfo, HTK_HMM_INFO *hmminfo);
+boolean voca_load_binary(FILE *fp, WORD_INFO *winfo, HTK_HMM_INFO *hmminfo, boolean ignore_tri_conv);
+boolean voca_save_binary(FILE *fp, WORD_INFO *winfo);
 WORD_ID voca_lookup_wid(char *, WORD_INFO *);
+void voca_hash_free(WORD_INFO *winfo);
 WORD_ID *new_str2wordseq(WORD_INFO *, char *, int *);
 char *cycle_triphone(char *p);
 char *cycle_triphone_flush();
@@ -73,7 +73,7 @@ void
 add_left_context(char name[], char *lc)
 {
   char *p;
-  static char buf[MAX_HMMNAME_LEN];
+  char buf[MAX_HMMNAME_LEN];
 
   if ((p = strchr(name, HMM_LC_DLIM_C)) != NULL) {
     p++;
@@ -86,7 +86,6 @@ add_left_context(char name[], char *lc)
   strcpy(name, buf);
 }
 
-static char gbuf[MAX_HMMNAME_LEN]; ///< Work area for get_{right|left}_context_HMM
 
 /**
  *
@@ -106,6 +105,8 @@ static char gbuf[MAX_HMMNAME_LEN]; ///< Work area for get_{right|left}_context_H
 HMM_Logical *
 get_right_context_HMM(HMM_Logical *base, char *rc_name, HTK_HMM_INFO *hmminfo)
 {
+  char gbuf[MAX_HMMNAME_LEN];	/* local for reentrancy */
+
   strcpy(gbuf, base->name);
   add_right_context(gbuf, rc_name);
   return(htk_hmmdata_lookup_logical(hmminfo, gbuf));
@@ -128,6 +129,8 @@ get_right_context_HMM(HMM_Logical *base, char *rc_name, HTK_HMM_INFO *hmminfo)
 HMM_Logical *
 get_left_context_HMM(HMM_Logical *base, char *lc_name, HTK_HMM_INFO *hmminfo)
 {
+  char gbuf[MAX_HMMNAME_LEN];	/* local for reentrancy */
+
   strcpy(gbuf, base->name);
   add_left_context(gbuf, lc_name);
   return(htk_hmmdata_lookup_logical(hmminfo, gbuf));
@@ -24,6 +24,10 @@
 
 #include <sent/stddefs.h>
 #include <sent/htk_hmm.h>
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/mman.h>
+#endif
 
 /** 
  * Allocate memory for a new %HMM definition data.
@@ -78,6 +82,8 @@ hmminfo_new()
   new->basephone.root = NULL;
   new->cdset_info.cdtree = NULL;
   new->variance_inversed = FALSE;
+  new->mmap_base = NULL;
+  new->mmap_len = 0;
 
 #ifdef ENABLE_MSD
   new->has_msd = FALSE;
@@ -108,6 +114,11 @@ hmminfo_free(HTK_HMM_INFO *hmm)
   if (hmm->mroot != NULL) mybfree2(&(hmm->mroot));
   if (hmm->lroot != NULL) mybfree2(&(hmm->lroot));
 
+#ifdef HAVE_MMAP
+  /* unmap vector image mapped from binhmm */
+  if (hmm->mmap_base != NULL) munmap(hmm->mmap_base, hmm->mmap_len);
+#endif
+
   /* free whole */
   free(hmm);
 
@@ -149,17 +160,9 @@ init_hmminfo(HTK_HMM_INFO *hmminfo, char *hmmfilename, char *namemapfile, Value
   }
   if (ok_p == FALSE) {
     /* second, try binary format */
-    if ((fp = fopen_readfile(hmmfilename)) == NULL) {
-      jlog("Error: init_phmm: failed to open %s\n",hmmfilename);
-      return FALSE;
-    }
-    if (read_binhmm(fp, hmminfo, TRUE, para) == TRUE) {
+    if (read_binhmm_file(hmmfilename, hmminfo, para) == TRUE) {
       ok_p = TRUE;
     }
-    if (fclose_readfile(fp) < 0) {
-      jlog("Error: init_phmm: failed to close %s\n", hmmfilename);
-      return FALSE;
-    }
   }
   if (ok_p == FALSE) {
     jlog("Error: init_phmm: failed to read %s\n", hmmfilename);
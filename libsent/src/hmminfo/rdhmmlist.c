@@ -68,7 +68,7 @@
 boolean
 rdhmmlist(FILE *fp, HTK_HMM_INFO *hmminfo)
 {
-  char *buf, *lname, *pname;
+  char *buf, *lname, *pname, *p;
   HMM_Logical *new, *match;
   HTK_HMM_Data *mapped;
   boolean ok_flag = TRUE;
@@ -80,16 +80,26 @@ rdhmmlist(FILE *fp, HTK_HMM_INFO *hmminfo)
   n = 0;
   while (getl(buf, MAXLINEINHMMLIST, fp) != NULL) {
     n++;
-    if ((lname = strtok(buf, DELM)) == NULL) {
+    /* split into names without strtok(), since this may run while
+       N-gram is being read in another thread (-parallelload) */
+    lname = buf + strspn(buf, DELM);
+    if (*lname == '\0') {
       jlog("Error: rdhmmlist: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
+    p = lname + strcspn(lname, DELM);
+    if (*p != '\0') *(p++) = '\0';
     if (strlen(lname) >= MAX_HMMNAME_LEN) {
       jlog("Error: rdhmmlist: %d: name too long: \"%s\"\n", n, lname);
       jlog("Error: rdhmmlist: try increase value of MAX_HMMNAME_LEN\n");
       return FALSE;
     }
-    pname = strtok(NULL, DELM);
+    pname = p + strspn(p, DELM);
+    if (*pname == '\0') {
+      pname = NULL;
+    } else {
+      pname[strcspn(pname, DELM)] = '\0';
+    }
     if (pname == NULL) {
       /* 1 column */
       mapped = htk_hmmdata_lookup_physical(hmminfo, lname);
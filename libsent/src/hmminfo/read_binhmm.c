@@ -8,6 +8,13 @@
  * HTKΥ %HMM ե뤫ХʥؤѴϡ
  * °Υġ mkbinhmm ǹԤʤޤΥХʥϡHTK 
  * ХʥȤߴǤΤդƲ
+ *
+ * إå˽ 'I' ĥեǤϡʿѡʬܹʤɤ
+ * ٥ȥϥեΥڡ·줿᡼ˤޤȤ
+ * Ǽ졤ϥ᡼ΥեåȤǻȤ롥
+ * read_binhmm_file() ɤ߹硤Υ᡼ϥե뤫ľ
+ * ɤ߹Ѥǥ˥ޥåפ졤ʣΥץ֤Ƕͭ롥
+ * ̤ƤХȥۤʤ̾ɤɤ߹ࡥ
  * </JA>
  * 
  * <EN>
@@ -17,6 +24,14 @@
  * The tool "mkbinhmm" can convert the ascii format HTK %HMM definition
  * file to this format.  Please note that this binary format is 
  * not compatible with the HTK binary format.
+ *
+ * When the header has qualifier 'I', the vectors (means, variances,
+ * transition matrices and stream weights) are stored together in a
+ * page-aligned image at the end of the file, and each definition refers
+ * to them by offset.  When read by read_binhmm_file(), the image is
+ * mapped read-only from the file directly, so it can be shared among
+ * processes.  Compressed files or images in other byte order are read
+ * as usual.
  * </EN>
  * 
  * @author Akinobu LEE
@@ -34,10 +49,20 @@
 #include <sent/stddefs.h>
 #include <sent/htk_param.h>
 #include <sent/htk_hmm.h>
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #undef DMES			/* define to enable debug message */
 
 static boolean gzfile;	      ///< TRUE when opened by fopen_readfile
+static size_t rdcount;	      ///< Number of bytes read from the top of the file
+static boolean image_mode;    ///< TRUE if vectors are stored in the image
+static char *image_file = NULL; ///< File name to map the image from, or NULL
 
 #define rdn(A,B,C,D) if (rdnfunc(A,B,C,D) == FALSE) return FALSE
 #define rdn_str(A,B,C) if ((C = rdn_strfunc(A,B)) == NULL) return FALSE
@@ -66,6 +91,7 @@ rdnfunc(FILE *fp, void *buf, size_t unitbyte, int unitnum)
     jlog("Error: read_binhmm: failed to read %d bytes\n", unitbyte * unitnum);
     return FALSE;
   }
+  rdcount += unitbyte * unitnum;
 #ifndef WORDS_BIGENDIAN
   if (unitbyte != 1) {
     swap_bytes(buf, unitbyte, unitnum);
@@ -102,6 +128,7 @@ rdn_strfunc(FILE *fp, HTK_HMM_INFO *hmm)
     if (c == '\0') break;
   }
   if (len == 0) return NULL;
+  rdcount += len;
   if (len == 1) {
     p = &nostr;
   } else {
@@ -220,6 +247,10 @@ rd_header(FILE *fp, HTK_HMM_INFO *hmm, Value *para, boolean *mpdf_macro_ret)
 	  *mpdf_macro_ret = TRUE;
 	  jlog("Stat: binhmm-header: mixture PDF macro used\n");
 	  break;
+	case BINHMM_HEADER_V2_IMAGE:
+	  image_mode = TRUE;
+	  jlog("Stat: binhmm-header: vectors stored in image\n");
+	  break;
 	default:
 	  jlog("Error: unknown format qualifier in header: \"%c\"\n", *q);
 	  return FALSE;
@@ -288,6 +319,7 @@ rd_type(FILE *fp, HTK_HMM_INFO *hmm)
 /* read transition data */
 static HTK_HMM_Trans **tr_index; ///< Map transition matrix id to its pointer
 static unsigned int tr_num;	///< Length of above
+static unsigned int *tr_off;	///< Offsets of the matrices in the image
 
 /** 
  * @brief  Read a sequence of transition matrix data for @a tr_num.
@@ -310,6 +342,7 @@ rd_trans(FILE *fp, HTK_HMM_INFO *hmm)
 
   rdn(fp, &tr_num, sizeof(unsigned int), 1);
   tr_index = (HTK_HMM_Trans **)mymalloc(sizeof(HTK_HMM_Trans *) * tr_num);
+  if (image_mode) tr_off = (unsigned int *)mymalloc(sizeof(unsigned int) * tr_num);
 
   hmm->trstart = NULL;
   hmm->tr_root = NULL;
@@ -319,10 +352,15 @@ rd_trans(FILE *fp, HTK_HMM_INFO *hmm)
     t->name = (*p == '\0') ? NULL : p;
     rdn(fp, &(t->statenum), sizeof(short), 1);
     t->a = (PROB **)mybmalloc2(sizeof(PROB *) * t->statenum, &(hmm->mroot));
-    atmp = (PROB *)mybmalloc2(sizeof(PROB) * t->statenum * t->statenum, &(hmm->mroot));
-    for (i=0;i<t->statenum;i++) {
-      t->a[i] = &(atmp[i*t->statenum]);
-      rdn(fp, t->a[i], sizeof(PROB), t->statenum);
+    if (image_mode) {
+      /* matrix is in the image, will be set by rd_image() */
+      rdn(fp, &(tr_off[idx]), sizeof(unsigned int), 1);
+    } else {
+      atmp = (PROB *)mybmalloc2(sizeof(PROB) * t->statenum * t->statenum, &(hmm->mroot));
+      for (i=0;i<t->statenum;i++) {
+	t->a[i] = &(atmp[i*t->statenum]);
+	rdn(fp, t->a[i], sizeof(PROB), t->statenum);
+      }
     }
     trans_add(hmm, t);
     tr_index[idx] = t;
@@ -337,6 +375,7 @@ rd_trans(FILE *fp, HTK_HMM_INFO *hmm)
 
 static HTK_HMM_Var **vr_index;	///< Map variance id to its pointer
 static unsigned int vr_num;	///< Length of above
+static unsigned int *vr_off;	///< Offsets of the variance vectors in the image
 
 /** 
  * @brief  Read a sequence of variance vector for @a vr_num.
@@ -357,6 +396,7 @@ rd_var(FILE *fp, HTK_HMM_INFO *hmm)
 
   rdn(fp, &vr_num, sizeof(unsigned int), 1);
   vr_index = (HTK_HMM_Var **)mymalloc(sizeof(HTK_HMM_Var *) * vr_num);
+  if (image_mode) vr_off = (unsigned int *)mymalloc(sizeof(unsigned int) * vr_num);
   
   hmm->vrstart = NULL;
   hmm->vr_root = NULL;
@@ -365,8 +405,12 @@ rd_var(FILE *fp, HTK_HMM_INFO *hmm)
     rdn_str(fp, hmm, p);
     v->name = (*p == '\0') ? NULL : p;
     rdn(fp, &(v->len), sizeof(short), 1);
-    v->vec = (VECT *)mybmalloc2(sizeof(VECT) * v->len, &(hmm->mroot));
-    rdn(fp, v->vec, sizeof(VECT), v->len);
+    if (image_mode) {
+      rdn(fp, &(vr_off[idx]), sizeof(unsigned int), 1);
+    } else {
+      v->vec = (VECT *)mybmalloc2(sizeof(VECT) * v->len, &(hmm->mroot));
+      rdn(fp, v->vec, sizeof(VECT), v->len);
+    }
     vr_index[idx] = v;
     var_add(hmm, v);
   }
@@ -380,6 +424,7 @@ rd_var(FILE *fp, HTK_HMM_INFO *hmm)
 /* read density data */
 static HTK_HMM_Dens **dens_index; ///< Map density id to its pointer
 static unsigned int dens_num;	///< Length of above
+static unsigned int *dens_off;	///< Offsets of the mean vectors in the image
 
 /** 
  * @brief  Read a sequence of mixture densities for @a dens_num.
@@ -403,6 +448,7 @@ rd_dens(FILE *fp, HTK_HMM_INFO *hmm)
   rdn(fp, &dens_num, sizeof(unsigned int), 1);
   hmm->totalmixnum = dens_num;
   dens_index = (HTK_HMM_Dens **)mymalloc(sizeof(HTK_HMM_Dens *) * dens_num);
+  if (image_mode) dens_off = (unsigned int *)mymalloc(sizeof(unsigned int) * dens_num);
 
   hmm->dnstart = NULL;
   hmm->dn_root = NULL;
@@ -411,8 +457,12 @@ rd_dens(FILE *fp, HTK_HMM_INFO *hmm)
     rdn_str(fp, hmm, p);
     d->name = (*p == '\0') ? NULL : p;
     rdn(fp, &(d->meanlen), sizeof(short), 1);
-    d->mean = (VECT *)mybmalloc2(sizeof(VECT) * d->meanlen, &(hmm->mroot));
-    rdn(fp, d->mean, sizeof(VECT), d->meanlen);
+    if (image_mode) {
+      rdn(fp, &(dens_off[idx]), sizeof(unsigned int), 1);
+    } else {
+      d->mean = (VECT *)mybmalloc2(sizeof(VECT) * d->meanlen, &(hmm->mroot));
+      rdn(fp, d->mean, sizeof(VECT), d->meanlen);
+    }
     rdn(fp, &vid, sizeof(unsigned int), 1);
     d->var = vr_index[vid];
     rdn(fp, &(d->gconst), sizeof(LOGPROB), 1);
@@ -429,6 +479,7 @@ rd_dens(FILE *fp, HTK_HMM_INFO *hmm)
 /* read stream weight data */
 static HTK_HMM_StreamWeight **streamweight_index; ///< Map stream weights id to its pointer
 static unsigned int streamweight_num;	///< Length of above
+static unsigned int *streamweight_off;	///< Offsets of the weights in the image
 
 /** 
  * @brief  Read a sequence of stream weights for @a streamweight_num.
@@ -450,6 +501,7 @@ rd_streamweight(FILE *fp, HTK_HMM_INFO *hmm)
 
   rdn(fp, &streamweight_num, sizeof(unsigned int), 1);
   streamweight_index = (HTK_HMM_StreamWeight **)mymalloc(sizeof(HTK_HMM_StreamWeight *) * streamweight_num);
+  if (image_mode) streamweight_off = (unsigned int *)mymalloc(sizeof(unsigned int) * streamweight_num);
 
   hmm->swstart = NULL;
   hmm->sw_root = NULL;
@@ -458,8 +510,12 @@ rd_streamweight(FILE *fp, HTK_HMM_INFO *hmm)
     rdn_str(fp, hmm, p);
     sw->name = (*p == '\0') ? NULL : p;
     rdn(fp, &(sw->len), sizeof(short), 1);
-    sw->weight = (VECT *)mybmalloc2(sizeof(VECT) * sw->len, &(hmm->mroot));
-    rdn(fp, sw->weight, sizeof(VECT), sw->len);
+    if (image_mode) {
+      rdn(fp, &(streamweight_off[idx]), sizeof(unsigned int), 1);
+    } else {
+      sw->weight = (VECT *)mybmalloc2(sizeof(VECT) * sw->len, &(hmm->mroot));
+      rdn(fp, sw->weight, sizeof(VECT), sw->len);
+    }
     streamweight_index[idx] = sw;
     sw_add(hmm, sw);
   }
@@ -743,6 +799,141 @@ rd_data(FILE *fp, HTK_HMM_INFO *hmm)
 
 
 
+#ifdef HAVE_MMAP
+/** 
+ * Map the vector image from the file directly.  The image is mapped
+ * read-only, and the mapping is kept in @a hmm to be released by
+ * hmminfo_free().
+ * 
+ * @param filename [in] file name
+ * @param offset [in] byte offset of the image from the top of the file
+ * @param len [in] length of the image in bytes
+ * @param hmm [i/o] %HMM definition structure
+ * 
+ * @return pointer to the top of the image, or NULL if it cannot be mapped.
+ */
+static char *
+map_image(char *filename, unsigned int offset, unsigned int len, HTK_HMM_INFO *hmm)
+{
+  int fd;
+  struct stat st;
+  size_t top;
+  char *p;
+
+  if ((fd = open(filename, O_RDONLY)) < 0) return NULL;
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < (size_t)offset + len) {
+    /* compressed file */
+    close(fd);
+    return NULL;
+  }
+  /* mapping should begin at page boundary */
+  top = offset / getpagesize() * getpagesize();
+  p = mmap(NULL, offset + len - top, PROT_READ, MAP_PRIVATE, fd, top);
+  close(fd);
+  if (p == MAP_FAILED) {
+    jlog("Warning: read_binhmm: failed to map \"%s\", read it instead\n", filename);
+    return NULL;
+  }
+  if (*((unsigned int *)(p + offset - top)) != BINHMM_IMAGE_MAGIC) {
+    /* compressed file or in other byte order */
+    munmap(p, offset + len - top);
+    return NULL;
+  }
+  hmm->mmap_base = p;
+  hmm->mmap_len = offset + len - top;
+  jlog("Stat: read_binhmm: mapped %u bytes of vector image from \"%s\"\n", len, filename);
+
+  return(p + offset - top);
+}
+#endif /* HAVE_MMAP */
+
+/** 
+ * @brief  Read the vector image and set the vector pointers to it.
+ *
+ * The image is mapped from the file if possible, or read into memory.
+ * It is mapped only when variances are already inversed, since the
+ * mapped image should not be modified.
+ * 
+ * @param fp [in] file pointer
+ * @param hmm [i/o] %HMM definition structure
+ */
+static boolean
+rd_image(FILE *fp, HTK_HMM_INFO *hmm)
+{
+  unsigned int offset, len;
+  unsigned int idx, size;
+  char *base;
+  size_t n;
+  int i;
+
+  rdn(fp, &offset, sizeof(unsigned int), 1);
+  rdn(fp, &len, sizeof(unsigned int), 1);
+  if (offset < rdcount || len < sizeof(unsigned int)) {
+    jlog("Error: read_binhmm: wrong image location: offset=%u, len=%u\n", offset, len);
+    return FALSE;
+  }
+
+  base = NULL;
+#ifdef HAVE_MMAP
+  if (image_file != NULL && hmm->variance_inversed) {
+    base = map_image(image_file, offset, len, hmm);
+  }
+#endif
+  if (base == NULL) {
+    /* skip padding and read the image */
+    while (rdcount < offset) {
+      n = offset - rdcount;
+      if (n > MAXLINELEN) n = MAXLINELEN;
+      rdn(fp, buf, 1, n);
+    }
+    base = (char *)mybmalloc2(len, &(hmm->mroot));
+    rdn(fp, base, 1, len);
+    if (*((unsigned int *)base) != BINHMM_IMAGE_MAGIC) {
+      /* vectors are all 4 bytes */
+      swap_bytes(base, sizeof(VECT), len / sizeof(VECT));
+      if (*((unsigned int *)base) != BINHMM_IMAGE_MAGIC) {
+	jlog("Error: read_binhmm: wrong magic number in image\n");
+	return FALSE;
+      }
+    }
+  }
+
+  /* set pointers */
+  for (idx = 0; idx < tr_num; idx++) {
+    size = sizeof(PROB) * tr_index[idx]->statenum * tr_index[idx]->statenum;
+    if (tr_off[idx] + size > len) goto image_err;
+    for (i=0;i<tr_index[idx]->statenum;i++) {
+      tr_index[idx]->a[i] = (PROB *)(base + tr_off[idx]) + i * tr_index[idx]->statenum;
+    }
+  }
+  for (idx = 0; idx < vr_num; idx++) {
+    size = sizeof(VECT) * vr_index[idx]->len;
+    if (vr_off[idx] + size > len) goto image_err;
+    vr_index[idx]->vec = (VECT *)(base + vr_off[idx]);
+  }
+  for (idx = 0; idx < dens_num; idx++) {
+    size = sizeof(VECT) * dens_index[idx]->meanlen;
+    if (dens_off[idx] + size > len) goto image_err;
+    dens_index[idx]->mean = (VECT *)(base + dens_off[idx]);
+  }
+  if (hmm->opt.stream_info.num > 1) {
+    for (idx = 0; idx < streamweight_num; idx++) {
+      size = sizeof(VECT) * streamweight_index[idx]->len;
+      if (streamweight_off[idx] + size > len) goto image_err;
+      streamweight_index[idx]->weight = (VECT *)(base + streamweight_off[idx]);
+    }
+  }
+
+#ifdef DMES
+  jlog("Stat: read_binhmm: %u bytes of vector image read\n", len);
+#endif
+  return TRUE;
+
+ image_err:
+  jlog("Error: read_binhmm: vector offset exceeds the image\n");
+  return FALSE;
+}
+
 /** 
  * Top function to read a binary %HMM file from @a fp.
  * 
@@ -759,6 +950,8 @@ read_binhmm(FILE *fp, HTK_HMM_INFO *hmm, boolean gzfile_p, Value *para)
   boolean mpdf_macro = FALSE;
 
   gzfile = gzfile_p;
+  rdcount = 0;
+  image_mode = FALSE;
 
   /* read header */
   if (rd_header(fp, hmm, para, &mpdf_macro) == FALSE) {
@@ -833,6 +1026,18 @@ read_binhmm(FILE *fp, HTK_HMM_INFO *hmm, boolean gzfile_p, Value *para)
     return FALSE;
   }
 
+  /* read vector image */
+  if (image_mode) {
+    if (rd_image(fp, hmm) == FALSE) {
+      jlog("Error: read_binhmm: failed to read vector image\n");
+      return FALSE;
+    }
+    free(tr_off);
+    free(vr_off);
+    free(dens_off);
+    if (hmm->opt.stream_info.num > 1) free(streamweight_off);
+  }
+
   /* free pointer->index work area */
   if (mpdf_macro) free(mpdf_index);
   free(tr_index);
@@ -910,3 +1115,33 @@ read_binhmm(FILE *fp, HTK_HMM_INFO *hmm, boolean gzfile_p, Value *para)
 
   return (TRUE);
 }
+
+/** 
+ * Read a binary %HMM file.  If the vectors are stored in the image,
+ * the image will be mapped from the file directly when possible.
+ * 
+ * @param filename [in] file name
+ * @param hmm [out] %HMM definition structure to hold the read models.
+ * @param para [out] store acoustic parameters if embedded in binhmm (V2)
+ * 
+ * @return TRUE on success, FALSE on failure.
+ */
+boolean
+read_binhmm_file(char *filename, HTK_HMM_INFO *hmm, Value *para)
+{
+  FILE *fp;
+  boolean ret;
+
+  if ((fp = fopen_readfile(filename)) == NULL) {
+    jlog("Error: read_binhmm: failed to open %s\n", filename);
+    return FALSE;
+  }
+  image_file = filename;
+  ret = read_binhmm(fp, hmm, TRUE, para);
+  image_file = NULL;
+  if (fclose_readfile(fp) < 0) {
+    jlog("Error: read_binhmm: failed to close %s\n", filename);
+    return FALSE;
+  }
+  return(ret);
+}
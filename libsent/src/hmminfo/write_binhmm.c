@@ -8,6 +8,10 @@
  * HTKΥ %HMM ե뤫ХʥؤѴϡ
  * °Υġ mkbinhmm ǹԤʤޤΥХʥϡHTK 
  * ХʥȤߴǤΤդƲ
+ *
+ * write_binhmm_image() ϡ٥ȥեΥڡ·
+ * ᡼˥ޥΥХȥǤޤȤƽ񤭽ФJulius Ϥ
+ * ᡼ľܥ˥ޥåפƻѤǤ롥
  * </JA>
  * 
  * <EN>
@@ -17,6 +21,10 @@
  * The tool "mkbinhmm" can convert the ascii format HTK %HMM definition
  * file to this format.  Please note that this binary format is 
  * not compatible with the HTK binary format.
+ *
+ * write_binhmm_image() writes the vectors in a page-aligned image at the
+ * end of the file in the machine's natural byte order, so that Julius
+ * can map it to memory directly.
  * </EN>
  * 
  * @author Akinobu LEE
@@ -41,9 +49,17 @@
 #define wrt(A,B,C,D) if (wrtfunc(A,B,C,D) == FALSE) return FALSE
 #define wrt_str(A,B) if (wrt_strfunc(A,B) == FALSE) return FALSE
 
+static size_t count;		///< Number of bytes written from the top of the file
+static boolean image_mode;	///< TRUE when writing vectors in the image
+static unsigned int image_len;	///< Current length of the image in bytes
+static char *swapbuf = NULL;	///< Work area for byte-swapped output
+static size_t swapbuflen = 0;	///< Allocated length of @a swapbuf
+
 
 /** 
- * Binary write function with byte swap (assume file is BIG ENDIAN)
+ * Binary write function with byte swap (assume file is BIG ENDIAN).
+ * The data is swapped on a work area, since the source may be
+ * read-only (e.g. vectors on a memory-mapped image).
  * 
  * @param fp [in] file pointer
  * @param buf [in] data to write
@@ -53,23 +69,78 @@
 static boolean
 wrtfunc(FILE *fp, void *buf, size_t unitbyte, size_t unitnum)
 {
+  size_t len;
 
   if (unitnum == 0) return TRUE;
 
+  len = unitbyte * unitnum;
 #ifndef WORDS_BIGENDIAN
   if (unitbyte != 1) {
-    swap_bytes((char *)buf, unitbyte, unitnum);
+    if (swapbuflen < len) {
+      swapbuf = (char *)myrealloc(swapbuf, len);
+      swapbuflen = len;
+    }
+    memcpy(swapbuf, buf, len);
+    swap_bytes(swapbuf, unitbyte, unitnum);
+    buf = swapbuf;
   }
 #endif
   if (myfwrite(buf, unitbyte, unitnum, fp) < unitnum) {
-    jlog("Error: write_binhmm: failed to write %d bytes", unitbyte * unitnum);
+    jlog("Error: write_binhmm: failed to write %d bytes", len);
     return FALSE;
   }
-#ifndef WORDS_BIGENDIAN
-  if (unitbyte != 1) {
-    swap_bytes((char *)buf, unitbyte, unitnum);
+  count += len;
+  return TRUE;
+}
+
+/** 
+ * Reserve an area of vectors in the image, and write its offset.
+ * 
+ * @param fp [in] file pointer
+ * @param size [in] size of the vectors in bytes
+ */
+static boolean
+wrt_image_offset(FILE *fp, unsigned int size)
+{
+  wrt(fp, &image_len, sizeof(unsigned int), 1);
+  image_len += (size + BINHMM_IMAGE_ALIGN - 1) / BINHMM_IMAGE_ALIGN * BINHMM_IMAGE_ALIGN;
+  return TRUE;
+}
+
+/** 
+ * Write vectors to the image in natural byte order.
+ * 
+ * @param fp [in] file pointer
+ * @param buf [in] data to write
+ * @param size [in] size of the vectors in bytes
+ */
+static boolean
+wrt_image_vec(FILE *fp, void *buf, unsigned int size)
+{
+  if (myfwrite(buf, 1, size, fp) < size) {
+    jlog("Error: write_binhmm: failed to write %d bytes", size);
+    return FALSE;
+  }
+  count += size;
+  return TRUE;
+}
+
+/** 
+ * Pad zero bytes so that the next data begins at the alignment boundary.
+ * 
+ * @param fp [in] file pointer
+ * @param align [in] alignment in bytes (<= BINHMM_IMAGE_PAGE)
+ */
+static boolean
+wrt_image_pad(FILE *fp, unsigned int align)
+{
+  static char pad[BINHMM_IMAGE_PAGE];
+  unsigned int len;
+
+  len = (align - count % align) % align;
+  if (len > 0) {
+    if (wrt_image_vec(fp, pad, len) == FALSE) return FALSE;
   }
-#endif
   return TRUE;
 }
 
@@ -124,6 +195,10 @@ wt_header(FILE *fp, boolean emp, boolean inv, boolean mpdfmacro)
     *p++ = '_';
     *p++ = BINHMM_HEADER_V2_MPDFMACRO;
   }
+  if (image_mode) {
+    *p++ = '_';
+    *p++ = BINHMM_HEADER_V2_IMAGE;
+  }
   *p = '\0';
   wrt_str(fp, buf);
   jlog("Stat: write_binhmm: written header: \"%s%s\"\n", binhmm_header_v2, buf);
@@ -252,8 +327,12 @@ wt_trans(FILE *fp, HTK_HMM_INFO *hmm)
     t = tr_index[idx];
     wrt_str(fp, t->name);
     wrt(fp, &(t->statenum), sizeof(short), 1);
-    for(i=0;i<t->statenum;i++) {
-      wrt(fp, t->a[i], sizeof(PROB), t->statenum);
+    if (image_mode) {
+      if (wrt_image_offset(fp, sizeof(PROB) * t->statenum * t->statenum) == FALSE) return FALSE;
+    } else {
+      for(i=0;i<t->statenum;i++) {
+	wrt(fp, t->a[i], sizeof(PROB), t->statenum);
+      }
     }
   }
 
@@ -338,7 +417,11 @@ wt_var(FILE *fp, HTK_HMM_INFO *hmm)
     v = vr_index[idx];
     wrt_str(fp, v->name);
     wrt(fp, &(v->len), sizeof(short), 1);
-    wrt(fp, v->vec, sizeof(VECT), v->len);
+    if (image_mode) {
+      if (wrt_image_offset(fp, sizeof(VECT) * v->len) == FALSE) return FALSE;
+    } else {
+      wrt(fp, v->vec, sizeof(VECT), v->len);
+    }
   }
   jlog("Stat: write_binhmm: %d variance written\n", vr_num);
 
@@ -423,7 +506,11 @@ wt_dens(FILE *fp, HTK_HMM_INFO *hmm)
     d = dens_index[idx];
     wrt_str(fp, d->name);
     wrt(fp, &(d->meanlen), sizeof(short), 1);
-    wrt(fp, d->mean, sizeof(VECT), d->meanlen);
+    if (image_mode) {
+      if (wrt_image_offset(fp, sizeof(VECT) * d->meanlen) == FALSE) return FALSE;
+    } else {
+      wrt(fp, d->mean, sizeof(VECT), d->meanlen);
+    }
     vid = search_vid(d->var);
     /* for debug */
     if (d->var != vr_index[vid]) {
@@ -515,7 +602,11 @@ wt_streamweight(FILE *fp, HTK_HMM_INFO *hmm)
     sw = streamweight_index[idx];
     wrt_str(fp, sw->name);
     wrt(fp, &(sw->len), sizeof(short), 1);
-    wrt(fp, sw->weight, sizeof(VECT), sw->len);
+    if (image_mode) {
+      if (wrt_image_offset(fp, sizeof(VECT) * sw->len) == FALSE) return FALSE;
+    } else {
+      wrt(fp, sw->weight, sizeof(VECT), sw->len);
+    }
   }
   jlog("Stat: write_binhmm: %d stream weights written\n", streamweight_num);
 
@@ -982,7 +1073,66 @@ wt_data(FILE *fp, HTK_HMM_INFO *hmm)
 
 
 /** 
- * Top function to write %HMM definition data to a binary file.
+ * @brief  Write the vector image at the end of the file.
+ *
+ * The location of the image is written first, and the image begins at
+ * the next page boundary.  The vectors are written in the same order
+ * as their offsets were reserved by wrt_image_offset().
+ * 
+ * @param fp [in] file pointer
+ * @param hmm [in] %HMM definition structure to be written
+ */
+static boolean
+wt_image(FILE *fp, HTK_HMM_INFO *hmm)
+{
+  unsigned int offset;
+  unsigned int magic;
+  unsigned int idx;
+  int i;
+
+  offset = count + sizeof(unsigned int) * 2;
+  offset = (offset + BINHMM_IMAGE_PAGE - 1) / BINHMM_IMAGE_PAGE * BINHMM_IMAGE_PAGE;
+  wrt(fp, &offset, sizeof(unsigned int), 1);
+  wrt(fp, &image_len, sizeof(unsigned int), 1);
+  if (wrt_image_pad(fp, BINHMM_IMAGE_PAGE) == FALSE) return FALSE;
+
+  /* magic number to detect byte order */
+  magic = BINHMM_IMAGE_MAGIC;
+  if (wrt_image_vec(fp, &magic, sizeof(unsigned int)) == FALSE) return FALSE;
+  if (wrt_image_pad(fp, BINHMM_IMAGE_ALIGN) == FALSE) return FALSE;
+
+  for (idx = 0; idx < tr_num; idx++) {
+    for(i=0;i<tr_index[idx]->statenum;i++) {
+      if (wrt_image_vec(fp, tr_index[idx]->a[i], sizeof(PROB) * tr_index[idx]->statenum) == FALSE) return FALSE;
+    }
+    if (wrt_image_pad(fp, BINHMM_IMAGE_ALIGN) == FALSE) return FALSE;
+  }
+  for (idx = 0; idx < vr_num; idx++) {
+    if (wrt_image_vec(fp, vr_index[idx]->vec, sizeof(VECT) * vr_index[idx]->len) == FALSE) return FALSE;
+    if (wrt_image_pad(fp, BINHMM_IMAGE_ALIGN) == FALSE) return FALSE;
+  }
+  for (idx = 0; idx < dens_num; idx++) {
+    if (wrt_image_vec(fp, dens_index[idx]->mean, sizeof(VECT) * dens_index[idx]->meanlen) == FALSE) return FALSE;
+    if (wrt_image_pad(fp, BINHMM_IMAGE_ALIGN) == FALSE) return FALSE;
+  }
+  if (hmm->opt.stream_info.num > 1) {
+    for (idx = 0; idx < streamweight_num; idx++) {
+      if (wrt_image_vec(fp, streamweight_index[idx]->weight, sizeof(VECT) * streamweight_index[idx]->len) == FALSE) return FALSE;
+      if (wrt_image_pad(fp, BINHMM_IMAGE_ALIGN) == FALSE) return FALSE;
+    }
+  }
+
+  if (count - offset != image_len) {
+    jlog("Error: write_binhmm: image length not match!!!\n");
+    return FALSE;
+  }
+  jlog("Stat: write_binhmm: %u bytes of vector image written\n", image_len);
+
+  return TRUE;
+}
+
+/** 
+ * Write %HMM definition data to a binary file.
  * 
  * @param fp [in] file pointer
  * @param hmm [in] %HMM definition structure to be written
@@ -990,11 +1140,15 @@ wt_data(FILE *fp, HTK_HMM_INFO *hmm)
  * 
  * @return TRUE on success, FALSE on failure.
  */
-boolean
-write_binhmm(FILE *fp, HTK_HMM_INFO *hmm, Value *para)
+static boolean
+wt_binhmm(FILE *fp, HTK_HMM_INFO *hmm, Value *para)
 {
   boolean mpdf_macro;
 
+  count = 0;
+  /* the top of the image is reserved for the magic number */
+  image_len = BINHMM_IMAGE_ALIGN;
+
   if (hmm->pdf_root != NULL) {
     /* "~p" macro definition exist */
     /* save mixture pdf separatedly from state definition */
@@ -1084,6 +1238,14 @@ write_binhmm(FILE *fp, HTK_HMM_INFO *hmm, Value *para)
     return FALSE;
   }
 
+  /* write vector image */
+  if (image_mode) {
+    if (wt_image(fp, hmm) == FALSE) {
+      jlog("Error: write_binhmm: failed to write vector image\n");
+      return FALSE;
+    }
+  }
+
   /* free pointer->index work area */
   if (mpdf_macro) free(mpdf_index);
   free(tr_index);
@@ -1095,3 +1257,53 @@ write_binhmm(FILE *fp, HTK_HMM_INFO *hmm, Value *para)
 
   return (TRUE);
 }
+
+/** 
+ * Top function to write %HMM definition data to a binary file.
+ * 
+ * @param fp [in] file pointer
+ * @param hmm [in] %HMM definition structure to be written
+ * @param para [in] acoustic analysis parameter, or NULL if not available
+ * 
+ * @return TRUE on success, FALSE on failure.
+ */
+boolean
+write_binhmm(FILE *fp, HTK_HMM_INFO *hmm, Value *para)
+{
+  boolean ret;
+
+  image_mode = FALSE;
+  ret = wt_binhmm(fp, hmm, para);
+  if (swapbuf != NULL) {
+    free(swapbuf);
+    swapbuf = NULL;
+    swapbuflen = 0;
+  }
+  return ret;
+}
+
+/** 
+ * Write %HMM definition data to a binary file, with the vectors stored
+ * in a memory-mappable image.  The file should not be compressed to
+ * be mapped.
+ * 
+ * @param fp [in] file pointer
+ * @param hmm [in] %HMM definition structure to be written
+ * @param para [in] acoustic analysis parameter, or NULL if not available
+ * 
+ * @return TRUE on success, FALSE on failure.
+ */
+boolean
+write_binhmm_image(FILE *fp, HTK_HMM_INFO *hmm, Value *para)
+{
+  boolean ret;
+
+  image_mode = TRUE;
+  ret = wt_binhmm(fp, hmm, para);
+  if (swapbuf != NULL) {
+    free(swapbuf);
+    swapbuf = NULL;
+    swapbuflen = 0;
+  }
+  return ret;
+}
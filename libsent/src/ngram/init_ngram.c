@@ -38,6 +38,16 @@ init_ngram_bin(NGRAM_INFO *ndata, char *bin_ngram_file)
   FILE *fp;
   
   jlog("Stat: init_ngram: reading in binary n-gram from %s\n", bin_ngram_file);
+  /* map v6 binary N-gram directly if possible */
+  switch(ngram_mmap_bin(bin_ngram_file, ndata)) {
+  case 1:
+    set_default_unknown_id(ndata);
+    jlog("Stat: init_ngram: finished reading n-gram\n");
+    return TRUE;
+  case -1:
+    jlog("Error: init_ngram: failed to read \"%s\"\n", bin_ngram_file);
+    return FALSE;
+  }
   if ((fp = fopen_readfile(bin_ngram_file)) == NULL) {
     jlog("Error: init_ngram: failed to open \"%s\"\n", bin_ngram_file);
     return FALSE;
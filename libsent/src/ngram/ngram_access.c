@@ -28,6 +28,106 @@
 
 #undef ADEBUG
 
+/** 
+ * Get an entry from bit-packed array.
+ * 
+ * @param a [in] bit-packed array
+ * @param bits [in] bit width of an entry
+ * @param i [in] entry index
+ * 
+ * @return the value.
+ */
+static unsigned int
+pack_get(unsigned int *a, int bits, NNID i)
+{
+  size_t pos;
+  size_t idx;
+  int off;
+  unsigned int v;
+
+  pos = (size_t)i * bits;
+  idx = pos >> 5;
+  off = pos & 31;
+  v = a[idx] >> off;
+  if (off + bits > 32) v |= a[idx+1] << (32 - off);
+  if (bits < 32) v &= (1U << bits) - 1;
+  return v;
+}
+
+/// Probability of a tuple, decoding quantized one
+#define TUPLE_PROB(T,I) ((T)->packed ? (T)->prob_cb[(T)->prob_q[I]] : (T)->prob[I])
+/// Back-off weight of a context, decoding quantized one
+#define TUPLE_BO_WT(T,I) ((T)->packed ? (T)->bo_wt_cb[(T)->bo_wt_q[I]] : (T)->bo_wt[I])
+
+/** 
+ * Search for a word in a tuple set.  A word out of the range of the
+ * set is rejected at first, and then binary search is performed.  The
+ * loop halves the range without a data-dependent exit or branch, so
+ * the compiler can make it a conditional move and the number of
+ * iterations depends only on the size of the set.
+ * 
+ * @param wid [in] word IDs of tuples (nnid2wid)
+ * @param left [in] first tuple ID of the set
+ * @param right [in] last tuple ID of the set
+ * @param wkey [in] the target word ID
+ * 
+ * @return corresponding tuple ID if found, or NNID_INVALID if not exist.
+ */
+static NNID
+search_word(WORD_ID *wid, NNID left, NNID right, WORD_ID wkey)
+{
+  NNID n, half;
+
+  if (wkey < wid[left] || wkey > wid[right]) return (NNID_INVALID);
+  n = right - left + 1;
+  while(n > 1) {
+    half = n / 2;
+    if (wid[left + half] <= wkey) left += half;
+    n -= half;
+  }
+  if (wid[left] == wkey) {
+    return (left);
+  } else {
+    return (NNID_INVALID);
+  }
+}
+
+/** 
+ * Search for a word in a tuple set of quantized and bit-packed m-gram.
+ * Same as search_word() except for the access to word IDs.
+ * 
+ * @param t [in] m-gram
+ * @param nnid [in] context ID
+ * @param wkey [in] the target word ID
+ * 
+ * @return corresponding tuple ID if found, or NNID_INVALID if not exist.
+ */
+static NNID
+search_packed(NGRAM_TUPLE_INFO *t, NNID nnid, WORD_ID wkey)
+{
+  NNID left,right;
+  NNID num, n, half;
+
+  num = pack_get(t->num_pk, t->num_bits, nnid);
+  if (num == 0) return (NNID_INVALID);
+  left = pack_get(t->bgn_pk, t->bgn_bits, nnid);
+  right = left + num - 1;
+
+  if (wkey < pack_get(t->wid_pk, t->wid_bits, left)
+      || wkey > pack_get(t->wid_pk, t->wid_bits, right)) return (NNID_INVALID);
+  n = num;
+  while(n > 1) {
+    half = n / 2;
+    if (pack_get(t->wid_pk, t->wid_bits, left + half) <= wkey) left += half;
+    n -= half;
+  }
+  if (pack_get(t->wid_pk, t->wid_bits, left) == wkey) {
+    return (left);
+  } else {
+    return (NNID_INVALID);
+  }
+}
+
 /** 
  * Search for n-gram tuple.
  * 
@@ -44,7 +144,7 @@ search_ngram_core(NGRAM_INFO *ndata, int n, NNID nid_prev, WORD_ID wkey)
 {
   NGRAM_TUPLE_INFO *t, *tprev;
   NNID nnid;
-  NNID left,right,mid;
+  NNID left,right;
   NNID x;
 
   if (ndata->bigram_index_reversed && n == 2) {
@@ -65,6 +165,7 @@ search_ngram_core(NGRAM_INFO *ndata, int n, NNID nid_prev, WORD_ID wkey)
   } else {
     nnid = nid_prev;
   }
+  if (t->packed) return(search_packed(t, nnid, wkey));
   if (t->is24bit) {
     left = t->bgn_upper[nnid];
     if (left == NNID_INVALID_UPPER) return (NNID_INVALID);
@@ -75,19 +176,7 @@ search_ngram_core(NGRAM_INFO *ndata, int n, NNID nid_prev, WORD_ID wkey)
   }
   right = left + t->num[nnid] - 1;
 
-  while(left < right) {
-    mid = (left + right) / 2;
-    if (t->nnid2wid[mid] < wkey) {
-      left = mid + 1;
-    } else {
-      right = mid;
-    }
-  }
-  if (t->nnid2wid[left] == wkey) {
-    return (left);
-  } else {
-    return (NNID_INVALID);
-  }
+  return(search_word(t->nnid2wid, left, right, wkey));
 }
 
 /** 
@@ -195,9 +284,9 @@ ngram_prob(NGRAM_INFO *ndata, int n, WORD_ID *w)
       }
       /* return back-off likelihood */
 #ifdef ADEBUG
-      printf("back: %f + %f\n", t->bo_wt[bid], p);
+      printf("back: %f + %f\n", TUPLE_BO_WT(t, bid), p);
 #endif
-      return(t->bo_wt[bid] + p);
+      return(TUPLE_BO_WT(t, bid) + p);
     } else {
       /* previous context not found, fallback to (n-1)-gram */
       return(p);
@@ -205,7 +294,7 @@ ngram_prob(NGRAM_INFO *ndata, int n, WORD_ID *w)
   }
   /* n-gram found */
   /* trigram exist */
-  p = ndata->d[n-1].prob[next];
+  p = TUPLE_PROB(&(ndata->d[n-1]), next);
   if (w[n-1] == ndata->unk_id) p -= ndata->unk_num_log;
 
 #ifdef ADEBUG
@@ -248,29 +337,18 @@ uni_prob(NGRAM_INFO *ndata, WORD_ID w)
 static NNID
 search_bigram(NGRAM_INFO *ndata, WORD_ID w_context, WORD_ID w)
 {
-  /* do binary search to find bigram entry */
   /* assume ct_compaction and is24bit is FALSE on 2-gram */
-  NNID left,right,mid;		/* n2 */
+  NNID left,right;		/* n2 */
   NGRAM_TUPLE_INFO *t;
 
   t = &(ndata->d[1]);
 
+  if (t->packed) return(search_packed(t, w_context, w));
   if ((left = t->bgn[w_context]) == NNID_INVALID) /* has no bigram */
     return (NNID_INVALID);
   right = left + t->num[w_context] - 1;
-  while(left < right) {
-    mid = (left + right) / 2;
-    if (t->nnid2wid[mid] < w) {
-      left = mid + 1;
-    } else {
-      right = mid;
-    }
-  }
-  if (t->nnid2wid[left] == w) {
-    return (left);
-  } else {
-    return (NNID_INVALID);
-  }
+
+  return(search_word(t->nnid2wid, left, right, w));
 }
 
 /** 
@@ -293,7 +371,7 @@ bi_prob_normal(NGRAM_INFO *ndata, WORD_ID w1, WORD_ID w2)
   /* index is LR */
   /* prob is in main N-gram area */
   if ((n2 = search_bigram(ndata, w1, w2)) != NNID_INVALID) {
-    prob = ndata->d[1].prob[n2];
+    prob = TUPLE_PROB(&(ndata->d[1]), n2);
   } else {
     prob = ndata->d[0].bo_wt[w1] + ndata->d[0].prob[w2];
   }
@@ -389,7 +467,7 @@ bi_prob_compute(NGRAM_INFO *ndata, WORD_ID w1, WORD_ID w2)
   /* no additional N-gram, compute it directly */
   /* get p(w1|w2) */
   if ((n2 = search_bigram(ndata, w2, w1)) != NNID_INVALID) {
-    prob = ndata->d[1].prob[n2];
+    prob = TUPLE_PROB(&(ndata->d[1]), n2);
   } else {
     prob = ndata->d[0].bo_wt[w2] + ndata->d[0].prob[w1];
   }
@@ -24,6 +24,10 @@
 
 #include <sent/stddefs.h>
 #include <sent/ngram2.h>
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/mman.h>
+#endif
 
 /** 
  * Allocate a new N-gram structure.
@@ -42,7 +46,10 @@ ngram_info_new()
   new->bo_wt_1 = NULL;
   new->p_2 = NULL;
   new->bos_eos_swap = FALSE;
+  new->read_thread_num = 1;
   new->mroot = NULL;
+  new->mmap_base = NULL;
+  new->mmap_len = 0;
 
   return(new);
 }
@@ -58,10 +65,21 @@ free_ngram_tuple(NGRAM_TUPLE_INFO *t)
   }
   if (t->num) free(t->num);
   if (t->nnid2wid) free(t->nnid2wid);
-  free(t->prob);
+  if (t->prob) free(t->prob);
   if (t->bo_wt) free(t->bo_wt);
   if (t->nnid2ctid_upper) free(t->nnid2ctid_upper);
   if (t->nnid2ctid_lower) free(t->nnid2ctid_lower);
+  if (t->packed) {
+    free(t->bgn_pk);
+    free(t->num_pk);
+    free(t->wid_pk);
+    free(t->prob_cb);
+    free(t->prob_q);
+    if (t->bo_wt_q) {
+      free(t->bo_wt_cb);
+      free(t->bo_wt_q);
+    }
+  }
 }
 /** 
  * Free N-gram data.
@@ -74,6 +92,30 @@ ngram_info_free(NGRAM_INFO *ndata)
   int i;
   WORD_ID w;
 
+#ifdef HAVE_MMAP
+  if (ndata->mmap_base) {
+    /* arrays are on the mapped image: free only the index */
+    if (ndata->wname) free(ndata->wname);
+    if (ndata->d) {
+      for(i=0;i<ndata->n;i++) {
+	/* quantized after mapping */
+	if (ndata->d[i].packed
+	    && ((char *)ndata->d[i].bgn_pk < (char *)ndata->mmap_base
+		|| (char *)ndata->d[i].bgn_pk >= (char *)ndata->mmap_base + ndata->mmap_len)) {
+	  ndata->d[i].nnid2ctid_upper = NULL;
+	  ndata->d[i].nnid2ctid_lower = NULL;
+	  free_ngram_tuple(&(ndata->d[i]));
+	}
+      }
+      free(ndata->d);
+    }
+    if (ndata->mroot) mybfree2(&(ndata->mroot));
+    munmap(ndata->mmap_base, ndata->mmap_len);
+    free(ndata);
+    return;
+  }
+#endif
+
   /* bin test only */
   /* free word names */
   if (ndata->from_bin) {
@@ -0,0 +1,375 @@
+/**
+ * @file   ngram_quantize.c
+ *
+ * <JA>
+ * @brief  N-gram¤Τ̻Ҳȥӥåȥѥå
+ *
+ * 2-gram ʾγ m-gram ˤĤơΨȥХåշ 8bit 
+ * ɥ֥åֹ̻ҲñIDץ뽸γϰ֤ǿ
+ * 줾κͤ˱ӥå˵ͤݻ롥ɥ֥å
+ * m-gram Ȥ1 Lloyd ˡǵ롥ۤʤͤοɥ֥å
+ * ʲξͤ򤽤ΤޤݻΤǸʤ
+ * 1-gram 1ѥѤ2-gram̻Ҳʤ
+ *
+ * ̻Ҳ줿 N-gram  v7 ΥХʥN-gramȤƽ񤭽Ф졤
+ * ɤ߹߸ ngram_access.c ƩŪ˥ǥɤ롥
+ * </JA>
+ *
+ * <EN>
+ * @brief  Quantization and bit-packing of N-gram data
+ *
+ * For each m-gram of 2-gram and above, probabilities and back-off
+ * weights are quantized to 8-bit codebook indices, and word IDs,
+ * beginning IDs and sizes of tuple sets are packed into bit fields
+ * whose width is determined from their maximum values.  The codebook
+ * is trained per m-gram by one-dimensional Lloyd algorithm.  When the
+ * number of distinct values is not larger than the codebook size, the
+ * values are kept as is and no error occurs.  1-gram and the additional
+ * forward 2-gram for the 1st pass are not quantized.
+ *
+ * The quantized N-gram is written as v7 binary N-gram, and will be
+ * decoded transparently in ngram_access.c after being read.
+ * </EN>
+ *
+ * @author Akinobu LEE
+ * @date   Mon Oct 19 11:12:40 2026
+ *
+ * $Revision: 1.1 $
+ *
+ */
+/*
+ * Copyright (c) 1991-2013 Kawahara Lab., Kyoto University
+ * Copyright (c) 2000-2005 Shikano Lab., Nara Institute of Science and Technology
+ * Copyright (c) 2005-2013 Julius project team, Nagoya Institute of Technology
+ * All rights reserved
+ */
+
+#include <sent/stddefs.h>
+#include <sent/ngram2.h>
+
+/// Number of iterations for codebook training
+#define QUANT_ITERATION 20
+
+/**
+ * qsort callback to sort values in ascending order.
+ *
+ */
+static int
+compare_logprob(const void *a, const void *b)
+{
+  LOGPROB x = *(LOGPROB *)a;
+  LOGPROB y = *(LOGPROB *)b;
+  if (x < y) return -1;
+  if (x > y) return 1;
+  return 0;
+}
+
+/**
+ * Return the minimum bit width to hold the value.
+ *
+ * @param maxval [in] maximum value to be held
+ *
+ * @return the number of bits (1 to 32).
+ */
+static int
+bits_for(unsigned int maxval)
+{
+  int b;
+
+  b = 1;
+  while(b < 32 && (maxval >> b) != 0) b++;
+  return b;
+}
+
+/**
+ * Store a value into bit-packed array.  The array should be cleared
+ * beforehand.
+ *
+ * @param a [i/o] bit-packed array
+ * @param bits [in] bit width of an entry
+ * @param i [in] entry index
+ * @param v [in] value to store
+ */
+static void
+pack_set(unsigned int *a, int bits, NNID i, unsigned int v)
+{
+  size_t pos;
+  size_t idx;
+  int off;
+
+  pos = (size_t)i * bits;
+  idx = pos >> 5;
+  off = pos & 31;
+  a[idx] |= v << off;
+  if (off + bits > 32) a[idx+1] |= v >> (32 - off);
+}
+
+/**
+ * Allocate a cleared bit-packed array.
+ *
+ * @param num [in] number of entries
+ * @param bits [in] bit width of an entry
+ *
+ * @return the newly allocated array.
+ */
+static unsigned int *
+pack_new(NNID num, int bits)
+{
+  unsigned int *a;
+  size_t len;
+
+  len = NGRAM_PACK_WORDS(num, bits);
+  a = (unsigned int *)mymalloc_big(sizeof(unsigned int), len);
+  memset(a, 0, sizeof(unsigned int) * len);
+  return a;
+}
+
+/**
+ * Find the nearest codebook entry.
+ *
+ * @param cb [in] codebook sorted in ascending order
+ * @param v [in] value
+ *
+ * @return the index of the nearest entry.
+ */
+static int
+nearest_code(LOGPROB *cb, LOGPROB v)
+{
+  int left, right, mid;
+
+  left = 0;
+  right = NGRAM_QUANT_CBSIZE - 1;
+  /* find the last entry not larger than v */
+  while(left < right) {
+    mid = (left + right + 1) / 2;
+    if (cb[mid] <= v) {
+      left = mid;
+    } else {
+      right = mid - 1;
+    }
+  }
+  if (left < NGRAM_QUANT_CBSIZE - 1 && cb[left+1] - v < v - cb[left]) left++;
+  return left;
+}
+
+/**
+ * Train a codebook for the values by Lloyd algorithm, and quantize
+ * them.
+ *
+ * @param val [in] values
+ * @param num [in] number of values
+ * @param cb_ret [out] newly allocated codebook
+ * @param maxerr [out] maximum quantization error
+ *
+ * @return newly allocated codebook indices.
+ */
+static unsigned char *
+quantize_values(LOGPROB *val, NNID num, LOGPROB **cb_ret, LOGPROB *maxerr)
+{
+  LOGPROB *s, *cb;
+  double *sum;
+  NNID i, distinct;
+  NNID *b;
+  int k, iter;
+  LOGPROB th, err;
+  unsigned char *q;
+
+  cb = (LOGPROB *)mymalloc(sizeof(LOGPROB) * NGRAM_QUANT_CBSIZE);
+  q = (unsigned char *)mymalloc_big(sizeof(unsigned char), num);
+  *maxerr = 0.0;
+  if (num == 0) {
+    for(k=0;k<NGRAM_QUANT_CBSIZE;k++) cb[k] = 0.0;
+    *cb_ret = cb;
+    return q;
+  }
+
+  s = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), num);
+  memcpy(s, val, sizeof(LOGPROB) * num);
+  qsort(s, num, sizeof(LOGPROB), compare_logprob);
+
+  /* count distinct values */
+  distinct = 1;
+  for(i=1;i<num;i++) if (s[i] != s[i-1]) distinct++;
+
+  if (distinct <= NGRAM_QUANT_CBSIZE) {
+    /* hold them as is */
+    k = 0;
+    cb[k++] = s[0];
+    for(i=1;i<num;i++) if (s[i] != s[i-1]) cb[k++] = s[i];
+    while(k < NGRAM_QUANT_CBSIZE) {
+      cb[k] = cb[k-1];
+      k++;
+    }
+  } else {
+    /* initialize by quantiles */
+    for(k=0;k<NGRAM_QUANT_CBSIZE;k++) {
+      cb[k] = s[((size_t)k * 2 + 1) * num / (NGRAM_QUANT_CBSIZE * 2)];
+    }
+    /* cumulative sums to get cell means */
+    sum = (double *)mymalloc_big(sizeof(double), num + 1);
+    sum[0] = 0.0;
+    for(i=0;i<num;i++) sum[i+1] = sum[i] + s[i];
+    b = (NNID *)mymalloc(sizeof(NNID) * (NGRAM_QUANT_CBSIZE + 1));
+    for(iter=0;iter<QUANT_ITERATION;iter++) {
+      /* cell boundaries at the midpoints of neighboring codes */
+      b[0] = 0;
+      b[NGRAM_QUANT_CBSIZE] = num;
+      for(k=1;k<NGRAM_QUANT_CBSIZE;k++) {
+	NNID left, right, mid;
+	th = (cb[k-1] + cb[k]) * 0.5;
+	left = b[k-1];
+	right = num;
+	while(left < right) {
+	  mid = left + (right - left) / 2;
+	  if (s[mid] <= th) {
+	    left = mid + 1;
+	  } else {
+	    right = mid;
+	  }
+	}
+	b[k] = left;
+      }
+      /* move codes to the cell means */
+      for(k=0;k<NGRAM_QUANT_CBSIZE;k++) {
+	if (b[k+1] > b[k]) {
+	  cb[k] = (sum[b[k+1]] - sum[b[k]]) / (b[k+1] - b[k]);
+	}
+      }
+    }
+    free(b);
+    free(sum);
+  }
+  free(s);
+
+  for(i=0;i<num;i++) {
+    k = nearest_code(cb, val[i]);
+    q[i] = k;
+    err = val[i] - cb[k];
+    if (err < 0) err = -err;
+    if (*maxerr < err) *maxerr = err;
+  }
+
+  *cb_ret = cb;
+  return q;
+}
+
+/**
+ * Quantize and bit-pack an m-gram.
+ *
+ * @param ndata [in] N-gram information
+ * @param t [i/o] m-gram to be converted
+ * @param m [in] N of the m-gram
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+quantize_tuple(NGRAM_INFO *ndata, NGRAM_TUPLE_INFO *t, int m)
+{
+  NNID i, bgn, maxnum;
+  WORD_ID maxwid;
+  LOGPROB err_p, err_b;
+
+  /* bit width */
+  maxnum = 0;
+  for(i=0;i<t->bgnlistlen;i++) {
+    if (maxnum < t->num[i]) maxnum = t->num[i];
+  }
+  maxwid = 0;
+  for(i=0;i<t->totalnum;i++) {
+    if (maxwid < t->nnid2wid[i]) maxwid = t->nnid2wid[i];
+  }
+  t->bgn_bits = bits_for(t->totalnum);
+  t->num_bits = bits_for(maxnum);
+  t->wid_bits = bits_for(maxwid);
+
+  /* pack tuple set index */
+  t->bgn_pk = pack_new(t->bgnlistlen, t->bgn_bits);
+  t->num_pk = pack_new(t->bgnlistlen, t->num_bits);
+  for(i=0;i<t->bgnlistlen;i++) {
+    if (t->is24bit) {
+      if (t->bgn_upper[i] == NNID_INVALID_UPPER) {
+	bgn = NNID_INVALID;
+      } else {
+	bgn = ((NNID)(t->bgn_upper[i]) << 16) + (NNID)(t->bgn_lower[i]);
+      }
+    } else {
+      bgn = t->bgn[i];
+    }
+    if (bgn == NNID_INVALID) {
+      if (t->num[i] != 0) {
+	jlog("Error: ngram_quantize: internal error\n");
+	return FALSE;
+      }
+      continue;
+    }
+    pack_set(t->bgn_pk, t->bgn_bits, i, bgn);
+    pack_set(t->num_pk, t->num_bits, i, t->num[i]);
+  }
+  t->wid_pk = pack_new(t->totalnum, t->wid_bits);
+  for(i=0;i<t->totalnum;i++) {
+    pack_set(t->wid_pk, t->wid_bits, i, t->nnid2wid[i]);
+  }
+
+  /* quantize probabilities and back-off weights */
+  t->prob_q = quantize_values(t->prob, t->totalnum, &(t->prob_cb), &err_p);
+  err_b = 0.0;
+  if (t->bo_wt) {
+    t->bo_wt_q = quantize_values(t->bo_wt, t->context_num, &(t->bo_wt_cb), &err_b);
+  }
+
+  jlog("Stat: ngram_quantize: %d-gram: word=%dbit, bgn=%dbit, num=%dbit, max error prob=%f bo_wt=%f\n", m, t->wid_bits, t->bgn_bits, t->num_bits, err_p, err_b);
+
+  /* release the original arrays */
+  if (ndata->mmap_base == NULL) {
+    if (t->is24bit) {
+      free(t->bgn_upper);
+      free(t->bgn_lower);
+    } else {
+      free(t->bgn);
+    }
+    free(t->num);
+    free(t->nnid2wid);
+    free(t->prob);
+    if (t->bo_wt) free(t->bo_wt);
+  }
+  t->bgn_upper = NULL;
+  t->bgn_lower = NULL;
+  t->bgn = NULL;
+  t->num = NULL;
+  t->nnid2wid = NULL;
+  t->prob = NULL;
+  t->bo_wt = NULL;
+  t->packed = TRUE;
+
+  return TRUE;
+}
+
+/**
+ * <JA>
+ * N-gram  2-gram ʾ̻Ҳӥåȥѥå󥰤롥̻Ҳ
+ * Ƥ m-gram ϤΤޤޤˤ롥
+ *
+ * @param ndata [i/o] N-gram ǡ
+ *
+ * @return  TRUEԻ FALSE ֤
+ * </JA>
+ * <EN>
+ * Quantize and bit-pack 2-gram and above of the N-gram.  Already
+ * quantized m-grams are left as is.
+ *
+ * @param ndata [i/o] N-gram data
+ *
+ * @return TRUE on success, FALSE on failure.
+ * </EN>
+ */
+boolean
+ngram_quantize(NGRAM_INFO *ndata)
+{
+  int n;
+
+  for(n=1;n<ndata->n;n++) {
+    if (ndata->d[n].packed) continue;
+    if (quantize_tuple(ndata, &(ndata->d[n]), n + 1) == FALSE) return FALSE;
+  }
+  return TRUE;
+}
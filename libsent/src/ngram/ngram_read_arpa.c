@@ -36,21 +36,432 @@
 
 #include <sent/stddefs.h>
 #include <sent/ngram2.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 static char buf[800];			///< Local buffer for reading
 static char pbuf[800];			///< Local buffer for error string 
 
+/// Size of block to read from ARPA file at once
+#define ARPA_BLOCK_SIZE 4194304
+/// Maximum number of N-gram lines to be parsed at once
+#define ARPA_BATCH_LINES 65536
+/// Minimum number of lines to be assigned to a thread
+#define ARPA_THREAD_MIN_LINES 1024
+
+/**
+ * Block reader of ARPA file.  The file is read by large blocks instead
+ * of line by line, and lines are cut out in the buffer.
+ *
+ */
+typedef struct {
+  FILE *fp;			///< File pointer
+  char *buf;			///< Read buffer
+  size_t size;			///< Allocated size of @a buf
+  size_t len;			///< Length of valid data in @a buf
+  size_t pos;			///< Current read point in @a buf
+  boolean eof;			///< TRUE if already reached end of file
+} ARPA_READER;
+
+/// Status of parsed N-gram line: successfully parsed
+#define ARPA_ENTRY_OK 0
+/// Status of parsed N-gram line: a word not found in 1-gram
+#define ARPA_ENTRY_NOWORD 1
+/// Status of parsed N-gram line: failed to parse
+#define ARPA_ENTRY_FORMAT 2
+
+/**
+ * An N-gram line parsed by parse_ngram_lines().
+ *
+ */
+typedef struct {
+  char *line;			///< Line in the read buffer, tokenized in place
+  int len;			///< Original length of @a line
+  int status;			///< ARPA_ENTRY_OK, ARPA_ENTRY_NOWORD or ARPA_ENTRY_FORMAT
+  char *errword;		///< Word not found in 1-gram on ARPA_ENTRY_NOWORD
+  LOGPROB prob;			///< N-gram probability
+  LOGPROB bo_wt;		///< Back-off weight
+  boolean has_bo_wt;		///< TRUE if back-off weight is given
+  NNID cid;			///< Tuple ID of the context in (N-1)-gram
+} ARPA_ENTRY;
+
+/**
+ * Work area of a thread to parse a part of N-gram lines.
+ *
+ */
+typedef struct {
+  NGRAM_INFO *ndata;		///< N-gram being read
+  int n;			///< N of the lines
+  ARPA_ENTRY *e;		///< Lines to parse
+  WORD_ID *w;			///< Words of lines, @a n words per line
+  int bgn;			///< First line to parse
+  int end;			///< Last line to parse + 1
+} ARPA_PARSE_JOB;
+
+/**
+ * Initialize the block reader.
+ *
+ * @param r [out] block reader
+ * @param r [i/o] block reader of the file
+ */
+static void
+reader_init(ARPA_READER *r, FILE *fp)
+{
+  r->fp = fp;
+  r->size = ARPA_BLOCK_SIZE;
+  r->buf = (char *)mymalloc(r->size);
+  r->len = r->pos = 0;
+  r->eof = FALSE;
+}
+
+/**
+ * Free the block reader.
+ *
+ * @param r [i/o] block reader
+ */
+static void
+reader_free(ARPA_READER *r)
+{
+  free(r->buf);
+  r->buf = NULL;
+}
+
+/**
+ * Read next block from file.  The remaining data is moved to the top of
+ * the buffer, and the buffer is expanded if a line does not fit in it.
+ * Lines previously got from the reader become invalid.
+ *
+ * @param r [i/o] block reader
+ *
+ * @return TRUE on success, FALSE on read error.
+ */
+static boolean
+reader_fill(ARPA_READER *r)
+{
+  size_t cnt;
+
+  if (r->pos >= r->len) {
+    r->len = 0;
+  } else if (r->pos > 0) {
+    memmove(r->buf, r->buf + r->pos, r->len - r->pos);
+    r->len -= r->pos;
+  }
+  r->pos = 0;
+  /* keep one byte for the terminator of the last line */
+  if (r->len >= r->size - 1) {
+    r->size *= 2;
+    r->buf = (char *)myrealloc(r->buf, r->size);
+  }
+  cnt = myfread(r->buf + r->len, 1, r->size - 1 - r->len, r->fp);
+  if (cnt == (size_t)-1) {
+    jlog("Error: ngram_read_arpa: failed to read from file\n");
+    return FALSE;
+  }
+  if (cnt == 0) r->eof = TRUE;
+  r->len += cnt;
+
+  return TRUE;
+}
+
+/**
+ * Get next line in the read buffer.  Blank lines are skipped, and the
+ * newline code is stripped.
+ *
+ * @param r [i/o] block reader
+ * @param line [out] the line, terminated in the buffer
+ * @param stop_at_section [in] if TRUE, stop at a section header line
+ * beginning with '\\' without consuming it
+ *
+ * @return 1 if a line is got, 0 if the buffer does not have a whole line
+ * and needs reader_fill(), 2 if stopped at section header, or -1 on end of
+ * file.
+ */
+static int
+reader_next(ARPA_READER *r, char **line, boolean stop_at_section)
+{
+  char *p, *e;
+  size_t l;
+
+  for(;;) {
+    if (r->pos >= r->len) return(r->eof ? -1 : 0);
+    p = r->buf + r->pos;
+    e = memchr(p, '\n', r->len - r->pos);
+    if (e == NULL) {
+      if (! r->eof) return 0;
+      /* last line without newline */
+      e = r->buf + r->len;
+    }
+    l = e - p;
+    if (l > 0 && p[l-1] == '\r') l--;
+    if (l == 0) {		/* blank line */
+      r->pos = e - r->buf + 1;
+      continue;
+    }
+    if (stop_at_section && p[0] == '\\') return 2;
+    p[l] = '\0';
+    r->pos = e - r->buf + 1;
+    *line = p;
+    return 1;
+  }
+}
+
+/**
+ * Read one line from the block reader into a buffer, as getl().
+ *
+ * @param r [i/o] block reader
+ * @param buf [out] data buffer
+ * @param maxlen [in] maximum length of above
+ *
+ * @return the buffer @a buf, or NULL on EOF or error.
+ */
+static char *
+reader_getl(ARPA_READER *r, char *buf, int maxlen)
+{
+  char *p;
+  int ret;
+
+  for(;;) {
+    ret = reader_next(r, &p, FALSE);
+    if (ret == 1) break;
+    if (ret == -1) return NULL;
+    if (reader_fill(r) == FALSE) return NULL;
+  }
+  strncpy(buf, p, maxlen - 1);
+  buf[maxlen - 1] = '\0';
+
+  return buf;
+}
+
+/**
+ * Get lines of an N-gram section from the block reader.  Reading stops
+ * at the next section header, which is left unread.
+ *
+ * @param r [i/o] block reader
+ * @param e [out] the lines are set to e[0..]
+ * @param max [in] maximum number of lines to get
+ *
+ * @return the number of lines got, 0 at the end of the section, or -1 on
+ * read error.
+ */
+static int
+reader_lines(ARPA_READER *r, ARPA_ENTRY *e, int max)
+{
+  char *p;
+  int num, ret;
+
+  num = 0;
+  while(num < max) {
+    ret = reader_next(r, &p, TRUE);
+    if (ret == 1) {
+      e[num++].line = p;
+    } else if (ret == 0) {
+      /* lines got so far will be moved by reading next block */
+      if (num > 0) break;
+      if (reader_fill(r) == FALSE) return -1;
+    } else {
+      break;
+    }
+  }
+
+  return num;
+}
+
+/**
+ * Get next token from a string, as strtok() with DELM but re-entrant.
+ *
+ * @param p [i/o] current point in the string, updated to the next point
+ *
+ * @return the token, or NULL if no more token.
+ */
+static char *
+next_token(char **p)
+{
+  char *s;
+
+  s = *p + strspn(*p, DELM);
+  if (*s == '\0') {
+    *p = s;
+    return NULL;
+  }
+  *p = s + strcspn(s, DELM);
+  if (**p != '\0') {
+    **p = '\0';
+    (*p)++;
+  }
+
+  return s;
+}
+
+/**
+ * Parse N-gram lines: convert values, look up the word IDs and find the
+ * tuple ID of the context in (N-1)-gram.  The context IDs are searched
+ * only when the context changes from the previous line.  This does not
+ * modify the N-gram, so can be run in parallel for separate lines.
+ *
+ * @param ndata [in] N-gram being read, (N-1)-gram should be already read
+ * @param n [in] N of the lines
+ * @param e [i/o] lines to parse, the result is stored
+ * @param wbuf [out] words of the lines, @a n words per line
+ * @param bgn [in] first line to parse
+ * @param end [in] last line to parse + 1
+ */
+static void
+parse_ngram_lines(NGRAM_INFO *ndata, int n, ARPA_ENTRY *e, WORD_ID *wbuf, int bgn, int end)
+{
+  ARPA_ENTRY *x;
+  WORD_ID *w, *wprev;
+  char *p, *s;
+  int k, i;
+
+  for(k=bgn;k<end;k++) {
+    x = &(e[k]);
+    w = &(wbuf[k * n]);
+    x->len = strlen(x->line);
+    x->status = ARPA_ENTRY_OK;
+    p = x->line;
+    /* N-gram probability */
+    if ((s = next_token(&p)) == NULL) {
+      x->status = ARPA_ENTRY_FORMAT;
+      continue;
+    }
+    x->prob = (LOGPROB)atof(s);
+    /* words */
+    for(i=0;i<n;i++) {
+      if ((s = next_token(&p)) == NULL) {
+	x->status = ARPA_ENTRY_FORMAT;
+	break;
+      }
+      if ((w[i] = ngram_lookup_word(ndata, s)) == WORD_INVALID) {
+	x->status = ARPA_ENTRY_NOWORD;
+	x->errword = s;
+	break;
+      }
+    }
+    if (i < n) continue;
+    /* back-off weight */
+    if ((s = next_token(&p)) != NULL) {
+      x->bo_wt = (LOGPROB)atof(s);
+      x->has_bo_wt = TRUE;
+    } else {
+      x->has_bo_wt = FALSE;
+    }
+    /* context */
+    if (k > bgn && e[k-1].status == ARPA_ENTRY_OK) {
+      wprev = &(wbuf[(k - 1) * n]);
+      for(i=0;i<n-1;i++) {
+	if (w[i] != wprev[i]) break;
+      }
+      if (i == n-1) {
+	x->cid = e[k-1].cid;
+	continue;
+      }
+    }
+    x->cid = search_ngram(ndata, n-1, w);
+  }
+}
+
+#ifdef HAVE_PTHREAD
+/**
+ * Thread function to parse a part of N-gram lines.
+ *
+ * @param arg [in] work area (ARPA_PARSE_JOB)
+ *
+ * @return NULL
+ */
+static void *
+parse_ngram_worker(void *arg)
+{
+  ARPA_PARSE_JOB *j = arg;
+
+  parse_ngram_lines(j->ndata, j->n, j->e, j->w, j->bgn, j->end);
+
+  return NULL;
+}
+#endif
+
+/**
+ * Parse N-gram lines, with threads if ndata->read_thread_num > 1.  The
+ * lines are divided into continuous parts for each thread.
+ *
+ * @param ndata [in] N-gram being read, (N-1)-gram should be already read
+ * @param n [in] N of the lines
+ * @param e [i/o] lines to parse, the result is stored
+ * @param wbuf [out] words of the lines, @a n words per line
+ * @param num [in] number of lines
+ */
+static void
+parse_ngram_batch(NGRAM_INFO *ndata, int n, ARPA_ENTRY *e, WORD_ID *wbuf, int num)
+{
+#ifdef HAVE_PTHREAD
+  ARPA_PARSE_JOB *job;
+  pthread_t *th;
+  boolean *running;
+  int tnum, i;
+
+  tnum = ndata->read_thread_num;
+  if (tnum > num / ARPA_THREAD_MIN_LINES) tnum = num / ARPA_THREAD_MIN_LINES;
+  if (tnum > 1) {
+    job = (ARPA_PARSE_JOB *)mymalloc(sizeof(ARPA_PARSE_JOB) * tnum);
+    th = (pthread_t *)mymalloc(sizeof(pthread_t) * tnum);
+    running = (boolean *)mymalloc(sizeof(boolean) * tnum);
+    for(i=0;i<tnum;i++) {
+      job[i].ndata = ndata;
+      job[i].n = n;
+      job[i].e = e;
+      job[i].w = wbuf;
+      job[i].bgn = (int)((double)num * i / tnum);
+      job[i].end = (int)((double)num * (i + 1) / tnum);
+    }
+    /* the first part is processed by this thread */
+    for(i=1;i<tnum;i++) {
+      running[i] = (pthread_create(&(th[i]), NULL, parse_ngram_worker, &(job[i])) == 0);
+    }
+    parse_ngram_lines(ndata, n, e, wbuf, job[0].bgn, job[0].end);
+    for(i=1;i<tnum;i++) {
+      if (running[i]) {
+	pthread_join(th[i], NULL);
+      } else {
+	/* failed to create thread, process here */
+	parse_ngram_lines(ndata, n, e, wbuf, job[i].bgn, job[i].end);
+      }
+    }
+    free(running);
+    free(th);
+    free(job);
+    return;
+  }
+#endif
+  parse_ngram_lines(ndata, n, e, wbuf, 0, num);
+}
+
+/**
+ * Set the original text of a parsed line to @a pbuf for error message.
+ *
+ * @param x [in] parsed line
+ */
+static void
+set_errline(ARPA_ENTRY *x)
+{
+  int i, len;
+
+  len = x->len;
+  if (len > (int)sizeof(pbuf) - 1) len = sizeof(pbuf) - 1;
+  for(i=0;i<len;i++) pbuf[i] = (x->line[i] == '\0') ? ' ' : x->line[i];
+  pbuf[len] = '\0';
+}
+
 
 /** 
  * Set number of N-gram entries, for reading the first LR 2-gram.
  * 
- * @param fp [in] file pointer
+ * @param r [i/o] block reader of the file
  * @param numlist [out] set the values to this buffer (malloc)
  *
  * @return the value of N, or -1 on error.
  */
 static int
-get_total_info(FILE *fp, NNID **numlist)
+get_total_info(ARPA_READER *r, NNID **numlist)
 {
   char *p;
   int n;
@@ -63,7 +474,7 @@ get_total_info(FILE *fp, NNID **numlist)
   numnum = 10;
   *numlist = (NNID *)mymalloc(sizeof(NNID) * numnum);
 
-  while (getl(buf, sizeof(buf), fp) != NULL && buf[0] != '\\') {
+  while (reader_getl(r, buf, sizeof(buf)) != NULL && buf[0] != '\\') {
     if (strnmatch(buf, "ngram", 5)) { /* n-gram num */
       //p = strtok(buf, " =");
       //n = atoi(p);
@@ -96,16 +507,16 @@ get_total_info(FILE *fp, NNID **numlist)
 /** 
  * Read word/class entry names and 1-gram data from LR 2-gram file.
  * 
- * @param fp [in] file pointer
+ * @param r [i/o] block reader of the file
  * @param ndata [out] N-gram to set the read data.
  */
 static boolean
-set_unigram(FILE *fp, NGRAM_INFO *ndata)
+set_unigram(ARPA_READER *r, NGRAM_INFO *ndata)
 {
   WORD_ID nid;
   int resid;
   LOGPROB prob, bo_wt;
-  char *name, *p;
+  char *name, *p, *q;
   boolean ok_p = TRUE;
   NGRAM_TUPLE_INFO *t;
 
@@ -133,18 +544,19 @@ set_unigram(FILE *fp, NGRAM_INFO *ndata)
 
   nid = 0;
   
-  while (getl(buf, sizeof(buf), fp) != NULL && buf[0] != '\\') {
-    if ((p = strtok(buf, DELM)) == NULL) {
+  while (reader_getl(r, buf, sizeof(buf)) != NULL && buf[0] != '\\') {
+    q = buf;
+    if ((p = next_token(&q)) == NULL) {
       jlog("Error: ngram_read_arpa: 1-gram: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
     prob = (LOGPROB)atof(p);
-    if ((p = strtok(NULL, DELM)) == NULL) {
+    if ((p = next_token(&q)) == NULL) {
       jlog("Error: ngram_read_arpa: 1-gram: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
     name = strcpy((char *)mymalloc(strlen(p)+1), p);
-    if ((p = strtok(NULL, DELM)) == NULL) {
+    if ((p = next_token(&q)) == NULL) {
       bo_wt = 0.0;
     } else {
       bo_wt = (LOGPROB)atof(p);
@@ -196,34 +608,35 @@ set_unigram(FILE *fp, NGRAM_INFO *ndata)
  * Read 1-gram data from RL 3-gram file.  Only the back-off weights are
  * stored.
  * 
- * @param fp [in] file pointer
+ * @param r [i/o] block reader of the file
  * @param ndata [out] N-gram to store the read data.
  */
 static boolean
-add_unigram(FILE *fp, NGRAM_INFO *ndata)
+add_unigram(ARPA_READER *r, NGRAM_INFO *ndata)
 {
   WORD_ID read_word_num;
   WORD_ID nid;
   LOGPROB prob, bo_wt;
-  char *name, *p;
+  char *name, *p, *q;
   boolean ok_p = TRUE;
   boolean mismatched = FALSE;
 
   ndata->bo_wt_1 = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), ndata->max_word_num);
 
   read_word_num = 0;
-  while (getl(buf, sizeof(buf), fp) != NULL && buf[0] != '\\') {
-    if ((p = strtok(buf, DELM)) == NULL) {
+  while (reader_getl(r, buf, sizeof(buf)) != NULL && buf[0] != '\\') {
+    q = buf;
+    if ((p = next_token(&q)) == NULL) {
       jlog("Error: ngram_read_arpa: RL 1-gram: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
     prob = atof(p);
-    if ((p = strtok(NULL, DELM)) == NULL) {
+    if ((p = next_token(&q)) == NULL) {
       jlog("Error: ngram_read_arpa: RL 1-gram: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
     name = strcpy((char *)mymalloc(strlen(p)+1), p);
-    if ((p = strtok(NULL, DELM)) == NULL) {
+    if ((p = next_token(&q)) == NULL) {
       bo_wt = 0.0;
     } else {
       bo_wt = (LOGPROB)atof(p);
@@ -260,32 +673,33 @@ add_unigram(FILE *fp, NGRAM_INFO *ndata)
  * Read forward 2-gram data and set the LR 2-gram probabilities to the
  * already loaded RL N-gram.
  * 
- * @param fp [in] file pointer
+ * @param r [i/o] block reader of the file
  * @param ndata [i/o] N-gram to set the read data.
  */
 static boolean
-add_bigram(FILE *fp, NGRAM_INFO *ndata)
+add_bigram(ARPA_READER *r, NGRAM_INFO *ndata)
 {
   WORD_ID w[2], wtmp;
   LOGPROB prob;
   NNID bi_count = 0;
   NNID n2;
   boolean ok_p = TRUE;
-  char *s;
+  char *s, *q;
 
   ndata->p_2 = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), ndata->d[1].totalnum);
 
-  while (getl(buf, sizeof(buf), fp) != NULL && buf[0] != '\\') {
+  while (reader_getl(r, buf, sizeof(buf)) != NULL && buf[0] != '\\') {
     strcpy(pbuf, buf);
     if ( ++bi_count % 100000 == 0) {
       jlog("Stat: ngram_read_arpa: 2-gram read %lu (%d%%)\n", bi_count, bi_count * 100 / ndata->d[1].totalnum);
     }
-    if ((s = strtok(buf, DELM)) == NULL) {
+    q = buf;
+    if ((s = next_token(&q)) == NULL) {
       jlog("Error: ngram_read_arpa: 2-gram: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
     prob = (LOGPROB)atof(s);
-    if ((s = strtok(NULL, DELM)) == NULL) {
+    if ((s = next_token(&q)) == NULL) {
       jlog("Error: ngram_read_arpa: 2-gram: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
@@ -295,7 +709,7 @@ add_bigram(FILE *fp, NGRAM_INFO *ndata)
       ok_p = FALSE;
       continue;
     }
-    if ((s = strtok(NULL, DELM)) == NULL) {
+    if ((s = next_token(&q)) == NULL) {
       jlog("Error: ngram_read_arpa: 2-gram: failed to parse, corrupted or invalid data?\n");
       return FALSE;
     }
@@ -329,30 +743,33 @@ add_bigram(FILE *fp, NGRAM_INFO *ndata)
 /** 
  * Read n-gram data for a given N from ARPA n-gram file. (n >= 2)
  * 
- * @param fp [in] file pointer
+ * Lines are read in batch and parsed by parse_ngram_batch(), possibly
+ * in parallel, and then stored to the tuple arrays in order.
+ * 
+ * @param r [i/o] block reader of the file
  * @param ndata [out] N-gram to set the read data.
  */
 static boolean
-set_ngram(FILE *fp, NGRAM_INFO *ndata, int n)
+set_ngram(ARPA_READER *r, NGRAM_INFO *ndata, int n)
 {
   NNID i;
   WORD_ID *w;
   WORD_ID *w_last;
-  LOGPROB p, bowt;
   NNID nnid;
   NNID cid, cid_last;
   boolean ok_p = TRUE;
-  char *s;
   NGRAM_TUPLE_INFO *t;
   NGRAM_TUPLE_INFO *tprev;
   NNID ntmp;
+  ARPA_ENTRY *e, *x;
+  WORD_ID *wbuf;
+  int num, k;
 
   if (n < 2) {
     jlog("Error: ngram_read_arpa: unable to process 1-gram\n");
     return FALSE;
   }
 
-  w = (WORD_ID *)mymalloc(sizeof(WORD_ID) * n);
   w_last = (WORD_ID *)mymalloc(sizeof(WORD_ID) * n);
 
   t = &(ndata->d[n-1]);
@@ -363,7 +780,7 @@ set_ngram(FILE *fp, NGRAM_INFO *ndata, int n)
   if (t->is24bit) {
     t->bgn_upper = (NNID_UPPER *)mymalloc_big(sizeof(NNID_UPPER), t->bgnlistlen);
     t->bgn_lower = (NNID_LOWER *)mymalloc_big(sizeof(NNID_LOWER), t->bgnlistlen);
-    for(i = 0; i < t->bgnlistlen; i++) {    
+    for(i = 0; i < t->bgnlistlen; i++) {
       t->bgn_upper[i] = NNID_INVALID_UPPER;
       t->bgn_lower[i] = 0;
     }
@@ -389,126 +806,130 @@ set_ngram(FILE *fp, NGRAM_INFO *ndata, int n)
   cid = cid_last = NNID_INVALID;
   for(i=0;i<n;i++) w_last[i] = WORD_INVALID;
 
-  /* read in N-gram */
-  for (;;) {
-    if (getl(buf, sizeof(buf), fp) == NULL || buf[0] == '\\') break;
-    strcpy(pbuf, buf);
-    if ( nnid % 100000 == 0) {
-      jlog("Stat: ngram_read_arpa: %d-gram read %d (%d%%)\n", n, nnid, nnid * 100 / t->totalnum);
-    }
+  e = (ARPA_ENTRY *)mymalloc(sizeof(ARPA_ENTRY) * ARPA_BATCH_LINES);
+  wbuf = (WORD_ID *)mymalloc(sizeof(WORD_ID) * n * ARPA_BATCH_LINES);
 
-    /* N-gram probability */
-    if ((s = strtok(buf, DELM)) == NULL) {
-      jlog("Error: ngram_read_arpa: %d-gram: failed to parse, corrupted or invalid data?\n", n);
-      free(w_last); free(w);
-      return FALSE;
-    }
-    p = (LOGPROB)atof(s);
-    /* read in context word and lookup the ID */
-    for(i=0;i<n;i++) {
-      if ((s = strtok(NULL, DELM)) == NULL) {
+  /* read in N-gram */
+  while ((num = reader_lines(r, e, ARPA_BATCH_LINES)) > 0) {
+    parse_ngram_batch(ndata, n, e, wbuf, num);
+    for(k=0;k<num;k++) {
+      x = &(e[k]);
+      w = &(wbuf[k * n]);
+      if ( nnid % 100000 == 0) {
+	jlog("Stat: ngram_read_arpa: %d-gram read %d (%d%%)\n", n, nnid, nnid * 100 / t->totalnum);
+      }
+      if (x->status == ARPA_ENTRY_FORMAT) {
 	jlog("Error: ngram_read_arpa: %d-gram: failed to parse, corrupted or invalid data?\n", n);
-	free(w_last); free(w);
+	free(wbuf); free(e); free(w_last);
 	return FALSE;
       }
-      if ((w[i] = ngram_lookup_word(ndata, s)) == WORD_INVALID) {
-	jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": \"%s\" not exist in %d-gram\n", n, nnid+1, pbuf, s, n);
+      if (x->status == ARPA_ENTRY_NOWORD) {
+	set_errline(x);
+	jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": \"%s\" not exist in %d-gram\n", n, nnid+1, pbuf, x->errword, n);
 	ok_p = FALSE;
-	break;
+	continue;
       }
-      /* increment nnid_bgn and nnid_num if context word changed */
-    }
-    if (i < n) continue;	/* error out */
-
-    /* detect context entry change at this line */
-    for(i=0;i<n-1;i++) {
-      if (w[i] != w_last[i]) break;
-    }
-    if (i < n-1) {		/* context changed here */
-      /* find new entry point */
-      cid = search_ngram(ndata, n-1, w);
-      if (cid == NNID_INVALID) {	/* no context */
-        //jlog("Warning: ngram_read_arpa: %d-gram #%d: \"%s\": context (%s,%s) not exist in %d-gram (ignored)\n", n, nnid+1, pbuf, ndata->wname[w_m], ndata->wname[w_r], n-1);
-        jlog("Warning: ngram_read_arpa: %d-gram #%d: \"%s\": context (",
-	     n, nnid+1, pbuf);
-	for(i=0;i<n-1;i++) {
-	  jlog(" %s", ndata->wname[w[i]]);
-	}
-        jlog(") not exist in %d-gram (ignored)\n", n-1);
-	ok_p = FALSE;
-        continue;
+
+      /* detect context entry change at this line */
+      for(i=0;i<n-1;i++) {
+	if (w[i] != w_last[i]) break;
       }
-      if (cid_last != NNID_INVALID) {
-	/* close last entry */
+      if (i < n-1) {		/* context changed here */
+	/* new entry point was found at parsing */
+	cid = x->cid;
+	if (cid == NNID_INVALID) {	/* no context */
+	  set_errline(x);
+	  jlog("Warning: ngram_read_arpa: %d-gram #%d: \"%s\": context (",
+	       n, nnid+1, pbuf);
+	  for(i=0;i<n-1;i++) {
+	    jlog(" %s", ndata->wname[w[i]]);
+	  }
+	  jlog(") not exist in %d-gram (ignored)\n", n-1);
+	  ok_p = FALSE;
+	  continue;
+	}
+	if (cid_last != NNID_INVALID) {
+	  /* close last entry */
+	  if (t->is24bit) {
+	    ntmp = ((NNID)(t->bgn_upper[cid_last]) << 16) + (NNID)(t->bgn_lower[cid_last]);
+	  } else {
+	    ntmp = t->bgn[cid_last];
+	  }
+	  t->num[cid_last] = nnid - ntmp;
+	}
+	/* the next context word should be an new entry */
 	if (t->is24bit) {
-	  ntmp = ((NNID)(t->bgn_upper[cid_last]) << 16) + (NNID)(t->bgn_lower[cid_last]);
+	  if (t->bgn_upper[cid] != NNID_INVALID_UPPER) {
+	    set_errline(x);
+	    jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": word order is not the same as 1-gram\n", n, nnid+1, pbuf);
+	    free(wbuf); free(e); free(w_last);
+	    return FALSE;
+	  }
+	  ntmp = nnid & 0xffff;
+	  t->bgn_lower[cid] = ntmp;
+	  ntmp = nnid >> 16;
+	  t->bgn_upper[cid] = ntmp;
 	} else {
-	  ntmp = t->bgn[cid_last];
+	  if (t->bgn[cid] != NNID_INVALID) {
+	    set_errline(x);
+	    jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": word order is not the same as 1-gram\n", n, nnid+1, pbuf);
+	    free(wbuf); free(e); free(w_last);
+	    return FALSE;
+	  }
+	  t->bgn[cid] = nnid;
 	}
-	t->num[cid_last] = nnid - ntmp;
+
+	cid_last = cid;
+	w_last[n-1] = WORD_INVALID;
       }
-      /* the next context word should be an new entry */
-      if (t->is24bit) {
-	if (t->bgn_upper[cid] != NNID_INVALID_UPPER) {
-	  jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": word order is not the same as 1-gram\n", n, nnid+1, pbuf);
-	  free(w_last); free(w);
-	  return FALSE;
+
+      /* store the probabilities of the target word */
+      if (w[n-1] == w_last[n-1]) {
+	set_errline(x);
+	jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": duplicated entry\n", n, nnid+1, pbuf);
+	ok_p = FALSE;
+	continue;
+      } else if (w_last[n-1] != WORD_INVALID && w[n-1] < w_last[n-1]) {
+	set_errline(x);
+	jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": word order is not the same as 1-gram\n", n, nnid+1, pbuf);
+	free(wbuf); free(e); free(w_last);
+	return FALSE;
+      }
+
+      /* if the 2-gram has back-off entries, store them here */
+      if (x->has_bo_wt) {
+	if (t->bo_wt == NULL) {
+	  t->bo_wt = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), t->totalnum);
+	  for(i=0;i<nnid;i++) t->bo_wt[i] = 0.0;
 	}
-	ntmp = nnid & 0xffff;
-	t->bgn_lower[cid] = ntmp;
-	ntmp = nnid >> 16;
-	t->bgn_upper[cid] = ntmp;
+	t->bo_wt[nnid] = x->bo_wt;
       } else {
-	if (t->bgn[cid] != NNID_INVALID) {
-	  jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": word order is not the same as 1-gram\n", n, nnid+1, pbuf);
-	  free(w_last); free(w);
-	  return FALSE;
-	}
-	t->bgn[cid] = nnid;
+	if (t->bo_wt != NULL) t->bo_wt[nnid] = 0.0;
       }
 
-      cid_last = cid;
-      w_last[n-1] = WORD_INVALID;
-    }
+      /* store the entry info */
+      t->nnid2wid[nnid] = w[n-1];
+      t->prob[nnid] = x->prob;
 
-    /* store the probabilities of the target word */
-    if (w[n-1] == w_last[n-1]) {
-      jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": duplicated entry\n", n, nnid+1, pbuf);
-      ok_p = FALSE;
-      continue;
-    } else if (w_last[n-1] != WORD_INVALID && w[n-1] < w_last[n-1]) {
-      jlog("Error: ngram_read_arpa: %d-gram #%d: \"%s\": word order is not the same as 1-gram\n", n, nnid+1, pbuf);
-      free(w_last); free(w);
-      return FALSE;
-    }
+      nnid++;
+      for(i=0;i<n;i++) w_last[i] = w[i];
 
-    /* if the 2-gram has back-off entries, store them here */
-    if ((s = strtok(NULL, DELM)) != NULL) {
-      bowt = (LOGPROB) atof(s);
-      if (t->bo_wt == NULL) {
-	t->bo_wt = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), t->totalnum);
-	for(i=0;i<nnid;i++) t->bo_wt[i] = 0.0;
+      /* check total num */
+      if (nnid > t->totalnum) {
+	jlog("Error: ngram_read_arpa: %d-gram: read num (%d) not match the header value (%d)\n", n, nnid, t->totalnum);
+	free(wbuf); free(e); free(w_last);
+	return FALSE;
       }
-      t->bo_wt[nnid] = bowt;
-    } else {
-      if (t->bo_wt != NULL) t->bo_wt[nnid] = 0.0;
-    }
-
-    /* store the entry info */
-    t->nnid2wid[nnid] = w[n-1];
-    t->prob[nnid] = p;
-
-    nnid++;
-    for(i=0;i<n;i++) w_last[i] = w[i];
-
-    /* check total num */
-    if (nnid > t->totalnum) {
-      jlog("Error: ngram_read_arpa: %d-gram: read num (%d) not match the header value (%d)\n", n, nnid, t->totalnum);
-      free(w_last); free(w);
-      return FALSE;
     }
   }
-  
+  free(wbuf); free(e);
+  if (num < 0) {
+    free(w_last);
+    return FALSE;
+  }
+  /* get the next section header */
+  if (reader_getl(r, buf, sizeof(buf)) == NULL) buf[0] = '\0';
+
   /* set the last entry */
   if (t->is24bit) {
     ntmp = ((NNID)(t->bgn_upper[cid_last]) << 16) + (NNID)(t->bgn_lower[cid_last]);
@@ -523,22 +944,21 @@ set_ngram(FILE *fp, NGRAM_INFO *ndata, int n)
     jlog("Stat: ngram_read_arpa: %d-gram read %d end\n", n, nnid);
   }
 
-  free(w_last); free(w);
+  free(w_last);
   return ok_p;
 }
 
 /** 
- * Read in one ARPA N-gram file.  Supported combinations are
- * LR 2-gram, RL 3-gram and LR 3-gram.
+ * Read in one ARPA N-gram file from the block reader.
  * 
- * @param fp [in] file pointer
+ * @param r [i/o] block reader of the file
  * @param ndata [out] N-gram data to store the read data
  * @param addition [in] TRUE if going to read additional 2-gram
  * 
  * @return TRUE on success, FALSE on failure.
  */
-boolean
-ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
+static boolean
+read_arpa(ARPA_READER *r, NGRAM_INFO *ndata, boolean addition)
 {
   int i, n;
   NNID *num;
@@ -548,7 +968,7 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
   ndata->bigram_index_reversed = FALSE;
 
   /* read until `\data\' found */
-  while (getl(buf, sizeof(buf), fp) != NULL && strncmp(buf,"\\data\\",6) != 0);
+  while (reader_getl(r, buf, sizeof(buf)) != NULL && strncmp(buf,"\\data\\",6) != 0);
 
 
   if (addition) {
@@ -560,7 +980,7 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
     }
 
     /* read n-gram total info */
-    n = get_total_info(fp, &num);
+    n = get_total_info(r, &num);
     if (n == -1) {		/* error */
       free(num);
       return FALSE;
@@ -591,14 +1011,14 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
       return FALSE;
     }
     jlog("Stat: ngram_read_arpa: reading 1-gram part...\n");
-    if (add_unigram(fp, ndata) == FALSE) return FALSE;
+    if (add_unigram(r, ndata) == FALSE) return FALSE;
     /* read 2-gram data */
     if (!strnmatch(buf,"\\2-grams", 8)) {
       jlog("Error: ngram_read_arpa: 2-gram not found for additional LR 2-gram\n");
       return FALSE;
     }
     jlog("Stat: ngram_read_arpa: reading 2-gram part...\n");
-    if (add_bigram(fp, ndata) == FALSE) return FALSE;
+    if (add_bigram(r, ndata) == FALSE) return FALSE;
 
 
     /* ignore the rest */
@@ -608,7 +1028,7 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
 
   } else {
     /* read n-gram total info */
-    n = get_total_info(fp, &num);
+    n = get_total_info(r, &num);
     if (n == -1) {		/* error */
       free(num);
       return FALSE;
@@ -655,7 +1075,7 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
       return FALSE;
     }
     jlog("Stat: ngram_read_arpa: reading 1-gram part...\n");
-    if (set_unigram(fp, ndata) == FALSE) return FALSE;
+    if (set_unigram(r, ndata) == FALSE) return FALSE;
     
     i = 2;
     while(i <= n) {
@@ -666,7 +1086,7 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
 	return FALSE;
       }
       jlog("Stat: ngram_read_arpa: reading %d-gram part...\n", i);
-      if (set_ngram(fp, ndata, i) == FALSE) return FALSE;
+      if (set_ngram(r, ndata, i) == FALSE) return FALSE;
       i++;
     }
     /* finished reading file */
@@ -724,7 +1144,7 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
     
 #ifdef CLASS_NGRAM
   /* skip in-class word entries (they should be in word dictionary) */
-  if (getl(buf, sizeof(buf), fp) != NULL) {
+  if (reader_getl(r, buf, sizeof(buf)) != NULL) {
     if (strnmatch(buf, "\\class", 6)) {
       jlog("Stat: ngram_read_arpa: skipping in-class word entries...\n");
     }
@@ -735,3 +1155,37 @@ ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
 
   return TRUE;
 }
+
+/** 
+ * Read in one ARPA N-gram file.  Supported combinations are
+ * LR 2-gram, RL 3-gram and LR 3-gram.
+ *
+ * The file is read by large blocks.  If ndata->read_thread_num is
+ * larger than 1, the 2-gram and longer entries are parsed by that
+ * number of threads.
+ * 
+ * @param fp [in] file pointer
+ * @param ndata [out] N-gram data to store the read data
+ * @param addition [in] TRUE if going to read additional 2-gram
+ * 
+ * @return TRUE on success, FALSE on failure.
+ */
+boolean
+ngram_read_arpa(FILE *fp, NGRAM_INFO *ndata, boolean addition)
+{
+  ARPA_READER r;
+  boolean ret;
+
+  if (ndata->read_thread_num > 1) {
+#ifdef HAVE_PTHREAD
+    jlog("Stat: ngram_read_arpa: parse with %d threads\n", ndata->read_thread_num);
+#else
+    jlog("Warning: ngram_read_arpa: no thread support, parse in single thread\n");
+#endif
+  }
+  reader_init(&r, fp);
+  ret = read_arpa(&r, ndata, addition);
+  reader_free(&r);
+
+  return ret;
+}
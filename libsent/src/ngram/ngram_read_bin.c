@@ -22,6 +22,14 @@
  * ۤʤХȥΥޥ
  * ХʥN-gramǤʤɤ롥Υǥ⤽Τޤ
  * ɤ߹롥
+ *
+ * v6  v5 γڡ·Τǡޥ
+ * Хȥǽ񤫤Ƥ ngram_mmap_bin() ˤä
+ * եľܥ˥ޥåפƻѤ롥ޥåפϽ񤭹߻
+ * ԡǹԤΤǡʣΥץƱեɤ߹硤
+ * ʪΥڡå϶ͭ롥̤Ƥ
+ * Хȥۤʤ̾ɤɤ߹ࡥ̻Ҳ줿
+ * v7 Ʊͤ˰롥
  * 
  * </JA>
  * 
@@ -43,6 +51,14 @@
  * to 24bit index will performed just after model has been read.
  * Byte order will also considered by header information, so
  * binary N-gram still can be used among different machines.
+ *
+ * The v6 format is the v5 format with each array aligned to page
+ * boundary.  When it is in the natural byte order, ngram_mmap_bin()
+ * maps the file directly to memory instead of reading it.  The mapping
+ * is copy-on-write, so processes that load the same file share the
+ * pages in the page cache.  Compressed files or files in other byte
+ * order are read as usual.  The quantized v7 format is handled in the
+ * same way.
  * </EN>
  * 
  * @author Akinobu LEE
@@ -60,9 +76,17 @@
 
 #include <sent/stddefs.h>
 #include <sent/ngram2.h>
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 static int file_version;  ///< N-gram format version of the file
 static boolean need_swap; ///< TRUE if need byte swap
+static size_t rdcount;	  ///< Number of bytes read from the top of the file
 #ifdef WORDS_INT
 static boolean need_conv;	///< TRUE if need conversion of word ID from 2 bytes to 4 bytes
 static boolean words_int_retry = FALSE; ///< TRUE if retrying with conversion
@@ -74,6 +98,7 @@ static boolean words_int_retry = FALSE; ///< TRUE if retrying with conversion
  */
 #define rdn(A,B,C,D) if (rdnfunc(A,B,C,D) == FALSE) return FALSE
 #define rdn_wordid(A,B,C,D) if (rdn_wordid_func(A,B,C,D) == FALSE) return FALSE
+#define rdn_align(A) if (rdn_align_func(A) == FALSE) return FALSE
 /** 
  * Binary read function with byte swap
  * 
@@ -90,6 +115,7 @@ rdnfunc(FILE *fp, void *buf, size_t unitbyte, size_t unitnum)
     jlog("Error: ngram_read_bin: failed to read %d bytes\n", unitbyte*unitnum);
     return FALSE;
   }
+  rdcount += unitbyte * unitnum;
   if (need_swap) {
     if (unitbyte != 1) {
       swap_bytes(buf, unitbyte, unitnum);
@@ -134,16 +160,38 @@ rdn_wordid_func(FILE *fp, void *buf, int unitnum, boolean need_conv)
 #endif
 
 /** 
- * Check header to see whether the version matches.
+ * Skip padding bytes before an array in v6 format.
  * 
  * @param fp [in] file pointer
  */
 static boolean
-check_header(FILE *fp)
+rdn_align_func(FILE *fp)
 {
-  char buf[BINGRAM_HDSIZE], *p;
+  char buf[BINGRAM_ALIGN_V6];
+  size_t len;
+
+  if (file_version < 6) return TRUE;
+  len = (BINGRAM_ALIGN_V6 - rdcount % BINGRAM_ALIGN_V6) % BINGRAM_ALIGN_V6;
+  if (len > 0) {
+    if (myfread(buf, 1, len, fp) < len) {
+      jlog("Error: ngram_read_bin: failed to read %d bytes\n", (int)len);
+      return FALSE;
+    }
+    rdcount += len;
+  }
+  return TRUE;
+}
+
+/** 
+ * Check header to see whether the version matches.
+ * 
+ * @param buf [in] header of BINGRAM_HDSIZE bytes
+ */
+static boolean
+check_header_buf(char *buf)
+{
+  char *p;
 
-  rdn(fp, buf, 1, BINGRAM_HDSIZE);
   p = buf;
 #ifdef WORDS_INT
   need_conv = FALSE;
@@ -162,6 +210,14 @@ check_header(FILE *fp)
     /* bingram file made by JuliusLib-4 and later */
     file_version = 5;
     p += strlen(BINGRAM_IDSTR_V5) + 1;
+  } else if (strnmatch(p, BINGRAM_IDSTR_V6, strlen(BINGRAM_IDSTR_V6))) {
+    /* memory-mappable bingram file */
+    file_version = 6;
+    p += strlen(BINGRAM_IDSTR_V6) + 1;
+  } else if (strnmatch(p, BINGRAM_IDSTR_V7, strlen(BINGRAM_IDSTR_V7))) {
+    /* memory-mappable bingram file with quantized N-gram */
+    file_version = 7;
+    p += strlen(BINGRAM_IDSTR_V7) + 1;
   } else {
     /* not a bingram file */
     jlog("Error: ngram_read_bin: invalid header\n");
@@ -236,6 +292,77 @@ check_header(FILE *fp)
   return TRUE;
 }
 
+/** 
+ * Read header and check whether the version matches.
+ * 
+ * @param fp [in] file pointer
+ */
+static boolean
+check_header(FILE *fp)
+{
+  char buf[BINGRAM_HDSIZE];
+
+  rdcount = 0;
+  rdn(fp, buf, 1, BINGRAM_HDSIZE);
+  return(check_header_buf(buf));
+}
+
+/** 
+ * Read a quantized and bit-packed m-gram in v7 format.
+ * 
+ * @param fp [in] file pointer
+ * @param t [out] m-gram to store
+ */
+static boolean
+read_packed_tuple(FILE *fp, NGRAM_TUPLE_INFO *t)
+{
+  int i;
+  size_t len;
+
+  t->packed = TRUE;
+  rdn(fp, &(t->bgn_bits), sizeof(int), 1);
+  rdn(fp, &(t->num_bits), sizeof(int), 1);
+  rdn(fp, &(t->wid_bits), sizeof(int), 1);
+  len = NGRAM_PACK_WORDS(t->bgnlistlen, t->bgn_bits);
+  t->bgn_pk = (unsigned int *)mymalloc_big(sizeof(unsigned int), len);
+  rdn_align(fp);
+  rdn(fp, t->bgn_pk, sizeof(unsigned int), len);
+  len = NGRAM_PACK_WORDS(t->bgnlistlen, t->num_bits);
+  t->num_pk = (unsigned int *)mymalloc_big(sizeof(unsigned int), len);
+  rdn_align(fp);
+  rdn(fp, t->num_pk, sizeof(unsigned int), len);
+  len = NGRAM_PACK_WORDS(t->totalnum, t->wid_bits);
+  t->wid_pk = (unsigned int *)mymalloc_big(sizeof(unsigned int), len);
+  rdn_align(fp);
+  rdn(fp, t->wid_pk, sizeof(unsigned int), len);
+  t->prob_cb = (LOGPROB *)mymalloc(sizeof(LOGPROB) * NGRAM_QUANT_CBSIZE);
+  rdn_align(fp);
+  rdn(fp, t->prob_cb, sizeof(LOGPROB), NGRAM_QUANT_CBSIZE);
+  t->prob_q = (unsigned char *)mymalloc_big(sizeof(unsigned char), t->totalnum);
+  rdn_align(fp);
+  rdn(fp, t->prob_q, sizeof(unsigned char), t->totalnum);
+
+  rdn(fp, &i, sizeof(int), 1);
+  if (i == 1) {
+    t->bo_wt_cb = (LOGPROB *)mymalloc(sizeof(LOGPROB) * NGRAM_QUANT_CBSIZE);
+    rdn_align(fp);
+    rdn(fp, t->bo_wt_cb, sizeof(LOGPROB), NGRAM_QUANT_CBSIZE);
+    t->bo_wt_q = (unsigned char *)mymalloc_big(sizeof(unsigned char), t->context_num);
+    rdn_align(fp);
+    rdn(fp, t->bo_wt_q, sizeof(unsigned char), t->context_num);
+  }
+  rdn(fp, &i, sizeof(int), 1);
+  if (i == 1) {
+    t->nnid2ctid_upper = (NNID_UPPER *)mymalloc_big(sizeof(NNID_UPPER), t->totalnum);
+    t->nnid2ctid_lower = (NNID_LOWER *)mymalloc_big(sizeof(NNID_LOWER), t->totalnum);
+    rdn_align(fp);
+    rdn(fp, t->nnid2ctid_upper, sizeof(NNID_UPPER), t->totalnum);
+    rdn_align(fp);
+    rdn(fp, t->nnid2ctid_lower, sizeof(NNID_LOWER), t->totalnum);
+  }
+  return TRUE;
+}
+
 static boolean
 ngram_read_bin_v5(FILE *fp, NGRAM_INFO *ndata)
 {
@@ -264,6 +391,7 @@ ngram_read_bin_v5(FILE *fp, NGRAM_INFO *ndata)
   /* read wname */
   rdn(fp, &len, sizeof(int), 1);
   w = mymalloc(len);
+  rdn_align(fp);
   rdn(fp, w, 1, len);
   /* assign... */
   ndata->wname = (char **)mymalloc(sizeof(char *) * ndata->max_word_num);
@@ -290,23 +418,34 @@ ngram_read_bin_v5(FILE *fp, NGRAM_INFO *ndata)
     rdn(fp, &(t->bgnlistlen), sizeof(NNID), 1);
     rdn(fp, &(t->context_num), sizeof(NNID), 1);
 
+    if (file_version == 7 && n > 0) {
+      /* quantized and bit-packed */
+      if (read_packed_tuple(fp, t) == FALSE) return FALSE;
+      continue;
+    }
+
     if (n > 0) {
       if (t->is24bit) {
 	t->bgn_upper = (NNID_UPPER *)mymalloc_big(sizeof(NNID_UPPER), t->bgnlistlen);
+	rdn_align(fp);
 	rdn(fp, t->bgn_upper, sizeof(NNID_UPPER), t->bgnlistlen);
 	t->bgn_lower = (NNID_LOWER *)mymalloc_big(sizeof(NNID_LOWER), t->bgnlistlen);
+	rdn_align(fp);
 	rdn(fp, t->bgn_lower, sizeof(NNID_LOWER), t->bgnlistlen);
       } else {
 	t->bgn = (NNID *)mymalloc_big(sizeof(NNID), t->bgnlistlen);
+	rdn_align(fp);
 	rdn(fp, t->bgn, sizeof(NNID), t->bgnlistlen);
       }
       t->num = (WORD_ID *)mymalloc_big(sizeof(WORD_ID), t->bgnlistlen);
+      rdn_align(fp);
 #ifdef WORDS_INT
       rdn_wordid(fp, t->num, t->bgnlistlen, need_conv);
 #else
       rdn(fp, t->num, sizeof(WORD_ID), t->bgnlistlen);
 #endif
       t->nnid2wid = (WORD_ID *)mymalloc_big(sizeof(WORD_ID), t->totalnum);
+      rdn_align(fp);
 #ifdef WORDS_INT
       rdn_wordid(fp, t->nnid2wid, t->totalnum, need_conv);
 #else
@@ -322,11 +461,13 @@ ngram_read_bin_v5(FILE *fp, NGRAM_INFO *ndata)
     }
 
     t->prob = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), t->totalnum);
+    rdn_align(fp);
     rdn(fp, t->prob, sizeof(LOGPROB), t->totalnum);
 
     rdn(fp, &i, sizeof(int), 1);
     if (i == 1) {
       t->bo_wt = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), t->context_num);
+      rdn_align(fp);
       rdn(fp, t->bo_wt, sizeof(LOGPROB), t->context_num);
     } else {
       t->bo_wt = NULL;
@@ -335,7 +476,9 @@ ngram_read_bin_v5(FILE *fp, NGRAM_INFO *ndata)
     if (i == 1) {
       t->nnid2ctid_upper = (NNID_UPPER *)mymalloc_big(sizeof(NNID_UPPER), t->totalnum);
       t->nnid2ctid_lower = (NNID_LOWER *)mymalloc_big(sizeof(NNID_LOWER), t->totalnum);
+      rdn_align(fp);
       rdn(fp, t->nnid2ctid_upper, sizeof(NNID_UPPER), t->totalnum);
+      rdn_align(fp);
       rdn(fp, t->nnid2ctid_lower, sizeof(NNID_LOWER), t->totalnum);
     } else {
       t->nnid2ctid_upper = NULL;
@@ -345,6 +488,7 @@ ngram_read_bin_v5(FILE *fp, NGRAM_INFO *ndata)
   rdn(fp, &i, sizeof(int), 1);
   if (i == 1) {
     ndata->bo_wt_1 = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), ndata->d[0].context_num);
+    rdn_align(fp);
     rdn(fp, ndata->bo_wt_1, sizeof(LOGPROB), ndata->d[0].context_num);
   } else {
     ndata->bo_wt_1 = NULL;
@@ -353,6 +497,7 @@ ngram_read_bin_v5(FILE *fp, NGRAM_INFO *ndata)
   if (i == 1) {
     jlog("Stat: ngram_read_bin_v5: reading additional LR 2-gram\n");
     ndata->p_2 = (LOGPROB *)mymalloc_big(sizeof(LOGPROB), ndata->d[1].totalnum);
+    rdn_align(fp);
     rdn(fp, ndata->p_2, sizeof(LOGPROB), ndata->d[1].totalnum);
   } else {
     ndata->p_2 = NULL;
@@ -655,3 +800,272 @@ ngram_read_bin(FILE *fp, NGRAM_INFO *ndata)
   return TRUE;
 }
 
+#ifdef HAVE_MMAP
+
+/**
+ * Cursor to read a memory-mapped v6 binary N-gram.
+ * 
+ */
+typedef struct {
+  char *base;			///< Top of the mapped file image
+  size_t len;			///< Length of the file image
+  size_t pos;			///< Current read position
+} MMAP_CURSOR;
+
+#define mget(A,B,C,D) if (mgetfunc(A,B,C,D) == FALSE) return FALSE
+#define mget_array(A,B,C,D) if ((B = mget_array_func(A,C,D)) == NULL) return FALSE
+
+/** 
+ * Copy a scalar value from the mapped image.
+ * 
+ * @param c [i/o] cursor
+ * @param buf [out] data buffer
+ * @param unitbyte [in] unit size in bytes
+ * @param unitnum [in] number of unit to read.
+ */
+static boolean
+mgetfunc(MMAP_CURSOR *c, void *buf, size_t unitbyte, size_t unitnum)
+{
+  if (c->pos + unitbyte * unitnum > c->len) {
+    jlog("Error: ngram_mmap_bin: unexpected end of file\n");
+    return FALSE;
+  }
+  memcpy(buf, c->base + c->pos, unitbyte * unitnum);
+  c->pos += unitbyte * unitnum;
+  return TRUE;
+}
+
+/** 
+ * Get an aligned array in the mapped image.
+ * 
+ * @param c [i/o] cursor
+ * @param unitbyte [in] unit size in bytes
+ * @param unitnum [in] number of unit to read.
+ * 
+ * @return pointer to the array in the image, or NULL on error.
+ */
+static void *
+mget_array_func(MMAP_CURSOR *c, size_t unitbyte, size_t unitnum)
+{
+  void *p;
+
+  c->pos = (c->pos + BINGRAM_ALIGN_V6 - 1) / BINGRAM_ALIGN_V6 * BINGRAM_ALIGN_V6;
+  if (c->pos + unitbyte * unitnum > c->len) {
+    jlog("Error: ngram_mmap_bin: unexpected end of file\n");
+    return NULL;
+  }
+  p = c->base + c->pos;
+  c->pos += unitbyte * unitnum;
+  return p;
+}
+
+/** 
+ * Set up N-gram data on the mapped v6 image.  The order of the items
+ * follows ngram_read_bin_v5().
+ * 
+ * @param c [i/o] cursor just after the header
+ * @param ndata [out] N-gram data to store
+ * 
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+ngram_mmap_bin_body(MMAP_CURSOR *c, NGRAM_INFO *ndata)
+{
+  int i,n,len;
+  char *w, *p;
+  NGRAM_TUPLE_INFO *t;
+
+  mget(c, &(ndata->n), sizeof(int), 1);
+  mget(c, &(ndata->dir), sizeof(int), 1);
+  mget(c, &(ndata->bigram_index_reversed), sizeof(boolean), 1);
+
+  jlog("Stat: ngram_mmap_bin: this is %s %d-gram file\n", (ndata->dir == DIR_LR) ? "forward" : "backward", ndata->n);
+
+  ndata->d = (NGRAM_TUPLE_INFO *)mymalloc(sizeof(NGRAM_TUPLE_INFO) * ndata->n);
+  memset(ndata->d, 0, sizeof(NGRAM_TUPLE_INFO) * ndata->n);
+  for(n=0;n<ndata->n;n++) {
+    mget(c, &(ndata->d[n].totalnum), sizeof(NNID), 1);
+  }
+  ndata->max_word_num = ndata->d[0].totalnum;
+
+  /* wname: strings are in the image, only the index is allocated */
+  mget(c, &len, sizeof(int), 1);
+  mget_array(c, w, 1, len);
+  ndata->wname = (char **)mymalloc(sizeof(char *) * ndata->max_word_num);
+  p = w; i = 0;
+  while (p < w + len && i < ndata->max_word_num) {
+    ndata->wname[i++] = p;
+    while(p < w + len && *p != '\0') p++;
+    p++;
+  }
+  if (i != ndata->max_word_num || p != w + len) {
+    jlog("Error: ngram_mmap_bin: wname error??\n");
+    return FALSE;
+  }
+
+  for(n=0;n<ndata->n;n++) {
+    t = &(ndata->d[n]);
+    
+    mget(c, &(t->is24bit), sizeof(boolean), 1);
+    mget(c, &(t->ct_compaction), sizeof(boolean), 1);
+    mget(c, &(t->bgnlistlen), sizeof(NNID), 1);
+    mget(c, &(t->context_num), sizeof(NNID), 1);
+
+    if (file_version == 7 && n > 0) {
+      /* quantized and bit-packed */
+      t->packed = TRUE;
+      mget(c, &(t->bgn_bits), sizeof(int), 1);
+      mget(c, &(t->num_bits), sizeof(int), 1);
+      mget(c, &(t->wid_bits), sizeof(int), 1);
+      mget_array(c, t->bgn_pk, sizeof(unsigned int), NGRAM_PACK_WORDS(t->bgnlistlen, t->bgn_bits));
+      mget_array(c, t->num_pk, sizeof(unsigned int), NGRAM_PACK_WORDS(t->bgnlistlen, t->num_bits));
+      mget_array(c, t->wid_pk, sizeof(unsigned int), NGRAM_PACK_WORDS(t->totalnum, t->wid_bits));
+      mget_array(c, t->prob_cb, sizeof(LOGPROB), NGRAM_QUANT_CBSIZE);
+      mget_array(c, t->prob_q, sizeof(unsigned char), t->totalnum);
+      mget(c, &i, sizeof(int), 1);
+      if (i == 1) {
+	mget_array(c, t->bo_wt_cb, sizeof(LOGPROB), NGRAM_QUANT_CBSIZE);
+	mget_array(c, t->bo_wt_q, sizeof(unsigned char), t->context_num);
+      }
+      mget(c, &i, sizeof(int), 1);
+      if (i == 1) {
+	mget_array(c, t->nnid2ctid_upper, sizeof(NNID_UPPER), t->totalnum);
+	mget_array(c, t->nnid2ctid_lower, sizeof(NNID_LOWER), t->totalnum);
+      }
+      continue;
+    }
+
+    if (n > 0) {
+      if (t->is24bit) {
+	mget_array(c, t->bgn_upper, sizeof(NNID_UPPER), t->bgnlistlen);
+	mget_array(c, t->bgn_lower, sizeof(NNID_LOWER), t->bgnlistlen);
+      } else {
+	mget_array(c, t->bgn, sizeof(NNID), t->bgnlistlen);
+      }
+      mget_array(c, t->num, sizeof(WORD_ID), t->bgnlistlen);
+      mget_array(c, t->nnid2wid, sizeof(WORD_ID), t->totalnum);
+    } else {
+      t->bgnlistlen = 0;
+    }
+
+    mget_array(c, t->prob, sizeof(LOGPROB), t->totalnum);
+
+    mget(c, &i, sizeof(int), 1);
+    if (i == 1) {
+      mget_array(c, t->bo_wt, sizeof(LOGPROB), t->context_num);
+    }
+    mget(c, &i, sizeof(int), 1);
+    if (i == 1) {
+      mget_array(c, t->nnid2ctid_upper, sizeof(NNID_UPPER), t->totalnum);
+      mget_array(c, t->nnid2ctid_lower, sizeof(NNID_LOWER), t->totalnum);
+    }
+  }
+  mget(c, &i, sizeof(int), 1);
+  if (i == 1) {
+    mget_array(c, ndata->bo_wt_1, sizeof(LOGPROB), ndata->d[0].context_num);
+  }
+  mget(c, &i, sizeof(int), 1);
+  if (i == 1) {
+    jlog("Stat: ngram_mmap_bin: additional LR 2-gram found\n");
+    mget_array(c, ndata->p_2, sizeof(LOGPROB), ndata->d[1].totalnum);
+  }
+
+  return TRUE;
+}
+
+#endif /* HAVE_MMAP */
+
+/** 
+ * <JA>
+ * v6 / v7 ΥХʥN-gramե˥ޥåפɤ߹ࡥ
+ * ե뤬 v6 / v7 Ǥʤ̤Ƥ롤Хȥۤʤ
+ * ʤɤͳǥޥåפǤʤ 0 ֤ΤǡƤӽФ¦
+ * ngram_read_bin() ˤ̾ɤ߹ߤԤȡ
+ * 
+ * @param filename [in] ɤ߹ե̾
+ * @param ndata [out] ǡǼؤΥݥ
+ * 
+ * @return ޥåפ 1ޥåפǤʤ 0ե뤬
+ * Ƥ -1 ֤
+ * </JA>
+ * <EN>
+ * Load a v6 or v7 binary N-gram file by mapping it to memory.  If the file
+ * cannot be mapped, i.e. it is not in v6 / v7 format, compressed, or in
+ * other byte order, it returns 0 and the caller should read it by
+ * ngram_read_bin() as usual.
+ * 
+ * @param filename [in] file name to load
+ * @param ndata [out] pointer to store the N-gram data
+ * 
+ * @return 1 when mapped, 0 when the file cannot be mapped, or -1 when
+ * the file is broken.
+ * </EN>
+ */
+int
+ngram_mmap_bin(char *filename, NGRAM_INFO *ndata)
+{
+#ifdef HAVE_MMAP
+  int fd;
+  struct stat st;
+  void *base;
+  MMAP_CURSOR c;
+
+  if ((fd = open(filename, O_RDONLY)) < 0) return 0;
+  if (fstat(fd, &st) < 0 || st.st_size < BINGRAM_HDSIZE) {
+    close(fd);
+    return 0;
+  }
+  /* quick check of the id string before mapping */
+  {
+    char buf[sizeof(BINGRAM_IDSTR_V6)];
+    if (read(fd, buf, sizeof(buf)) != sizeof(buf)
+	|| (!strnmatch(buf, BINGRAM_IDSTR_V6, strlen(BINGRAM_IDSTR_V6))
+	    && !strnmatch(buf, BINGRAM_IDSTR_V7, strlen(BINGRAM_IDSTR_V7)))) {
+      close(fd);
+      return 0;
+    }
+  }
+  base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    jlog("Warning: ngram_mmap_bin: failed to map \"%s\", read it instead\n", filename);
+    return 0;
+  }
+
+  if (check_header_buf((char *)base) == FALSE) {
+    munmap(base, st.st_size);
+    return -1;
+  }
+  if (need_swap
+#ifdef WORDS_INT
+      || need_conv
+#endif
+      ) {
+    /* needs conversion while reading */
+    munmap(base, st.st_size);
+    return 0;
+  }
+
+  ndata->from_bin = TRUE;
+  ndata->mmap_base = base;
+  ndata->mmap_len = st.st_size;
+  c.base = (char *)base;
+  c.len = st.st_size;
+  c.pos = BINGRAM_HDSIZE;
+  if (ngram_mmap_bin_body(&c, ndata) == FALSE) {
+    jlog("Error: ngram_mmap_bin: failed to load \"%s\"\n", filename);
+    return -1;
+  }
+  jlog("Stat: ngram_mmap_bin: mapped %lu bytes from \"%s\"\n", (unsigned long)st.st_size, filename);
+
+  /* make word search tree for later lookup */
+  jlog("Stat: ngram_mmap_bin: making entry name index\n");
+  ngram_make_lookup_tree(ndata);
+
+  bi_prob_func_set(ndata);
+
+  return 1;
+#else
+  return 0;
+#endif
+}
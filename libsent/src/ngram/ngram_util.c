@@ -39,6 +39,20 @@ get_ngram_tuple_bytes(NGRAM_TUPLE_INFO *t)
   unsigned int size, unit;
 
   size = 0;
+  if (t->packed) {
+    /* quantized and bit-packed */
+    size += sizeof(unsigned int) * NGRAM_PACK_WORDS(t->bgnlistlen, t->bgn_bits);
+    size += sizeof(unsigned int) * NGRAM_PACK_WORDS(t->bgnlistlen, t->num_bits);
+    size += sizeof(unsigned int) * NGRAM_PACK_WORDS(t->totalnum, t->wid_bits);
+    size += sizeof(LOGPROB) * NGRAM_QUANT_CBSIZE + t->totalnum;
+    if (t->bo_wt_q) {
+      if (t->ct_compaction) {
+	size += (sizeof(NNID_UPPER) + sizeof(NNID_LOWER)) * t->totalnum;
+      }
+      size += sizeof(LOGPROB) * NGRAM_QUANT_CBSIZE + t->context_num;
+    }
+    return size;
+  }
   if (t->num != NULL) {		/* other than 1-gram */
     /* bgn */
     if (t->is24bit) {
@@ -99,9 +113,12 @@ print_ngram_info(FILE *fp, NGRAM_INFO *ndata)
   fprintf(fp, "\t    wordset size = %d\n", ndata->max_word_num);
   for(i=0;i<ndata->n;i++) {
     fprintf(fp, "\t  %d-gram entries = %10lu  (%5.1f MB)", i+1, (long unsigned int)ndata->d[i].totalnum, get_ngram_tuple_bytes(&(ndata->d[i])) / 1048576.0);
-    if (ndata->d[i].bo_wt != NULL && ndata->d[i].totalnum != ndata->d[i].context_num) {
+    if ((ndata->d[i].bo_wt != NULL || ndata->d[i].bo_wt_q != NULL) && ndata->d[i].totalnum != ndata->d[i].context_num) {
       fprintf(fp, " (%d%% are valid contexts)", ndata->d[i].context_num * 100 / ndata->d[i].totalnum);
     }
+    if (ndata->d[i].packed) {
+      fprintf(fp, " (quantized)");
+    }
     fprintf(fp, "\n");
   }
 
@@ -119,4 +136,7 @@ print_ngram_info(FILE *fp, NGRAM_INFO *ndata)
   } else {
     fprintf(fp, "2-gram in the forward n-gram\n");
   }
+  if (ndata->mmap_base) {
+    fprintf(fp, "\t          mapped = %5.1f MB from binary N-gram\n", ndata->mmap_len / 1048576.0);
+  }
 }
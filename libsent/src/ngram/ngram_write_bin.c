@@ -19,6 +19,14 @@
  * ɤ߹ࡥˤꡤۤʤХȥΥޥ
  * ХʥN-gramǤʤɤ롥Υǥ⤽Τޤ
  * ɤ߹롥
+ *
+ * ngram_write_bin_mmap() ϡƬڡ· v6 
+ * 񤭽Фv6 ϥޥΥХȥǽ񤫤졤ɤ߹߻
+ * mmap ľܥ˥ޥåפ롥
+ *
+ * ngram_write_bin_quant() ϡngram_quantize() ̻Ҳӥåȥѥå
+ * 줿 2-gram ʾ򤽤Τޤ¸ v7 ǽ񤭽Фv7 
+ * ֤ v6 Ʊڡ·롥
  * </JA>
  * 
  * <EN>
@@ -35,6 +43,15 @@
  * to 24bit index will performed just after model has been read.
  * Byte order will also considered by header information, so
  * binary N-gram still can be used among different machines.
+ *
+ * ngram_write_bin_mmap() writes the v6 format, in which the beginning
+ * of each array is aligned to page boundary.  The v6 format is written
+ * in the natural byte order of the machine, and is directly mapped to
+ * memory with mmap at reading.
+ *
+ * ngram_write_bin_quant() writes the v7 format, which holds 2-gram and
+ * above as quantized and bit-packed by ngram_quantize().  Arrays in v7
+ * format are aligned to page boundary as in v6.
  * </EN>
  * 
  * @author Akinobu LEE
@@ -54,8 +71,10 @@
 #include <sent/ngram2.h>
 
 static boolean need_swap; ///< TRUE if need byte swap
+static boolean align_section; ///< TRUE if align each array for v6 and v7 format
 
 #define wrt(A,B,C,D) if (wrtfunc(A,B,C,D) == FALSE) return FALSE
+#define wrt_align(A) if (wrtalignfunc(A) == FALSE) return FALSE
 
 static unsigned int count;
 void
@@ -95,28 +114,49 @@ wrtfunc(FILE *fp, void *buf, size_t unitbyte, size_t unitnum)
   return TRUE;
 }
 
+/** 
+ * Pad zero bytes so that the next array begins at the alignment
+ * boundary (v6 and v7 format only).
+ * 
+ * @param fp [in] file pointer
+ */
+static boolean
+wrtalignfunc(FILE *fp)
+{
+  char buf[BINGRAM_ALIGN_V6];
+  unsigned int len;
+
+  if (align_section == FALSE) return TRUE;
+  len = (BINGRAM_ALIGN_V6 - count % BINGRAM_ALIGN_V6) % BINGRAM_ALIGN_V6;
+  if (len > 0) {
+    memset(buf, 0, len);
+    wrt(fp, buf, 1, len);
+  }
+  return TRUE;
+}
+
 /** 
  * Write header information, with identifier string.
  * 
  * @param fp [in] file pointer
  * @param str [in] user header string (any string within BINGRAM_HDSIZE
  * bytes is allowed)
- * @param version [in] file format version id
+ * @param idstr [in] file format version id string
  */
 static boolean
-write_header(FILE *fp, char *str)
+write_header(FILE *fp, char *str, char *idstr)
 {
   char buf[BINGRAM_HDSIZE];
   int i, totallen;
 
   for(i=0;i<BINGRAM_HDSIZE;i++) buf[i] = EOF;
-  totallen = strlen(BINGRAM_IDSTR_V5) + 1 + strlen(BINGRAM_SIZESTR_HEAD) + strlen(BINGRAM_SIZESTR_BODY) + 1 + strlen(BINGRAM_BYTEORDER_HEAD) + strlen(BINGRAM_NATURAL_BYTEORDER) + 1 + strlen(str);
+  totallen = strlen(idstr) + 1 + strlen(BINGRAM_SIZESTR_HEAD) + strlen(BINGRAM_SIZESTR_BODY) + 1 + strlen(BINGRAM_BYTEORDER_HEAD) + strlen(BINGRAM_NATURAL_BYTEORDER) + 1 + strlen(str);
   if (totallen >= BINGRAM_HDSIZE) {
     jlog("Warning: write_bingram: header too long, last will be truncated\n");
     i = strlen(str) - (totallen - BINGRAM_HDSIZE);
     str[i] = '\0';
   }
-  sprintf(buf, "%s\n%s%s %s%s\n%s", BINGRAM_IDSTR_V5, BINGRAM_SIZESTR_HEAD, BINGRAM_SIZESTR_BODY, BINGRAM_BYTEORDER_HEAD, BINGRAM_NATURAL_BYTEORDER, str);
+  sprintf(buf, "%s\n%s%s %s%s\n%s", idstr, BINGRAM_SIZESTR_HEAD, BINGRAM_SIZESTR_BODY, BINGRAM_BYTEORDER_HEAD, BINGRAM_NATURAL_BYTEORDER, str);
   wrt(fp, buf, 1, BINGRAM_HDSIZE);
 
   return TRUE;
@@ -128,21 +168,40 @@ write_header(FILE *fp, char *str)
  * @param fp [in] file pointer
  * @param ndata [in] N-gram data to write
  * @param headerstr [in] user header string
+ * @param version [in] format version to write (5, 6 or 7)
  * 
  * @return TRUE on success, FALSE on failure
  */
-boolean
-ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
+static boolean
+write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr, int version)
 {
   int i,n;
   unsigned int len;
   int wlen;
   NGRAM_TUPLE_INFO *t;
+  char *idstr;
+
+  for(n=1;n<ndata->n;n++) {
+    if (ndata->d[n].packed && version != 7) {
+      jlog("Error: ngram_write_bin: quantized N-gram can be written only in v7 format\n");
+      return FALSE;
+    }
+    if (!ndata->d[n].packed && version == 7) {
+      jlog("Error: ngram_write_bin: N-gram should be quantized to write in v7 format\n");
+      return FALSE;
+    }
+  }
 
   reset_wrt_counter();
+  switch(version) {
+  case 5: idstr = BINGRAM_IDSTR_V5; break;
+  case 6: idstr = BINGRAM_IDSTR_V6; break;
+  default: idstr = BINGRAM_IDSTR_V7; break;
+  }
+  align_section = (version >= 6) ? TRUE : FALSE;
 
   /* write initial header */
-  if (write_header(fp, headerstr) == FALSE) return FALSE;
+  if (write_header(fp, headerstr, idstr) == FALSE) return FALSE;
 
   /* swap not needed any more */
   need_swap = FALSE;
@@ -166,6 +225,7 @@ ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
     wlen += strlen(ndata->wname[i]) + 1;
   }
   wrt(fp, &wlen, sizeof(int), 1);
+  wrt_align(fp);
   for(i=0;i<ndata->max_word_num;i++) {
     wrt(fp, ndata->wname[i], 1, strlen(ndata->wname[i]) + 1); /* include \0 */
   }
@@ -178,20 +238,66 @@ ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
     wrt(fp, &(t->ct_compaction), sizeof(boolean), 1);
     wrt(fp, &(t->bgnlistlen), sizeof(NNID), 1);
     wrt(fp, &(t->context_num), sizeof(NNID), 1);
+    if (version == 7 && n > 0) {
+      /* quantized and bit-packed */
+      wrt(fp, &(t->bgn_bits), sizeof(int), 1);
+      wrt(fp, &(t->num_bits), sizeof(int), 1);
+      wrt(fp, &(t->wid_bits), sizeof(int), 1);
+      wrt_align(fp);
+      wrt(fp, t->bgn_pk, sizeof(unsigned int), NGRAM_PACK_WORDS(t->bgnlistlen, t->bgn_bits));
+      wrt_align(fp);
+      wrt(fp, t->num_pk, sizeof(unsigned int), NGRAM_PACK_WORDS(t->bgnlistlen, t->num_bits));
+      wrt_align(fp);
+      wrt(fp, t->wid_pk, sizeof(unsigned int), NGRAM_PACK_WORDS(t->totalnum, t->wid_bits));
+      wrt_align(fp);
+      wrt(fp, t->prob_cb, sizeof(LOGPROB), NGRAM_QUANT_CBSIZE);
+      wrt_align(fp);
+      wrt(fp, t->prob_q, sizeof(unsigned char), t->totalnum);
+      if (t->bo_wt_q) {
+	i = 1;
+	wrt(fp, &i, sizeof(int), 1);
+	wrt_align(fp);
+	wrt(fp, t->bo_wt_cb, sizeof(LOGPROB), NGRAM_QUANT_CBSIZE);
+	wrt_align(fp);
+	wrt(fp, t->bo_wt_q, sizeof(unsigned char), t->context_num);
+      } else {
+	i = 0;
+	wrt(fp, &i, sizeof(int), 1);
+      }
+      if (t->nnid2ctid_upper) {
+	i = 1;
+	wrt(fp, &i, sizeof(int), 1);
+	wrt_align(fp);
+	wrt(fp, t->nnid2ctid_upper, sizeof(NNID_UPPER), t->totalnum);
+	wrt_align(fp);
+	wrt(fp, t->nnid2ctid_lower, sizeof(NNID_LOWER), t->totalnum);
+      } else {
+	i = 0;
+	wrt(fp, &i, sizeof(int), 1);
+      }
+      continue;
+    }
     if (n > 0) {
       if (t->is24bit) {
+	wrt_align(fp);
 	wrt(fp, t->bgn_upper, sizeof(NNID_UPPER), t->bgnlistlen);
+	wrt_align(fp);
 	wrt(fp, t->bgn_lower, sizeof(NNID_LOWER), t->bgnlistlen);
       } else {
+	wrt_align(fp);
 	wrt(fp, t->bgn, sizeof(NNID), t->bgnlistlen);
       }
+      wrt_align(fp);
       wrt(fp, t->num, sizeof(WORD_ID), t->bgnlistlen);
+      wrt_align(fp);
       wrt(fp, t->nnid2wid, sizeof(WORD_ID), t->totalnum);
     }
+    wrt_align(fp);
     wrt(fp, t->prob, sizeof(LOGPROB), t->totalnum);
     if (t->bo_wt) {
       i = 1;
       wrt(fp, &i, sizeof(int), 1);
+      wrt_align(fp);
       wrt(fp, t->bo_wt, sizeof(LOGPROB), t->context_num);
     } else {
       i = 0;
@@ -200,7 +306,9 @@ ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
     if (t->nnid2ctid_upper) {
       i = 1;
       wrt(fp, &i, sizeof(int), 1);
+      wrt_align(fp);
       wrt(fp, t->nnid2ctid_upper, sizeof(NNID_UPPER), t->totalnum);
+      wrt_align(fp);
       wrt(fp, t->nnid2ctid_lower, sizeof(NNID_LOWER), t->totalnum);
     } else {
       i = 0;
@@ -213,6 +321,7 @@ ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
   if (ndata->bo_wt_1) {
     i = 1;
     wrt(fp, &i, sizeof(int), 1);
+    wrt_align(fp);
     wrt(fp, ndata->bo_wt_1, sizeof(LOGPROB), ndata->d[0].context_num);
   } else {
     i = 0;
@@ -221,6 +330,7 @@ ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
   if (ndata->p_2) {
     i = 1;
     wrt(fp, &i, sizeof(int), 1);
+    wrt_align(fp);
     wrt(fp, ndata->p_2, sizeof(LOGPROB), ndata->d[1].totalnum);
   } else {
     i = 0;
@@ -231,3 +341,52 @@ ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
   jlog("Stat: ngram_write_bin: wrote %lu bytes (%.1f MB)\n", len, len / 1048576.0);
   return TRUE;
 }
+
+/** 
+ * Write a whole N-gram data in binary format.
+ * 
+ * @param fp [in] file pointer
+ * @param ndata [in] N-gram data to write
+ * @param headerstr [in] user header string
+ * 
+ * @return TRUE on success, FALSE on failure
+ */
+boolean
+ngram_write_bin(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
+{
+  return(write_bin(fp, ndata, headerstr, 5));
+}
+
+/** 
+ * Write a whole N-gram data in memory-mappable binary format (v6).
+ * Each array is aligned to BINGRAM_ALIGN_V6 bytes from the top of the
+ * file, so that it can be used directly after mapping the file.
+ * 
+ * @param fp [in] file pointer
+ * @param ndata [in] N-gram data to write
+ * @param headerstr [in] user header string
+ * 
+ * @return TRUE on success, FALSE on failure
+ */
+boolean
+ngram_write_bin_mmap(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
+{
+  return(write_bin(fp, ndata, headerstr, 6));
+}
+
+/** 
+ * Write a whole N-gram data in quantized binary format (v7).  The
+ * N-gram should be quantized by ngram_quantize() beforehand.  Arrays
+ * are aligned as in v6 format.
+ * 
+ * @param fp [in] file pointer
+ * @param ndata [in] N-gram data to write
+ * @param headerstr [in] user header string
+ * 
+ * @return TRUE on success, FALSE on failure
+ */
+boolean
+ngram_write_bin_quant(FILE *fp, NGRAM_INFO *ndata, char *headerstr)
+{
+  return(write_bin(fp, ndata, headerstr, 7));
+}
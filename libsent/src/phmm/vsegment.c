@@ -27,7 +27,7 @@
 #include <sent/hmm.h>
 
 /** 
- * @brief  Perform Viterbi alignment.
+ * @brief  Perform Viterbi alignment with a band of states and beam.
  *
  * This function performs viterbi alignment for the given sentence %HMM,
  * input parameter and unit definition.  Any segmentatino unit (word, phoneme
@@ -35,6 +35,14 @@
  * specifying a list of state id which are the end of each unit.
  * For example, if you want to obtain phoneme alignment, the list of state
  * number that exist at the end of phones should be specified by @a endstates.
+ *
+ * At each frame, only the band of states that are reachable from the
+ * beginning and can still reach the final state within the rest of the
+ * frames are computed.  This does not change the result.  When @a beam is
+ * larger than 0, states whose score is lower than the frame maximum by
+ * more than @a beam are also pruned.  The alignment may fail if the beam
+ * is too narrow or the input is too short: then LOG_ZERO is returned,
+ * the number of units is set to 0 and the arrays are set to NULL.
  * 
  * @param hmm [in] sentence HMM to be matched
  * @param param [in] input parameter data
@@ -42,6 +50,7 @@
  * @param multipath [in] TRUE if need multi-path handling
  * @param endstates [in] list of state id that corrsponds to the ends of units
  * @param ulen [in] total number of units in the @a hmm
+ * @param beam [in] score beam width, or 0.0 to disable
  * @param id_ret [out] Pointer to store the newly allocated array of the resulting id sequence of units on the best path.
  * @param seg_ret [out] Pointer to store the newly allocated array of the resulting end frame of each unit on the best path.
  * @param uscore_ret [out] Pointer to store the newly allocated array of the resulting score at the end frame of each unit on the best path.
@@ -50,7 +59,7 @@
  * @return the total acoustic score for the whole input.
  */
 LOGPROB
-viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int *endstates, int ulen, int **id_ret, int **seg_ret, LOGPROB **uscore_ret, int *slen_ret)
+viterbi_segment_band(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int *endstates, int ulen, LOGPROB beam, int **id_ret, int **seg_ret, LOGPROB **uscore_ret, int *slen_ret)
 {
   /* for viterbi */
   LOGPROB *nodescore[2];	/* node buffer */
@@ -69,6 +78,10 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
   int maxnode;			/* for debug */
   int *id, *seg, slen;
   LOGPROB *uscore;
+  int *remain;			/* minimum number of frames to reach the end */
+  int lo, hi, nlo, nhi;		/* band of active states */
+  LOGPROB thres;		/* beam threshold */
+  boolean changed;
 
   /* assume more than 1 units */
   if (ulen < 1) {
@@ -120,6 +133,30 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
     tokenp[tn][n] = newtoken;
   }
   from_node = (int *)mymalloc(sizeof(int) * hmm->len);
+
+  /* frame range */
+  if (multipath) {
+    startt = 0;  endt = param->samplenum;
+  } else {
+    startt = 1;  endt = param->samplenum - 1;
+  }
+
+  /* compute minimum number of frames needed to reach the final state
+     from each state (endt + 1 if unreachable) */
+  remain = (int *)mymalloc(sizeof(int) * hmm->len);
+  for (n = 0; n < hmm->len; n++) remain[n] = endt + 1;
+  remain[hmm->len-1] = 0;
+  do {
+    changed = FALSE;
+    for (n = hmm->len - 1; n >= 0; n--) {
+      for (ac = hmm->state[n].ac; ac; ac = ac->next) {
+	if (remain[n] > remain[ac->arc] + 1) {
+	  remain[n] = remain[ac->arc] + 1;
+	  changed = TRUE;
+	}
+      }
+    }
+  } while (changed);
   
   /* first frame: only set initial score */
   /*if (hmm->state[0].is_pseudo_state) {
@@ -131,12 +168,10 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
     nodescore[tn][0] = outprob(wrk, 0, &(hmm->state[0]), param);
   }
 
+  lo = hi = 0;
+  thres = LOG_ZERO;
+
   /* do viterbi for rest frame */
-  if (multipath) {
-    startt = 0;  endt = param->samplenum;
-  } else {
-    startt = 1;  endt = param->samplenum - 1;
-  }
   for (t = startt; t <= endt; t++) {
     i = tl;
     tl = tn;
@@ -150,17 +185,26 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
       from_node[i] = -1;
     }
 
-    /* select viterbi path for each node */
-    for (n = 0; n < hmm->len; n++) {
+    /* select viterbi path for each node in the band */
+    nlo = hmm->len;
+    nhi = -1;
+    for (n = lo; n <= hi; n++) {
       if (nodescore[tl][n] <= LOG_ZERO) continue;
+      if (nodescore[tl][n] < thres) continue; /* out of beam */
       for (ac = hmm->state[n].ac; ac; ac = ac->next) {
+	/* skip if the final state cannot be reached from there */
+	if (remain[ac->arc] > endt - (int)t) continue;
         tmpsum = nodescore[tl][n] + ac->a;
         if (nodescore[tn][ac->arc] < tmpsum) {
           nodescore[tn][ac->arc] = tmpsum;
 	  from_node[ac->arc] = n;
+	  if (nlo > ac->arc) nlo = ac->arc;
+	  if (nhi < ac->arc) nhi = ac->arc;
 	}
       }
     }
+    lo = nlo;
+    hi = nhi;
     /* propagate token, appending new if path was selected between units */
     if (multipath) {
       for (n = 0; n < hmm->len; n++) {
@@ -213,7 +257,7 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
     }
 	
     /* calc outprob to new nodes */
-    for (n = 0; n < hmm->len; n++) {
+    for (n = lo; n <= hi; n++) {
       if (multipath) {
 	if (hmm->state[n].out.state == NULL) continue;
       }
@@ -228,6 +272,8 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
 	maxnode = n;
       }
     }
+    /* set beam threshold for the next frame */
+    if (beam > 0.0) thres = maxscore - beam;
     
 #if 0
     for (i=0;i<ulen;i++) {
@@ -246,36 +292,46 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
   /* parse back the last token to see the trail of best viterbi path */
   /* and store the informations to returning buffer */
   slen = 0;
-  if (!multipath) slen++;
-  for(token = tokenp[tn][hmm->len-1]; token; token = token->next) {
-    if (token->last_end_frame == -1) break;
-    slen++;
+  if (result_score > LOG_ZERO) {
+    if (!multipath) slen++;
+    for(token = tokenp[tn][hmm->len-1]; token; token = token->next) {
+      if (token->last_end_frame == -1) break;
+      slen++;
+    }
   }
-  id = (int *)mymalloc(sizeof(int)*slen);
-  seg = (int *)mymalloc(sizeof(int)*slen);
-  uscore = (LOGPROB *)mymalloc(sizeof(LOGPROB)*slen);
 
-  if (multipath) {
-    i = slen - 1;
+  if (slen == 0) {
+    /* the final state was not reached: alignment failed */
+    result_score = LOG_ZERO;
+    id = seg = NULL;
+    uscore = NULL;
   } else {
-    id[slen-1] = ulen - 1;
-    seg[slen-1] = t - 1;
-    uscore[slen-1] = result_score;
-    i = slen - 2;
-  }
-  for(token = tokenp[tn][hmm->len-1]; token; token = token->next) {
-    if (i < 0 || token->last_end_frame == -1) break;
-    id[i] = token->last_id;
-    seg[i] = token->last_end_frame;
-    uscore[i] = token->last_end_score;
-    i--;
-  }
+    id = (int *)mymalloc(sizeof(int)*slen);
+    seg = (int *)mymalloc(sizeof(int)*slen);
+    uscore = (LOGPROB *)mymalloc(sizeof(LOGPROB)*slen);
 
-  /* normalize scores by frame */
-  for (i=slen-1;i>0;i--) {
-    uscore[i] = (uscore[i] - uscore[i-1]) / (seg[i] - seg[i-1]);
+    if (multipath) {
+      i = slen - 1;
+    } else {
+      id[slen-1] = ulen - 1;
+      seg[slen-1] = t - 1;
+      uscore[slen-1] = result_score;
+      i = slen - 2;
+    }
+    for(token = tokenp[tn][hmm->len-1]; token; token = token->next) {
+      if (i < 0 || token->last_end_frame == -1) break;
+      id[i] = token->last_id;
+      seg[i] = token->last_end_frame;
+      uscore[i] = token->last_end_score;
+      i--;
+    }
+
+    /* normalize scores by frame */
+    for (i=slen-1;i>0;i--) {
+      uscore[i] = (uscore[i] - uscore[i-1]) / (seg[i] - seg[i-1]);
+    }
+    uscore[0] = uscore[0] / (seg[0] + 1);
   }
-  uscore[0] = uscore[0] / (seg[0] + 1);
 
   /* set return value */
   *id_ret = id;
@@ -289,6 +345,7 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
     free(u_end);
   }
   free(from_node);
+  free(remain);
   token = root;
   while(token) {
     tmptoken = token->list;
@@ -303,3 +360,27 @@ viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int
   return(result_score);
 
 }
+
+/** 
+ * @brief  Perform Viterbi alignment.
+ *
+ * Same as viterbi_segment_band() without beam pruning.
+ * 
+ * @param hmm [in] sentence HMM to be matched
+ * @param param [in] input parameter data
+ * @param wrk [i/o] HMM computation work area
+ * @param multipath [in] TRUE if need multi-path handling
+ * @param endstates [in] list of state id that corrsponds to the ends of units
+ * @param ulen [in] total number of units in the @a hmm
+ * @param id_ret [out] Pointer to store the newly allocated array of the resulting id sequence of units on the best path.
+ * @param seg_ret [out] Pointer to store the newly allocated array of the resulting end frame of each unit on the best path.
+ * @param uscore_ret [out] Pointer to store the newly allocated array of the resulting score at the end frame of each unit on the best path.
+ * @param slen_ret [out] Pointer to store the total number of units on the best path.
+ * 
+ * @return the total acoustic score for the whole input.
+ */
+LOGPROB
+viterbi_segment(HMM *hmm, HTK_Param *param, HMMWork *wrk, boolean multipath, int *endstates, int ulen, int **id_ret, int **seg_ret, LOGPROB **uscore_ret, int *slen_ret)
+{
+  return(viterbi_segment_band(hmm, param, wrk, multipath, endstates, ulen, 0.0, id_ret, seg_ret, uscore_ret, slen_ret));
+}
@@ -147,3 +147,127 @@ mybfree2(BMALLOC_BASE **list)
   }
   *list = NULL;
 }
+
+/** 
+ * Initialize a resettable memory arena.
+ * 
+ * @param a [out] arena to be initialized
+ */
+void
+mybarena_init(BMALLOC_ARENA *a)
+{
+  a->root = NULL;
+  a->spare = NULL;
+  a->used = 0;
+  a->peak = 0;
+  a->total = 0;
+}
+
+/** 
+ * Allocate memory from a resettable arena.  The memory cannot be freed
+ * individually: all of them will be released at once by mybarena_reset().
+ * Blocks released by the reset are re-used here before allocating new ones.
+ * 
+ * @param size [in] memory size to be allocated
+ * @param a [i/o] arena
+ * 
+ * @return pointer to the newly allocated area.
+ */
+void *
+mybarena_malloc(unsigned int size, BMALLOC_ARENA *a)
+{
+  void *allocated;
+  BMALLOC_BASE *b, **p, **best;
+  unsigned int bsize;
+
+  if (!mybmalloc_initialized) mybmalloc_set_param();  /* initialize if not yet */
+  /* malloc segment should be aligned to a word boundary */
+  size = (size + align - 1) & align_mask;
+  if (a->root == NULL || a->root->now + size > a->root->end) {
+    /* look for the smallest spare block large enough */
+    best = NULL;
+    for (p = &(a->spare); *p; p = &((*p)->next)) {
+      if ((char *)(*p)->base + size > (*p)->end) continue;
+      if (best == NULL || (*p)->end - (char *)(*p)->base < (*best)->end - (char *)(*best)->base) best = p;
+    }
+    if (best != NULL) {
+      b = *best;
+      *best = b->next;
+    } else {
+      bsize = (size > blocksize) ? size : blocksize;
+      b = (BMALLOC_BASE *)mymalloc(sizeof(BMALLOC_BASE));
+      b->base = mymalloc(bsize);
+      b->end = (char *)b->base + bsize;
+      a->total += bsize;
+    }
+    b->now = (char *)b->base;
+    b->next = a->root;
+    a->root = b;
+  }
+  /* return current pointer */
+  allocated = a->root->now;
+  a->root->now += size;
+  a->used += size;
+  if (a->peak < a->used) a->peak = a->used;
+  return(allocated);
+}
+
+/** 
+ * Release all memories allocated from the arena at once.  The blocks are
+ * kept in the arena for re-use, up to twice the size used since the last
+ * reset (at least one block).  Blocks beyond that are freed, so that one
+ * unusually large use does not hold its memory for later ones.
+ * 
+ * @param a [i/o] arena
+ */
+void
+mybarena_reset(BMALLOC_ARENA *a)
+{
+  BMALLOC_BASE *b, *btmp, **p;
+  size_t keep, kept, bsize;
+
+  b = a->root;
+  while (b) {
+    btmp = b->next;
+    b->next = a->spare;
+    a->spare = b;
+    b = btmp;
+  }
+  a->root = NULL;
+
+  /* free spare blocks beyond the limit */
+  keep = a->used * 2;
+  if (keep < blocksize) keep = blocksize;
+  kept = 0;
+  p = &(a->spare);
+  while (*p) {
+    b = *p;
+    bsize = b->end - (char *)b->base;
+    if (kept + bsize <= keep) {
+      kept += bsize;
+      p = &(b->next);
+    } else {
+      *p = b->next;
+      free(b->base);
+      free(b);
+      a->total -= bsize;
+    }
+  }
+
+  a->used = 0;
+}
+
+/** 
+ * Free all blocks held in the arena.
+ * 
+ * @param a [i/o] arena
+ */
+void
+mybarena_free(BMALLOC_ARENA *a)
+{
+  a->used = 0;
+  mybarena_reset(a);
+  /* the reset keeps some blocks as spare: release them all */
+  mybfree2(&(a->spare));
+  a->total = 0;
+}
@@ -36,16 +36,37 @@
  * @param force_dict [in] TRUE if want to ignore the error words in the dictionary
  * 
  * @return TRUE on success, FALSE on failure.
+ *
+ * A binary dictionary made by mkbindict is auto-detected by its header.
  */
 boolean
 init_voca(WORD_INFO *winfo, char *filename, HTK_HMM_INFO *hmminfo, boolean not_conv_tri, boolean force_dict)
 {
   FILE *fd;
+  char hbuf[sizeof(BINDICT_HEADER)];
+  int hlen;
 
   if ((fd = fopen_readfile(filename)) == NULL) {
     jlog("Error: init_voca: failed to open %s\n",filename);
     return(FALSE);
   }
+  /* detect binary / ascii by the header */
+  hlen = strlen(BINDICT_HEADER);
+  if (myfread(hbuf, 1, hlen, fd) == hlen && strncmp(hbuf, BINDICT_HEADER, hlen) == 0) {
+    jlog("Stat: init_voca: loading binary dictionary\n");
+    if (!voca_load_binary(fd, winfo, hmminfo, not_conv_tri)) {
+      jlog("Error: init_voca: error in reading %s\n", filename);
+      fclose_readfile(fd);
+      return(FALSE);
+    }
+    if (fclose_readfile(fd) == -1) {
+      jlog("Error: init_voca: failed to close\n");
+      return(FALSE);
+    }
+    jlog("Stat: init_voca: read %d words\n", winfo->num);
+    return(TRUE);
+  }
+  myfrewind(fd);
   if (!voca_load_htkdict(fd, winfo, hmminfo, not_conv_tri)) {
     if (force_dict) {
       jlog("Warning: init_voca: the word errors are ignored\n");
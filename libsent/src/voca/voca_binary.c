@@ -0,0 +1,502 @@
+/**
+ * @file   voca_binary.c
+ *
+ * <JA>
+ * @brief  ñ켭ΥХʥǤɤ߽
+ *
+ * ñ̾ʸѴѤߤβ %HMM ̾ɽؤֹˡ
+ * 饹ΨʤɤޤȤƥХʥ¸ƥȼβϤ
+ * ǤȤ̾ȥ饤եѴԤʤ鷺˰礷ɤ߹ߤޤ
+ * ϼ˸ %HMM ̾ɽؤֹȤ¸졤
+ * ɤ߹߻ˤϤɽ̾Τߤ %HMM 鸡ޤ
+ * </JA>
+ *
+ * <EN>
+ * @brief  Read and write word dictionary in binary format
+ *
+ * Word names, output strings, converted phone sequences, in-class
+ * probabilities etc. are stored in a binary file, and read at once
+ * without parsing text entries, looking up each phone name or
+ * converting them to triphones.  The phone sequences are stored as
+ * indices to a table of logical %HMM names used in the dictionary, and
+ * only the names in the table are looked up on the %HMM definition at
+ * loading.
+ * </EN>
+ *
+ * @author Akinobu LEE
+ * @date   Mon Oct 19 18:05:42 2026
+ *
+ * $Revision: 1.1 $
+ *
+ */
+/*
+ * Copyright (c) 1991-2013 Kawahara Lab., Kyoto University
+ * Copyright (c) 2000-2005 Shikano Lab., Nara Institute of Science and Technology
+ * Copyright (c) 2005-2013 Julius project team, Nagoya Institute of Technology
+ * All rights reserved
+ */
+
+#include <sent/stddefs.h>
+#include <sent/vocabulary.h>
+
+/**
+ * Binary write function with byte swap (assume file is BIG ENDIAN)
+ *
+ * @param fp [in] file pointer
+ * @param buf [in] data to write
+ * @param unitbyte [in] size of a unit in bytes
+ * @param unitnum [in] number of unit to write
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+wrtfunc(FILE *fp, void *buf, size_t unitbyte, size_t unitnum)
+{
+  if (unitnum == 0) return TRUE;
+
+#ifndef WORDS_BIGENDIAN
+  if (unitbyte != 1) {
+    swap_bytes((char *)buf, unitbyte, unitnum);
+  }
+#endif
+  if (myfwrite(buf, unitbyte, unitnum, fp) < unitnum) {
+    jlog("Error: voca_binary: failed to write %d bytes\n", unitbyte * unitnum);
+    return FALSE;
+  }
+#ifndef WORDS_BIGENDIAN
+  if (unitbyte != 1) {
+    swap_bytes((char *)buf, unitbyte, unitnum);
+  }
+#endif
+  return TRUE;
+}
+
+/**
+ * Binary read function with byte swap (assume file is BIG ENDIAN)
+ *
+ * @param fp [in] file pointer
+ * @param buf [out] read data
+ * @param unitbyte [in] size of a unit in bytes
+ * @param unitnum [in] number of unit to be read
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+rdfunc(FILE *fp, void *buf, size_t unitbyte, size_t unitnum)
+{
+  if (unitnum == 0) return TRUE;
+
+  if (myfread(buf, unitbyte, unitnum, fp) < unitnum) {
+    jlog("Error: voca_binary: failed to read %d bytes\n", unitbyte * unitnum);
+    return FALSE;
+  }
+#ifndef WORDS_BIGENDIAN
+  if (unitbyte != 1) {
+    swap_bytes((char *)buf, unitbyte, unitnum);
+  }
+#endif
+  return TRUE;
+}
+
+/**
+ * qsort callback to sort logical %HMM pointers by address.
+ *
+ * @param a [in] element 1
+ * @param b [in] element 2
+ *
+ * @return order value
+ */
+static int
+compare_lg(const void *a, const void *b)
+{
+  HMM_Logical *x = *(HMM_Logical **)a;
+  HMM_Logical *y = *(HMM_Logical **)b;
+
+  if (x < y) return -1;
+  if (x > y) return 1;
+  return 0;
+}
+
+/**
+ * Look up index of a logical %HMM in the sorted table.
+ *
+ * @param lg [in] logical %HMM to look for
+ * @param table [in] sorted table of logical %HMM pointers
+ * @param num [in] number of elements in @a table
+ *
+ * @return the index in @a table, or -1 if not found.
+ */
+static int
+lookup_lg(HMM_Logical *lg, HMM_Logical **table, int num)
+{
+  int left, right, mid;
+
+  left = 0;
+  right = num - 1;
+  while (left <= right) {
+    mid = (left + right) / 2;
+    if (table[mid] == lg) return mid;
+    if (table[mid] < lg) left = mid + 1;
+    else right = mid - 1;
+  }
+  return -1;
+}
+
+/**
+ * Write a word dictionary to a file in binary format.  The phone
+ * sequences are stored as they are in @a winfo, so the dictionary
+ * should be read with the same triphone conversion setting as Julius.
+ *
+ * @param fp [in] file pointer to write
+ * @param winfo [in] word dictionary
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+boolean
+voca_save_binary(FILE *fp, WORD_INFO *winfo)
+{
+  WORD_ID w;
+  int i, k, len;
+  int flags, phnum, totalph, strbytes;
+  HMM_Logical **table;
+  unsigned char *ucbuf;
+  int *ibuf;
+  boolean ret;
+
+  /* set flags */
+  flags = 0;
+  if (winfo->num > 0) {
+    flags |= BINDICT_HAS_PHONE;
+    for (w = 0; w < winfo->num; w++) {
+      if (winfo->wseq[w] == NULL) {
+	flags &= ~BINDICT_HAS_PHONE;
+	break;
+      }
+    }
+  }
+  if ((flags & BINDICT_HAS_PHONE) && winfo->do_conv) flags |= BINDICT_TRIPHONE;
+#ifdef CLASS_NGRAM
+  if (winfo->cwnum > 0) flags |= BINDICT_HAS_CPROB;
+#endif
+#ifdef USE_MBR
+  if (winfo->weight != NULL) flags |= BINDICT_HAS_WEIGHT;
+#endif
+
+  /* make table of logical HMMs used in the dictionary */
+  totalph = 0;
+  phnum = 0;
+  table = NULL;
+  if (flags & BINDICT_HAS_PHONE) {
+    for (w = 0; w < winfo->num; w++) totalph += winfo->wlen[w];
+    table = (HMM_Logical **)mymalloc(sizeof(HMM_Logical *) * (totalph > 0 ? totalph : 1));
+    k = 0;
+    for (w = 0; w < winfo->num; w++) {
+      for (i = 0; i < winfo->wlen[w]; i++) table[k++] = winfo->wseq[w][i];
+    }
+    qsort(table, totalph, sizeof(HMM_Logical *), compare_lg);
+    for (k = 0; k < totalph; k++) {
+      if (phnum == 0 || table[phnum-1] != table[k]) table[phnum++] = table[k];
+    }
+  }
+
+  /* total length of word name and output strings */
+  strbytes = 0;
+  for (w = 0; w < winfo->num; w++) {
+    strbytes += strlen(winfo->wname[w]) + 1;
+    strbytes += strlen(winfo->woutput[w]) + 1;
+  }
+
+  ret = FALSE;
+  ucbuf = NULL;
+  ibuf = NULL;
+  do {
+    /* header */
+    if (myfwrite(BINDICT_HEADER, 1, strlen(BINDICT_HEADER), fp) < strlen(BINDICT_HEADER)) {
+      jlog("Error: voca_binary: failed to write header\n");
+      break;
+    }
+    k = BINDICT_VERSION;
+    if (wrtfunc(fp, &k, sizeof(int), 1) == FALSE) break;
+    if (wrtfunc(fp, &flags, sizeof(int), 1) == FALSE) break;
+    k = winfo->num;
+    if (wrtfunc(fp, &k, sizeof(int), 1) == FALSE) break;
+
+    /* logical HMM name table */
+    if (wrtfunc(fp, &phnum, sizeof(int), 1) == FALSE) break;
+    for (k = 0; k < phnum; k++) {
+      len = strlen(table[k]->name) + 1;
+      if (wrtfunc(fp, &len, sizeof(int), 1) == FALSE) break;
+      if (wrtfunc(fp, table[k]->name, 1, len) == FALSE) break;
+    }
+    if (k < phnum) break;
+
+    /* word name and output strings */
+    if (wrtfunc(fp, &strbytes, sizeof(int), 1) == FALSE) break;
+    for (w = 0; w < winfo->num; w++) {
+      if (wrtfunc(fp, winfo->wname[w], 1, strlen(winfo->wname[w]) + 1) == FALSE) break;
+      if (wrtfunc(fp, winfo->woutput[w], 1, strlen(winfo->woutput[w]) + 1) == FALSE) break;
+    }
+    if (w < winfo->num) break;
+
+    /* per-word values */
+    ucbuf = (unsigned char *)mymalloc(winfo->num > 0 ? winfo->num : 1);
+    for (w = 0; w < winfo->num; w++) ucbuf[w] = (flags & BINDICT_HAS_PHONE) ? winfo->wlen[w] : 0;
+    if (wrtfunc(fp, ucbuf, 1, winfo->num) == FALSE) break;
+    for (w = 0; w < winfo->num; w++) ucbuf[w] = winfo->is_transparent[w] ? 1 : 0;
+    if (wrtfunc(fp, ucbuf, 1, winfo->num) == FALSE) break;
+#ifdef CLASS_NGRAM
+    if (flags & BINDICT_HAS_CPROB) {
+      if (wrtfunc(fp, winfo->cprob, sizeof(LOGPROB), winfo->num) == FALSE) break;
+    }
+#endif
+#ifdef USE_MBR
+    if (flags & BINDICT_HAS_WEIGHT) {
+      if (wrtfunc(fp, winfo->weight, sizeof(LOGPROB), winfo->num) == FALSE) break;
+    }
+#endif
+
+    /* phone sequences as indices to the name table */
+    if (wrtfunc(fp, &totalph, sizeof(int), 1) == FALSE) break;
+    if (totalph > 0) {
+      ibuf = (int *)mymalloc(sizeof(int) * totalph);
+      k = 0;
+      for (w = 0; w < winfo->num; w++) {
+	for (i = 0; i < winfo->wlen[w]; i++) {
+	  ibuf[k++] = lookup_lg(winfo->wseq[w][i], table, phnum);
+	}
+      }
+      if (wrtfunc(fp, ibuf, sizeof(int), totalph) == FALSE) break;
+    }
+    ret = TRUE;
+  } while (0);
+
+  if (ibuf != NULL) free(ibuf);
+  if (ucbuf != NULL) free(ucbuf);
+  if (table != NULL) free(table);
+
+  if (ret == FALSE) {
+    jlog("Error: voca_binary: failed to write binary dictionary\n");
+  }
+  return ret;
+}
+
+/**
+ * Read body of a binary dictionary.  Header string is assumed to be
+ * already read.
+ *
+ * @param fp [in] file pointer
+ * @param winfo [i/o] word dictionary to store the data
+ * @param hmminfo [in] %HMM definition to resolve the phones, or NULL
+ * @param lgtable [out] work area for the resolved logical %HMM table
+ * @param ibuf [out] work area for the phone indices
+ * @param ucbuf [out] work area for the per-word byte values
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+static boolean
+rd_body(FILE *fp, WORD_INFO *winfo, HTK_HMM_INFO *hmminfo, HMM_Logical ***lgtable, int **ibuf, unsigned char **ucbuf)
+{
+  int k, len, version, flags, num, phnum, strbytes, totalph;
+  WORD_ID w;
+  char namebuf[MAX_HMMNAME_LEN];
+  char *p, *pend;
+  HMM_Logical **lgpool;
+  boolean ok_p;
+#ifndef USE_MBR
+  LOGPROB weight;
+#endif
+
+  if (rdfunc(fp, &version, sizeof(int), 1) == FALSE) return FALSE;
+  if (version != BINDICT_VERSION) {
+    jlog("Error: voca_binary: unsupported format version %d (expected %d)\n", version, BINDICT_VERSION);
+    return FALSE;
+  }
+  if (rdfunc(fp, &flags, sizeof(int), 1) == FALSE) return FALSE;
+  if (rdfunc(fp, &num, sizeof(int), 1) == FALSE) return FALSE;
+
+  /* check flags */
+  if (hmminfo != NULL) {
+    if (!(flags & BINDICT_HAS_PHONE)) {
+      jlog("Error: voca_binary: the binary dictionary has no phone sequence\n");
+      return FALSE;
+    }
+    if (((flags & BINDICT_TRIPHONE) ? TRUE : FALSE) != winfo->do_conv) {
+      if (flags & BINDICT_TRIPHONE) {
+	jlog("Error: voca_binary: phones in the binary dictionary are converted to triphone, but the current setting does not\n");
+      } else {
+	jlog("Error: voca_binary: phones in the binary dictionary are not converted to triphone, but the current setting requires it\n");
+      }
+      return FALSE;
+    }
+  }
+#ifndef CLASS_NGRAM
+  if (flags & BINDICT_HAS_CPROB) {
+    jlog("Error: voca_binary: cannot handle in-class word probability\n");
+    return FALSE;
+  }
+#endif
+
+  /* allocate word area */
+  if (num < 0 || num >= MAX_WORD_NUM) {
+    jlog("Error: voca_binary: number of words (%d) exceeds limit (%d)\n", num, MAX_WORD_NUM);
+    return FALSE;
+  }
+  while (winfo->maxnum <= num) {
+    if (winfo_expand(winfo) == FALSE) return FALSE;
+  }
+
+  /* read logical HMM name table and resolve them */
+  if (rdfunc(fp, &phnum, sizeof(int), 1) == FALSE) return FALSE;
+  *lgtable = (HMM_Logical **)mymalloc(sizeof(HMM_Logical *) * (phnum > 0 ? phnum : 1));
+  ok_p = TRUE;
+  for (k = 0; k < phnum; k++) {
+    if (rdfunc(fp, &len, sizeof(int), 1) == FALSE) return FALSE;
+    if (len <= 0 || len > MAX_HMMNAME_LEN) {
+      jlog("Error: voca_binary: corrupted phone name\n");
+      return FALSE;
+    }
+    if (rdfunc(fp, namebuf, 1, len) == FALSE) return FALSE;
+    namebuf[len-1] = '\0';
+    (*lgtable)[k] = NULL;
+    if (hmminfo != NULL) {
+      if (((*lgtable)[k] = htk_hmmdata_lookup_logical(hmminfo, namebuf)) == NULL) {
+	jlog("Error: voca_binary: phone \"%s\" not found\n", namebuf);
+	ok_p = FALSE;
+      }
+    }
+  }
+  if (ok_p == FALSE) {
+    jlog("Error: voca_binary: the binary dictionary was made with other HMM?\n");
+    return FALSE;
+  }
+
+  /* read word name and output strings at once */
+  if (rdfunc(fp, &strbytes, sizeof(int), 1) == FALSE) return FALSE;
+  if (strbytes < 0) {
+    jlog("Error: voca_binary: corrupted string area\n");
+    return FALSE;
+  }
+  p = (char *)mybmalloc2(strbytes > 0 ? strbytes : 1, &(winfo->mroot));
+  if (rdfunc(fp, p, 1, strbytes) == FALSE) return FALSE;
+  pend = p + strbytes;
+  for (w = 0; w < num; w++) {
+    if (p >= pend) break;
+    winfo->wname[w] = p;
+    p += strlen(p) + 1;
+    if (p >= pend) break;
+    winfo->woutput[w] = p;
+    p += strlen(p) + 1;
+  }
+  if (w < num || p != pend) {
+    jlog("Error: voca_binary: corrupted string area\n");
+    return FALSE;
+  }
+
+  /* per-word values */
+  *ucbuf = (unsigned char *)mymalloc(num > 0 ? num : 1);
+  if (rdfunc(fp, winfo->wlen, 1, num) == FALSE) return FALSE;
+  if (rdfunc(fp, *ucbuf, 1, num) == FALSE) return FALSE;
+  for (w = 0; w < num; w++) winfo->is_transparent[w] = (*ucbuf)[w] ? TRUE : FALSE;
+#ifdef CLASS_NGRAM
+  if (flags & BINDICT_HAS_CPROB) {
+    if (rdfunc(fp, winfo->cprob, sizeof(LOGPROB), num) == FALSE) return FALSE;
+    for (w = 0; w < num; w++) {
+      if (winfo->cprob[w] != 0.0) winfo->cwnum++;
+    }
+  } else {
+    for (w = 0; w < num; w++) winfo->cprob[w] = 0.0;
+  }
+#endif
+  if (flags & BINDICT_HAS_WEIGHT) {
+#ifdef USE_MBR
+    winfo->weight = (LOGPROB *)mymalloc(sizeof(LOGPROB) * winfo->maxnum);
+    if (rdfunc(fp, winfo->weight, sizeof(LOGPROB), num) == FALSE) return FALSE;
+#else
+    /* just skip */
+    for (w = 0; w < num; w++) {
+      if (rdfunc(fp, &weight, sizeof(LOGPROB), 1) == FALSE) return FALSE;
+    }
+#endif
+  }
+
+  /* phone sequences */
+  if (rdfunc(fp, &totalph, sizeof(int), 1) == FALSE) return FALSE;
+  len = 0;
+  for (w = 0; w < num; w++) len += winfo->wlen[w];
+  if (totalph != len) {
+    jlog("Error: voca_binary: corrupted phone sequence area\n");
+    return FALSE;
+  }
+  if (totalph > 0) {
+    *ibuf = (int *)mymalloc(sizeof(int) * totalph);
+    if (rdfunc(fp, *ibuf, sizeof(int), totalph) == FALSE) return FALSE;
+  }
+  if (hmminfo == NULL) {
+    /* phones are not used */
+    for (w = 0; w < num; w++) {
+      winfo->wseq[w] = NULL;
+      winfo->wlen[w] = 0;
+    }
+  } else {
+    lgpool = (HMM_Logical **)mybmalloc2(sizeof(HMM_Logical *) * (totalph > 0 ? totalph : 1), &(winfo->mroot));
+    k = 0;
+    for (w = 0; w < num; w++) {
+      if (winfo->wlen[w] == 0) {
+	jlog("Error: voca_binary: word #%d has no phone\n", w);
+	return FALSE;
+      }
+      winfo->wseq[w] = &(lgpool[k]);
+      for (len = 0; len < winfo->wlen[w]; len++) {
+	if ((*ibuf)[k] < 0 || (*ibuf)[k] >= phnum) {
+	  jlog("Error: voca_binary: corrupted phone sequence area\n");
+	  return FALSE;
+	}
+	lgpool[k] = (*lgtable)[(*ibuf)[k]];
+	k++;
+      }
+    }
+  }
+
+  winfo->num = num;
+
+  return TRUE;
+}
+
+/**
+ * Read a word dictionary in binary format.  The header string should
+ * be already read by the caller.
+ *
+ * @param fp [in] file pointer
+ * @param winfo [out] pointer to word dictionary to store the read data.
+ * @param hmminfo [in] HTK %HMM definition data.  if NULL, phonemes are ignored.
+ * @param ignore_tri_conv [in] TRUE if triphone conversion is ignored
+ *
+ * @return TRUE on success, FALSE on failure.
+ */
+boolean
+voca_load_binary(FILE *fp, WORD_INFO *winfo, HTK_HMM_INFO *hmminfo, boolean ignore_tri_conv)
+{
+  HMM_Logical **lgtable = NULL;
+  int *ibuf = NULL;
+  unsigned char *ucbuf = NULL;
+  boolean ret;
+
+  voca_load_start(winfo, hmminfo, ignore_tri_conv);
+
+  ret = rd_body(fp, winfo, hmminfo, &lgtable, &ibuf, &ucbuf);
+
+  if (ucbuf != NULL) free(ucbuf);
+  if (ibuf != NULL) free(ibuf);
+  if (lgtable != NULL) free(lgtable);
+
+  if (ret == FALSE) {
+    jlog("Error: voca_binary: failed to read binary dictionary\n");
+    winfo->num = 0;
+    winfo->ok_flag = FALSE;
+    return FALSE;
+  }
+
+  voca_set_stats(winfo);
+
+  return TRUE;
+}
@@ -13,6 +13,9 @@
  *
  * String can be "langentry" or "langentry[outputstring]", or
  * "#number".
+ *
+ * The word names are looked up through a hash index built on the first
+ * call and rebuilt when the number of words has changed.
  * </EN>
  * 
  * @author Akinobu LEE
@@ -31,6 +34,80 @@
 #include <sent/stddefs.h>
 #include <sent/vocabulary.h>
 
+/// Minimum number of hash buckets of the word lookup index
+#define VOCA_HASH_MIN 256
+
+/** 
+ * Hash function for word name string.
+ * 
+ * @param s [in] string
+ * @param len [in] length of the string
+ * 
+ * @return the hash value.
+ */
+static unsigned int
+voca_hash_str(char *s, int len)
+{
+  unsigned int h;
+  int i;
+
+  /* FNV-1a */
+  h = 2166136261U;
+  for (i = 0; i < len; i++) {
+    h ^= (unsigned char)s[i];
+    h *= 16777619U;
+  }
+  return h;
+}
+
+/** 
+ * Free the word lookup index.
+ * 
+ * @param winfo [i/o] word dictionary
+ */
+void
+voca_hash_free(WORD_INFO *winfo)
+{
+  if (winfo->hashtop != NULL) free(winfo->hashtop);
+  if (winfo->hashnext != NULL) free(winfo->hashnext);
+  winfo->hashtop = NULL;
+  winfo->hashnext = NULL;
+  winfo->hashsize = 0;
+  winfo->hashnum = 0;
+}
+
+/** 
+ * Build the word lookup index for all words in the dictionary.
+ * 
+ * @param winfo [i/o] word dictionary
+ */
+static void
+voca_hash_build(WORD_INFO *winfo)
+{
+  WORD_ID w;
+  unsigned int h;
+  int i, size;
+
+  voca_hash_free(winfo);
+  size = VOCA_HASH_MIN;
+  while (size < winfo->num) size *= 2;
+  winfo->hashtop = (WORD_ID *)mymalloc(sizeof(WORD_ID) * size);
+  for (i = 0; i < size; i++) winfo->hashtop[i] = WORD_INVALID;
+  winfo->hashnext = (WORD_ID *)mymalloc(sizeof(WORD_ID) * (winfo->num > 0 ? winfo->num : 1));
+  /* register in reverse order so that each chain is in ascending order */
+  for (w = winfo->num; w > 0; w--) {
+    if (winfo->wname[w-1] == NULL) {
+      winfo->hashnext[w-1] = WORD_INVALID;
+      continue;
+    }
+    h = voca_hash_str(winfo->wname[w-1], strlen(winfo->wname[w-1])) & (size - 1);
+    winfo->hashnext[w-1] = winfo->hashtop[h];
+    winfo->hashtop[h] = w-1;
+  }
+  winfo->hashsize = size;
+  winfo->hashnum = winfo->num;
+}
+
 /** 
  * Look up a word on dictionary by string.
  * 
@@ -43,7 +120,7 @@ WORD_ID
 voca_lookup_wid(char *keyword, WORD_INFO *winfo)
 {
   WORD_ID i, found;
-  int plen,totallen;
+  int plen, olen;
   boolean numflag = TRUE;
   int wid;
   char *c;
@@ -70,31 +147,30 @@ voca_lookup_wid(char *keyword, WORD_INFO *winfo)
     }
   }
       
+  /* (re)build index if not yet or the dictionary has been modified */
+  if (winfo->hashtop == NULL || winfo->hashnum != winfo->num) {
+    voca_hash_build(winfo);
+  }
+
   found = WORD_INVALID;
-  totallen = strlen(keyword);
   if ((c = strchr(keyword, '[')) != NULL) {
     plen = c - keyword;
-    for (i=0;i<winfo->num;i++) {
-      if (strnmatch(keyword,winfo->wname[i], plen)
-	  && strnmatch(c+1, winfo->woutput[i], totallen-plen-2)) {
-	if (found == WORD_INVALID) {
-	  found = i;
-	} else {
-	  jlog("Warning: voca_lookup: several \"%s\" found in dictionary, use the first one..\n");
-	  break;
-	}
-      }
-    }
+    olen = strlen(keyword) - plen - 2;
+    if (olen < 0) olen = 0;
   } else {
-    for (i=0;i<winfo->num;i++) {
-      if (strmatch(keyword,winfo->wname[i])) {
-	if (found == WORD_INVALID) {
-	  found = i;
-	} else {
-	  jlog("Warning: voca_lookup: several \"%s\" found in dictionary, use the first one..\n");
-	  break;
-	}
-      }
+    plen = strlen(keyword);
+    olen = -1;
+  }
+  for (i = winfo->hashtop[voca_hash_str(keyword, plen) & (winfo->hashsize - 1)]; i != WORD_INVALID; i = winfo->hashnext[i]) {
+    if (strlen(winfo->wname[i]) != plen || strncmp(keyword, winfo->wname[i], plen) != 0) continue;
+    if (olen >= 0) {
+      if (winfo->woutput[i] == NULL || strlen(winfo->woutput[i]) != olen || strncmp(c+1, winfo->woutput[i], olen) != 0) continue;
+    }
+    if (found == WORD_INVALID) {
+      found = i;
+    } else {
+      jlog("Warning: voca_lookup: several \"%s\" found in dictionary, use the first one..\n", keyword);
+      break;
     }
   }
   return found;
@@ -51,6 +51,10 @@ word_info_new()
 #ifdef USE_MBR
   new->weight = NULL;
 #endif
+  new->hashtop = NULL;
+  new->hashnext = NULL;
+  new->hashsize = 0;
+  new->hashnum = 0;
 
   return(new);
 }
@@ -74,6 +78,8 @@ word_info_free(WORD_INFO *winfo)
   if (winfo->cprob != NULL) free(winfo->cprob);
 #endif
   if (winfo->is_transparent != NULL) free(winfo->is_transparent);
+  /* free word lookup index */
+  voca_hash_free(winfo);
   /* free whole */
 #ifdef USE_MBR
   if (winfo->weight != NULL) free(winfo->weight);
@@ -109,6 +115,7 @@ winfo_init(WORD_INFO *winfo)
   winfo->maxwlen = 0;
   winfo->errnum = 0;
   winfo->errph_root = NULL;
+  voca_hash_free(winfo);
 }
 
 /** 
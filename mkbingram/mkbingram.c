@@ -52,6 +52,9 @@ usage(char *s)
   printf("    -d bingramfile  Julius binary N-gram file input\n");
   printf("    -c from to      convert character code\n");
   printf("    -swap           swap \"%s\" and \"%s\"\n", BEGIN_WORD_DEFAULT, END_WORD_DEFAULT);
+  printf("    -mmap           write in memory-mappable v6 format\n");
+  printf("    -q              quantize 2-gram and above (v7 format)\n");
+  printf("    -thread num     parse ARPA N-gram with num threads\n");
   printf("\n      When both \"-nlr\" and \"-nrl\" are specified, \n");
   printf("      Julius will use the BACKWARD N-gram as main LM\n");
   printf("      and use the forward 2-gram only at the 1st pass\n");
@@ -72,6 +75,9 @@ main(int argc, char *argv[])
   char *from_code, *to_code, *buf;
   boolean charconv_enabled = FALSE;
   boolean force_swap = FALSE;
+  boolean mmap_format = FALSE;
+  boolean quantize = FALSE;
+  int thread_num = 1;
   WORD_ID w;
 
   binfile = lrfile = rlfile = outfile = NULL;
@@ -130,6 +136,17 @@ main(int argc, char *argv[])
 	charconv_enabled = TRUE;
       } else if (argv[i][1] == 's') {
 	force_swap = TRUE;
+      } else if (argv[i][1] == 'm') {
+	mmap_format = TRUE;
+      } else if (argv[i][1] == 'q') {
+	quantize = TRUE;
+      } else if (argv[i][1] == 't') {
+	if (++i >= argc) {
+	  printf("Error: no argument for option \"%s\"\n", argv[i]);
+	  usage(argv[0]);
+	  return -1;
+	}
+	thread_num = atoi(argv[i]);
       }
     } else {
       if (outfile == NULL) {
@@ -195,6 +212,7 @@ main(int argc, char *argv[])
     if (force_swap) {
       ngram->bos_eos_swap = TRUE;
     }
+    ngram->read_thread_num = thread_num;
     if (rlfile) {
       if (init_ngram_arpa(ngram, rlfile, DIR_RL) == FALSE) return -1;
       if (lrfile) {
@@ -205,6 +223,18 @@ main(int argc, char *argv[])
     }
   }
 
+  if (ngram->n > 1 && ngram->d[1].packed && quantize == FALSE) {
+    /* already quantized, cannot be written in other format */
+    printf("Warning: input is quantized, output will also be quantized\n");
+    quantize = TRUE;
+  }
+  if (quantize) {
+    if (ngram_quantize(ngram) == FALSE) {
+      fprintf(stderr, "failed to quantize N-gram\n");
+      return -1;
+    }
+  }
+
   print_ngram_info(stdout, ngram);
   
   if (charconv_enabled == TRUE) {
@@ -227,10 +257,24 @@ main(int argc, char *argv[])
     fprintf(stderr, "failed to open \"%s\"\n", outfile);
     return -1;
   }
-  printf("\nWriting in v5 format to \"%s\"...\n", outfile);
-  if (ngram_write_bin(fp, ngram, header) == FALSE){/* failed */
-    fprintf(stderr, "failed to write \"%s\"\n",outfile);
-    return -1;
+  if (quantize) {
+    printf("\nWriting in v7 format to \"%s\"...\n", outfile);
+    if (ngram_write_bin_quant(fp, ngram, header) == FALSE){/* failed */
+      fprintf(stderr, "failed to write \"%s\"\n",outfile);
+      return -1;
+    }
+  } else if (mmap_format) {
+    printf("\nWriting in v6 format to \"%s\"...\n", outfile);
+    if (ngram_write_bin_mmap(fp, ngram, header) == FALSE){/* failed */
+      fprintf(stderr, "failed to write \"%s\"\n",outfile);
+      return -1;
+    }
+  } else {
+    printf("\nWriting in v5 format to \"%s\"...\n", outfile);
+    if (ngram_write_bin(fp, ngram, header) == FALSE){/* failed */
+      fprintf(stderr, "failed to write \"%s\"\n",outfile);
+      return -1;
+    }
   }
   fclose_writefile(fp);
 
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2003-2013 Kawahara Lab., Kyoto University
+ * Copyright (c) 2003-2005 Shikano Lab., Nara Institute of Science and Technology
+ * Copyright (c) 2005-2013 Julius project team, Nagoya Institute of Technology
+ * All rights reserved
+ */
+
+/* mkbindict --- read in ascii word dictionary and write in binary format */
+
+/* $Id: mkbindict.c,v 1.1 2026/10/19 18:05:42 sumomo Exp $ */
+
+#include <sent/stddefs.h>
+#include <sent/htk_hmm.h>
+#include <sent/vocabulary.h>
+
+
+HTK_HMM_INFO *hmminfo;
+WORD_INFO *winfo;
+Value para;
+
+
+static void
+usage(char *s)
+{
+  printf("mkbindict: convert word dictionary to binary format for Julius\n");
+  printf("usage: %s [-hlist HMMList] hmmdefs dict bindict\n", s);
+  printf("\nLibrary configuration: ");
+  confout_version(stdout);
+  confout_am(stdout);
+  printf("\n");
+}
+
+
+int
+main(int argc, char *argv[])
+{
+  FILE *fp;
+  char *hmmdefs_file;
+  char *hmmlist_file;
+  char *dict_file;
+  char *outfile;
+  int i;
+
+  hmmdefs_file = hmmlist_file = dict_file = outfile = NULL;
+  for(i=1;i<argc;i++) {
+    if (strmatch(argv[i], "-hlist")) {
+      if (++i >= argc) {
+	usage(argv[0]);
+	return -1;
+      }
+      hmmlist_file = argv[i];
+    } else if (hmmdefs_file == NULL) {
+      hmmdefs_file = argv[i];
+    } else if (dict_file == NULL) {
+      dict_file = argv[i];
+    } else if (outfile == NULL) {
+      outfile = argv[i];
+    } else {
+      usage(argv[0]);
+      return -1;
+    }
+  }
+  if (hmmdefs_file == NULL || dict_file == NULL || outfile == NULL) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  hmminfo = hmminfo_new();
+
+  printf("---- reading hmmdefs ----\n");
+  printf("filename: %s\n", hmmdefs_file);
+
+  /* read hmmdef file */
+  undef_para(&para);
+  if (init_hmminfo(hmminfo, hmmdefs_file, hmmlist_file, &para) == FALSE) {
+    fprintf(stderr, "--- terminated\n");
+    return -1;
+  }
+
+  /* pseudo phones can appear in the dictionary as the same as Julius */
+  if (hmminfo->is_triphone) {
+    if (hmminfo->cdset_root == NULL) {
+      fprintf(stderr, "making pseudo bi/mono-phone for IW-triphone\n");
+      if (make_cdset(hmminfo) == FALSE) {
+	fprintf(stderr, "ERROR: failed to make context-dependent state set\n");
+	return -1;
+      }
+    }
+    hmm_add_pseudo_phones(hmminfo);
+  }
+
+  printf("\n------------------------------------------------------------\n");
+  print_hmmdef_info(stdout, hmminfo);
+  printf("\n");
+
+  printf("------------------------------------------------------------\n");
+
+  printf("---- reading dictionary ----\n");
+  printf("filename: %s\n", dict_file);
+
+  winfo = word_info_new();
+  if (init_voca(winfo, dict_file, hmminfo, FALSE, FALSE) == FALSE) {
+    fprintf(stderr, "--- terminated\n");
+    return -1;
+  }
+
+  printf("\n------------------------------------------------------------\n");
+  print_voca_info(stdout, winfo);
+  printf("\n");
+
+  printf("------------------------------------------------------------\n");
+
+  printf("---- writing binary dictionary ----\n");
+  printf("filename: %s\n", outfile);
+
+  if ((fp = fopen_writefile(outfile)) == NULL) {
+    fprintf(stderr, "failed to open %s for writing\n", outfile);
+    return -1;
+  }
+  if (voca_save_binary(fp, winfo) == FALSE) {
+    fprintf(stderr, "failed to write to %s\n", outfile);
+    return -1;
+  }
+  if (fclose_writefile(fp) != 0) {
+    fprintf(stderr, "failed to close %s\n", outfile);
+    return -1;
+  }
+
+  printf("\n");
+  printf("binary dictionary is written to \"%s\"\n", outfile);
+
+  return 0;
+}
@@ -21,7 +21,7 @@ static void
 usage(char *s)
 {
   printf("mkbinhmm: convert HMM definition file to binary format for Julius\n");
-  printf("usage: %s [-htkconf HTKConfig] hmmdefs binhmm\n", s);
+  printf("usage: %s [-htkconf HTKConfig] [-mmap] hmmdefs binhmm\n", s);
   printf("\nLibrary configuration: ");
   confout_version(stdout);
   confout_am(stdout);
@@ -36,6 +36,7 @@ main(int argc, char *argv[])
   char *infile;
   char *outfile;
   char *conffile;
+  boolean mmap_format = FALSE;
   int i;
 
   infile = outfile = conffile = NULL;
@@ -46,6 +47,8 @@ main(int argc, char *argv[])
 	return -1;
       }
       conffile = argv[i];
+    } else if (strmatch(argv[i], "-mmap")) {
+      mmap_format = TRUE;
     } else {
       if (infile == NULL) {
 	infile = argv[i];
@@ -116,9 +119,16 @@ main(int argc, char *argv[])
     fprintf(stderr, "failed to open %s for writing\n", outfile);
     return -1;
   }
-  if (write_binhmm(fp, hmminfo, (para.loaded == 1) ? &para : NULL) == FALSE) {
-    fprintf(stderr, "failed to write to %s\n", outfile);
-    return -1;
+  if (mmap_format) {
+    if (write_binhmm_image(fp, hmminfo, (para.loaded == 1) ? &para : NULL) == FALSE) {
+      fprintf(stderr, "failed to write to %s\n", outfile);
+      return -1;
+    }
+  } else {
+    if (write_binhmm(fp, hmminfo, (para.loaded == 1) ? &para : NULL) == FALSE) {
+      fprintf(stderr, "failed to write to %s\n", outfile);
+      return -1;
+    }
   }
   if (fclose_writefile(fp) != 0) {
     fprintf(stderr, "failed to close %s\n", outfile);